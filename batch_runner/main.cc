@@ -0,0 +1,338 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// third-party includes
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/absl/strings/str_join.h>
+#include <physiology/interface/absl/strings/string_view.h>
+#include <physiology/interface/glog/logging.h>
+#include <physiology/interface/nlohmann/json.hpp>
+#include <physiology/modules/filesystem_absl.h>
+#include <smartspectra/container/settings.hpp>
+#include <smartspectra/container/foreground_container.hpp>
+#include <smartspectra/formats/metrics.hpp>
+
+// local includes
+#include "common/metrics_binary_file.hpp"
+
+namespace spectra = presage::smartspectra;
+namespace settings = presage::smartspectra::container::settings;
+namespace vs = presage::smartspectra::video_source;
+namespace examples = presage::smartspectra::examples;
+
+enum class BatchMode {
+    Spot,
+    Continuous,
+    Unknown_EnumEnd
+};
+
+const std::vector<std::string> kBatchModeNames = {"spot", "continuous"};
+
+bool AbslParseFlag(absl::string_view text, BatchMode* mode, std::string* error) {
+    for (size_t i_mode = 0; i_mode < kBatchModeNames.size(); i_mode++) {
+        if (text == kBatchModeNames[i_mode]) {
+            *mode = static_cast<BatchMode>(i_mode);
+            return true;
+        }
+    }
+    *error = "Possible values: " + absl::StrJoin(kBatchModeNames, ", ");
+    return false;
+}
+
+std::string AbslUnparseFlag(BatchMode mode) {
+    auto index = static_cast<size_t>(mode);
+    return index < kBatchModeNames.size() ? kBatchModeNames[index] : "unknown";
+}
+
+// region ========================================= BATCH SETTINGS =====================================================
+ABSL_FLAG(std::string, manifest_path, "",
+          "Path to the batch manifest: a text file listing one input video path per line. Empty lines and lines "
+          "starting with '#' are skipped. Relative paths are resolved against the manifest's folder.");
+ABSL_FLAG(std::string, output_directory, "out",
+          "Directory where to save per-clip results (each in its own sub-folder) and the batch summary "
+          "(batch_summary.json). If it does not exist, the app will attempt to make one.");
+ABSL_FLAG(int, jobs, 0,
+          "Number of clips to process at the same time, each on its own container. "
+          "When 0, uses the number of hardware threads.");
+ABSL_FLAG(BatchMode, mode, BatchMode::Spot,
+          "Kind of container to run on every clip: `spot` retrieves metrics from the Physiology REST API, "
+          "`continuous` saves preprocessed data as JSON. Possible values: " + absl::StrJoin(kBatchModeNames, ", "));
+// endregion ===========================================================================================================
+
+ABSL_FLAG(bool, also_log_to_stderr, false, "If true, log to stderr as well.");
+ABSL_FLAG(int, interframe_delay, 1,
+          "Delay, in milliseconds, before capturing the next frame: "
+          "higher values may free up more processing capacity for the graph, i.e. give it more time to process what it "
+          "already has and drop fewer frames, resulting in more robust output metrics. Defaults to the minimum, since "
+          "every clip takes at least its frame count times this delay to process (e.g. 20 ms caps a job at 50 frames "
+          "per second).");
+ABSL_FLAG(bool, scale_input, true,
+          "If true, uses input scaling in the ImageTransformationCalculator within the graph.");
+ABSL_FLAG(bool, enable_phasic_bp, false, "If true, enable the phasic blood pressure computation.");
+ABSL_FLAG(int, verbosity, 1, "Verbosity level -- raise to print more.");
+// region ======================== SPOT-MODE SETTINGS ==================================================================
+ABSL_FLAG(std::string, physiology_key, "",
+          "API key to use for the Physiology online service. "
+          "If not provided, final features and/or metrics are not retrieved.");
+ABSL_FLAG(double, spot_duration, 30.0, "Spot duration in floating-point seconds.");
+ABSL_FLAG(examples::MetricsFileFormat, metrics_file_format, examples::MetricsFileFormat::Json,
+          "Format to save each clip's metrics in: `json` (metrics.json), or `binary` / `compact_binary` "
+          "(metrics.ssmb, see docs/metrics_binary_format.md). Possible values: "
+          + absl::StrJoin(examples::GetMetricsFileFormatNames(), ", "));
+// endregion ===========================================================================================================
+// region ======================== CONTINUOUS-MODE SETTINGS ============================================================
+ABSL_FLAG(double, buffer_duration, 0.5,
+          "Duration of preprocessing buffer in seconds. Recommended values currently are between 0.2 and 1.0. "
+          "Shorter values will mean more frequent updates and higher Core processing loads.");
+// endregion ===========================================================================================================
+
+struct ClipResult {
+    std::filesystem::path input_video_path;
+    std::filesystem::path output_directory;
+    absl::Status status;
+    double wall_time_s = 0.0;
+};
+
+absl::StatusOr<std::vector<std::filesystem::path>> ReadManifest(const std::filesystem::path& manifest_path) {
+    std::ifstream manifest(manifest_path);
+    if (!manifest.is_open()) {
+        return absl::NotFoundError("Could not open batch manifest " + manifest_path.string());
+    }
+    std::vector<std::filesystem::path> input_video_paths;
+    std::string line;
+    while (std::getline(manifest, line)) {
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::filesystem::path input_video_path(line);
+        if (input_video_path.is_relative()) {
+            input_video_path = manifest_path.parent_path() / input_video_path;
+        }
+        input_video_paths.push_back(input_video_path);
+    }
+    return input_video_paths;
+}
+
+vs::VideoSourceSettings BuildVideoSourceSettings(const std::filesystem::path& input_video_path) {
+    vs::VideoSourceSettings video_source;
+    video_source.input_video_path = input_video_path.string();
+    return video_source;
+}
+
+absl::Status RunSpotClip(
+    const std::filesystem::path& input_video_path,
+    const std::filesystem::path& output_directory
+) {
+    settings::Settings<settings::OperationMode::Spot, settings::IntegrationMode::JsonRestApi> settings{
+        BuildVideoSourceSettings(input_video_path),
+        settings::VideoSinkSettings{},
+        /*headless=*/true,
+        absl::GetFlag(FLAGS_interframe_delay),
+        /*start_with_recording_on=*/true,
+        /*start_time_offset_ms=*/0,
+        absl::GetFlag(FLAGS_scale_input),
+        /*binary_graph=*/true,
+        absl::GetFlag(FLAGS_enable_phasic_bp),
+        /*print_graph_contents=*/false,
+        absl::GetFlag(FLAGS_verbosity),
+        settings::SpotSettings{
+            absl::GetFlag(FLAGS_spot_duration)
+        },
+        settings::JsonRestApiSettings{
+            absl::GetFlag(FLAGS_physiology_key),
+            output_directory.string(),
+            /*save_to_disk=*/false,
+        }
+    };
+    spectra::container::SpotRestForegroundContainer<presage::platform_independence::DeviceType::Cpu>
+        container(settings);
+    container.OnMetricsOutput = [&output_directory](const nlohmann::json& api_json_metrics) {
+        auto metrics_or_status = spectra::formats::MetricsFromRestApiJson(api_json_metrics);
+        if (!metrics_or_status.ok()) {
+            return metrics_or_status.status();
+        }
+        return examples::SaveMetrics(
+            metrics_or_status.value(), output_directory / "metrics", absl::GetFlag(FLAGS_metrics_file_format)
+        );
+    };
+    MP_RETURN_IF_ERROR(container.Initialize());
+    return container.Run();
+}
+
+absl::Status RunContinuousClip(
+    const std::filesystem::path& input_video_path,
+    const std::filesystem::path& output_directory
+) {
+    settings::Settings<settings::OperationMode::Continuous, settings::IntegrationMode::JsonFileOnDisk> settings{
+        BuildVideoSourceSettings(input_video_path),
+        settings::VideoSinkSettings{},
+        /*headless=*/true,
+        absl::GetFlag(FLAGS_interframe_delay),
+        /*start_with_recording_on=*/true,
+        /*start_time_offset_ms=*/0,
+        absl::GetFlag(FLAGS_scale_input),
+        /*binary_graph=*/true,
+        absl::GetFlag(FLAGS_enable_phasic_bp),
+        /*print_graph_contents=*/false,
+        absl::GetFlag(FLAGS_verbosity),
+        settings::ContinuousSettings{
+            absl::GetFlag(FLAGS_buffer_duration)
+        },
+        settings::JsonFileOnDiskSettings{
+            output_directory.string()
+        }
+    };
+    spectra::container::CpuContinuousFileForegroundContainer container(settings);
+    MP_RETURN_IF_ERROR(container.Initialize());
+    return container.Run();
+}
+
+ClipResult RunClip(size_t i_clip, const std::filesystem::path& input_video_path) {
+    std::stringstream clip_directory_name;
+    clip_directory_name << std::setw(5) << std::setfill('0') << i_clip << "_" << input_video_path.stem().string();
+    ClipResult result{
+        input_video_path,
+        std::filesystem::path(absl::GetFlag(FLAGS_output_directory)) / clip_directory_name.str()
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    result.status = presage::filesystem::abseil::CreateDirectoryIfMissing(result.output_directory);
+    if (result.status.ok()) {
+        result.status = absl::GetFlag(FLAGS_mode) == BatchMode::Continuous
+                        ? RunContinuousClip(input_video_path, result.output_directory)
+                        : RunSpotClip(input_video_path, result.output_directory);
+    }
+    result.wall_time_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (result.status.ok()) {
+        LOG(INFO) << "Processed " << input_video_path.string() << " in " << result.wall_time_s << " s.";
+    } else {
+        LOG(ERROR) << "Failed to process " << input_video_path.string() << ": " << result.status.message();
+    }
+    return result;
+}
+
+absl::Status WriteSummary(const std::vector<ClipResult>& results, double total_wall_time_s, int job_count) {
+    nlohmann::json clips = nlohmann::json::array();
+    size_t failed_clip_count = 0;
+    std::vector<double> wall_times_s;
+    for (const auto& result: results) {
+        clips.push_back({
+            {"input_video_path", result.input_video_path.string()},
+            {"output_directory", result.output_directory.string()},
+            {"ok", result.status.ok()},
+            {"error", std::string(result.status.message())},
+            {"wall_time_s", result.wall_time_s}
+        });
+        if (result.status.ok()) {
+            wall_times_s.push_back(result.wall_time_s);
+        } else {
+            failed_clip_count++;
+        }
+    }
+    std::sort(wall_times_s.begin(), wall_times_s.end());
+    // failed clips often fail fast (e.g. a missing file), so counting them would inflate the throughput
+    const size_t processed_clip_count = results.size() - failed_clip_count;
+    const double clips_per_second = static_cast<double>(processed_clip_count) / total_wall_time_s;
+    const double median_clip_wall_time_s = wall_times_s.empty() ? 0.0 : wall_times_s[wall_times_s.size() / 2];
+    nlohmann::json summary = {
+        {"jobs", job_count},
+        {"clip_count", results.size()},
+        {"processed_clip_count", processed_clip_count},
+        {"failed_clip_count", failed_clip_count},
+        {"total_wall_time_s", total_wall_time_s},
+        {"clips_per_second", clips_per_second},
+        {"median_clip_wall_time_s", median_clip_wall_time_s},
+        {"clips", clips}
+    };
+    auto summary_path = std::filesystem::path(absl::GetFlag(FLAGS_output_directory)) / "batch_summary.json";
+    std::ofstream summary_file(summary_path);
+    summary_file << summary.dump(2);
+    if (summary_file.fail()) {
+        return absl::InternalError("Could not write batch summary " + summary_path.string());
+    }
+    LOG(INFO) << "Processed " << processed_clip_count << "/" << results.size() << " clips (" << failed_clip_count
+              << " failed) in " << total_wall_time_s << " s using " << job_count << " jobs: " << clips_per_second
+              << " processed clips/s, median processed clip wall time " << median_clip_wall_time_s << " s. Summary: "
+              << summary_path.string();
+    return absl::OkStatus();
+}
+
+absl::Status RunBatch() {
+    auto input_video_paths_or_status = ReadManifest(absl::GetFlag(FLAGS_manifest_path));
+    if (!input_video_paths_or_status.ok()) {
+        return input_video_paths_or_status.status();
+    }
+    const std::vector<std::filesystem::path>& input_video_paths = input_video_paths_or_status.value();
+    if (input_video_paths.empty()) {
+        return absl::InvalidArgumentError("Batch manifest lists no videos.");
+    }
+    MP_RETURN_IF_ERROR(presage::filesystem::abseil::CreateDirectoryIfMissing(absl::GetFlag(FLAGS_output_directory)));
+
+    int job_count = absl::GetFlag(FLAGS_jobs);
+    if (job_count <= 0) {
+        job_count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    job_count = std::min(job_count, static_cast<int>(input_video_paths.size()));
+
+    std::vector<ClipResult> results(input_video_paths.size());
+    std::atomic<size_t> next_clip_index{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i_job = 0; i_job < job_count; i_job++) {
+        workers.emplace_back([&]() {
+            for (size_t i_clip = next_clip_index++; i_clip < input_video_paths.size(); i_clip = next_clip_index++) {
+                results[i_clip] = RunClip(i_clip, input_video_paths[i_clip]);
+            }
+        });
+    }
+    for (auto& worker: workers) {
+        worker.join();
+    }
+    double total_wall_time_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return WriteSummary(results, total_wall_time_s, job_count);
+}
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+
+    absl::SetProgramUsageMessage(
+        "Run Presage Physiology Preprocessing on every video listed in a manifest, processing several videos at the "
+        "same time (headless), and save per-clip results and timings to the output directory."
+    );
+    absl::ParseCommandLine(argc, argv);
+    if (absl::GetFlag(FLAGS_also_log_to_stderr)) {
+        // work-around for built-in logging to stderr (for a more human-readable flag name)
+        FLAGS_alsologtostderr = true;
+    }
+    if (absl::GetFlag(FLAGS_manifest_path).empty()) {
+        LOG(ERROR) << "A batch manifest is required. Run with --help=main to see usage.";
+        exit(-1);
+    }
+
+    absl::Status status = RunBatch();
+
+    if (!status.ok()) {
+        LOG(ERROR) << "Run failed. " << status.message();
+        return EXIT_FAILURE;
+    } else {
+        LOG(INFO) << "Success!";
+    }
+    return 0;
+}
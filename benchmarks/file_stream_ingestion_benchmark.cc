@@ -0,0 +1,213 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Compares how quickly (and at what CPU cost) frame files written into a file stream folder get picked up by
+// the re-scanning (polling) watcher versus the inotify-driven one, for folders holding different numbers of
+// unrelated files. Frame files are not decoded here, only detected.
+
+// stdlib includes
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// third-party includes
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/absl/strings/numbers.h>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/file_stream_watcher.hpp"
+#include "common/status_macros.hpp"
+
+namespace examples = presage::smartspectra::examples;
+
+ABSL_FLAG(std::string, benchmark_directory, "",
+          "Folder in which to create the temporary file stream folders. Defaults to the system temporary directory.");
+ABSL_FLAG(std::vector<std::string>, folder_sizes, std::vector<std::string>({"0", "1000", "10000"}),
+          "Comma-separated list of counts of unrelated files to place in the file stream folder before streaming.");
+ABSL_FLAG(int, frame_count, 300, "Number of frame files to stream for each configuration.");
+ABSL_FLAG(int, frame_interval_us, 33333, "Interval between frame files written by the producer, in microseconds.");
+ABSL_FLAG(int, frame_size_bytes, 256 * 1024, "Size of each (dummy) frame file, in bytes.");
+ABSL_FLAG(int, file_stream_rescan_delay, 5, "Delay, in milliseconds, between folder re-scans of the polling watcher.");
+ABSL_FLAG(bool, rename_into_place, true,
+          "If true, the producer writes each frame to a temporary name and renames it into place when done "
+          "(so the polling watcher cannot see partially-written files).");
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct RunResult {
+    std::vector<double> latencies_ms;
+    double watcher_cpu_ms = 0.0;
+    int missed_frame_count = 0;
+};
+
+double ThreadCpuTimeMs() {
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return static_cast<double>(time.tv_sec) * 1e3 + static_cast<double>(time.tv_nsec) / 1e6;
+}
+
+double Percentile(std::vector<double> values, double percentile) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    auto index = static_cast<size_t>(percentile / 100.0 * static_cast<double>(values.size() - 1));
+    return values[index];
+}
+
+void WriteFile(const std::filesystem::path& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary);
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+}
+
+void PopulateFolder(const std::filesystem::path& folder, int clutter_file_count) {
+    std::filesystem::remove_all(folder);
+    std::filesystem::create_directories(folder);
+    for (int i_file = 0; i_file < clutter_file_count; i_file++) {
+        WriteFile(folder / ("unrelated_" + std::to_string(i_file) + ".txt"), "");
+    }
+}
+
+absl::StatusOr<RunResult> RunConfiguration(
+    const std::filesystem::path& folder,
+    std::unique_ptr<examples::FrameFileWatcher> watcher,
+    const examples::FileStreamPattern& pattern
+) {
+    const int frame_count = absl::GetFlag(FLAGS_frame_count);
+    const bool rename_into_place = absl::GetFlag(FLAGS_rename_into_place);
+    const std::string frame_contents(absl::GetFlag(FLAGS_frame_size_bytes), '\0');
+    std::vector<Clock::time_point> written_at(frame_count);
+    std::vector<Clock::time_point> detected_at(frame_count);
+    std::vector<bool> detected(frame_count, false);
+
+    MP_RETURN_IF_ERROR(watcher->Start());
+    RunResult result;
+    absl::Status watcher_status;
+    std::thread consumer([&]() {
+        const double cpu_start_ms = ThreadCpuTimeMs();
+        std::vector<examples::FrameFile> ready;
+        bool end_of_stream = false;
+        while (!end_of_stream) {
+            ready.clear();
+            watcher_status = watcher->Wait(100, ready);
+            if (!watcher_status.ok()) {
+                break;
+            }
+            const auto now = Clock::now();
+            for (const auto& frame_file: ready) {
+                if (frame_file.end_of_stream) {
+                    end_of_stream = true;
+                    continue;
+                }
+                auto i_frame = static_cast<size_t>(frame_file.timestamp_us / absl::GetFlag(FLAGS_frame_interval_us));
+                if (i_frame < detected.size() && !detected[i_frame]) {
+                    detected[i_frame] = true;
+                    detected_at[i_frame] = now;
+                }
+            }
+        }
+        result.watcher_cpu_ms = ThreadCpuTimeMs() - cpu_start_ms;
+    });
+
+    const auto frame_interval = std::chrono::microseconds(absl::GetFlag(FLAGS_frame_interval_us));
+    auto next_frame_time = Clock::now();
+    for (int i_frame = 0; i_frame < frame_count; i_frame++) {
+        std::this_thread::sleep_until(next_frame_time);
+        next_frame_time += frame_interval;
+        auto frame_path = pattern.FramePath(i_frame * absl::GetFlag(FLAGS_frame_interval_us));
+        if (rename_into_place) {
+            auto temporary_path = folder / ("writing_" + std::to_string(i_frame) + ".tmp");
+            WriteFile(temporary_path, frame_contents);
+            written_at[i_frame] = Clock::now();
+            std::filesystem::rename(temporary_path, frame_path);
+        } else {
+            WriteFile(frame_path, frame_contents);
+            written_at[i_frame] = Clock::now();
+        }
+    }
+    WriteFile(folder / "end_of_stream", "");
+    consumer.join();
+    MP_RETURN_IF_ERROR(watcher_status);
+
+    for (int i_frame = 0; i_frame < frame_count; i_frame++) {
+        if (!detected[i_frame]) {
+            result.missed_frame_count++;
+            continue;
+        }
+        result.latencies_ms.push_back(
+            std::chrono::duration<double, std::milli>(detected_at[i_frame] - written_at[i_frame]).count()
+        );
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    absl::SetProgramUsageMessage(
+        "Benchmark frame pick-up latency and CPU use of polling vs. inotify file stream ingestion."
+    );
+    absl::ParseCommandLine(argc, argv);
+    FLAGS_alsologtostderr = true;
+
+    std::filesystem::path benchmark_directory = absl::GetFlag(FLAGS_benchmark_directory).empty()
+                                                ? std::filesystem::temp_directory_path() / "file_stream_benchmark"
+                                                : std::filesystem::path(absl::GetFlag(FLAGS_benchmark_directory));
+    auto pattern_or_status = examples::FileStreamPattern::Parse(benchmark_directory / "frame_0000000000000.png");
+    if (!pattern_or_status.ok()) {
+        LOG(ERROR) << pattern_or_status.status().message();
+        return EXIT_FAILURE;
+    }
+    const examples::FileStreamPattern& pattern = pattern_or_status.value();
+
+    std::cout << std::left << std::setw(10) << "watcher" << std::setw(14) << "folder_files"
+              << std::setw(12) << "p50_ms" << std::setw(12) << "p99_ms" << std::setw(12) << "max_ms"
+              << std::setw(16) << "cpu_ms/frame" << "missed" << std::endl;
+    for (const std::string& folder_size_string: absl::GetFlag(FLAGS_folder_sizes)) {
+        int folder_size = 0;
+        if (!absl::SimpleAtoi(folder_size_string, &folder_size)) {
+            LOG(ERROR) << "Invalid folder size: " << folder_size_string;
+            return EXIT_FAILURE;
+        }
+        for (const std::string watcher_name: {"polling", "inotify"}) {
+            PopulateFolder(benchmark_directory, folder_size);
+            std::unique_ptr<examples::FrameFileWatcher> watcher;
+            if (watcher_name == "polling") {
+                watcher = std::make_unique<examples::PollingFrameFileWatcher>(
+                    pattern, "end_of_stream", absl::GetFlag(FLAGS_file_stream_rescan_delay)
+                );
+            } else {
+                watcher = std::make_unique<examples::InotifyFrameFileWatcher>(pattern, "end_of_stream");
+            }
+            auto result_or_status = RunConfiguration(benchmark_directory, std::move(watcher), pattern);
+            if (!result_or_status.ok()) {
+                LOG(ERROR) << watcher_name << " run failed: " << result_or_status.status().message();
+                return EXIT_FAILURE;
+            }
+            const RunResult& result = result_or_status.value();
+            const auto& latencies = result.latencies_ms;
+            std::cout << std::left << std::fixed << std::setprecision(3)
+                      << std::setw(10) << watcher_name << std::setw(14) << folder_size
+                      << std::setw(12) << Percentile(latencies, 50) << std::setw(12) << Percentile(latencies, 99)
+                      << std::setw(12) << Percentile(latencies, 100)
+                      << std::setw(16) << result.watcher_cpu_ms / absl::GetFlag(FLAGS_frame_count)
+                      << result.missed_frame_count << std::endl;
+        }
+    }
+    std::filesystem::remove_all(benchmark_directory);
+    return 0;
+}
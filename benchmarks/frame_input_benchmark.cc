@@ -0,0 +1,281 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Compares the latency (from the producer having a frame in memory to the consumer holding it, ready to feed to the
+// graph) and the producer / consumer CPU cost of the ways another process can hand raw BGR frames to the examples:
+// the file stream folder (PNG files, inotify pick-up, decoding), the append-only raw frame file, and the
+// shared-memory frame ring.
+
+// stdlib includes
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// third-party includes
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/absl/strings/numbers.h>
+#include <physiology/interface/absl/strings/str_split.h>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/file_stream_frame_source.hpp"
+#include "common/file_stream_watcher.hpp"
+#include "common/raw_frame_file.hpp"
+#include "common/shared_memory_frame_ring.hpp"
+#include "common/status_macros.hpp"
+
+namespace examples = presage::smartspectra::examples;
+
+ABSL_FLAG(std::string, benchmark_directory, "",
+          "Folder in which to create the temporary file stream folder and raw frame file. Defaults to the system "
+          "temporary directory.");
+ABSL_FLAG(std::vector<std::string>, resolutions, std::vector<std::string>({"640x480", "1280x720"}),
+          "Comma-separated list of frame resolutions to benchmark, as <width>x<height>.");
+ABSL_FLAG(std::vector<std::string>, transports,
+          std::vector<std::string>({"file_stream", "raw_frame_file", "shared_memory"}),
+          "Comma-separated list of frame input paths to benchmark.");
+ABSL_FLAG(int, frame_count, 300, "Number of frames to stream for each configuration.");
+ABSL_FLAG(int, frame_interval_us, 33333, "Interval between frames published by the producer, in microseconds.");
+ABSL_FLAG(int, poll_delay_ms, 5,
+          "Delay, in milliseconds, between checks for new data of the raw frame file reader, and the futex wait "
+          "timeout of the shared-memory reader.");
+ABSL_FLAG(int, slot_count, 4, "Number of slots of the shared-memory frame ring.");
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct RunResult {
+    std::vector<double> latencies_ms;
+    double producer_cpu_ms = 0.0;
+    double consumer_cpu_ms = 0.0;
+    int missed_frame_count = 0;
+};
+
+// Producer side of a transport: called once per frame, then once to end the stream.
+struct FrameSink {
+    std::function<absl::Status(const cv::Mat&, int64_t)> publish;
+    std::function<absl::Status()> close;
+};
+
+double ThreadCpuTimeMs() {
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return static_cast<double>(time.tv_sec) * 1e3 + static_cast<double>(time.tv_nsec) / 1e6;
+}
+
+int64_t NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count();
+}
+
+double Percentile(std::vector<double> values, double percentile) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    auto index = static_cast<size_t>(percentile / 100.0 * static_cast<double>(values.size() - 1));
+    return values[index];
+}
+
+// Noise-like content, so that PNG frames are about as large as camera frames rather than trivially compressible.
+cv::Mat MakeFrame(int width, int height) {
+    cv::Mat frame(height, width, CV_8UC3);
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(255));
+    return frame;
+}
+
+// Consumer runs on its own thread, producer on this one; timestamps are the producer's steady clock, in microseconds,
+// so the consumer can tell the latency of each frame from the frame itself.
+absl::StatusOr<RunResult> RunConfiguration(
+    const cv::Mat& frame,
+    FrameSink sink,
+    std::function<absl::StatusOr<std::unique_ptr<examples::FrameSource>>()> open_source
+) {
+    const int frame_count = absl::GetFlag(FLAGS_frame_count);
+    RunResult result;
+    absl::Status consumer_status;
+    std::thread consumer([&]() {
+        const double cpu_start_ms = ThreadCpuTimeMs();
+        auto source_or_status = open_source();
+        if (!source_or_status.ok()) {
+            consumer_status = source_or_status.status();
+            return;
+        }
+        std::unique_ptr<examples::FrameSource> source = std::move(source_or_status).value();
+        consumer_status = source->Initialize();
+        examples::TimestampedFrame received;
+        while (consumer_status.ok()) {
+            auto has_frame_or_status = source->Next(received);
+            if (!has_frame_or_status.ok()) {
+                consumer_status = has_frame_or_status.status();
+                break;
+            }
+            if (!has_frame_or_status.value()) {
+                break;
+            }
+            result.latencies_ms.push_back(static_cast<double>(NowUs() - received.timestamp_us) / 1e3);
+        }
+        result.consumer_cpu_ms = ThreadCpuTimeMs() - cpu_start_ms;
+    });
+
+    const double cpu_start_ms = ThreadCpuTimeMs();
+    absl::Status producer_status;
+    const auto frame_interval = std::chrono::microseconds(absl::GetFlag(FLAGS_frame_interval_us));
+    auto next_frame_time = Clock::now();
+    for (int i_frame = 0; i_frame < frame_count && producer_status.ok(); i_frame++) {
+        std::this_thread::sleep_until(next_frame_time);
+        next_frame_time += frame_interval;
+        producer_status = sink.publish(frame, NowUs());
+    }
+    if (producer_status.ok()) {
+        producer_status = sink.close();
+    }
+    result.producer_cpu_ms = ThreadCpuTimeMs() - cpu_start_ms;
+    consumer.join();
+    MP_RETURN_IF_ERROR(producer_status);
+    MP_RETURN_IF_ERROR(consumer_status);
+    result.missed_frame_count = frame_count - static_cast<int>(result.latencies_ms.size());
+    return result;
+}
+
+absl::StatusOr<RunResult> RunFileStream(const cv::Mat& frame, const std::filesystem::path& folder) {
+    std::filesystem::remove_all(folder);
+    std::filesystem::create_directories(folder);
+    auto pattern_or_status = examples::FileStreamPattern::Parse(folder / "frame_0000000000000.png");
+    if (!pattern_or_status.ok()) {
+        return pattern_or_status.status();
+    }
+    const examples::FileStreamPattern pattern = pattern_or_status.value();
+    FrameSink sink{
+        [&](const cv::Mat& image, int64_t timestamp_us) {
+            // written under a temporary name and renamed into place, as a careful producer would
+            const std::filesystem::path temporary_path = folder / "writing.tmp.png";
+            if (!cv::imwrite(temporary_path.string(), image)) {
+                return absl::InternalError("Could not write " + temporary_path.string());
+            }
+            std::filesystem::rename(temporary_path, pattern.FramePath(timestamp_us));
+            return absl::OkStatus();
+        },
+        [&]() {
+            std::ofstream(folder / "end_of_stream").close();
+            return absl::OkStatus();
+        }
+    };
+    return RunConfiguration(frame, sink, [&]() -> absl::StatusOr<std::unique_ptr<examples::FrameSource>> {
+        std::unique_ptr<examples::FrameFileWatcher> watcher;
+        if (examples::InotifyFrameFileWatcher::IsSupported()) {
+            watcher = std::make_unique<examples::InotifyFrameFileWatcher>(pattern, "end_of_stream");
+        } else {
+            watcher = std::make_unique<examples::PollingFrameFileWatcher>(
+                pattern, "end_of_stream", absl::GetFlag(FLAGS_poll_delay_ms)
+            );
+        }
+        MP_RETURN_IF_ERROR(watcher->Start());
+        return std::make_unique<examples::FileStreamFrameSource>(
+            std::move(watcher), examples::FileStreamFrameSourceSettings{true}
+        );
+    });
+}
+
+absl::StatusOr<RunResult> RunRawFrameFile(const cv::Mat& frame, const std::filesystem::path& path) {
+    std::filesystem::remove(path);
+    examples::RawFrameFileWriter writer;
+    MP_RETURN_IF_ERROR(writer.Open(path, frame.cols, frame.rows));
+    FrameSink sink{
+        [&](const cv::Mat& image, int64_t timestamp_us) { return writer.Append(image, timestamp_us); },
+        [&]() { return writer.Close(); }
+    };
+    auto result_or_status = RunConfiguration(
+        frame, sink, [&]() -> absl::StatusOr<std::unique_ptr<examples::FrameSource>> {
+            return std::make_unique<examples::RawFrameFileSource>(path, absl::GetFlag(FLAGS_poll_delay_ms));
+        }
+    );
+    std::filesystem::remove(path);
+    return result_or_status;
+}
+
+absl::StatusOr<RunResult> RunSharedMemory(const cv::Mat& frame, const std::string& name) {
+    examples::SharedMemoryFrameRingWriter writer;
+    MP_RETURN_IF_ERROR(writer.Open(name, frame.cols, frame.rows, absl::GetFlag(FLAGS_slot_count)));
+    FrameSink sink{
+        [&](const cv::Mat& image, int64_t timestamp_us) { return writer.Publish(image, timestamp_us).status(); },
+        [&]() { return writer.Close(); }
+    };
+    return RunConfiguration(frame, sink, [&]() -> absl::StatusOr<std::unique_ptr<examples::FrameSource>> {
+        return std::make_unique<examples::SharedMemoryFrameSource>(name, absl::GetFlag(FLAGS_poll_delay_ms));
+    });
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    absl::SetProgramUsageMessage(
+        "Benchmark frame latency and CPU use of the file stream, raw frame file, and shared-memory frame inputs."
+    );
+    absl::ParseCommandLine(argc, argv);
+    FLAGS_alsologtostderr = true;
+
+    std::filesystem::path benchmark_directory = absl::GetFlag(FLAGS_benchmark_directory).empty()
+                                                ? std::filesystem::temp_directory_path() / "frame_input_benchmark"
+                                                : std::filesystem::path(absl::GetFlag(FLAGS_benchmark_directory));
+    std::filesystem::create_directories(benchmark_directory);
+
+    std::cout << std::left << std::setw(16) << "transport" << std::setw(12) << "resolution"
+              << std::setw(12) << "p50_ms" << std::setw(12) << "p99_ms" << std::setw(12) << "max_ms"
+              << std::setw(20) << "producer_cpu_ms/f" << std::setw(20) << "consumer_cpu_ms/f" << "missed" << std::endl;
+    for (const std::string& resolution: absl::GetFlag(FLAGS_resolutions)) {
+        std::vector<std::string> dimensions = absl::StrSplit(resolution, 'x');
+        int width = 0;
+        int height = 0;
+        if (dimensions.size() != 2 || !absl::SimpleAtoi(dimensions[0], &width) ||
+            !absl::SimpleAtoi(dimensions[1], &height) || width <= 0 || height <= 0) {
+            LOG(ERROR) << "Invalid resolution: " << resolution;
+            return EXIT_FAILURE;
+        }
+        const cv::Mat frame = MakeFrame(width, height);
+        for (const std::string& transport: absl::GetFlag(FLAGS_transports)) {
+            absl::StatusOr<RunResult> result_or_status;
+            if (transport == "file_stream") {
+                result_or_status = RunFileStream(frame, benchmark_directory / "file_stream");
+            } else if (transport == "raw_frame_file") {
+                result_or_status = RunRawFrameFile(frame, benchmark_directory / "frames.raw");
+            } else if (transport == "shared_memory") {
+                result_or_status = RunSharedMemory(frame, "/smartspectra_frame_input_benchmark");
+            } else {
+                LOG(ERROR) << "Unknown transport: " << transport;
+                return EXIT_FAILURE;
+            }
+            if (!result_or_status.ok()) {
+                LOG(ERROR) << transport << " run failed: " << result_or_status.status().message();
+                return EXIT_FAILURE;
+            }
+            const RunResult& result = result_or_status.value();
+            const auto& latencies = result.latencies_ms;
+            const double frame_count = absl::GetFlag(FLAGS_frame_count);
+            std::cout << std::left << std::fixed << std::setprecision(3)
+                      << std::setw(16) << transport << std::setw(12) << resolution
+                      << std::setw(12) << Percentile(latencies, 50) << std::setw(12) << Percentile(latencies, 99)
+                      << std::setw(12) << Percentile(latencies, 100)
+                      << std::setw(20) << result.producer_cpu_ms / frame_count
+                      << std::setw(20) << result.consumer_cpu_ms / frame_count
+                      << result.missed_frame_count << std::endl;
+        }
+    }
+    std::filesystem::remove_all(benchmark_directory);
+    return 0;
+}
@@ -0,0 +1,211 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Compares typical computations over metrics time series (fixed-rate resampling, windowed mean/min/max,
+// confidence-gated filtering) on the array-of-structs layout of formats::Metrics against the same algorithms on the
+// structure-of-arrays layout of MetricsColumns (see common/metric_columns.hpp).
+
+// stdlib includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// third-party includes
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/glog/logging.h>
+#include <smartspectra/formats/metrics.hpp>
+
+// local includes
+#include "common/metric_columns.hpp"
+
+namespace examples = presage::smartspectra::examples;
+namespace formats = presage::smartspectra::formats;
+
+ABSL_FLAG(int, trace_length, 30 * 60 * 30, "Number of measurements in the synthetic series (default: 30 min at 30 fps).");
+ABSL_FLAG(double, frame_rate, 30.0, "Frame rate of the synthetic series, in frames per second.");
+ABSL_FLAG(double, resample_rate, 25.0, "Rate to resample the series to, in Hz.");
+ABSL_FLAG(int, window_size, 150, "Window size for the windowed mean/min/max, in measurements.");
+ABSL_FLAG(double, min_confidence, 0.5, "Confidence threshold for confidence-gated filtering.");
+ABSL_FLAG(int, repetitions, 50, "Number of times to run each computation (the median is reported).");
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using AosSeries = std::vector<formats::MeasurementWithConfidence<float>>;
+
+// region ===================================== AoS reference implementations ==========================================
+// Same algorithms as in common/metric_columns.cc, reading straight from the measurement structs.
+std::vector<float> AosResampleLinear(const AosSeries& series, float rate_hz) {
+    if (series.empty()) {
+        return {};
+    }
+    const float start_time = series.front().time;
+    const auto sample_count = static_cast<size_t>(std::floor((series.back().time - start_time) * rate_hz)) + 1;
+    std::vector<float> samples(sample_count);
+    size_t i_left = 0;
+    for (size_t i_sample = 0; i_sample < sample_count; i_sample++) {
+        const float sample_time = start_time + static_cast<float>(i_sample) / rate_hz;
+        while (i_left + 2 < series.size() && series[i_left + 1].time <= sample_time) {
+            i_left++;
+        }
+        const size_t i_right = std::min(i_left + 1, series.size() - 1);
+        const float interval = series[i_right].time - series[i_left].time;
+        const float weight = interval > 0.0f
+                             ? std::clamp((sample_time - series[i_left].time) / interval, 0.0f, 1.0f) : 0.0f;
+        samples[i_sample] = series[i_left].value + weight * (series[i_right].value - series[i_left].value);
+    }
+    return samples;
+}
+
+std::vector<float> AosWindowedMean(const AosSeries& series, size_t window_size) {
+    if (series.size() < window_size) {
+        return {};
+    }
+    std::vector<double> prefix_sums(series.size() + 1, 0.0);
+    for (size_t i_value = 0; i_value < series.size(); i_value++) {
+        prefix_sums[i_value + 1] = prefix_sums[i_value] + series[i_value].value;
+    }
+    std::vector<float> means(series.size() - window_size + 1);
+    for (size_t i_window = 0; i_window < means.size(); i_window++) {
+        means[i_window] = static_cast<float>(
+            (prefix_sums[i_window + window_size] - prefix_sums[i_window]) / static_cast<double>(window_size)
+        );
+    }
+    return means;
+}
+
+template<typename TCombine>
+std::vector<float> AosWindowedExtremum(const AosSeries& series, size_t window_size, TCombine combine) {
+    if (series.size() < window_size) {
+        return {};
+    }
+    std::vector<float> prefix(series.size());
+    std::vector<float> suffix(series.size());
+    for (size_t block_start = 0; block_start < series.size(); block_start += window_size) {
+        const size_t block_end = std::min(block_start + window_size, series.size());
+        prefix[block_start] = series[block_start].value;
+        for (size_t i_value = block_start + 1; i_value < block_end; i_value++) {
+            prefix[i_value] = combine(prefix[i_value - 1], series[i_value].value);
+        }
+        suffix[block_end - 1] = series[block_end - 1].value;
+        for (size_t i_value = block_end - 1; i_value > block_start; i_value--) {
+            suffix[i_value - 1] = combine(suffix[i_value], series[i_value - 1].value);
+        }
+    }
+    std::vector<float> extrema(series.size() - window_size + 1);
+    for (size_t i_window = 0; i_window < extrema.size(); i_window++) {
+        extrema[i_window] = combine(suffix[i_window], prefix[i_window + window_size - 1]);
+    }
+    return extrema;
+}
+
+AosSeries AosFilterByConfidence(const AosSeries& series, float min_confidence) {
+    AosSeries filtered;
+    filtered.reserve(series.size());
+    std::copy_if(series.begin(), series.end(), std::back_inserter(filtered),
+                 [min_confidence](const auto& measurement) { return measurement.confidence >= min_confidence; });
+    return filtered;
+}
+// endregion ===========================================================================================================
+
+AosSeries GenerateSeries(int length, double frame_rate) {
+    std::mt19937 random_generator(42);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    std::uniform_real_distribution<float> confidence(0.0f, 1.0f);
+    AosSeries series(length);
+    for (int i_measurement = 0; i_measurement < length; i_measurement++) {
+        // slightly jittered frame times, as with real captures
+        series[i_measurement].time = static_cast<float>((i_measurement + 0.1 * noise(random_generator)) / frame_rate);
+        series[i_measurement].value = std::sin(series[i_measurement].time * 7.5f) + noise(random_generator);
+        series[i_measurement].confidence = confidence(random_generator);
+    }
+    return series;
+}
+
+double MedianTimeMs(const std::function<size_t()>& computation, int repetitions) {
+    std::vector<double> times_ms;
+    size_t checksum = 0;
+    for (int i_repetition = 0; i_repetition < repetitions; i_repetition++) {
+        const auto start = Clock::now();
+        checksum += computation();
+        times_ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    // keeps the computations from being optimized away
+    if (checksum == 0) {
+        LOG(WARNING) << "All computations produced empty results.";
+    }
+    std::sort(times_ms.begin(), times_ms.end());
+    return times_ms[times_ms.size() / 2];
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    absl::SetProgramUsageMessage(
+        "Benchmark resampling, windowed statistics and confidence filtering on array-of-structs vs. columnar metrics "
+        "series."
+    );
+    absl::ParseCommandLine(argc, argv);
+    FLAGS_alsologtostderr = true;
+
+    const int repetitions = std::max(1, absl::GetFlag(FLAGS_repetitions));
+    const auto window_size = static_cast<size_t>(std::max(1, absl::GetFlag(FLAGS_window_size)));
+    const auto resample_rate = static_cast<float>(absl::GetFlag(FLAGS_resample_rate));
+    const auto min_confidence = static_cast<float>(absl::GetFlag(FLAGS_min_confidence));
+    const AosSeries aos_series = GenerateSeries(absl::GetFlag(FLAGS_trace_length), absl::GetFlag(FLAGS_frame_rate));
+    const examples::SeriesColumns<float> columns = examples::ToColumns(aos_series);
+
+    if (examples::WindowedMax(columns.value, window_size) != AosWindowedExtremum(
+        aos_series, window_size, [](float a, float b) { return std::max(a, b); }
+    ) || examples::ResampleLinear(columns, resample_rate) != AosResampleLinear(aos_series, resample_rate)) {
+        LOG(ERROR) << "Columnar and array-of-structs results differ.";
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<std::tuple<std::string, std::function<size_t()>, std::function<size_t()>>> computations = {
+        {"resample",
+         [&]() { return AosResampleLinear(aos_series, resample_rate).size(); },
+         [&]() { return examples::ResampleLinear(columns, resample_rate).size(); }},
+        {"windowed_mean",
+         [&]() { return AosWindowedMean(aos_series, window_size).size(); },
+         [&]() { return examples::WindowedMean(columns.value, window_size).size(); }},
+        {"windowed_min",
+         [&]() {
+             return AosWindowedExtremum(aos_series, window_size, [](float a, float b) { return std::min(a, b); }).size();
+         },
+         [&]() { return examples::WindowedMin(columns.value, window_size).size(); }},
+        {"windowed_max",
+         [&]() {
+             return AosWindowedExtremum(aos_series, window_size, [](float a, float b) { return std::max(a, b); }).size();
+         },
+         [&]() { return examples::WindowedMax(columns.value, window_size).size(); }},
+        {"confidence_filter",
+         [&]() { return AosFilterByConfidence(aos_series, min_confidence).size(); },
+         [&]() { return examples::FilterByConfidence(columns, min_confidence).Size(); }},
+    };
+
+    std::cout << std::left << std::setw(20) << "computation" << std::setw(12) << "aos_ms" << std::setw(12) << "soa_ms"
+              << "speedup" << std::endl;
+    for (const auto& [name, aos_computation, soa_computation]: computations) {
+        const double aos_time_ms = MedianTimeMs(aos_computation, repetitions);
+        const double soa_time_ms = MedianTimeMs(soa_computation, repetitions);
+        std::cout << std::left << std::fixed << std::setprecision(3)
+                  << std::setw(20) << name << std::setw(12) << aos_time_ms << std::setw(12) << soa_time_ms
+                  << aos_time_ms / std::max(soa_time_ms, 1e-6) << std::endl;
+    }
+    std::cout << "One-off conversion to columns: "
+              << MedianTimeMs([&]() { return examples::ToColumns(aos_series).Size(); }, repetitions) << " ms"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Compares output size and serialization / deserialization time of metrics in JSON (the REST API response schema,
+// with the boolean series per measurement or as intervals, and formats::Metrics converted with nlohmann::json)
+// against the binary metrics format (raw and delta-varint columns, see docs/metrics_binary_format.md), on synthetic
+// metrics of different durations.
+
+// stdlib includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// third-party includes
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/absl/strings/numbers.h>
+#include <physiology/interface/glog/logging.h>
+#include <physiology/interface/nlohmann/json.hpp>
+#include <smartspectra/formats/metrics.hpp>
+
+// local includes
+#include "common/metrics_binary_file.hpp"
+#include "common/rest_metrics_parser.hpp"
+#include "common/rest_metrics_writer.hpp"
+
+namespace examples = presage::smartspectra::examples;
+
+ABSL_FLAG(std::vector<std::string>, durations, std::vector<std::string>({"0.5", "30", "300", "1800"}),
+          "Comma-separated list of durations, in seconds, of the synthetic metrics to serialize "
+          "(0.5 s corresponds to one continuous-mode buffer with the default buffer_duration).");
+ABSL_FLAG(double, frame_rate, 30.0, "Frame rate of the synthetic per-frame traces, in frames per second.");
+ABSL_FLAG(int, repetitions, 5, "Number of times to run each serialization (the median is reported).");
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void FillSeries(
+    examples::SeriesColumns<float>& series, size_t count, double interval_s, bool with_confidence,
+    std::mt19937& random_generator
+) {
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    std::uniform_real_distribution<float> confidence(0.5f, 1.0f);
+    for (size_t i_measurement = 0; i_measurement < count; i_measurement++) {
+        const auto time = static_cast<float>(static_cast<double>(i_measurement) * interval_s);
+        series.time.push_back(time);
+        series.value.push_back(std::sin(time * 7.5f) + noise(random_generator));
+        if (with_confidence) {
+            series.confidence.push_back(confidence(random_generator));
+        }
+    }
+}
+
+examples::MetricsColumns GenerateMetrics(double duration_s, double frame_rate) {
+    std::mt19937 random_generator(42);
+    const auto frame_count = static_cast<size_t>(duration_s * frame_rate);
+    const auto second_count = static_cast<size_t>(duration_s);
+    const double frame_interval_s = 1.0 / frame_rate;
+    examples::MetricsColumns columns;
+    FillSeries(columns.pulse_rate, second_count, 1.0, true, random_generator);
+    FillSeries(columns.pulse_trace, frame_count, frame_interval_s, false, random_generator);
+    FillSeries(columns.breathing_rate, second_count, 1.0, true, random_generator);
+    FillSeries(columns.breathing_upper_trace, frame_count, frame_interval_s, false, random_generator);
+    FillSeries(columns.breathing_lower_trace, frame_count, frame_interval_s, false, random_generator);
+    FillSeries(columns.breathing_amplitude, second_count, 1.0, false, random_generator);
+    FillSeries(columns.phasic_blood_pressure, frame_count, frame_interval_s, false, random_generator);
+    // per-frame booleans, nearly always false: a blink every 4 s, a 10 s apnea every 5 minutes
+    for (size_t i_frame = 0; i_frame < frame_count; i_frame++) {
+        const auto time = static_cast<float>(static_cast<double>(i_frame) * frame_interval_s);
+        columns.apnea.Append(time, std::fmod(time, 300.0f) >= 290.0f);
+        columns.face_blinking.Append(time, std::fmod(time, 4.0f) < 0.1f);
+        columns.face_talking.Append(time, false);
+    }
+    columns.pulse_strict = 60.5f;
+    columns.pulse_snr_sufficient = true;
+    columns.version = "3.10.1";
+    return columns;
+}
+
+double MedianTimeMs(const std::function<void()>& run, int repetitions) {
+    std::vector<double> times_ms;
+    for (int i_repetition = 0; i_repetition < repetitions; i_repetition++) {
+        const auto start = Clock::now();
+        run();
+        times_ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    std::sort(times_ms.begin(), times_ms.end());
+    return times_ms[times_ms.size() / 2];
+}
+
+struct Method {
+    std::string name;
+    std::function<std::string(const examples::MetricsColumns&)> serialize;
+    std::function<bool(const std::string&)> deserialize;
+};
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    absl::SetProgramUsageMessage("Benchmark JSON vs. binary metrics serialization.");
+    absl::ParseCommandLine(argc, argv);
+    FLAGS_alsologtostderr = true;
+
+    const std::vector<Method> methods = {
+        {"rest_json",
+         [](const examples::MetricsColumns& columns) { return examples::ToRestApiJsonText(columns); },
+         [](const std::string& data) { return examples::ParseRestApiMetricsColumns(data).ok(); }},
+        {"rest_json_intervals",
+         [](const examples::MetricsColumns& columns) {
+             examples::RestMetricsWriterSettings settings;
+             settings.boolean_intervals = true;
+             return examples::ToRestApiJsonText(columns, settings);
+         },
+         [](const std::string& data) { return examples::ParseRestApiMetricsColumns(data).ok(); }},
+        {"metrics_json",
+         [](const examples::MetricsColumns& columns) { return nlohmann::json(examples::ToMetrics(columns)).dump(); },
+         [](const std::string& data) { return !nlohmann::json::parse(data).is_discarded(); }},
+        {"binary",
+         [](const examples::MetricsColumns& columns) {
+             return examples::SerializeMetricsBinary(columns, examples::MetricsColumnEncoding::Raw);
+         },
+         [](const std::string& data) { return examples::DeserializeMetricsBinary(data).ok(); }},
+        {"compact_binary",
+         [](const examples::MetricsColumns& columns) {
+             return examples::SerializeMetricsBinary(columns, examples::MetricsColumnEncoding::DeltaVarint);
+         },
+         [](const std::string& data) { return examples::DeserializeMetricsBinary(data).ok(); }},
+    };
+
+    const int repetitions = std::max(1, absl::GetFlag(FLAGS_repetitions));
+    std::cout << std::left << std::setw(10) << "duration_s" << std::setw(22) << "format" << std::setw(14) << "size_KiB"
+              << std::setw(14) << "write_ms" << std::setw(14) << "read_ms" << "write_MiB/s" << std::endl;
+    for (const std::string& duration_string: absl::GetFlag(FLAGS_durations)) {
+        double duration_s = 0.0;
+        if (!absl::SimpleAtod(duration_string, &duration_s)) {
+            LOG(ERROR) << "Invalid duration: " << duration_string;
+            return EXIT_FAILURE;
+        }
+        const examples::MetricsColumns columns = GenerateMetrics(duration_s, absl::GetFlag(FLAGS_frame_rate));
+        for (const Method& method: methods) {
+            std::string data;
+            const double write_time_ms = MedianTimeMs([&]() { data = method.serialize(columns); }, repetitions);
+            bool read_ok = true;
+            const double read_time_ms = MedianTimeMs([&]() { read_ok = read_ok && method.deserialize(data); },
+                                                     repetitions);
+            if (!read_ok) {
+                LOG(ERROR) << "Could not read back " << method.name << " output.";
+                return EXIT_FAILURE;
+            }
+            const double size_mib = static_cast<double>(data.size()) / (1024.0 * 1024.0);
+            std::cout << std::left << std::fixed << std::setprecision(3)
+                      << std::setw(10) << duration_s << std::setw(22) << method.name
+                      << std::setw(14) << size_mib * 1024.0 << std::setw(14) << write_time_ms
+                      << std::setw(14) << read_time_ms << size_mib / std::max(write_time_ms / 1000.0, 1e-9)
+                      << std::endl;
+        }
+    }
+    return 0;
+}
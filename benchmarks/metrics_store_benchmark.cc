@@ -0,0 +1,205 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Compares range queries over the metrics of a long continuous session answered from the metrics store (see
+// common/metrics_store.hpp) against getting the same answers without it: re-parsing the emitted metrics (the
+// `--metrics_delta_path` NDJSON stream) into a history, or scanning a history already held in memory. The session is
+// synthetic: outputs every `--output_interval` seconds, each holding the last `--core_buffer` seconds of per-frame
+// traces and per-second rates, as Core sends them.
+
+// stdlib includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+// third-party includes
+#include <google/protobuf/util/json_util.h>
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/glog/logging.h>
+#include <physiology/modules/messages/metrics.pb.h>
+
+// local includes
+#include "common/metrics_delta.hpp"
+#include "common/metrics_store.hpp"
+
+namespace physiology = presage::physiology;
+namespace examples = presage::smartspectra::examples;
+
+ABSL_FLAG(double, session_minutes, 120.0, "Duration of the synthetic continuous session, in minutes.");
+ABSL_FLAG(double, frame_rate, 30.0, "Frame rate of the synthetic per-frame traces, in frames per second.");
+ABSL_FLAG(double, output_interval, 0.5, "Interval between metrics outputs, in seconds.");
+ABSL_FLAG(double, core_buffer, 20.0, "Seconds of measurements each output holds.");
+ABSL_FLAG(int, memory_mb, 2,
+          "Memory, in MiB, the store may take up before spilling (0: never spill). The default has the early part of a "
+          "two-hour session spilled.");
+ABSL_FLAG(int, repetitions, 5, "Number of times to run each query (the median is reported).");
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The output Core sends at `time_s` into the session.
+physiology::MetricsBuffer GenerateOutput(double time_s, double frame_rate, double core_buffer_s) {
+    physiology::MetricsBuffer metrics;
+    const double start_s = std::max(0.0, time_s - core_buffer_s);
+    for (auto i_frame = static_cast<int64_t>(std::ceil(start_s * frame_rate)); i_frame / frame_rate <= time_s;
+         i_frame++) {
+        const auto time = static_cast<float>(i_frame / frame_rate);
+        auto* pulse_trace = metrics.mutable_pulse()->add_trace();
+        pulse_trace->set_time(time);
+        pulse_trace->set_value(std::sin(time * 7.5f));
+        auto* upper_trace = metrics.mutable_breath()->add_upper_trace();
+        upper_trace->set_time(time);
+        upper_trace->set_value(std::sin(time * 1.5f));
+        auto* lower_trace = metrics.mutable_breath()->add_lower_trace();
+        lower_trace->set_time(time);
+        lower_trace->set_value(-std::sin(time * 1.5f));
+    }
+    for (auto second = static_cast<int64_t>(std::ceil(start_s)); second <= time_s; second++) {
+        auto* pulse_rate = metrics.mutable_pulse()->add_rate();
+        pulse_rate->set_time(static_cast<float>(second));
+        pulse_rate->set_value(60.0f + static_cast<float>(second % 7));
+        pulse_rate->set_confidence(0.9f);
+        auto* breathing_rate = metrics.mutable_breath()->add_rate();
+        breathing_rate->set_time(static_cast<float>(second));
+        breathing_rate->set_value(15.0f + static_cast<float>(second % 3));
+        breathing_rate->set_confidence(0.9f);
+    }
+    return metrics;
+}
+
+// The pulse trace measurements within [from_time_s, until_time_s), found by scanning the history.
+size_t ScanPulseTrace(const physiology::MetricsBuffer& history, double from_time_s, double until_time_s) {
+    size_t measurement_count = 0;
+    for (const auto& measurement: history.pulse().trace()) {
+        measurement_count += measurement.time() >= from_time_s && measurement.time() < until_time_s ? 1 : 0;
+    }
+    return measurement_count;
+}
+
+// 10 s buckets of the pulse trace, computed by scanning the history.
+size_t ScanPulseTraceRollup(const physiology::MetricsBuffer& history) {
+    std::vector<double> sums;
+    std::vector<uint32_t> counts;
+    for (const auto& measurement: history.pulse().trace()) {
+        const auto i_bucket = static_cast<size_t>(measurement.time() / 10.0f);
+        if (i_bucket >= sums.size()) {
+            sums.resize(i_bucket + 1, 0.0);
+            counts.resize(i_bucket + 1, 0);
+        }
+        sums[i_bucket] += measurement.value();
+        counts[i_bucket]++;
+    }
+    return sums.size();
+}
+
+double MedianTimeUs(const std::function<void()>& run, int repetitions) {
+    std::vector<double> times_us;
+    for (int i_repetition = 0; i_repetition < repetitions; i_repetition++) {
+        const auto start = Clock::now();
+        run();
+        times_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    std::sort(times_us.begin(), times_us.end());
+    return times_us[times_us.size() / 2];
+}
+
+struct Query {
+    std::string name;
+    // returns the number of measurements (or buckets) found
+    std::function<size_t()> run;
+};
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    absl::SetProgramUsageMessage("Benchmark metrics store range queries vs. re-parsing or scanning the metrics.");
+    absl::ParseCommandLine(argc, argv);
+    FLAGS_alsologtostderr = true;
+
+    examples::MetricsStoreSettings store_settings;
+    store_settings.max_resident_bytes = static_cast<size_t>(std::max(0, absl::GetFlag(FLAGS_memory_mb))) << 20;
+    auto store_or_status = examples::MetricsStore::Create(store_settings);
+    if (!store_or_status.ok()) {
+        LOG(ERROR) << store_or_status.status().message();
+        return EXIT_FAILURE;
+    }
+    examples::MetricsStore& store = *store_or_status.value();
+
+    // the session: the store is fed every output, the NDJSON stream gets each output's delta
+    const double session_s = absl::GetFlag(FLAGS_session_minutes) * 60.0;
+    const double output_interval_s = std::max(0.01, absl::GetFlag(FLAGS_output_interval));
+    examples::MetricsDeltaTracker tracker;
+    physiology::MetricsBuffer delta;
+    std::vector<std::string> delta_jsons;
+    double append_time_ms = 0.0;
+    for (double time_s = output_interval_s; time_s <= session_s; time_s += output_interval_s) {
+        const physiology::MetricsBuffer output = GenerateOutput(
+            time_s, absl::GetFlag(FLAGS_frame_rate), absl::GetFlag(FLAGS_core_buffer)
+        );
+        const auto start = Clock::now();
+        const absl::Status status = store.Append(output);
+        append_time_ms += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (!status.ok()) {
+            LOG(ERROR) << status.message();
+            return EXIT_FAILURE;
+        }
+        delta.Clear();
+        const bool is_snapshot = tracker.Track(output, delta);
+        std::string delta_json;
+        (void) google::protobuf::util::MessageToJsonString(is_snapshot ? output : delta, &delta_json);
+        delta_jsons.push_back(std::move(delta_json));
+    }
+    std::cout << "Stored " << delta_jsons.size() << " outputs in " << std::fixed << std::setprecision(3)
+              << append_time_ms << " ms (" << append_time_ms * 1000.0 / std::max<size_t>(1, delta_jsons.size())
+              << " us per output): " << store.Summarize() << std::endl;
+
+    auto reparse_history = [&delta_jsons]() {
+        physiology::MetricsBuffer history;
+        physiology::MetricsBuffer parsed;
+        for (const std::string& delta_json: delta_jsons) {
+            parsed.Clear();
+            (void) google::protobuf::util::JsonStringToMessage(delta_json, &parsed);
+            examples::MergeMetricsSeries(parsed, history);
+        }
+        return history;
+    };
+    const physiology::MetricsBuffer history = reparse_history();
+    const double last_time_s = store.GetLastTime("pulse.trace").value_or(0.0f);
+    // a minute from early on in the session, likely spilled
+    const double early_from_s = std::min(600.0, session_s / 4.0);
+    constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+    const std::vector<Query> queries = {
+        {"ndjson_reparse_last_60s",
+         [&]() { return ScanPulseTrace(reparse_history(), last_time_s - 60.0, kInfinity); }},
+        {"history_scan_last_60s", [&]() { return ScanPulseTrace(history, last_time_s - 60.0, kInfinity); }},
+        {"store_last_60s", [&]() { return store.QueryLast("pulse.trace", 60.0).value().Size(); }},
+        {"history_scan_early_60s",
+         [&]() { return ScanPulseTrace(history, early_from_s, early_from_s + 60.0); }},
+        {"store_early_60s",
+         [&]() { return store.Query("pulse.trace", early_from_s, early_from_s + 60.0).value().Size(); }},
+        {"history_scan_rollup_10s", [&]() { return ScanPulseTraceRollup(history); }},
+        {"store_rollup_10s",
+         [&]() { return store.QueryRollup("pulse.trace", 10.0, -kInfinity, kInfinity).value().size(); }},
+    };
+    const int repetitions = std::max(1, absl::GetFlag(FLAGS_repetitions));
+    std::cout << std::left << std::setw(28) << "query" << std::setw(16) << "time_us" << "results" << std::endl;
+    for (const Query& query: queries) {
+        size_t result_count = 0;
+        const double time_us = MedianTimeUs([&]() { result_count = query.run(); }, repetitions);
+        std::cout << std::left << std::fixed << std::setprecision(3) << std::setw(28) << query.name
+                  << std::setw(16) << time_us << result_count << std::endl;
+    }
+    return 0;
+}
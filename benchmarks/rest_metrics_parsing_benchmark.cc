@@ -0,0 +1,260 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Compares the current way of turning a Physiology REST API response into formats::Metrics (parse the text into an
+// nlohmann::json DOM, convert the DOM with formats::MetricsFromRestApiJson, and, as rest_spot_example used to,
+// convert the result back to JSON for printing) against the streaming ParseRestApiMetrics, on synthetic responses
+// of different spot durations. Reports wall time and heap allocation counts per parse.
+
+// stdlib includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// third-party includes
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/absl/strings/numbers.h>
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/absl/strings/str_join.h>
+#include <physiology/interface/glog/logging.h>
+#include <physiology/interface/nlohmann/json.hpp>
+#include <smartspectra/formats/metrics.hpp>
+
+// local includes
+#include "common/rest_metrics_parser.hpp"
+
+namespace examples = presage::smartspectra::examples;
+namespace formats = presage::smartspectra::formats;
+
+ABSL_FLAG(std::vector<std::string>, spot_durations, std::vector<std::string>({"30", "300", "1800"}),
+          "Comma-separated list of (synthetic) spot durations, in seconds, to generate responses for.");
+ABSL_FLAG(double, frame_rate, 30.0, "Frame rate of the synthetic per-frame traces, in frames per second.");
+ABSL_FLAG(int, repetitions, 5, "Number of times to parse each response with each method (the median is reported).");
+ABSL_FLAG(bool, shuffle_keys, true,
+          "If true, series entries appear in random order in the response text, as the API does not guarantee order.");
+
+namespace {
+
+std::atomic<uint64_t> allocation_count{0};
+
+using Clock = std::chrono::steady_clock;
+
+struct Sample {
+    double time_ms;
+    uint64_t allocation_count;
+};
+
+void AppendSeries(
+    std::string& text, const std::string& name, std::vector<int> indices, double interval_s, bool with_confidence,
+    std::mt19937& random_generator
+) {
+    if (absl::GetFlag(FLAGS_shuffle_keys)) {
+        std::shuffle(indices.begin(), indices.end(), random_generator);
+    }
+    std::uniform_real_distribution<float> value_distribution(0.0f, 1.0f);
+    absl::StrAppend(&text, "\"", name, "\":{");
+    for (size_t i_entry = 0; i_entry < indices.size(); i_entry++) {
+        absl::StrAppend(&text, i_entry > 0 ? "," : "", "\"", indices[i_entry] * interval_s, "\":{\"value\":",
+                        value_distribution(random_generator));
+        if (with_confidence) {
+            absl::StrAppend(&text, ",\"confidence\":", value_distribution(random_generator));
+        }
+        absl::StrAppend(&text, "}");
+    }
+    absl::StrAppend(&text, "}");
+}
+
+std::string GenerateResponse(double spot_duration_s, double frame_rate) {
+    std::mt19937 random_generator(42);
+    std::vector<int> frame_indices(static_cast<size_t>(spot_duration_s * frame_rate));
+    std::vector<int> second_indices(static_cast<size_t>(spot_duration_s));
+    for (size_t i = 0; i < frame_indices.size(); i++) frame_indices[i] = static_cast<int>(i);
+    for (size_t i = 0; i < second_indices.size(); i++) second_indices[i] = static_cast<int>(i);
+    const double frame_interval_s = 1.0 / frame_rate;
+
+    std::string text = "{\"error\":\"\",\"version\":\"3.10.1\",\"pulse\":{";
+    AppendSeries(text, "hr", second_indices, 1.0, true, random_generator);
+    text += ",";
+    AppendSeries(text, "hr_trace", frame_indices, frame_interval_s, false, random_generator);
+    text += ",\"hr_strict\":{\"28\":{\"confidence\":[32.4054],\"value\":60.5}},\"hrv\":{}},\"breath\":{";
+    AppendSeries(text, "rr", second_indices, 1.0, true, random_generator);
+    text += ",";
+    AppendSeries(text, "rr_trace", frame_indices, frame_interval_s, false, random_generator);
+    text += ",";
+    AppendSeries(text, "rr_trace_lower", frame_indices, frame_interval_s, false, random_generator);
+    text += ",\"rr_strict\":{\"28\":{\"confidence\":[32.4054],\"value\":18.5}},";
+    AppendSeries(text, "rrl", second_indices, 1.0, false, random_generator);
+    text += ",\"apnea\":{\"0\":{\"value\":false}},";
+    AppendSeries(text, "ie", second_indices, 1.0, false, random_generator);
+    text += ",";
+    AppendSeries(text, "amplitude", second_indices, 1.0, false, random_generator);
+    text += "},\"pressure\":{";
+    AppendSeries(text, "phasic", frame_indices, frame_interval_s, false, random_generator);
+    text += "},\"face\":{\"blinking\":{\"0\":{\"value\":false}},\"talking\":{\"0\":{\"value\":false}}}}";
+    return text;
+}
+
+template<typename TParse>
+Sample Measure(TParse parse) {
+    const uint64_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+    const auto start = Clock::now();
+    parse();
+    return {
+        std::chrono::duration<double, std::milli>(Clock::now() - start).count(),
+        allocation_count.load(std::memory_order_relaxed) - allocations_before
+    };
+}
+
+Sample Median(std::vector<Sample> samples) {
+    std::sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b) { return a.time_ms < b.time_ms; });
+    return samples[samples.size() / 2];
+}
+
+template<typename TValue>
+bool SameMeasurement(const formats::Measurement<TValue>& a, const formats::Measurement<TValue>& b) {
+    return a.time == b.time && a.value == b.value;
+}
+
+template<typename TValue>
+bool SameMeasurement(
+    const formats::MeasurementWithConfidence<TValue>& a,
+    const formats::MeasurementWithConfidence<TValue>& b
+) {
+    return a.time == b.time && a.value == b.value && a.confidence == b.confidence;
+}
+
+// Appends `name` to `mismatches` unless both series hold the same measurements (times, values and confidences).
+template<typename TMeasurement>
+void CheckSameSeries(
+    const std::vector<TMeasurement>& a,
+    const std::vector<TMeasurement>& b,
+    const char* name,
+    std::vector<std::string>& mismatches
+) {
+    if (a.size() != b.size()) {
+        mismatches.push_back(absl::StrCat(name, " (", a.size(), " vs. ", b.size(), " measurements)"));
+        return;
+    }
+    for (size_t i_measurement = 0; i_measurement < a.size(); i_measurement++) {
+        if (!SameMeasurement(a[i_measurement], b[i_measurement])) {
+            mismatches.push_back(absl::StrCat(name, " (from measurement ", i_measurement, " on)"));
+            return;
+        }
+    }
+}
+
+// Names of the fields that differ between `a` and `b`; empty if they are the same.
+std::vector<std::string> FindMismatches(const formats::Metrics& a, const formats::Metrics& b) {
+    std::vector<std::string> mismatches;
+    CheckSameSeries(a.pulse.values, b.pulse.values, "pulse.values", mismatches);
+    CheckSameSeries(a.pulse.trace, b.pulse.trace, "pulse.trace", mismatches);
+    if (a.pulse.strict != b.pulse.strict) mismatches.push_back("pulse.strict");
+    if (a.pulse.snr_sufficient != b.pulse.snr_sufficient) mismatches.push_back("pulse.snr_sufficient");
+    CheckSameSeries(a.breathing.values, b.breathing.values, "breathing.values", mismatches);
+    CheckSameSeries(a.breathing.upper_trace, b.breathing.upper_trace, "breathing.upper_trace", mismatches);
+    CheckSameSeries(a.breathing.lower_trace, b.breathing.lower_trace, "breathing.lower_trace", mismatches);
+    if (a.breathing.strict != b.breathing.strict) mismatches.push_back("breathing.strict");
+    if (a.breathing.snr_sufficient != b.breathing.snr_sufficient) mismatches.push_back("breathing.snr_sufficient");
+    CheckSameSeries(a.breathing.amplitude, b.breathing.amplitude, "breathing.amplitude", mismatches);
+    CheckSameSeries(a.breathing.apnea, b.breathing.apnea, "breathing.apnea", mismatches);
+    CheckSameSeries(
+        a.breathing.respiratory_line_length, b.breathing.respiratory_line_length, "breathing.respiratory_line_length",
+        mismatches
+    );
+    CheckSameSeries(
+        a.breathing.inhale_exhale_ratio, b.breathing.inhale_exhale_ratio, "breathing.inhale_exhale_ratio", mismatches
+    );
+    CheckSameSeries(a.blood_pressure.phasic, b.blood_pressure.phasic, "blood_pressure.phasic", mismatches);
+    if (a.version != b.version) mismatches.push_back("version");
+    return mismatches;
+}
+
+} // anonymous namespace
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t /*size*/) noexcept {
+    std::free(pointer);
+}
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    absl::SetProgramUsageMessage(
+        "Benchmark DOM-based vs. streaming parsing of Physiology REST API metrics responses into formats::Metrics."
+    );
+    absl::ParseCommandLine(argc, argv);
+    FLAGS_alsologtostderr = true;
+
+    const int repetitions = std::max(1, absl::GetFlag(FLAGS_repetitions));
+    std::cout << std::left << std::setw(12) << "spot_s" << std::setw(12) << "text_MiB" << std::setw(16) << "method"
+              << std::setw(12) << "time_ms" << "allocations" << std::endl;
+    for (const std::string& spot_duration_string: absl::GetFlag(FLAGS_spot_durations)) {
+        double spot_duration_s = 0.0;
+        if (!absl::SimpleAtod(spot_duration_string, &spot_duration_s)) {
+            LOG(ERROR) << "Invalid spot duration: " << spot_duration_string;
+            return EXIT_FAILURE;
+        }
+        const std::string text = GenerateResponse(spot_duration_s, absl::GetFlag(FLAGS_frame_rate));
+
+        formats::Metrics dom_metrics;
+        formats::Metrics streamed_metrics;
+        std::vector<Sample> dom_print_samples, dom_samples, streaming_samples;
+        for (int i_repetition = 0; i_repetition < repetitions; i_repetition++) {
+            dom_print_samples.push_back(Measure([&]() {
+                auto metrics_or_status = formats::MetricsFromRestApiJson(nlohmann::json::parse(text));
+                nlohmann::json metrics_nice_json{metrics_or_status.value()};
+                return metrics_nice_json.dump(2).size();
+            }));
+            dom_samples.push_back(Measure([&]() {
+                dom_metrics = formats::MetricsFromRestApiJson(nlohmann::json::parse(text)).value();
+            }));
+            streaming_samples.push_back(Measure([&]() {
+                auto metrics_or_status = examples::ParseRestApiMetrics(text);
+                if (!metrics_or_status.ok()) {
+                    LOG(ERROR) << metrics_or_status.status().message();
+                    std::exit(EXIT_FAILURE);
+                }
+                streamed_metrics = std::move(metrics_or_status.value());
+            }));
+        }
+        const std::vector<std::string> mismatches = FindMismatches(dom_metrics, streamed_metrics);
+        if (!mismatches.empty()) {
+            LOG(ERROR) << "Streaming parser output does not match formats::MetricsFromRestApiJson output in: "
+                       << absl::StrJoin(mismatches, ", ") << ".";
+            return EXIT_FAILURE;
+        }
+
+        const double text_size_mib = static_cast<double>(text.size()) / (1024.0 * 1024.0);
+        for (const auto& [method, samples]: {
+            std::make_pair("dom+print", &dom_print_samples),
+            std::make_pair("dom", &dom_samples),
+            std::make_pair("streaming", &streaming_samples)
+        }) {
+            Sample median = Median(*samples);
+            std::cout << std::left << std::fixed << std::setprecision(2)
+                      << std::setw(12) << spot_duration_s << std::setw(12) << text_size_mib << std::setw(16) << method
+                      << std::setw(12) << median.time_ms << median.allocation_count << std::endl;
+        }
+    }
+    return 0;
+}
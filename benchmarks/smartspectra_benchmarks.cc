@@ -0,0 +1,629 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Runs the SmartSpectra containers headless over a matrix of recorded videos and synthetic file stream folders,
+// operation / integration modes, input resolutions, buffer durations and input scaling, fully offline, and reports
+// throughput, per-frame latency percentiles, peak RSS and CPU time of every run as JSON, for comparing SDK versions.
+//  * `file`: continuous mode, preprocessed data saved as JSON files on disk.
+//  * `grpc`: continuous mode against the local Physiology Core stand-in (example_physiology_core_grpc_server),
+//    started for the duration of the benchmark.
+//  * `spot`: spot mode without a Physiology API key, i.e. preprocessing only, no REST API call.
+// Each run happens in its own child process, so that peak RSS and CPU time are its own.
+
+// stdlib includes
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// third-party includes
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/absl/strings/numbers.h>
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/absl/strings/str_split.h>
+#include <physiology/interface/glog/logging.h>
+#include <physiology/interface/nlohmann/json.hpp>
+#include <physiology/modules/filesystem_absl.h>
+#include <smartspectra/container/settings.hpp>
+#include <smartspectra/container/foreground_container.hpp>
+
+// local includes
+#include "common/file_stream_watcher.hpp"
+#include "common/input_reduction.hpp"
+#include "common/pipeline_metrics.hpp"
+#include "common/status_macros.hpp"
+
+namespace pcam = presage::camera;
+namespace spectra = presage::smartspectra;
+namespace settings = presage::smartspectra::container::settings;
+namespace vs = presage::smartspectra::video_source;
+namespace examples = presage::smartspectra::examples;
+
+ABSL_FLAG(std::vector<std::string>, input_video_paths, std::vector<std::string>(),
+          "Comma-separated list of recorded videos to run on, at their own resolution.");
+ABSL_FLAG(int, synthetic_frame_count, 300,
+          "Number of frames of each synthetic file stream folder (at 30 fps), one per `--resolutions` entry. "
+          "When 0, no synthetic input is used. Synthetic frames hold no face: they exercise the per-frame path only.");
+ABSL_FLAG(std::vector<std::string>, resolutions, std::vector<std::string>({"640x480", "1280x720"}),
+          "Comma-separated list of WIDTHxHEIGHT resolutions of the synthetic file stream folders (also passed on as "
+          "`capture_width_px` / `capture_height_px`).");
+ABSL_FLAG(std::vector<std::string>, modes, std::vector<std::string>({"file", "grpc", "spot"}),
+          "Comma-separated list of modes to run: `file` (continuous, JSON files on disk), `grpc` (continuous, against "
+          "the local Physiology Core stand-in), `spot` (spot, preprocessing only).");
+ABSL_FLAG(std::vector<std::string>, buffer_durations, std::vector<std::string>({"0.2", "0.5", "1.0"}),
+          "Comma-separated list of preprocessing buffer durations, in seconds, for the continuous modes.");
+ABSL_FLAG(std::vector<std::string>, scale_input_values, std::vector<std::string>({"true", "false"}),
+          "Comma-separated list of `scale_input` values to run with.");
+ABSL_FLAG(std::vector<std::string>, input_max_widths, std::vector<std::string>({"0"}),
+          "Comma-separated list of `input_max_width` values to run with: frames wider than this are downsampled "
+          "before they enter the graph. 0: frames enter the graph as they are.");
+ABSL_FLAG(double, spot_duration, 10.0, "Spot duration, in seconds, in the `spot` mode.");
+ABSL_FLAG(int, interframe_delay, 20, "Delay, in milliseconds, before capturing the next frame, as in the examples.");
+ABSL_FLAG(int, repetitions, 1, "Number of times to run each configuration.");
+ABSL_FLAG(std::string, core_server_path, SMARTSPECTRA_CORE_STAND_IN_PATH,
+          "Path of the Physiology Core stand-in server executable used in the `grpc` mode.");
+ABSL_FLAG(uint16_t, core_port, 50092, "Port of the Physiology Core stand-in in the `grpc` mode.");
+ABSL_FLAG(std::string, work_directory, "",
+          "Folder for synthetic inputs and the preprocessed data of the runs. Defaults to a folder in the system "
+          "temporary directory, which is removed afterwards.");
+ABSL_FLAG(std::string, output_path, "benchmark_results.json", "Path of the JSON file to write the results to.");
+ABSL_FLAG(bool, also_log_to_stderr, false, "If true, log to stderr as well.");
+ABSL_FLAG(int, verbosity, 0, "Verbosity level of the containers -- raise to print more.");
+
+namespace {
+
+constexpr int64_t kSyntheticFrameIntervalUs = 33333;
+constexpr int kCoreStartTimeoutMs = 10000;
+
+struct BenchmarkInput {
+    std::string name;
+    std::string input_video_path;
+    std::string file_stream_path;
+    // 0 when the input resolution is its own
+    int width = 0;
+    int height = 0;
+};
+
+struct RunConfiguration {
+    std::string mode;
+    const BenchmarkInput* input = nullptr;
+    bool scale_input = true;
+    // 0: no input reduction
+    int input_max_width = 0;
+    // not used in spot mode
+    double buffer_duration = 0.0;
+    int repetition = 0;
+};
+
+// region ======================================== INPUTS ==============================================================
+absl::StatusOr<std::pair<int, int>> ParseResolution(const std::string& text) {
+    std::vector<std::string> parts = absl::StrSplit(text, 'x');
+    int width = 0;
+    int height = 0;
+    if (parts.size() != 2 || !absl::SimpleAtoi(parts[0], &width) || !absl::SimpleAtoi(parts[1], &height) ||
+        width <= 0 || height <= 0) {
+        return absl::InvalidArgumentError("Invalid resolution (expected WIDTHxHEIGHT): " + text);
+    }
+    return std::make_pair(width, height);
+}
+
+// Writes frames of moving color gradients, with an end-of-stream token, in file stream layout.
+absl::StatusOr<std::string> WriteSyntheticFileStream(const std::filesystem::path& folder, int width, int height) {
+    std::filesystem::remove_all(folder);
+    MP_RETURN_IF_ERROR(presage::filesystem::abseil::CreateDirectoryIfMissing(folder));
+    const std::filesystem::path file_stream_path = folder / "frame_0000000000000.png";
+    auto pattern_or_status = examples::FileStreamPattern::Parse(file_stream_path);
+    if (!pattern_or_status.ok()) {
+        return pattern_or_status.status();
+    }
+    cv::Mat frame(height, width, CV_8UC3);
+    for (int i_frame = 0; i_frame < absl::GetFlag(FLAGS_synthetic_frame_count); i_frame++) {
+        for (int y = 0; y < height; y++) {
+            auto* row = frame.ptr<cv::Vec3b>(y);
+            for (int x = 0; x < width; x++) {
+                row[x] = cv::Vec3b(
+                    static_cast<uint8_t>(x + i_frame), static_cast<uint8_t>(y + 2 * i_frame),
+                    static_cast<uint8_t>(x + y + 3 * i_frame)
+                );
+            }
+        }
+        const auto frame_path = pattern_or_status->FramePath(i_frame * kSyntheticFrameIntervalUs);
+        if (!cv::imwrite(frame_path.string(), frame)) {
+            return absl::InternalError("Could not write synthetic frame " + frame_path.string());
+        }
+    }
+    std::ofstream(folder / "end_of_stream").close();
+    return file_stream_path.string();
+}
+
+absl::StatusOr<std::vector<BenchmarkInput>> PrepareInputs(const std::filesystem::path& work_directory) {
+    std::vector<BenchmarkInput> inputs;
+    for (const std::string& input_video_path: absl::GetFlag(FLAGS_input_video_paths)) {
+        if (!std::filesystem::exists(input_video_path)) {
+            return absl::NotFoundError("Input video not found: " + input_video_path);
+        }
+        inputs.push_back(BenchmarkInput{std::filesystem::path(input_video_path).filename().string(), input_video_path, ""});
+    }
+    if (absl::GetFlag(FLAGS_synthetic_frame_count) > 0) {
+        for (const std::string& resolution: absl::GetFlag(FLAGS_resolutions)) {
+            auto resolution_or_status = ParseResolution(resolution);
+            if (!resolution_or_status.ok()) {
+                return resolution_or_status.status();
+            }
+            const auto [width, height] = resolution_or_status.value();
+            LOG(INFO) << "Writing the " << resolution << " synthetic file stream...";
+            auto path_or_status = WriteSyntheticFileStream(work_directory / ("synthetic_" + resolution), width, height);
+            if (!path_or_status.ok()) {
+                return path_or_status.status();
+            }
+            inputs.push_back(BenchmarkInput{"synthetic_" + resolution, "", path_or_status.value(), width, height});
+        }
+    }
+    return inputs;
+}
+// endregion ===========================================================================================================
+
+// region ======================================== RUNS ================================================================
+vs::VideoSourceSettings BuildVideoSourceSettings(const BenchmarkInput& input) {
+    return vs::VideoSourceSettings{
+        /*device_index=*/0,
+        vs::ResolutionSelectionMode::Auto,
+        input.width > 0 ? input.width : -1,
+        input.height > 0 ? input.height : -1,
+        pcam::CameraResolutionRange::Unspecified_EnumEnd,
+        pcam::CaptureCodec::MJPG,
+        /*auto_lock=*/true,
+        input.input_video_path,
+        input.file_stream_path,
+        /*end_of_stream=*/"end_of_stream",
+        /*file_stream_rescan_delay=*/5,
+        // synthetic frames are reused across runs
+        /*erase_read_files=*/false,
+        /*loop=*/false,
+    };
+}
+
+template<
+    settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode,
+    typename TOperationSettings, typename TIntegrationSettings
+>
+settings::Settings<TOperationMode, TIntegrationMode> BuildSettings(
+    const RunConfiguration& configuration,
+    TOperationSettings operation,
+    TIntegrationSettings integration
+) {
+    return settings::Settings<TOperationMode, TIntegrationMode>{
+        BuildVideoSourceSettings(*configuration.input),
+        settings::VideoSinkSettings{},
+        /*headless=*/true,
+        absl::GetFlag(FLAGS_interframe_delay),
+        /*start_with_recording_on=*/true,
+        /*start_time_offset_ms=*/0,
+        configuration.scale_input,
+        /*binary_graph=*/true,
+        /*enable_phasic_bp=*/false,
+        /*print_graph_contents=*/false,
+        absl::GetFlag(FLAGS_verbosity),
+        operation,
+        integration
+    };
+}
+
+struct RunTimes {
+    double initialization_s = 0.0;
+    double run_s = 0.0;
+};
+
+template<typename TContainer>
+absl::Status InitializeAndRun(TContainer& container, RunTimes& times) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    MP_RETURN_IF_ERROR(container.Initialize());
+    times.initialization_s = std::chrono::duration<double>(Clock::now() - start).count();
+    start = Clock::now();
+    absl::Status status = container.Run();
+    times.run_s = std::chrono::duration<double>(Clock::now() - start).count();
+    return status;
+}
+
+absl::Status RunContainer(
+    const RunConfiguration& configuration,
+    const std::filesystem::path& output_directory,
+    examples::PipelineMetrics& pipeline_metrics,
+    RunTimes& times
+) {
+    const examples::InputReductionSettings reduction_settings{
+        configuration.input_max_width, /*max_height=*/0, /*region_of_interest=*/cv::Rect(), &pipeline_metrics
+    };
+    if (configuration.mode == "spot") {
+        auto run_settings = BuildSettings<settings::OperationMode::Spot, settings::IntegrationMode::JsonRestApi>(
+            configuration,
+            settings::SpotSettings{absl::GetFlag(FLAGS_spot_duration)},
+            // without an API key, metrics are not retrieved from the REST API
+            settings::JsonRestApiSettings{/*physiology_key=*/"", output_directory.string(), /*save_to_disk=*/false}
+        );
+        examples::InstrumentedContainer<examples::InputReductionContainer<
+            spectra::container::SpotRestForegroundContainer<presage::platform_independence::DeviceType::Cpu>
+        >> container(&pipeline_metrics, reduction_settings, run_settings);
+        return InitializeAndRun(container, times);
+    }
+    if (configuration.mode == "grpc") {
+        auto run_settings = BuildSettings<settings::OperationMode::Continuous, settings::IntegrationMode::Grpc>(
+            configuration,
+            settings::ContinuousSettings{configuration.buffer_duration},
+            settings::GrpcSettings{absl::GetFlag(FLAGS_core_port)}
+        );
+        examples::InstrumentedContainer<
+            examples::InputReductionContainer<spectra::container::CpuContinuousGrpcForegroundContainer>
+        > container(&pipeline_metrics, reduction_settings, run_settings);
+        container.OnCoreMetricsOutput = [&container](
+            const presage::physiology::MetricsBuffer& /*metrics*/, int64_t timestamp_us
+        ) {
+            container.RecordMetricsOutput(timestamp_us);
+            return absl::OkStatus();
+        };
+        return InitializeAndRun(container, times);
+    }
+    auto run_settings = BuildSettings<settings::OperationMode::Continuous, settings::IntegrationMode::JsonFileOnDisk>(
+        configuration,
+        settings::ContinuousSettings{configuration.buffer_duration},
+        settings::JsonFileOnDiskSettings{output_directory.string()}
+    );
+    examples::InstrumentedContainer<
+        examples::InputReductionContainer<spectra::container::CpuContinuousFileForegroundContainer>
+    > container(&pipeline_metrics, reduction_settings, run_settings);
+    return InitializeAndRun(container, times);
+}
+
+nlohmann::json SummarizeLatencies(const examples::LatencyHistogram& histogram) {
+    return {
+        {"count", histogram.GetCount()},
+        {"mean_ms", histogram.GetMeanUs() / 1e3},
+        {"p50_ms", static_cast<double>(histogram.GetQuantileUs(0.5)) / 1e3},
+        {"p90_ms", static_cast<double>(histogram.GetQuantileUs(0.9)) / 1e3},
+        {"p99_ms", static_cast<double>(histogram.GetQuantileUs(0.99)) / 1e3},
+        {"max_ms", static_cast<double>(histogram.GetMaxUs()) / 1e3}
+    };
+}
+
+// Runs in the child process: returns the in-process part of the run result.
+nlohmann::json RunInChild(const RunConfiguration& configuration, const std::filesystem::path& output_directory) {
+    examples::PipelineMetrics pipeline_metrics;
+    RunTimes times;
+    const auto start = std::chrono::steady_clock::now();
+    absl::Status status = presage::filesystem::abseil::CreateDirectoryIfMissing(output_directory);
+    if (status.ok()) {
+        status = RunContainer(configuration, output_directory, pipeline_metrics, times);
+    }
+    const double wall_time_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const int64_t frame_count = pipeline_metrics.GetCounter("frames_read_total", "").load();
+    return {
+        {"ok", status.ok()},
+        {"error", std::string(status.message())},
+        {"wall_time_s", wall_time_s},
+        {"initialization_time_s", times.initialization_s},
+        {"run_time_s", times.run_s},
+        {"frame_count", frame_count},
+        // over the run proper, i.e. excluding graph initialization
+        {"fps", times.run_s > 0.0 ? static_cast<double>(frame_count) / times.run_s : 0.0},
+        {"dropped_frame_count", pipeline_metrics.GetCounter("frames_dropped_total", "").load()},
+        {"metrics_output_count", pipeline_metrics.GetCounter("metrics_outputs_total", "").load()},
+        {"frame_capture", SummarizeLatencies(pipeline_metrics.GetHistogram("frame_capture", ""))},
+        {"frame_processing", SummarizeLatencies(pipeline_metrics.GetHistogram("frame_processing", ""))},
+        {"frame_to_metrics", SummarizeLatencies(pipeline_metrics.GetHistogram("frame_to_metrics", ""))},
+        {"input_reduction", SummarizeLatencies(pipeline_metrics.GetHistogram("input_reduction", ""))}
+    };
+}
+
+std::string DescribeConfiguration(const RunConfiguration& configuration) {
+    std::string description = absl::StrCat(
+        configuration.mode, " ", configuration.input->name, " scale_input=", configuration.scale_input
+    );
+    if (configuration.input_max_width > 0) {
+        absl::StrAppend(&description, " input_max_width=", configuration.input_max_width);
+    }
+    if (configuration.mode != "spot") {
+        absl::StrAppend(&description, " buffer_duration=", configuration.buffer_duration);
+    }
+    return description;
+}
+
+// Runs the configuration in a child process, returning the result along with the child's resource usage.
+nlohmann::json Run(const RunConfiguration& configuration, const std::filesystem::path& work_directory) {
+    nlohmann::json result = {
+        {"mode", configuration.mode},
+        {"input", configuration.input->name},
+        {"width", configuration.input->width},
+        {"height", configuration.input->height},
+        {"scale_input", configuration.scale_input},
+        {"input_max_width", configuration.input_max_width},
+        {"repetition", configuration.repetition}
+    };
+    if (configuration.mode != "spot") {
+        result["buffer_duration"] = configuration.buffer_duration;
+    }
+    int result_pipe[2];
+    if (pipe(result_pipe) != 0) {
+        result["ok"] = false;
+        result["error"] = absl::StrCat("Could not create a pipe: ", std::strerror(errno));
+        return result;
+    }
+    const pid_t child = fork();
+    if (child == 0) {
+        close(result_pipe[0]);
+        const std::string child_result =
+            RunInChild(configuration, work_directory / absl::StrCat("run_", getpid())).dump();
+        size_t written_size = 0;
+        while (written_size < child_result.size()) {
+            const ssize_t size = write(result_pipe[1], child_result.data() + written_size,
+                                       child_result.size() - written_size);
+            if (size <= 0) {
+                break;
+            }
+            written_size += static_cast<size_t>(size);
+        }
+        close(result_pipe[1]);
+        // skips the destructors of the state copied from the parent
+        _exit(0);
+    }
+    close(result_pipe[1]);
+    if (child < 0) {
+        close(result_pipe[0]);
+        result["ok"] = false;
+        result["error"] = absl::StrCat("Could not fork: ", std::strerror(errno));
+        return result;
+    }
+    std::string child_result;
+    char buffer[4096];
+    ssize_t size;
+    while ((size = read(result_pipe[0], buffer, sizeof(buffer))) > 0 || (size < 0 && errno == EINTR)) {
+        if (size > 0) {
+            child_result.append(buffer, static_cast<size_t>(size));
+        }
+    }
+    close(result_pipe[0]);
+    int wait_status = 0;
+    rusage usage{};
+    wait4(child, &wait_status, 0, &usage);
+
+    auto child_json = nlohmann::json::parse(child_result, nullptr, /*allow_exceptions=*/false);
+    if (child_json.is_discarded()) {
+        result["ok"] = false;
+        result["error"] = WIFSIGNALED(wait_status)
+                          ? absl::StrCat("Run crashed with signal ", WTERMSIG(wait_status))
+                          : absl::StrCat("Run exited with status ", WEXITSTATUS(wait_status), " without a result");
+    } else {
+        result.update(child_json);
+    }
+    const double user_cpu_s = static_cast<double>(usage.ru_utime.tv_sec) + usage.ru_utime.tv_usec / 1e6;
+    const double system_cpu_s = static_cast<double>(usage.ru_stime.tv_sec) + usage.ru_stime.tv_usec / 1e6;
+    // ru_maxrss is in kilobytes on Linux
+    result["peak_rss_mb"] = static_cast<double>(usage.ru_maxrss) / 1024.0;
+    result["user_cpu_s"] = user_cpu_s;
+    result["system_cpu_s"] = system_cpu_s;
+    if (result.contains("wall_time_s") && result["wall_time_s"].get<double>() > 0.0) {
+        result["cpu_utilization"] = (user_cpu_s + system_cpu_s) / result["wall_time_s"].get<double>();
+    }
+    return result;
+}
+// endregion ===========================================================================================================
+
+// region =================================== CORE STAND-IN ============================================================
+absl::StatusOr<pid_t> StartCoreStandIn() {
+    const std::string server_path = absl::GetFlag(FLAGS_core_server_path);
+    const std::string port_argument = absl::StrCat("--port=", absl::GetFlag(FLAGS_core_port));
+    const pid_t server = fork();
+    if (server == 0) {
+        execl(server_path.c_str(), server_path.c_str(), port_argument.c_str(), "--constant_metrics",
+              static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    if (server < 0) {
+        return absl::InternalError(absl::StrCat("Could not fork: ", std::strerror(errno)));
+    }
+    // wait for it to accept connections
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kCoreStartTimeoutMs);
+    while (std::chrono::steady_clock::now() < deadline) {
+        int wait_status = 0;
+        if (waitpid(server, &wait_status, WNOHANG) == server) {
+            return absl::UnavailableError("The Physiology Core stand-in exited early: " + server_path);
+        }
+        const int descriptor = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(absl::GetFlag(FLAGS_core_port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        const bool connected = connect(descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        close(descriptor);
+        if (connected) {
+            return server;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    kill(server, SIGKILL);
+    waitpid(server, nullptr, 0);
+    return absl::DeadlineExceededError("The Physiology Core stand-in did not start listening in time.");
+}
+
+void StopCoreStandIn(pid_t server) {
+    kill(server, SIGTERM);
+    waitpid(server, nullptr, 0);
+}
+// endregion ===========================================================================================================
+
+std::string CurrentTimeIso8601() {
+    const std::time_t now = std::time(nullptr);
+    std::tm utc{};
+    gmtime_r(&now, &utc);
+    std::ostringstream text;
+    text << std::put_time(&utc, "%Y-%m-%dT%H:%M:%SZ");
+    return text.str();
+}
+
+absl::Status RunBenchmarks(const std::filesystem::path& work_directory) {
+    auto inputs_or_status = PrepareInputs(work_directory);
+    if (!inputs_or_status.ok()) {
+        return inputs_or_status.status();
+    }
+    const std::vector<BenchmarkInput>& inputs = inputs_or_status.value();
+    if (inputs.empty()) {
+        return absl::InvalidArgumentError("No inputs: pass `--input_video_paths` and/or `--synthetic_frame_count`.");
+    }
+
+    std::vector<bool> scale_input_values;
+    for (const std::string& text: absl::GetFlag(FLAGS_scale_input_values)) {
+        bool value;
+        if (!absl::SimpleAtob(text, &value)) {
+            return absl::InvalidArgumentError("Invalid scale_input value: " + text);
+        }
+        scale_input_values.push_back(value);
+    }
+    std::vector<int> input_max_widths;
+    for (const std::string& text: absl::GetFlag(FLAGS_input_max_widths)) {
+        int value;
+        if (!absl::SimpleAtoi(text, &value) || value < 0) {
+            return absl::InvalidArgumentError("Invalid input_max_width value: " + text);
+        }
+        input_max_widths.push_back(value);
+    }
+    std::vector<double> buffer_durations;
+    for (const std::string& text: absl::GetFlag(FLAGS_buffer_durations)) {
+        double value;
+        if (!absl::SimpleAtod(text, &value) || value <= 0.0) {
+            return absl::InvalidArgumentError("Invalid buffer duration: " + text);
+        }
+        buffer_durations.push_back(value);
+    }
+    std::vector<RunConfiguration> configurations;
+    bool uses_core = false;
+    for (const std::string& mode: absl::GetFlag(FLAGS_modes)) {
+        if (mode != "file" && mode != "grpc" && mode != "spot") {
+            return absl::InvalidArgumentError("Unknown mode (expected file, grpc or spot): " + mode);
+        }
+        uses_core |= mode == "grpc";
+        // spot mode has no buffer duration
+        const std::vector<double> mode_buffer_durations = mode == "spot" ? std::vector<double>{0.0} : buffer_durations;
+        for (const BenchmarkInput& input: inputs) {
+            for (bool scale_input: scale_input_values) {
+                for (int input_max_width: input_max_widths) {
+                    for (double buffer_duration: mode_buffer_durations) {
+                        for (int repetition = 0; repetition < absl::GetFlag(FLAGS_repetitions); repetition++) {
+                            configurations.push_back(RunConfiguration{
+                                mode, &input, scale_input, input_max_width, buffer_duration, repetition
+                            });
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    pid_t core_server = -1;
+    if (uses_core) {
+        auto server_or_status = StartCoreStandIn();
+        if (!server_or_status.ok()) {
+            return server_or_status.status();
+        }
+        core_server = server_or_status.value();
+    }
+
+    nlohmann::json runs = nlohmann::json::array();
+    size_t failed_run_count = 0;
+    std::cout << std::left << std::setw(64) << "configuration" << std::setw(10) << "fps" << std::setw(12)
+              << "p50_ms" << std::setw(12) << "p99_ms" << std::setw(12) << "rss_mb" << "cpu_s" << std::endl;
+    for (size_t i_run = 0; i_run < configurations.size(); i_run++) {
+        const RunConfiguration& configuration = configurations[i_run];
+        LOG(INFO) << "Run " << i_run + 1 << "/" << configurations.size() << ": "
+                  << DescribeConfiguration(configuration);
+        nlohmann::json result = Run(configuration, work_directory);
+        if (!result.value("ok", false)) {
+            failed_run_count++;
+            LOG(ERROR) << "Run failed: " << result.value("error", std::string());
+        } else {
+            std::cout << std::left << std::fixed << std::setprecision(2) << std::setw(64)
+                      << DescribeConfiguration(configuration) << std::setw(10) << result["fps"].get<double>()
+                      << std::setw(12) << result["frame_processing"]["p50_ms"].get<double>()
+                      << std::setw(12) << result["frame_processing"]["p99_ms"].get<double>()
+                      << std::setw(12) << result["peak_rss_mb"].get<double>()
+                      << result["user_cpu_s"].get<double>() + result["system_cpu_s"].get<double>() << std::endl;
+        }
+        runs.push_back(std::move(result));
+    }
+    if (core_server > 0) {
+        StopCoreStandIn(core_server);
+    }
+
+    nlohmann::json report = {
+        {"sdk_version", SMARTSPECTRA_SDK_VERSION},
+        {"started_at", CurrentTimeIso8601()},
+        {"hardware_threads", std::thread::hardware_concurrency()},
+        {"interframe_delay_ms", absl::GetFlag(FLAGS_interframe_delay)},
+        {"run_count", runs.size()},
+        {"failed_run_count", failed_run_count},
+        {"runs", runs}
+    };
+    std::ofstream output(absl::GetFlag(FLAGS_output_path));
+    output << report.dump(2) << std::endl;
+    if (output.fail()) {
+        return absl::InternalError("Could not write the results to " + absl::GetFlag(FLAGS_output_path));
+    }
+    LOG(INFO) << "Ran " << runs.size() - failed_run_count << "/" << runs.size() << " configurations successfully. "
+              << "Results: " << absl::GetFlag(FLAGS_output_path);
+    return absl::OkStatus();
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    absl::SetProgramUsageMessage(
+        "Benchmark the SmartSpectra containers offline over recorded videos and synthetic file streams, writing "
+        "throughput, latency, memory and CPU figures of every configuration as JSON."
+    );
+    absl::ParseCommandLine(argc, argv);
+    if (absl::GetFlag(FLAGS_also_log_to_stderr)) {
+        // work-around for built-in logging to stderr (for a more human-readable flag name)
+        FLAGS_alsologtostderr = true;
+    }
+
+    const bool remove_work_directory = absl::GetFlag(FLAGS_work_directory).empty();
+    const std::filesystem::path work_directory = remove_work_directory
+                                                 ? std::filesystem::temp_directory_path() / "smartspectra_benchmarks"
+                                                 : std::filesystem::path(absl::GetFlag(FLAGS_work_directory));
+
+    absl::Status status = RunBenchmarks(work_directory);
+    if (remove_work_directory) {
+        std::error_code error;
+        std::filesystem::remove_all(work_directory, error);
+    }
+
+    if (!status.ok()) {
+        LOG(ERROR) << "Run failed. " << status.message();
+        return EXIT_FAILURE;
+    } else {
+        LOG(INFO) << "Success!";
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Compares writing passthrough video on the processing thread (cv::VideoWriter called right after each frame, as the
+// SDK's own video sink does) against handing the frames to a ThreadedVideoSink (see common/threaded_video_sink.hpp)
+// under each of its drop policies. The processing loop is synthetic: each frame is a moving gradient, followed by
+// `--processing_ms` of simulated graph work. Reported per method: the time per loop iteration (what the pipeline sees),
+// the overall frame rate, and how many frames made it into the video.
+
+// stdlib includes
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// third-party includes
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/latency_histogram.hpp"
+#include "common/threaded_video_sink.hpp"
+
+namespace examples = presage::smartspectra::examples;
+
+ABSL_FLAG(int, frame_count, 600, "Number of frames to run through each method.");
+ABSL_FLAG(int, frame_width, 1280, "Width of the synthetic frames, in pixels.");
+ABSL_FLAG(int, frame_height, 720, "Height of the synthetic frames, in pixels.");
+ABSL_FLAG(double, processing_ms, 10.0, "Simulated processing time per frame, in milliseconds.");
+ABSL_FLAG(std::string, fourcc, "MJPG", "Four-character code of the codec to encode with.");
+ABSL_FLAG(int, queue_size, 32, "Number of frames that can wait for the threaded encoder.");
+ABSL_FLAG(std::string, output_directory, "",
+          "Directory to write the videos to (removed afterwards). When empty, the system's temporary directory.");
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct RunResult {
+    examples::LatencyHistogram iteration_histogram;
+    double wall_time_s = 0.0;
+    uint64_t encoded_count = 0;
+    uint64_t dropped_count = 0;
+};
+
+// A frame of the synthetic video: a gradient shifted by `i_frame`, so that consecutive frames differ.
+void FillFrame(cv::Mat& frame, int i_frame) {
+    for (int row = 0; row < frame.rows; row++) {
+        auto* pixels = frame.ptr<uint8_t>(row);
+        for (int column = 0; column < frame.cols * 3; column++) {
+            pixels[column] = static_cast<uint8_t>(row + column + i_frame * 4);
+        }
+    }
+}
+
+// Runs the processing loop, calling `write` with each frame. Frames are allocated per iteration, as capture does.
+template<typename TWrite>
+void RunLoop(RunResult& result, TWrite&& write) {
+    const cv::Size frame_size(absl::GetFlag(FLAGS_frame_width), absl::GetFlag(FLAGS_frame_height));
+    const auto processing_time = std::chrono::microseconds(
+        static_cast<int64_t>(absl::GetFlag(FLAGS_processing_ms) * 1000.0)
+    );
+    const auto start = Clock::now();
+    for (int i_frame = 0; i_frame < absl::GetFlag(FLAGS_frame_count); i_frame++) {
+        const auto iteration_start = Clock::now();
+        cv::Mat frame(frame_size, CV_8UC3);
+        FillFrame(frame, i_frame);
+        write(frame);
+        std::this_thread::sleep_for(processing_time);
+        result.iteration_histogram.Record(Clock::now() - iteration_start);
+    }
+    result.wall_time_s = std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+absl::Status RunInline(const std::string& path, RunResult& result) {
+    const std::string fourcc = absl::GetFlag(FLAGS_fourcc);
+    cv::VideoWriter writer(
+        path, cv::VideoWriter::fourcc(fourcc[0], fourcc[1], fourcc[2], fourcc[3]), 30.0,
+        cv::Size(absl::GetFlag(FLAGS_frame_width), absl::GetFlag(FLAGS_frame_height)), true
+    );
+    if (!writer.isOpened()) {
+        return absl::UnavailableError("Could not open the output video " + path);
+    }
+    RunLoop(result, [&writer, &result](const cv::Mat& frame) {
+        writer.write(frame);
+        result.encoded_count++;
+    });
+    writer.release();
+    return absl::OkStatus();
+}
+
+absl::Status RunThreaded(const std::string& path, examples::VideoSinkDropPolicy drop_policy, RunResult& result) {
+    examples::ThreadedVideoSinkSettings sink_settings;
+    sink_settings.destination = path;
+    sink_settings.fourcc = absl::GetFlag(FLAGS_fourcc);
+    sink_settings.queue_capacity = static_cast<size_t>(std::max(1, absl::GetFlag(FLAGS_queue_size)));
+    sink_settings.drop_policy = drop_policy;
+    auto sink_or_status = examples::ThreadedVideoSink::Start(sink_settings);
+    if (!sink_or_status.ok()) {
+        return sink_or_status.status();
+    }
+    examples::ThreadedVideoSink& sink = *sink_or_status.value();
+    RunLoop(result, [&sink](const cv::Mat& frame) { sink.Write(frame); });
+    // the encoder finishing up what is queued counts as well
+    const auto close_start = Clock::now();
+    MP_RETURN_IF_ERROR(sink.Close());
+    result.wall_time_s += std::chrono::duration<double>(Clock::now() - close_start).count();
+    result.encoded_count = sink.GetEncodedFrameCount();
+    result.dropped_count = sink.GetDroppedFrameCount();
+    return absl::OkStatus();
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    absl::SetProgramUsageMessage("Benchmark writing passthrough video inline vs. on a threaded video sink.");
+    absl::ParseCommandLine(argc, argv);
+    FLAGS_alsologtostderr = true;
+
+    if (absl::GetFlag(FLAGS_fourcc).size() != 4) {
+        LOG(ERROR) << "--fourcc has to be four characters long.";
+        return EXIT_FAILURE;
+    }
+    const std::filesystem::path output_directory = absl::GetFlag(FLAGS_output_directory).empty()
+                                                   ? std::filesystem::temp_directory_path()
+                                                   : std::filesystem::path(absl::GetFlag(FLAGS_output_directory));
+    const std::vector<std::string> methods = {"inline", "threaded_drop_oldest", "threaded_drop_every_nth",
+                                              "threaded_block"};
+    std::cout << std::left << std::setw(26) << "method" << std::setw(14) << "mean_us" << std::setw(14) << "p99_us"
+              << std::setw(14) << "max_us" << std::setw(10) << "fps" << std::setw(10) << "encoded" << "dropped"
+              << std::endl;
+    for (size_t i_method = 0; i_method < methods.size(); i_method++) {
+        const std::string path = (output_directory / ("video_sink_benchmark_" + methods[i_method] + ".avi")).string();
+        RunResult result;
+        const absl::Status status = i_method == 0
+                                    ? RunInline(path, result)
+                                    : RunThreaded(path, static_cast<examples::VideoSinkDropPolicy>(i_method - 1),
+                                                  result);
+        std::filesystem::remove(path);
+        if (!status.ok()) {
+            LOG(ERROR) << methods[i_method] << ": " << status.message();
+            return EXIT_FAILURE;
+        }
+        const double frame_rate = static_cast<double>(result.iteration_histogram.GetCount()) / result.wall_time_s;
+        std::cout << std::left << std::fixed << std::setprecision(1) << std::setw(26) << methods[i_method]
+                  << std::setw(14) << result.iteration_histogram.GetMeanUs()
+                  << std::setw(14) << result.iteration_histogram.GetQuantileUs(0.99)
+                  << std::setw(14) << result.iteration_histogram.GetMaxUs() << std::setw(10) << frame_rate
+                  << std::setw(10) << result.encoded_count << result.dropped_count << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <thread>
+
+// third-party includes
+#include <physiology/interface/absl/strings/str_format.h>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/adaptive_pacing.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+// weight of the latest frame in the moving average of the processing time
+constexpr double kProcessingTimeSmoothing = 0.1;
+
+double ToMilliseconds(AdaptivePacer::Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+} // anonymous namespace
+
+// region ===================================== AdaptivePacer ==========================================================
+AdaptivePacer::AdaptivePacer(AdaptivePacingSettings settings)
+    : settings(settings),
+      delay_ms(std::clamp(settings.initial_delay_ms, settings.min_delay_ms, settings.max_delay_ms)) {}
+
+void AdaptivePacer::OnFrameRequested(Clock::time_point now) {
+    if (!frame_out) {
+        return;
+    }
+    frame_out = false;
+    const double frame_processing_ms = ToMilliseconds(now - last_read_time);
+    processing_ms = read_count == 1
+                    ? frame_processing_ms
+                    : processing_ms + kProcessingTimeSmoothing * (frame_processing_ms - processing_ms);
+}
+
+void AdaptivePacer::OnFrameRead(int64_t timestamp_us, Clock::time_point now) {
+    if (tracking_drops) {
+        window_dropped_count += drop_detector.OnFrame(timestamp_us);
+    }
+    RecordFrameRead(now);
+}
+
+void AdaptivePacer::OnFrameReadWithoutTimestamp(Clock::time_point now) {
+    if (tracking_drops) {
+        tracking_drops = false;
+        window_dropped_count = 0;
+        LOG(WARNING) << "The input has no exact frame timestamps, so dropped frames cannot be told apart: adaptive "
+                     << "pacing ignores the target drop rate, and assumes a "
+                     << drop_detector.GetFrameIntervalMs() << " ms input frame interval.";
+    }
+    RecordFrameRead(now);
+}
+
+void AdaptivePacer::RecordFrameRead(Clock::time_point now) {
+    last_read_time = now;
+    frame_out = true;
+    if (read_count == 0) {
+        next_log_time = now + std::chrono::seconds(settings.log_interval_seconds);
+    }
+    read_count++;
+    window_read_count++;
+
+    if (window_read_count >= settings.adjustment_interval_frames) {
+        Adjust();
+    }
+    if (settings.log_interval_seconds > 0 && now >= next_log_time) {
+        LogProgress(now);
+    }
+}
+
+void AdaptivePacer::Adjust() {
+    const double drop_rate =
+        static_cast<double>(window_dropped_count) / static_cast<double>(window_read_count + window_dropped_count);
+    const int previous_delay_ms = delay_ms;
+    if (processing_ms > GetTargetProcessingMs()) {
+        delay_ms = std::min(delay_ms + 1, settings.max_delay_ms);
+    } else if (tracking_drops && drop_rate > settings.target_drop_rate) {
+        delay_ms = std::max(delay_ms / 2, settings.min_delay_ms);
+    }
+    if (delay_ms != previous_delay_ms) {
+        VLOG(1) << "Interframe delay " << previous_delay_ms << " -> " << delay_ms << " ms (processing "
+                << processing_ms << " ms, " << window_dropped_count << " of "
+                << window_read_count + window_dropped_count << " frames dropped).";
+    }
+    window_read_count = 0;
+    window_dropped_count = 0;
+}
+
+void AdaptivePacer::LogProgress(Clock::time_point now) {
+    next_log_time = now + std::chrono::seconds(settings.log_interval_seconds);
+    if (!tracking_drops) {
+        LOG(INFO) << absl::StrFormat(
+            "Interframe delay: %dms, per-frame processing: %.1fms (target %.1fms), %d frames since the last report.",
+            delay_ms, processing_ms, GetTargetProcessingMs(), read_count - logged_read_count
+        );
+        logged_read_count = read_count;
+        return;
+    }
+    LOG(INFO) << absl::StrFormat(
+        "Interframe delay: %dms, per-frame processing: %.1fms (target %.1fms), dropped %d of %d frames since the last "
+        "report.",
+        delay_ms, processing_ms, GetTargetProcessingMs(), drop_detector.GetDroppedCount() - logged_dropped_count,
+        (read_count - logged_read_count) + (drop_detector.GetDroppedCount() - logged_dropped_count)
+    );
+    logged_read_count = read_count;
+    logged_dropped_count = drop_detector.GetDroppedCount();
+}
+
+double AdaptivePacer::GetTargetProcessingMs() const {
+    return settings.target_processing_ms > 0.0 ? settings.target_processing_ms
+                                               : 0.8 * drop_detector.GetFrameIntervalMs();
+}
+
+std::string AdaptivePacer::Summarize() const {
+    if (!tracking_drops) {
+        return absl::StrFormat(
+            "delay=%dms processing=%.1fms (target %.1fms) read %d frames, frame drops not tracked",
+            delay_ms, processing_ms, GetTargetProcessingMs(), read_count
+        );
+    }
+    const int64_t dropped_count = drop_detector.GetDroppedCount();
+    const int64_t frame_count = read_count + dropped_count;
+    return absl::StrFormat(
+        "delay=%dms processing=%.1fms (target %.1fms) dropped %d of %d frames (%.2f%%)",
+        delay_ms, processing_ms, GetTargetProcessingMs(), dropped_count, frame_count,
+        frame_count == 0 ? 0.0 : 100.0 * static_cast<double>(dropped_count) / static_cast<double>(frame_count)
+    );
+}
+// endregion ===========================================================================================================
+
+// region ===================================== PacedVideoSource =======================================================
+PacedVideoSource::PacedVideoSource(std::unique_ptr<video_source::VideoSource> video_source, AdaptivePacer& pacer)
+    : video_source(std::move(video_source)), pacer(pacer) {}
+
+absl::Status PacedVideoSource::Initialize(const video_source::VideoSourceSettings& /*settings*/) {
+    // the wrapped source is initialized by the container before it gets wrapped
+    return absl::OkStatus();
+}
+
+bool PacedVideoSource::SupportsExactFrameTimestamp() const {
+    return video_source->SupportsExactFrameTimestamp();
+}
+
+int64_t PacedVideoSource::GetFrameTimestamp() const {
+    return video_source->GetFrameTimestamp();
+}
+
+int PacedVideoSource::GetWidth() {
+    return video_source->GetWidth();
+}
+
+int PacedVideoSource::GetHeight() {
+    return video_source->GetHeight();
+}
+
+video_source::VideoSource& PacedVideoSource::operator>>(cv::Mat& frame) {
+    pacer.OnFrameRequested(AdaptivePacer::Clock::now());
+    if (pacer.GetDelayMs() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(pacer.GetDelayMs()));
+    }
+    *video_source >> frame;
+    const auto read_time = AdaptivePacer::Clock::now();
+    if (!frame.empty()) {
+        // read times would only show the pacing itself, not the frames the input dropped
+        if (video_source->SupportsExactFrameTimestamp()) {
+            pacer.OnFrameRead(video_source->GetFrameTimestamp(), read_time);
+        } else {
+            pacer.OnFrameReadWithoutTimestamp(read_time);
+        }
+    }
+    return *this;
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
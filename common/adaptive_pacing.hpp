@@ -0,0 +1,134 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+// third-party includes
+#include <physiology/interface/absl/status/status.h>
+#include <smartspectra/video_source/video_source.hpp>
+
+// local includes
+#include "common/frame_drop_detector.hpp"
+#include "common/status_macros.hpp"
+
+namespace presage::smartspectra::examples {
+
+struct AdaptivePacingSettings {
+    bool enabled = false;
+    // delay before capturing the first frame
+    int initial_delay_ms = 20;
+    int min_delay_ms = 0;
+    int max_delay_ms = 100;
+    // Per-frame processing time (the time the container holds on to a frame before asking for the next one) to stay
+    // under: it grows as the graph backs up. When 0, 80% of the input frame interval is used.
+    double target_processing_ms = 0.0;
+    // fraction of input frames that may be dropped (i.e. not read in time) before the delay is cut
+    double target_drop_rate = 0.01;
+    // number of frames between delay adjustments
+    int adjustment_interval_frames = 15;
+    // the delay, processing time and dropped-frame counts are logged this often (never when 0)
+    int log_interval_seconds = 5;
+};
+
+// Closed-loop replacement for a fixed interframe delay. Before each frame, waits for the current delay; every
+// `adjustment_interval_frames` frames, adjusts it:
+//  * while the per-frame processing time is over target, the graph is falling behind: the delay grows by 1 ms at a
+//    time, freeing up CPU for the graph to catch up;
+//  * otherwise, while more frames than targeted are dropped (told apart by gaps in the input timestamps), capture is
+//    not keeping up with the input: the delay is halved. Inputs without exact frame timestamps leave no such gaps to
+//    go by (read times only reflect the pacing itself), so for them this is skipped, and the input frame interval is
+//    assumed to be 1/30 s.
+class AdaptivePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit AdaptivePacer(AdaptivePacingSettings settings);
+
+    // Called when the container asks for the next frame: records how long it held on to the previous one.
+    void OnFrameRequested(Clock::time_point now);
+    int GetDelayMs() const { return delay_ms; }
+    // Called once the frame is read, with its (exact) input timestamp, in microseconds.
+    void OnFrameRead(int64_t timestamp_us, Clock::time_point now);
+    // Called instead once a frame without an exact input timestamp is read: turns off frame drop tracking.
+    void OnFrameReadWithoutTimestamp(Clock::time_point now);
+
+    // e.g. "delay=14ms processing=21.3ms (target 26.7ms) dropped 3 of 900 frames (0.33%)", over the whole run, or
+    // "... frame drops not tracked" for inputs without exact timestamps
+    std::string Summarize() const;
+
+private:
+    void RecordFrameRead(Clock::time_point now);
+    void Adjust();
+    void LogProgress(Clock::time_point now);
+    double GetTargetProcessingMs() const;
+
+    AdaptivePacingSettings settings;
+    int delay_ms;
+
+    Clock::time_point last_read_time;
+    bool frame_out = false;
+    // exponentially-weighted moving average of the per-frame processing time
+    double processing_ms = 0.0;
+    FrameDropDetector drop_detector;
+    // false once a frame without an exact timestamp was read
+    bool tracking_drops = true;
+
+    int64_t window_read_count = 0;
+    int64_t window_dropped_count = 0;
+    int64_t read_count = 0;
+    int64_t logged_read_count = 0;
+    int64_t logged_dropped_count = 0;
+    Clock::time_point next_log_time;
+};
+
+// Hands out the frames of another video source, paced by an AdaptivePacer.
+class PacedVideoSource : public video_source::VideoSource {
+public:
+    PacedVideoSource(std::unique_ptr<video_source::VideoSource> video_source, AdaptivePacer& pacer);
+
+    absl::Status Initialize(const video_source::VideoSourceSettings& settings) override;
+    bool SupportsExactFrameTimestamp() const override;
+    int64_t GetFrameTimestamp() const override;
+    int GetWidth() override;
+    int GetHeight() override;
+    video_source::VideoSource& operator>>(cv::Mat& frame) override;
+
+private:
+    std::unique_ptr<video_source::VideoSource> video_source;
+    AdaptivePacer& pacer;
+};
+
+// Foreground container whose video source (whichever the base container sets up) is paced adaptively when
+// `pacing_settings.enabled`, in which case the container's own interframe delay should be set to the minimum (1 ms).
+template<typename TContainer>
+class PacedContainer : public TContainer {
+public:
+    template<typename... TArgs>
+    explicit PacedContainer(AdaptivePacingSettings pacing_settings, TArgs&& ... args)
+        : TContainer(std::forward<TArgs>(args)...), pacer(pacing_settings), pacing_enabled(pacing_settings.enabled) {}
+
+    const AdaptivePacer& GetPacer() const { return pacer; }
+
+protected:
+    absl::Status InitializeVideoSource() override {
+        MP_RETURN_IF_ERROR(TContainer::InitializeVideoSource());
+        if (pacing_enabled) {
+            this->video_source = std::make_unique<PacedVideoSource>(std::move(this->video_source), pacer);
+        }
+        return absl::OkStatus();
+    }
+
+private:
+    AdaptivePacer pacer;
+    bool pacing_enabled;
+};
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+// third-party includes
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/core_stream_relay.hpp"
+#include "common/latency_histogram.hpp"
+
+namespace presage::smartspectra::examples {
+
+// Physiology service of one stream's relay port.
+class CoreStreamRelay::StreamService : public physiology::Physiology::Service {
+public:
+    StreamService(physiology::Physiology::Stub& stub, std::string stream_id, uint16_t port)
+        : stub(stub), stream_id(std::move(stream_id)), port(port) {}
+
+    grpc::Status AddPreprocessedData(
+        grpc::ServerContext* context,
+        const physiology::PreprocessedDataBuffer* request,
+        google::protobuf::Empty* response
+    ) override {
+        return Forward(&physiology::Physiology::Stub::AddPreprocessedData, *context, *request, response,
+                       &add_preprocessed_data_histogram);
+    }
+
+    grpc::Status GetMetrics(
+        grpc::ServerContext* context,
+        const google::protobuf::Empty* request,
+        physiology::MetricsBuffer* response
+    ) override {
+        return Forward(&physiology::Physiology::Stub::GetMetrics, *context, *request, response, &get_metrics_histogram);
+    }
+
+    grpc::Status IssueBlueTooth(
+        grpc::ServerContext* context,
+        const physiology::BlueTooth* request,
+        google::protobuf::Empty* response
+    ) override {
+        return Forward(&physiology::Physiology::Stub::IssueBlueTooth, *context, *request, response);
+    }
+
+    grpc::Status SetBufferDuration(
+        grpc::ServerContext* context,
+        const google::protobuf::DoubleValue* request,
+        google::protobuf::Empty* response
+    ) override {
+        return Forward(&physiology::Physiology::Stub::SetBufferDuration, *context, *request, response);
+    }
+
+    grpc::Status ResetProcessing(
+        grpc::ServerContext* context,
+        const google::protobuf::Empty* request,
+        google::protobuf::Empty* response
+    ) override {
+        return Forward(&physiology::Physiology::Stub::ResetProcessing, *context, *request, response);
+    }
+
+    void LogStatistics() const {
+        LOG(INFO) << "Stream '" << stream_id << "' (port " << port << ") to Core: AddPreprocessedData "
+                  << add_preprocessed_data_histogram.Summarize() << "; GetMetrics " << get_metrics_histogram.Summarize()
+                  << "; " << failed_call_count.load() << " failed calls.";
+    }
+
+private:
+    template<typename TRequest, typename TResponse>
+    using StubMethod =
+        grpc::Status (physiology::Physiology::Stub::*)(grpc::ClientContext*, const TRequest&, TResponse*);
+
+    template<typename TRequest, typename TResponse>
+    grpc::Status Forward(
+        StubMethod<TRequest, TResponse> method,
+        const grpc::ServerContext& server_context,
+        const TRequest& request,
+        TResponse* response,
+        LatencyHistogram* histogram = nullptr
+    ) {
+        // carries the deadline and cancellation of the container's call over to the relayed one
+        std::unique_ptr<grpc::ClientContext> context = grpc::ClientContext::FromServerContext(server_context);
+        context->AddMetadata(kStreamIdMetadataKey, stream_id);
+        const auto start = std::chrono::steady_clock::now();
+        grpc::Status status = (stub.*method)(context.get(), request, response);
+        if (histogram != nullptr) {
+            histogram->Record(std::chrono::steady_clock::now() - start);
+        }
+        if (!status.ok()) {
+            failed_call_count++;
+            LOG_EVERY_N(WARNING, 100) << "Relaying a call of stream '" << stream_id << "' to Core failed: "
+                                      << status.error_message();
+        }
+        return status;
+    }
+
+    physiology::Physiology::Stub& stub;
+    const std::string stream_id;
+    const uint16_t port;
+    LatencyHistogram add_preprocessed_data_histogram;
+    LatencyHistogram get_metrics_histogram;
+    std::atomic<int64_t> failed_call_count{0};
+};
+
+CoreStreamRelay::CoreStreamRelay(const std::string& core_address)
+    : channel(grpc::CreateChannel(core_address, grpc::InsecureChannelCredentials())),
+      stub(physiology::Physiology::NewStub(channel)) {}
+
+CoreStreamRelay::~CoreStreamRelay() {
+    Shutdown();
+}
+
+absl::Status CoreStreamRelay::AddStream(const std::string& stream_id, uint16_t port, int max_threads) {
+    auto service = std::make_unique<StreamService>(*stub, stream_id, port);
+    grpc::ServerBuilder builder;
+    const std::string address = absl::StrCat("localhost:", port);
+    builder.AddListeningPort(address, grpc::InsecureServerCredentials());
+    builder.RegisterService(service.get());
+    builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::NUM_CQS, 1);
+    builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::MIN_POLLERS, 1);
+    builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::MAX_POLLERS, std::max(1, max_threads));
+    std::unique_ptr<grpc::Server> server = builder.BuildAndStart();
+    if (server == nullptr) {
+        return absl::UnavailableError(
+            absl::StrCat("Could not start the relay for stream '", stream_id, "' on ", address)
+        );
+    }
+    std::lock_guard<std::mutex> lock(streams_mutex);
+    streams.push_back(std::move(service));
+    servers.push_back(std::move(server));
+    return absl::OkStatus();
+}
+
+void CoreStreamRelay::Shutdown() {
+    std::lock_guard<std::mutex> lock(streams_mutex);
+    for (auto& server: servers) {
+        server->Shutdown(std::chrono::system_clock::now() + std::chrono::seconds(1));
+    }
+    servers.clear();
+}
+
+void CoreStreamRelay::LogStatistics() const {
+    std::lock_guard<std::mutex> lock(streams_mutex);
+    for (const auto& stream: streams) {
+        stream->LogStatistics();
+    }
+}
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,53 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// third-party includes
+#include <grpcpp/grpcpp.h>
+#include <physiology/graph/physiology_core_service.grpc.pb.h>
+#include <physiology/interface/absl/status/status.h>
+
+namespace presage::smartspectra::examples {
+
+// Metadata key under which calls relayed to Core carry the ID of the stream they belong to. For the streams to be kept
+// apart, Core has to keep its processing state (buffer duration, preprocessed data buffer) per stream ID.
+inline constexpr const char* kStreamIdMetadataKey = "x-presage-stream-id";
+
+// Fans the Physiology calls of several gRPC continuous containers in one process in to a single Core endpoint.
+// Each container talks to its own local relay port, as it would to Core; the relay forwards every call, tagged with
+// the stream ID of the port it came in on, over one channel (i.e. one HTTP/2 connection) shared by all streams, so
+// that ResetProcessing, SetBufferDuration etc. can apply only to the stream that issued them.
+class CoreStreamRelay {
+public:
+    explicit CoreStreamRelay(const std::string& core_address);
+    ~CoreStreamRelay();
+
+    // Starts relaying the calls made to localhost:`port` to Core, tagged with `stream_id`. Calls are served by threads
+    // of the stream's own (with at most `max_threads` polling for calls), started from, and so sharing the CPU
+    // affinity of, the calling thread, so that a busy stream does not hold up the calls of the others.
+    absl::Status AddStream(const std::string& stream_id, uint16_t port, int max_threads = 2);
+    void Shutdown();
+
+    // Logs, per stream, the latency of the round trips to Core and the number of failed calls.
+    void LogStatistics() const;
+
+private:
+    class StreamService;
+
+    std::shared_ptr<grpc::Channel> channel;
+    std::unique_ptr<physiology::Physiology::Stub> stub;
+    mutable std::mutex streams_mutex;
+    std::vector<std::unique_ptr<StreamService>> streams;
+    std::vector<std::unique_ptr<grpc::Server>> servers;
+};
+
+} // namespace presage::smartspectra::examples
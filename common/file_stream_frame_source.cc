@@ -0,0 +1,247 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <chrono>
+
+// third-party includes
+#include <opencv2/imgcodecs.hpp>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/file_stream_frame_source.hpp"
+#include "common/status_macros.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+constexpr int kWatcherTimeoutMs = 100;
+constexpr uint64_t kStatisticsLogIntervalFrames = 300;
+} // anonymous namespace
+
+FileStreamFrameSource::FileStreamFrameSource(
+    std::unique_ptr<FrameFileWatcher> watcher,
+    FileStreamFrameSourceSettings settings
+) : watcher(std::move(watcher)), settings(settings) {
+    if (settings.pipeline_metrics != nullptr) {
+        decode_histogram = &settings.pipeline_metrics->GetHistogram(
+            "frame_decode", "Time to read and decode a frame file."
+        );
+        ready_frame_gauge = &settings.pipeline_metrics->GetGauge(
+            "prefetch_ready_frames", "Decoded frames waiting to be picked up, as of the last frame picked up."
+        );
+    }
+}
+
+FileStreamFrameSource::~FileStreamFrameSource() {
+    stop_requested = true;
+    {
+        std::lock_guard<std::mutex> lock(prefetch_mutex);
+        slot_queued.notify_all();
+        slot_freed.notify_all();
+    }
+    if (dispatcher.joinable()) {
+        dispatcher.join();
+    }
+    for (auto& decoder: decoders) {
+        decoder.join();
+    }
+}
+
+absl::Status FileStreamFrameSource::Initialize() {
+    if (settings.decode_threads > 0 && settings.prefetch_depth < 1) {
+        return absl::InvalidArgumentError("Prefetch depth must be at least 1 when decoding on worker threads.");
+    }
+    if (settings.decode_threads > 0) {
+        dispatcher = std::thread(&FileStreamFrameSource::DispatchFrameFiles, this);
+        for (int i_thread = 0; i_thread < settings.decode_threads; i_thread++) {
+            decoders.emplace_back(&FileStreamFrameSource::DecodeFrameFiles, this);
+        }
+    }
+    return absl::OkStatus();
+}
+
+absl::StatusOr<std::optional<FrameFile>> FileStreamFrameSource::NextFrameFile() {
+    std::vector<FrameFile> ready;
+    while (pending_frame_files.empty()) {
+        if (end_of_stream_seen) {
+            return std::optional<FrameFile>();
+        }
+        if (stop_requested) {
+            return absl::CancelledError("Frame source is shutting down.");
+        }
+        ready.clear();
+        MP_RETURN_IF_ERROR(watcher->Wait(kWatcherTimeoutMs, ready));
+        for (auto& frame_file: ready) {
+            if (frame_file.end_of_stream) {
+                end_of_stream_seen = true;
+            } else if (frame_file.timestamp_us > last_dispatched_timestamp_us) {
+                pending_frame_files.emplace(frame_file.timestamp_us, std::move(frame_file.path));
+            } else {
+                VLOG(1) << "Skipping frame file " << frame_file.path.string()
+                        << ", which arrived after a more recent frame was already read.";
+            }
+        }
+    }
+    auto first = pending_frame_files.begin();
+    FrameFile frame_file{std::move(first->second), first->first, /*end_of_stream=*/false};
+    pending_frame_files.erase(first);
+    last_dispatched_timestamp_us = frame_file.timestamp_us;
+    return std::optional<FrameFile>(std::move(frame_file));
+}
+
+cv::Mat FileStreamFrameSource::ReadFrameFile(const FrameFile& frame_file) const {
+    const auto start = std::chrono::steady_clock::now();
+    cv::Mat image = cv::imread(frame_file.path.string(), cv::IMREAD_COLOR);
+    if (decode_histogram != nullptr) {
+        decode_histogram->Record(std::chrono::steady_clock::now() - start);
+    }
+    if (settings.erase_read_files) {
+        std::error_code error;
+        std::filesystem::remove(frame_file.path, error);
+    }
+    if (image.empty()) {
+        LOG(WARNING) << "Could not decode frame file " << frame_file.path.string() << ", skipping it.";
+    }
+    return image;
+}
+
+absl::StatusOr<bool> FileStreamFrameSource::Next(TimestampedFrame& frame) {
+    if (settings.decode_threads > 0) {
+        return NextPrefetched(frame);
+    }
+    while (true) {
+        auto frame_file_or_status = NextFrameFile();
+        if (!frame_file_or_status.ok()) {
+            return frame_file_or_status.status();
+        }
+        if (!frame_file_or_status->has_value()) {
+            return false;
+        }
+        const FrameFile& frame_file = frame_file_or_status->value();
+        frame.image = ReadFrameFile(frame_file);
+        frame.timestamp_us = frame_file.timestamp_us;
+        if (!frame.image.empty()) {
+            return true;
+        }
+    }
+}
+
+// region ====================================== Prefetching ===========================================================
+void FileStreamFrameSource::DispatchFrameFiles() {
+    absl::Status status;
+    while (!stop_requested) {
+        {
+            std::unique_lock<std::mutex> lock(prefetch_mutex);
+            slot_freed.wait(lock, [this] {
+                return stop_requested || prefetch_slots.size() < static_cast<size_t>(settings.prefetch_depth);
+            });
+            if (stop_requested) {
+                break;
+            }
+        }
+        // the watcher and pending frame files are only ever touched by this thread once prefetching is on
+        auto frame_file_or_status = NextFrameFile();
+        if (!frame_file_or_status.ok()) {
+            status = frame_file_or_status.status();
+            break;
+        }
+        if (!frame_file_or_status->has_value()) {
+            break;
+        }
+        std::lock_guard<std::mutex> lock(prefetch_mutex);
+        prefetch_slots.push_back(PrefetchSlot{std::move(frame_file_or_status->value()), SlotState::Queued, cv::Mat()});
+        slot_queued.notify_one();
+    }
+    std::lock_guard<std::mutex> lock(prefetch_mutex);
+    dispatch_finished = true;
+    dispatch_status = status;
+    slot_queued.notify_all();
+    slot_decoded.notify_all();
+}
+
+void FileStreamFrameSource::DecodeFrameFiles() {
+    std::unique_lock<std::mutex> lock(prefetch_mutex);
+    while (true) {
+        auto queued_slot = prefetch_slots.end();
+        slot_queued.wait(lock, [this, &queued_slot] {
+            queued_slot = std::find_if(prefetch_slots.begin(), prefetch_slots.end(), [](const PrefetchSlot& slot) {
+                return slot.state == SlotState::Queued;
+            });
+            return stop_requested || dispatch_finished || queued_slot != prefetch_slots.end();
+        });
+        if (stop_requested || queued_slot == prefetch_slots.end()) {
+            return;
+        }
+        // references to deque elements survive insertions and removals at either end,
+        // and a slot is only removed by the consumer after it has been decoded
+        PrefetchSlot& slot = *queued_slot;
+        slot.state = SlotState::Decoding;
+        lock.unlock();
+        cv::Mat image = ReadFrameFile(slot.frame_file);
+        lock.lock();
+        slot.image = std::move(image);
+        slot.state = SlotState::Decoded;
+        slot_decoded.notify_all();
+    }
+}
+
+absl::StatusOr<bool> FileStreamFrameSource::NextPrefetched(TimestampedFrame& frame) {
+    std::unique_lock<std::mutex> lock(prefetch_mutex);
+    while (true) {
+        auto ready_frame_count = static_cast<int>(std::count_if(
+            prefetch_slots.begin(), prefetch_slots.end(),
+            [](const PrefetchSlot& slot) { return slot.state == SlotState::Decoded; }
+        ));
+        bool next_frame_ready = !prefetch_slots.empty() && prefetch_slots.front().state == SlotState::Decoded;
+        if (!next_frame_ready) {
+            if (prefetch_slots.empty() && dispatch_finished) {
+                if (!dispatch_status.ok()) {
+                    return dispatch_status;
+                }
+                return false;
+            }
+            statistics.underrun_count++;
+            slot_decoded.wait(lock, [this] {
+                return (!prefetch_slots.empty() && prefetch_slots.front().state == SlotState::Decoded) ||
+                       (prefetch_slots.empty() && dispatch_finished);
+            });
+            continue;
+        }
+
+        PrefetchSlot slot = std::move(prefetch_slots.front());
+        prefetch_slots.pop_front();
+        slot_freed.notify_one();
+        if (slot.image.empty()) {
+            continue;
+        }
+        frame.image = std::move(slot.image);
+        frame.timestamp_us = slot.frame_file.timestamp_us;
+
+        statistics.delivered_frame_count++;
+        ready_frame_count_sum += ready_frame_count;
+        if (ready_frame_gauge != nullptr) {
+            ready_frame_gauge->store(ready_frame_count, std::memory_order_relaxed);
+        }
+        statistics.max_ready_frame_count = std::max(statistics.max_ready_frame_count, ready_frame_count);
+        statistics.mean_ready_frame_count = static_cast<double>(ready_frame_count_sum) /
+                                            static_cast<double>(statistics.delivered_frame_count);
+        if (statistics.delivered_frame_count % kStatisticsLogIntervalFrames == 0) {
+            LOG(INFO) << "Frame prefetch queue: " << ready_frame_count << "/" << settings.prefetch_depth
+                      << " frames ready (mean " << statistics.mean_ready_frame_count << ", max "
+                      << statistics.max_ready_frame_count << "), " << statistics.underrun_count
+                      << " underruns over " << statistics.delivered_frame_count << " frames.";
+        }
+        return true;
+    }
+}
+
+PrefetchStatistics FileStreamFrameSource::GetPrefetchStatistics() const {
+    std::lock_guard<std::mutex> lock(prefetch_mutex);
+    return statistics;
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
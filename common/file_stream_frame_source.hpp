@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// local includes
+#include "common/file_stream_watcher.hpp"
+#include "common/frame_source.hpp"
+#include "common/pipeline_metrics.hpp"
+
+namespace presage::smartspectra::examples {
+
+struct FileStreamFrameSourceSettings {
+    bool erase_read_files = true;
+    // Number of worker threads reading & decoding upcoming frame files ahead of time.
+    // When 0, each frame file is read and decoded on the thread calling Next().
+    int decode_threads = 0;
+    // Maximum number of frame files being decoded or waiting (decoded) to be picked up by Next().
+    int prefetch_depth = 8;
+    // When set, frame file decoding times and the prefetch queue occupancy are recorded there as well.
+    PipelineMetrics* pipeline_metrics = nullptr;
+};
+
+struct PrefetchStatistics {
+    uint64_t delivered_frame_count = 0;
+    // number of Next() calls that found the next frame not decoded yet
+    uint64_t underrun_count = 0;
+    // queue occupancy, i.e. decoded frames ready to be picked up, as seen by Next() calls
+    double mean_ready_frame_count = 0.0;
+    int max_ready_frame_count = 0;
+};
+
+// Reads and decodes frame image files (in timestamp order) that a FrameFileWatcher reports, following the same
+// input contract as the SDK's file stream mode: the stream ends once the end-of-stream token file shows up
+// and all frames before it have been read. The watcher passed in should already be started.
+class FileStreamFrameSource : public FrameSource {
+public:
+    FileStreamFrameSource(std::unique_ptr<FrameFileWatcher> watcher, FileStreamFrameSourceSettings settings);
+    ~FileStreamFrameSource() override;
+
+    FileStreamFrameSource(const FileStreamFrameSource&) = delete;
+    FileStreamFrameSource& operator=(const FileStreamFrameSource&) = delete;
+
+    absl::Status Initialize() override;
+    absl::StatusOr<bool> Next(TimestampedFrame& frame) override;
+
+    PrefetchStatistics GetPrefetchStatistics() const;
+
+private:
+    enum class SlotState { Queued, Decoding, Decoded };
+
+    // Entry of the reorder buffer. Slots are queued in timestamp order, but may finish decoding in any order.
+    struct PrefetchSlot {
+        FrameFile frame_file;
+        SlotState state = SlotState::Queued;
+        cv::Mat image;
+    };
+
+    // Returns the next frame file to read (or nullopt at end of stream), waiting for the watcher as needed.
+    absl::StatusOr<std::optional<FrameFile>> NextFrameFile();
+    cv::Mat ReadFrameFile(const FrameFile& frame_file) const;
+
+    absl::StatusOr<bool> NextPrefetched(TimestampedFrame& frame);
+    void DispatchFrameFiles();
+    void DecodeFrameFiles();
+
+    std::unique_ptr<FrameFileWatcher> watcher;
+    const FileStreamFrameSourceSettings settings;
+    std::map<int64_t, std::filesystem::path> pending_frame_files;
+    int64_t last_dispatched_timestamp_us = -1;
+    bool end_of_stream_seen = false;
+
+    // prefetching state, used only when settings.decode_threads > 0
+    std::deque<PrefetchSlot> prefetch_slots;
+    mutable std::mutex prefetch_mutex;
+    // signalled when a slot is queued, dispatch finishes, or a stop is requested
+    std::condition_variable slot_queued;
+    // signalled when a slot is decoded or dispatch finishes
+    std::condition_variable slot_decoded;
+    // signalled when the consumer frees up a slot, or a stop is requested
+    std::condition_variable slot_freed;
+    bool dispatch_finished = false;
+    absl::Status dispatch_status;
+    std::atomic<bool> stop_requested{false};
+    std::thread dispatcher;
+    std::vector<std::thread> decoders;
+    PrefetchStatistics statistics;
+    uint64_t ready_frame_count_sum = 0;
+
+    // from settings.pipeline_metrics, if set
+    LatencyHistogram* decode_histogram = nullptr;
+    std::atomic<int64_t>* ready_frame_gauge = nullptr;
+};
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,252 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// third-party includes
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/file_stream_watcher.hpp"
+#include "common/status_macros.hpp"
+
+namespace presage::smartspectra::examples {
+
+// region ==================================== FileStreamPattern ======================================================
+absl::StatusOr<FileStreamPattern> FileStreamPattern::Parse(const std::filesystem::path& file_stream_path) {
+    if (!file_stream_path.has_extension()) {
+        return absl::InvalidArgumentError(
+            "File stream path " + file_stream_path.string() + " is missing a file extension."
+        );
+    }
+    const std::string stem = file_stream_path.stem().string();
+    const size_t digits_end = stem.find_last_of("0123456789");
+    if (digits_end == std::string::npos) {
+        return absl::InvalidArgumentError(
+            "File stream path " + file_stream_path.string() + " has no zero-padded timestamp in its file name."
+        );
+    }
+    size_t digits_begin = digits_end;
+    while (digits_begin > 0 && std::isdigit(static_cast<unsigned char>(stem[digits_begin - 1]))) {
+        digits_begin--;
+    }
+
+    FileStreamPattern pattern;
+    pattern.directory = file_stream_path.has_parent_path() ? file_stream_path.parent_path() : ".";
+    pattern.prefix = stem.substr(0, digits_begin);
+    pattern.timestamp_digit_count = digits_end - digits_begin + 1;
+    pattern.postfix_and_extension = stem.substr(digits_end + 1) + file_stream_path.extension().string();
+    return pattern;
+}
+
+std::optional<int64_t> FileStreamPattern::MatchTimestamp(const std::string& file_name) const {
+    if (file_name.size() != prefix.size() + timestamp_digit_count + postfix_and_extension.size() ||
+        file_name.compare(0, prefix.size(), prefix) != 0 ||
+        file_name.compare(file_name.size() - postfix_and_extension.size(), std::string::npos,
+                          postfix_and_extension) != 0) {
+        return std::nullopt;
+    }
+    int64_t timestamp_us = 0;
+    for (size_t i_char = prefix.size(); i_char < prefix.size() + timestamp_digit_count; i_char++) {
+        const char character = file_name[i_char];
+        if (!std::isdigit(static_cast<unsigned char>(character))) {
+            return std::nullopt;
+        }
+        timestamp_us = timestamp_us * 10 + (character - '0');
+    }
+    return timestamp_us;
+}
+
+std::filesystem::path FileStreamPattern::FramePath(int64_t timestamp_us) const {
+    std::stringstream file_name;
+    file_name << prefix << std::setw(static_cast<int>(timestamp_digit_count)) << std::setfill('0') << timestamp_us
+              << postfix_and_extension;
+    return directory / file_name.str();
+}
+// endregion ===========================================================================================================
+
+// region ================================== PollingFrameFileWatcher ===================================================
+PollingFrameFileWatcher::PollingFrameFileWatcher(
+    FileStreamPattern pattern,
+    std::string end_of_stream_file_name,
+    int rescan_delay_ms
+) : pattern(std::move(pattern)),
+    end_of_stream_file_name(std::move(end_of_stream_file_name)),
+    rescan_delay_ms(rescan_delay_ms) {}
+
+absl::Status PollingFrameFileWatcher::Start() {
+    if (!std::filesystem::is_directory(pattern.directory)) {
+        return absl::NotFoundError("File stream folder " + pattern.directory.string() + " does not exist.");
+    }
+    return absl::OkStatus();
+}
+
+absl::Status PollingFrameFileWatcher::Scan(std::vector<FrameFile>& ready) {
+    std::error_code error;
+    int64_t newest_found_timestamp_us = newest_reported_timestamp_us;
+    for (const auto& entry: std::filesystem::directory_iterator(pattern.directory, error)) {
+        const std::string file_name = entry.path().filename().string();
+        if (file_name == end_of_stream_file_name) {
+            if (!end_of_stream_reported) {
+                ready.push_back(FrameFile{entry.path(), 0, /*end_of_stream=*/true});
+                end_of_stream_reported = true;
+            }
+            continue;
+        }
+        auto timestamp_us = pattern.MatchTimestamp(file_name);
+        if (timestamp_us.has_value() && timestamp_us.value() > newest_reported_timestamp_us) {
+            ready.push_back(FrameFile{entry.path(), timestamp_us.value(), /*end_of_stream=*/false});
+            newest_found_timestamp_us = std::max(newest_found_timestamp_us, timestamp_us.value());
+        }
+    }
+    if (error) {
+        return absl::InternalError(
+            "Could not list file stream folder " + pattern.directory.string() + ": " + error.message()
+        );
+    }
+    newest_reported_timestamp_us = newest_found_timestamp_us;
+    return absl::OkStatus();
+}
+
+absl::Status PollingFrameFileWatcher::Wait(int timeout_ms, std::vector<FrameFile>& ready) {
+    const size_t initial_ready_count = ready.size();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        MP_RETURN_IF_ERROR(Scan(ready));
+        if (ready.size() > initial_ready_count || std::chrono::steady_clock::now() >= deadline) {
+            return absl::OkStatus();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(rescan_delay_ms));
+    }
+}
+// endregion ===========================================================================================================
+
+// region ================================== InotifyFrameFileWatcher ===================================================
+InotifyFrameFileWatcher::InotifyFrameFileWatcher(FileStreamPattern pattern, std::string end_of_stream_file_name)
+    : pattern(std::move(pattern)), end_of_stream_file_name(std::move(end_of_stream_file_name)) {}
+
+InotifyFrameFileWatcher::~InotifyFrameFileWatcher() {
+#ifdef __linux__
+    if (inotify_fd >= 0) {
+        close(inotify_fd);
+    }
+#endif
+}
+
+bool InotifyFrameFileWatcher::IsSupported() {
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+void InotifyFrameFileWatcher::AddIfMatching(const std::string& file_name, std::vector<FrameFile>& ready) const {
+    if (file_name == end_of_stream_file_name) {
+        ready.push_back(FrameFile{pattern.directory / file_name, 0, /*end_of_stream=*/true});
+        return;
+    }
+    auto timestamp_us = pattern.MatchTimestamp(file_name);
+    if (timestamp_us.has_value()) {
+        ready.push_back(FrameFile{pattern.directory / file_name, timestamp_us.value(), /*end_of_stream=*/false});
+    }
+}
+
+void InotifyFrameFileWatcher::ListFolder(std::vector<FrameFile>& ready) const {
+    std::error_code error;
+    for (const auto& entry: std::filesystem::directory_iterator(pattern.directory, error)) {
+        AddIfMatching(entry.path().filename().string(), ready);
+    }
+    if (error) {
+        LOG(WARNING) << "Could not list file stream folder " << pattern.directory.string() << ": " << error.message();
+    }
+}
+
+absl::Status InotifyFrameFileWatcher::Start() {
+#ifdef __linux__
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd < 0) {
+        return absl::UnavailableError(absl::StrCat("inotify_init1 failed: ", std::strerror(errno)));
+    }
+    watch_descriptor = inotify_add_watch(inotify_fd, pattern.directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watch_descriptor < 0) {
+        return absl::UnavailableError(absl::StrCat(
+            "Could not watch file stream folder ", pattern.directory.string(), ": ", std::strerror(errno)
+        ));
+    }
+    // Frames already in the folder will produce no events. The watch is added before listing, so nothing written
+    // in between is missed (at worst, some files get reported twice).
+    ListFolder(pending_initial_listing);
+    return absl::OkStatus();
+#else
+    return absl::UnavailableError("inotify is only available on Linux.");
+#endif
+}
+
+absl::Status InotifyFrameFileWatcher::Wait(int timeout_ms, std::vector<FrameFile>& ready) {
+#ifdef __linux__
+    if (!pending_initial_listing.empty()) {
+        ready.insert(ready.end(), pending_initial_listing.begin(), pending_initial_listing.end());
+        pending_initial_listing.clear();
+        return absl::OkStatus();
+    }
+
+    pollfd poll_descriptor{inotify_fd, POLLIN, 0};
+    int poll_result = poll(&poll_descriptor, 1, timeout_ms);
+    if (poll_result < 0) {
+        if (errno == EINTR) {
+            return absl::OkStatus();
+        }
+        return absl::InternalError(absl::StrCat("Polling inotify descriptor failed: ", std::strerror(errno)));
+    }
+    if (poll_result == 0) {
+        return absl::OkStatus();
+    }
+
+    alignas(inotify_event) char buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+    while (true) {
+        ssize_t length = read(inotify_fd, buffer, sizeof(buffer));
+        if (length < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                return absl::OkStatus();
+            }
+            return absl::InternalError(absl::StrCat("Reading inotify events failed: ", std::strerror(errno)));
+        }
+        for (char* pointer = buffer; pointer < buffer + length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(pointer);
+            if (event->mask & IN_Q_OVERFLOW) {
+                LOG(WARNING) << "inotify event queue overflowed, re-listing the file stream folder.";
+                ListFolder(ready);
+            } else if (event->mask & IN_IGNORED) {
+                return absl::NotFoundError(
+                    "File stream folder " + pattern.directory.string() + " was removed while being watched."
+                );
+            } else if (event->len > 0 && !(event->mask & IN_ISDIR)) {
+                AddIfMatching(event->name, ready);
+            }
+            pointer += sizeof(inotify_event) + event->len;
+        }
+    }
+#else
+    return absl::UnavailableError("inotify is only available on Linux.");
+#endif
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
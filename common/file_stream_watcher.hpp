@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+// third-party includes
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/status/statusor.h>
+
+namespace presage::smartspectra::examples {
+
+// Frame file naming scheme of a file stream, parsed from a `--file_stream_path` value such as
+// "/path/to/files/frame_0000000000000.png": non-digit prefix, zero-padded microsecond timestamp, non-digit postfix,
+// and the (mandatory) extension.
+struct FileStreamPattern {
+    std::filesystem::path directory;
+    std::string prefix;
+    size_t timestamp_digit_count = 0;
+    std::string postfix_and_extension;
+
+    static absl::StatusOr<FileStreamPattern> Parse(const std::filesystem::path& file_stream_path);
+
+    // Returns the frame timestamp (in microseconds) if `file_name` follows the pattern.
+    std::optional<int64_t> MatchTimestamp(const std::string& file_name) const;
+
+    std::filesystem::path FramePath(int64_t timestamp_us) const;
+};
+
+struct FrameFile {
+    std::filesystem::path path;
+    int64_t timestamp_us = 0;
+    bool end_of_stream = false;
+};
+
+// Reports frame files (and the end-of-stream token) that a producer finished writing into the file stream folder.
+class FrameFileWatcher {
+public:
+    virtual ~FrameFileWatcher() = default;
+
+    virtual absl::Status Start() = 0;
+
+    // Waits up to `timeout_ms` for new frame files and appends whatever shows up to `ready`, in no particular order.
+    // A file may be reported more than once (e.g. when the folder has to be re-listed), so callers should de-duplicate.
+    virtual absl::Status Wait(int timeout_ms, std::vector<FrameFile>& ready) = 0;
+};
+
+// Re-lists the folder every `rescan_delay_ms`, which is what the SDK's own file stream source does. Listing cost
+// grows with the number of files in the folder. Only frames newer than the newest one already reported are reported.
+class PollingFrameFileWatcher : public FrameFileWatcher {
+public:
+    PollingFrameFileWatcher(FileStreamPattern pattern, std::string end_of_stream_file_name, int rescan_delay_ms);
+
+    absl::Status Start() override;
+    absl::Status Wait(int timeout_ms, std::vector<FrameFile>& ready) override;
+
+private:
+    absl::Status Scan(std::vector<FrameFile>& ready);
+
+    FileStreamPattern pattern;
+    std::string end_of_stream_file_name;
+    int rescan_delay_ms;
+    int64_t newest_reported_timestamp_us = -1;
+    bool end_of_stream_reported = false;
+};
+
+// Linux-only: gets IN_CLOSE_WRITE / IN_MOVED_TO events from the kernel for the file stream folder, so frames are
+// reported as soon as the writer closes them (or renames them in), at no cost for folder size.
+class InotifyFrameFileWatcher : public FrameFileWatcher {
+public:
+    InotifyFrameFileWatcher(FileStreamPattern pattern, std::string end_of_stream_file_name);
+    ~InotifyFrameFileWatcher() override;
+
+    InotifyFrameFileWatcher(const InotifyFrameFileWatcher&) = delete;
+    InotifyFrameFileWatcher& operator=(const InotifyFrameFileWatcher&) = delete;
+
+    // Returns Unavailable status if inotify cannot be used for the folder, so the caller can fall back to polling.
+    absl::Status Start() override;
+    absl::Status Wait(int timeout_ms, std::vector<FrameFile>& ready) override;
+
+    static bool IsSupported();
+
+private:
+    void ListFolder(std::vector<FrameFile>& ready) const;
+    void AddIfMatching(const std::string& file_name, std::vector<FrameFile>& ready) const;
+
+    FileStreamPattern pattern;
+    std::string end_of_stream_file_name;
+    int inotify_fd = -1;
+    int watch_descriptor = -1;
+    std::vector<FrameFile> pending_initial_listing;
+};
+
+} // namespace presage::smartspectra::examples
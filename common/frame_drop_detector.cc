@@ -0,0 +1,50 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <cmath>
+
+// local includes
+#include "common/frame_drop_detector.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+// number of recent timestamp differences to take the input frame interval from
+constexpr size_t kFrameIntervalWindow = 60;
+// gaps between timestamps longer than this many frame intervals mean that frames were dropped
+constexpr double kDroppedFrameGapRatio = 1.5;
+constexpr double kDefaultFrameIntervalMs = 1000.0 / 30.0;
+} // anonymous namespace
+
+int64_t FrameDropDetector::OnFrame(int64_t timestamp_us) {
+    int64_t dropped = 0;
+    if (last_timestamp_us >= 0 && timestamp_us > last_timestamp_us) {
+        const int64_t interval_us = timestamp_us - last_timestamp_us;
+        // judge the gap against the interval seen so far, before it can take part in it
+        if (!recent_intervals_us.empty()) {
+            const double frame_interval_us = GetFrameIntervalMs() * 1000.0;
+            if (static_cast<double>(interval_us) > kDroppedFrameGapRatio * frame_interval_us) {
+                dropped = std::llround(static_cast<double>(interval_us) / frame_interval_us) - 1;
+            }
+        }
+        recent_intervals_us.push_back(interval_us);
+        if (recent_intervals_us.size() > kFrameIntervalWindow) {
+            recent_intervals_us.pop_front();
+        }
+    }
+    last_timestamp_us = timestamp_us;
+    dropped_count += dropped;
+    return dropped;
+}
+
+double FrameDropDetector::GetFrameIntervalMs() const {
+    if (recent_intervals_us.empty()) {
+        return kDefaultFrameIntervalMs;
+    }
+    return static_cast<double>(*std::min_element(recent_intervals_us.begin(), recent_intervals_us.end())) / 1000.0;
+}
+
+} // namespace presage::smartspectra::examples
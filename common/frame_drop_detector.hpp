@@ -0,0 +1,32 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <cstdint>
+#include <deque>
+
+namespace presage::smartspectra::examples {
+
+// Tells apart input frames that were dropped before they could be read by the gaps they leave in the timestamps of
+// the frames that were read: a gap of more than 1.5 input frame intervals (the smallest gap among recent frames)
+// means that frames were missed.
+class FrameDropDetector {
+public:
+    // Returns the number of frames dropped right before the frame with the given timestamp, in microseconds.
+    int64_t OnFrame(int64_t timestamp_us);
+
+    // Input frame interval, assumed to be 1/30 s until known.
+    double GetFrameIntervalMs() const;
+    int64_t GetDroppedCount() const { return dropped_count; }
+
+private:
+    int64_t last_timestamp_us = -1;
+    // recent timestamp differences, the smallest of which is taken for the input frame interval
+    std::deque<int64_t> recent_intervals_us;
+    int64_t dropped_count = 0;
+};
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,36 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <cstdint>
+
+// third-party includes
+#include <opencv2/core/mat.hpp>
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/status/statusor.h>
+
+namespace presage::smartspectra::examples {
+
+struct TimestampedFrame {
+    cv::Mat image;
+    // frame capture time, in whole microseconds
+    int64_t timestamp_us = 0;
+};
+
+// Pull-based producer of BGR frames that the examples own (as opposed to the SDK's built-in camera, video file, and
+// file stream sources). Use FrameSourceContainer (see frame_source_container.hpp) to hand one to a container.
+class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+
+    virtual absl::Status Initialize() = 0;
+
+    // Blocks until the next frame is available and stores it in `frame`.
+    // Returns false once the stream has ended, i.e. when there will be no more frames.
+    virtual absl::StatusOr<bool> Next(TimestampedFrame& frame) = 0;
+};
+
+} // namespace presage::smartspectra::examples
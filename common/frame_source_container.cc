@@ -0,0 +1,70 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// third-party includes
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/frame_source_container.hpp"
+
+namespace presage::smartspectra::examples {
+
+FrameSourceVideoSource::FrameSourceVideoSource(std::unique_ptr<FrameSource> frame_source)
+    : frame_source(std::move(frame_source)) {}
+
+absl::Status FrameSourceVideoSource::Initialize(const video_source::VideoSourceSettings& /*settings*/) {
+    if (frame_source == nullptr) {
+        return absl::FailedPreconditionError("Frame source is missing or was already used.");
+    }
+    MP_RETURN_IF_ERROR(frame_source->Initialize());
+    // peek at the first frame to learn the input dimensions, which the graph needs before it starts
+    auto has_frame_or_status = frame_source->Next(current_frame);
+    if (!has_frame_or_status.ok()) {
+        return has_frame_or_status.status();
+    }
+    if (!has_frame_or_status.value()) {
+        return absl::OutOfRangeError("Frame source ended before producing a single frame.");
+    }
+    width = current_frame.image.cols;
+    height = current_frame.image.rows;
+    return absl::OkStatus();
+}
+
+bool FrameSourceVideoSource::SupportsExactFrameTimestamp() const {
+    return true;
+}
+
+int64_t FrameSourceVideoSource::GetFrameTimestamp() const {
+    return current_frame.timestamp_us;
+}
+
+int FrameSourceVideoSource::GetWidth() {
+    return width;
+}
+
+int FrameSourceVideoSource::GetHeight() {
+    return height;
+}
+
+video_source::VideoSource& FrameSourceVideoSource::operator>>(cv::Mat& frame) {
+    if (!current_frame.image.empty()) {
+        // first frame, already read during initialization
+        frame = std::move(current_frame.image);
+        current_frame.image = cv::Mat();
+        return *this;
+    }
+    auto has_frame_or_status = frame_source->Next(current_frame);
+    if (!has_frame_or_status.ok()) {
+        LOG(ERROR) << "Failed to read frame: " << has_frame_or_status.status().message();
+        frame = cv::Mat();
+    } else if (!has_frame_or_status.value()) {
+        frame = cv::Mat();
+    } else {
+        frame = std::move(current_frame.image);
+        current_frame.image = cv::Mat();
+    }
+    return *this;
+}
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <memory>
+#include <utility>
+
+// third-party includes
+#include <physiology/interface/absl/status/status.h>
+#include <smartspectra/video_source/video_source.hpp>
+
+// local includes
+#include "common/frame_source.hpp"
+#include "common/status_macros.hpp"
+
+namespace presage::smartspectra::examples {
+
+// Exposes a FrameSource through the SDK video source interface.
+// An empty frame is handed out once the underlying source has ended (or failed), same as the built-in sources do.
+class FrameSourceVideoSource : public video_source::VideoSource {
+public:
+    explicit FrameSourceVideoSource(std::unique_ptr<FrameSource> frame_source);
+
+    absl::Status Initialize(const video_source::VideoSourceSettings& settings) override;
+    bool SupportsExactFrameTimestamp() const override;
+    int64_t GetFrameTimestamp() const override;
+    int GetWidth() override;
+    int GetHeight() override;
+    video_source::VideoSource& operator>>(cv::Mat& frame) override;
+
+private:
+    std::unique_ptr<FrameSource> frame_source;
+    TimestampedFrame current_frame;
+    int width = 0;
+    int height = 0;
+};
+
+// Foreground container that reads its input from a FrameSource owned by the example instead of the video source
+// the SDK would build from `settings.video_source`, so the settings need not point at any camera, video, or file stream.
+template<typename TContainer>
+class FrameSourceContainer : public TContainer {
+public:
+    template<typename TSettings>
+    FrameSourceContainer(TSettings& settings, std::unique_ptr<FrameSource> frame_source)
+        : TContainer(settings), frame_source(std::move(frame_source)) {}
+
+protected:
+    absl::Status InitializeVideoSource() override {
+        auto source = std::make_unique<FrameSourceVideoSource>(std::move(this->frame_source));
+        MP_RETURN_IF_ERROR(source->Initialize(this->settings.video_source));
+        this->video_source = std::move(source);
+        return absl::OkStatus();
+    }
+
+private:
+    std::unique_ptr<FrameSource> frame_source;
+};
+
+} // namespace presage::smartspectra::examples
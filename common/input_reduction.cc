@@ -0,0 +1,177 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+// third-party includes
+#include <opencv2/imgproc.hpp>
+#include <physiology/interface/absl/strings/numbers.h>
+#include <physiology/interface/absl/strings/str_format.h>
+#include <physiology/interface/absl/strings/str_split.h>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/input_reduction.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+double ToMegabytes(const cv::Size& size) {
+    return static_cast<double>(size.area()) * 3 / 1e6;
+}
+} // anonymous namespace
+
+// region ========================================= InputReducer =====================================================
+InputReducer::InputReducer(InputReductionSettings settings) : settings(settings) {
+    if (settings.pipeline_metrics != nullptr) {
+        pipeline_reduction_histogram = &settings.pipeline_metrics->GetHistogram(
+            "input_reduction", "Time spent cropping and downsampling each input frame before it enters the graph."
+        );
+    }
+}
+
+absl::Status InputReducer::Initialize(const cv::Size& input_size) {
+    if (input_size.width <= 0 || input_size.height <= 0) {
+        return absl::FailedPreconditionError("Input frame size is not known, cannot set up input reduction.");
+    }
+    cv::Rect region(cv::Point(0, 0), input_size);
+    if (!settings.region_of_interest.empty()) {
+        region &= settings.region_of_interest;
+        if (region.empty()) {
+            return absl::InvalidArgumentError(absl::StrFormat(
+                "Region of interest %dx%d+%d+%d lies outside of the %dx%d input frames.",
+                settings.region_of_interest.width, settings.region_of_interest.height,
+                settings.region_of_interest.x, settings.region_of_interest.y, input_size.width, input_size.height
+            ));
+        }
+    }
+    double scale = 1.0;
+    if (settings.max_width > 0) {
+        scale = std::min(scale, static_cast<double>(settings.max_width) / region.width);
+    }
+    if (settings.max_height > 0) {
+        scale = std::min(scale, static_cast<double>(settings.max_height) / region.height);
+    }
+    const cv::Size output_size(
+        std::max(1, static_cast<int>(std::lround(region.width * scale))),
+        std::max(1, static_cast<int>(std::lround(region.height * scale)))
+    );
+    {
+        std::lock_guard<std::mutex> lock(geometry_mutex);
+        geometry = InputGeometry{input_size, region, scale, output_size};
+    }
+    LOG(INFO) << "Input frames reduced to " << output_size.width << "x" << output_size.height << ": region "
+              << region.width << "x" << region.height << "+" << region.x << "+" << region.y << " of the "
+              << input_size.width << "x" << input_size.height << " input, scaled by " << scale << ".";
+    return absl::OkStatus();
+}
+
+void InputReducer::Reduce(const cv::Mat& input, cv::Mat& output) {
+    const auto start = std::chrono::steady_clock::now();
+    const InputGeometry current_geometry = GetGeometry();
+    cv::Mat region;
+    if (input.size() == current_geometry.input_size) {
+        // a view, nothing is copied yet
+        region = input(current_geometry.region);
+    } else {
+        LOG_FIRST_N(WARNING, 1) << "Input frame size changed to " << input.cols << "x" << input.rows
+                                << ", scaling whole frames to the size the graph was set up for.";
+        region = input;
+    }
+    if (region.size() == current_geometry.output_size) {
+        output = region.clone();
+    } else {
+        // area interpolation is the one that does not alias when downsampling (and is vectorized in OpenCV)
+        cv::resize(region, output, current_geometry.output_size, 0, 0, cv::INTER_AREA);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    reduction_histogram.Record(elapsed);
+    if (pipeline_reduction_histogram != nullptr) {
+        pipeline_reduction_histogram->Record(elapsed);
+    }
+}
+
+InputGeometry InputReducer::GetGeometry() const {
+    std::lock_guard<std::mutex> lock(geometry_mutex);
+    return geometry;
+}
+
+std::string InputReducer::Summarize() const {
+    const InputGeometry current_geometry = GetGeometry();
+    const double input_megabytes = ToMegabytes(current_geometry.input_size);
+    const double output_megabytes = ToMegabytes(current_geometry.output_size);
+    return absl::StrFormat(
+        "%dx%d -> %dx%d frames: %.1f MB -> %.1f MB each (%.0f%% less), %.2f ms per frame to reduce (%d frames)",
+        current_geometry.input_size.width, current_geometry.input_size.height,
+        current_geometry.output_size.width, current_geometry.output_size.height,
+        input_megabytes, output_megabytes,
+        input_megabytes > 0.0 ? 100.0 * (1.0 - output_megabytes / input_megabytes) : 0.0,
+        reduction_histogram.GetMeanUs() / 1e3, reduction_histogram.GetCount()
+    );
+}
+// endregion ===========================================================================================================
+
+// region ====================================== ReducedVideoSource ==================================================
+ReducedVideoSource::ReducedVideoSource(std::unique_ptr<video_source::VideoSource> video_source, InputReducer& reducer)
+    : video_source(std::move(video_source)), reducer(reducer) {}
+
+absl::Status ReducedVideoSource::Initialize(const video_source::VideoSourceSettings& /*settings*/) {
+    // the wrapped source is initialized by the container before it gets wrapped
+    return absl::OkStatus();
+}
+
+bool ReducedVideoSource::SupportsExactFrameTimestamp() const {
+    return video_source->SupportsExactFrameTimestamp();
+}
+
+int64_t ReducedVideoSource::GetFrameTimestamp() const {
+    return video_source->GetFrameTimestamp();
+}
+
+int ReducedVideoSource::GetWidth() {
+    return reducer.GetGeometry().output_size.width;
+}
+
+int ReducedVideoSource::GetHeight() {
+    return reducer.GetGeometry().output_size.height;
+}
+
+video_source::VideoSource& ReducedVideoSource::operator>>(cv::Mat& frame) {
+    *video_source >> input_frame;
+    if (input_frame.empty()) {
+        frame = cv::Mat();
+    } else {
+        reducer.Reduce(input_frame, frame);
+    }
+    // let go of the input pixels right away, e.g. for frame sources handing out views of their own buffers
+    input_frame.release();
+    return *this;
+}
+// endregion ===========================================================================================================
+
+absl::StatusOr<cv::Rect> ParseRegionOfInterest(const std::string& text) {
+    if (text.empty()) {
+        return cv::Rect();
+    }
+    std::vector<std::string> parts = absl::StrSplit(text, ',');
+    int values[4];
+    if (parts.size() != 4) {
+        return absl::InvalidArgumentError("Expected a region of interest as <x>,<y>,<width>,<height>, got " + text);
+    }
+    for (size_t i_part = 0; i_part < parts.size(); i_part++) {
+        if (!absl::SimpleAtoi(parts[i_part], &values[i_part]) || values[i_part] < 0) {
+            return absl::InvalidArgumentError("Invalid region of interest: " + text);
+        }
+    }
+    if (values[2] == 0 || values[3] == 0) {
+        return absl::InvalidArgumentError("Region of interest is empty: " + text);
+    }
+    return cv::Rect(values[0], values[1], values[2], values[3]);
+}
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <cmath>
+
+// third-party includes
+#include <physiology/interface/absl/strings/str_format.h>
+
+// local includes
+#include "common/latency_histogram.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+constexpr size_t kSubBucketBits = LatencyHistogram::kSubBucketBits;
+constexpr uint64_t kSubBucketCount = uint64_t{1} << kSubBucketBits;
+
+size_t GetMostSignificantBit(uint64_t value) {
+    return 63 - static_cast<size_t>(__builtin_clzll(value));
+}
+
+// Index of the bucket holding `value`, for buckets that include their lower bound, e.g. [8, 10), [10, 12).
+size_t GetLowerInclusiveBucketIndex(uint64_t value) {
+    if (value < kSubBucketCount) {
+        return static_cast<size_t>(value);
+    }
+    // the top kSubBucketBits bits after the most significant one select the sub-bucket
+    const size_t most_significant_bit = GetMostSignificantBit(value);
+    const size_t sub_bucket = (value >> (most_significant_bit - kSubBucketBits)) & (kSubBucketCount - 1);
+    return ((most_significant_bit - kSubBucketBits + 1) << kSubBucketBits) + sub_bucket;
+}
+
+// Lowest value of the bucket at `index`, for buckets that include their lower bound.
+uint64_t GetLowerInclusiveBucketBound(size_t index) {
+    if (index < kSubBucketCount) {
+        return index;
+    }
+    const size_t most_significant_bit = (index >> kSubBucketBits) + kSubBucketBits - 1;
+    const uint64_t sub_bucket = index & (kSubBucketCount - 1);
+    return (kSubBucketCount | sub_bucket) << (most_significant_bit - kSubBucketBits);
+}
+} // anonymous namespace
+
+// Bucket `index` holds the values in (GetLowerInclusiveBucketBound(index), GetLowerInclusiveBucketBound(index + 1)],
+// e.g. (8, 10], (10, 12], with 0 going into bucket 0 along with 1.
+size_t LatencyHistogram::GetBucketIndex(uint64_t latency_us) {
+    return latency_us == 0 ? 0 : GetLowerInclusiveBucketIndex(latency_us - 1);
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBoundUs(size_t index) {
+    return GetLowerInclusiveBucketBound(index + 1);
+}
+
+void LatencyHistogram::Record(uint64_t latency_us) {
+    bucket_counts[GetBucketIndex(latency_us)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum_us.fetch_add(latency_us, std::memory_order_relaxed);
+    uint64_t previous_max_us = max_us.load(std::memory_order_relaxed);
+    while (latency_us > previous_max_us &&
+           !max_us.compare_exchange_weak(previous_max_us, latency_us, std::memory_order_relaxed)) {}
+}
+
+double LatencyHistogram::GetMeanUs() const {
+    const uint64_t recorded_count = GetCount();
+    return recorded_count == 0
+           ? 0.0 : static_cast<double>(sum_us.load(std::memory_order_relaxed)) / static_cast<double>(recorded_count);
+}
+
+uint64_t LatencyHistogram::GetQuantileUs(double quantile) const {
+    const uint64_t recorded_count = GetCount();
+    if (recorded_count == 0) {
+        return 0;
+    }
+    const auto rank = static_cast<uint64_t>(
+        std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(recorded_count))
+    );
+    uint64_t cumulative_count = 0;
+    for (size_t i_bucket = 0; i_bucket < kBucketCount; i_bucket++) {
+        cumulative_count += bucket_counts[i_bucket].load(std::memory_order_relaxed);
+        if (cumulative_count >= std::max<uint64_t>(rank, 1)) {
+            // never report more than what was actually seen
+            return i_bucket + 1 < kBucketCount ? std::min(GetBucketUpperBoundUs(i_bucket), GetMaxUs()) : GetMaxUs();
+        }
+    }
+    return GetMaxUs();
+}
+
+uint64_t LatencyHistogram::GetCountAtOrBelowUs(uint64_t latency_us) const {
+    uint64_t count_at_or_below = 0;
+    for (size_t i_bucket = 0; i_bucket <= GetBucketIndex(latency_us); i_bucket++) {
+        count_at_or_below += bucket_counts[i_bucket].load(std::memory_order_relaxed);
+    }
+    return count_at_or_below;
+}
+
+std::string LatencyHistogram::Summarize() const {
+    return absl::StrFormat(
+        "count=%d mean=%.1fus p50<=%dus p90<=%dus p99<=%dus max=%dus",
+        GetCount(), GetMeanUs(), GetQuantileUs(0.5), GetQuantileUs(0.9), GetQuantileUs(0.99), GetMaxUs()
+    );
+}
+
+} // namespace presage::smartspectra::examples
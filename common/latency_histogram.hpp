@@ -0,0 +1,53 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace presage::smartspectra::examples {
+
+// Log-linear histogram of latencies in microseconds (four buckets per power of two, i.e. bucket bounds within 25% of
+// the recorded values), safe to record into from any number of threads at once. Buckets include their upper bound,
+// so that every power of two is the last value of a bucket.
+class LatencyHistogram {
+public:
+    static constexpr size_t kSubBucketBits = 2;
+    static constexpr size_t kBucketCount = (64 - kSubBucketBits + 1) << kSubBucketBits;
+
+    void Record(uint64_t latency_us);
+    void Record(std::chrono::steady_clock::duration latency) {
+        Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count()));
+    }
+
+    uint64_t GetCount() const { return count.load(std::memory_order_relaxed); }
+    uint64_t GetSumUs() const { return sum_us.load(std::memory_order_relaxed); }
+    double GetMeanUs() const;
+    uint64_t GetMaxUs() const { return max_us.load(std::memory_order_relaxed); }
+    // Upper bound of the bucket holding the given quantile (0-1) of the recorded latencies (0 if none were recorded).
+    uint64_t GetQuantileUs(double quantile) const;
+    // e.g. "count=1200 mean=153.2us p50<=160us p90<=224us p99<=448us max=1021us"
+    std::string Summarize() const;
+    // Number of recorded latencies up to the upper bound of the bucket holding `latency_us` (i.e. exactly those at or
+    // below `latency_us` when it is a bucket bound, such as any power of two).
+    uint64_t GetCountAtOrBelowUs(uint64_t latency_us) const;
+
+    // Highest value of the bucket at `index` (the last bucket's is past what a uint64_t holds).
+    static uint64_t GetBucketUpperBoundUs(size_t index);
+    static size_t GetBucketIndex(uint64_t latency_us);
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> bucket_counts{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum_us{0};
+    std::atomic<uint64_t> max_us{0};
+};
+
+} // namespace presage::smartspectra::examples
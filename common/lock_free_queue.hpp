@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace presage::smartspectra::examples {
+
+// Bounded multi-producer / multi-consumer queue that never blocks and never allocates after construction
+// (D. Vyukov's array-based design). Capacity is rounded up to a power of two.
+template<typename T>
+class LockFreeBoundedQueue {
+public:
+    explicit LockFreeBoundedQueue(size_t capacity)
+        : mask(RoundUpToPowerOfTwo(capacity) - 1), cells(new Cell[mask + 1]) {
+        for (size_t i_cell = 0; i_cell <= mask; i_cell++) {
+            cells[i_cell].sequence.store(i_cell, std::memory_order_relaxed);
+        }
+    }
+
+    LockFreeBoundedQueue(const LockFreeBoundedQueue&) = delete;
+    LockFreeBoundedQueue& operator=(const LockFreeBoundedQueue&) = delete;
+
+    // Returns false (leaving `value` untouched) if the queue is full.
+    bool TryPush(T&& value) {
+        size_t position = enqueue_position.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0) {
+                if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::optional<T> TryPop() {
+        size_t position = dequeue_position.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+            if (difference == 0) {
+                if (dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    std::optional<T> value(std::move(cell.value));
+                    cell.sequence.store(position + mask + 1, std::memory_order_release);
+                    return value;
+                }
+            } else if (difference < 0) {
+                return std::nullopt;
+            } else {
+                position = dequeue_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t Capacity() const {
+        return mask + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static size_t RoundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t mask;
+    const std::unique_ptr<Cell[]> cells;
+    // kept on separate cache lines, so producers and consumers don't invalidate each other's position
+    alignas(64) std::atomic<size_t> enqueue_position{0};
+    alignas(64) std::atomic<size_t> dequeue_position{0};
+};
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,389 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <string>
+
+// third-party includes
+#include <google/protobuf/descriptor.h>
+
+// local includes
+#include "common/metric_columns.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+
+// Van Herk / Gil-Werman sliding window extremum: per-block running extrema from the left and from the right, so that
+// each window's extremum is the combination of one suffix and one prefix value. The final (dominant) pass is a
+// branch-free element-wise combination of two arrays.
+template<typename TCombine>
+std::vector<float> WindowedExtremum(const std::vector<float>& values, size_t window_size, TCombine combine) {
+    const size_t value_count = values.size();
+    if (window_size == 0 || value_count < window_size) {
+        return {};
+    }
+    std::vector<float> prefix(value_count);
+    std::vector<float> suffix(value_count);
+    for (size_t block_start = 0; block_start < value_count; block_start += window_size) {
+        const size_t block_end = std::min(block_start + window_size, value_count);
+        prefix[block_start] = values[block_start];
+        for (size_t i_value = block_start + 1; i_value < block_end; i_value++) {
+            prefix[i_value] = combine(prefix[i_value - 1], values[i_value]);
+        }
+        suffix[block_end - 1] = values[block_end - 1];
+        for (size_t i_value = block_end - 1; i_value > block_start; i_value--) {
+            suffix[i_value - 1] = combine(suffix[i_value], values[i_value - 1]);
+        }
+    }
+    const size_t window_count = value_count - window_size + 1;
+    std::vector<float> extrema(window_count);
+    const float* __restrict suffix_data = suffix.data();
+    const float* __restrict prefix_data = prefix.data() + window_size - 1;
+    float* __restrict extrema_data = extrema.data();
+    for (size_t i_window = 0; i_window < window_count; i_window++) {
+        extrema_data[i_window] = combine(suffix_data[i_window], prefix_data[i_window]);
+    }
+    return extrema;
+}
+
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+
+float GetNumber(const Message& message, const FieldDescriptor* field) {
+    const google::protobuf::Reflection* reflection = message.GetReflection();
+    switch (field->cpp_type()) {
+        case FieldDescriptor::CPPTYPE_FLOAT:
+            return reflection->GetFloat(message, field);
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+            return static_cast<float>(reflection->GetDouble(message, field));
+        case FieldDescriptor::CPPTYPE_INT32:
+            return static_cast<float>(reflection->GetInt32(message, field));
+        case FieldDescriptor::CPPTYPE_INT64:
+            return static_cast<float>(reflection->GetInt64(message, field));
+        case FieldDescriptor::CPPTYPE_BOOL:
+            return reflection->GetBool(message, field) ? 1.0f : 0.0f;
+        default:
+            return 0.0f;
+    }
+}
+
+// Appends the measurements of the repeated field at `path` (e.g. "pulse.rate") of `metrics`, if it has one, to
+// `series`: their "time", their "value" (or, for detection series, "detected") and, if `with_confidence`, their
+// "confidence".
+template<typename TValue>
+void AppendBufferSeries(
+    const physiology::MetricsBuffer& metrics,
+    const std::string& path,
+    bool with_confidence,
+    SeriesColumns<TValue>& series
+) {
+    const Message* message = &metrics;
+    size_t name_start = 0;
+    while (true) {
+        const size_t name_end = path.find('.', name_start);
+        const FieldDescriptor* field =
+            message->GetDescriptor()->FindFieldByName(path.substr(name_start, name_end - name_start));
+        if (field == nullptr || field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+            return;
+        }
+        const google::protobuf::Reflection* reflection = message->GetReflection();
+        if (name_end != std::string::npos) {
+            if (field->is_repeated() || !reflection->HasField(*message, field)) {
+                return;
+            }
+            message = &reflection->GetMessage(*message, field);
+            name_start = name_end + 1;
+            continue;
+        }
+        if (!field->is_repeated()) {
+            return;
+        }
+        const google::protobuf::Descriptor* measurement_type = field->message_type();
+        const FieldDescriptor* time_field = measurement_type->FindFieldByName("time");
+        const FieldDescriptor* value_field = measurement_type->FindFieldByName("value");
+        if (value_field == nullptr) {
+            value_field = measurement_type->FindFieldByName("detected");
+        }
+        const FieldDescriptor* confidence_field =
+            with_confidence ? measurement_type->FindFieldByName("confidence") : nullptr;
+        if (time_field == nullptr || value_field == nullptr) {
+            return;
+        }
+        for (const Message& measurement: reflection->GetRepeatedPtrField<Message>(*message, field)) {
+            series.time.push_back(GetNumber(measurement, time_field));
+            series.value.push_back(static_cast<TValue>(GetNumber(measurement, value_field)));
+            if (confidence_field != nullptr) {
+                series.confidence.push_back(GetNumber(measurement, confidence_field));
+            }
+        }
+        return;
+    }
+}
+
+BooleanIntervals GetBufferIntervals(const physiology::MetricsBuffer& metrics, const std::string& path) {
+    SeriesColumns<uint8_t> series;
+    AppendBufferSeries(metrics, path, false, series);
+    return ToIntervals(std::move(series));
+}
+
+} // anonymous namespace
+
+// region ==================================== Boolean intervals ====================================================
+size_t BooleanIntervals::GetMeasurementCount() const {
+    size_t measurement_count = 0;
+    for (const uint32_t interval_count: count) {
+        measurement_count += interval_count;
+    }
+    return measurement_count;
+}
+
+void BooleanIntervals::Append(float time, bool measurement_value, float max_gap_s) {
+    const uint8_t stored_value = measurement_value ? 1 : 0;
+    if (Size() > 0 && spacing_interval == Size() - 1 && value.back() == stored_value &&
+        time - end_time.back() <= max_gap_s) {
+        // the new measurement's index in the interval, and the spacing Expand() would use with it as the end
+        const auto i_measurement = static_cast<double>(count.back());
+        const double start = start_time.back();
+        const double spacing = (static_cast<double>(time) - start) / i_measurement;
+        // spacings that keep this measurement, too, within the error bound, which also allows for the float
+        // resolution of its time (times evenly spaced in double precision are not, once rounded to float)
+        const double tolerance =
+            kMaxTimeErrorS + (std::nextafter(std::abs(time), std::numeric_limits<float>::infinity()) - std::abs(time));
+        const double new_min_spacing = std::max(min_spacing, (time - tolerance - start) / i_measurement);
+        const double new_max_spacing = std::min(max_spacing, (time + tolerance - start) / i_measurement);
+        if (spacing >= new_min_spacing && spacing <= new_max_spacing) {
+            end_time.back() = time;
+            count.back()++;
+            min_spacing = new_min_spacing;
+            max_spacing = new_max_spacing;
+            return;
+        }
+    }
+    start_time.push_back(time);
+    end_time.push_back(time);
+    count.push_back(1);
+    value.push_back(stored_value);
+    spacing_interval = Size() - 1;
+    min_spacing = -std::numeric_limits<double>::infinity();
+    max_spacing = std::numeric_limits<double>::infinity();
+}
+
+void BooleanIntervals::Expand(size_t i_interval, SeriesColumns<uint8_t>& series) const {
+    const uint32_t interval_count = count[i_interval];
+    // in double precision, so that rounding does not add up over long intervals
+    const double start = start_time[i_interval];
+    const double spacing = interval_count > 1
+                           ? (end_time[i_interval] - start) / static_cast<double>(interval_count - 1) : 0.0;
+    for (uint32_t i_measurement = 0; i_measurement < interval_count; i_measurement++) {
+        // the last one exactly at the end time, whatever the rounding
+        const double time = start + static_cast<double>(i_measurement) * spacing;
+        series.time.push_back(i_measurement + 1 == interval_count ? end_time[i_interval] : static_cast<float>(time));
+        series.value.push_back(value[i_interval]);
+    }
+}
+
+BooleanIntervals ToIntervals(SeriesColumns<uint8_t> series) {
+    if (!std::is_sorted(series.time.begin(), series.time.end())) {
+        std::vector<size_t> order(series.Size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&series](size_t a, size_t b) {
+            return series.time[a] < series.time[b];
+        });
+        SeriesColumns<uint8_t> sorted;
+        sorted.Reserve(series.Size(), false);
+        for (const size_t i_measurement: order) {
+            sorted.time.push_back(series.time[i_measurement]);
+            sorted.value.push_back(series.value[i_measurement]);
+        }
+        series = std::move(sorted);
+    }
+    BooleanIntervals intervals;
+    for (size_t i_measurement = 0; i_measurement < series.Size(); i_measurement++) {
+        intervals.Append(series.time[i_measurement], series.value[i_measurement] != 0);
+    }
+    return intervals;
+}
+
+BooleanIntervals ToIntervals(const std::vector<formats::Measurement<bool>>& series) {
+    SeriesColumns<uint8_t> columns;
+    columns.Reserve(series.size(), false);
+    for (const auto& measurement: series) {
+        columns.time.push_back(measurement.time);
+        columns.value.push_back(measurement.value ? 1 : 0);
+    }
+    return ToIntervals(std::move(columns));
+}
+
+SeriesColumns<uint8_t> ToColumns(const BooleanIntervals& intervals) {
+    SeriesColumns<uint8_t> series;
+    series.Reserve(intervals.GetMeasurementCount(), false);
+    for (size_t i_interval = 0; i_interval < intervals.Size(); i_interval++) {
+        intervals.Expand(i_interval, series);
+    }
+    return series;
+}
+
+std::vector<formats::Measurement<bool>> ToMeasurements(const BooleanIntervals& intervals) {
+    const SeriesColumns<uint8_t> series = ToColumns(intervals);
+    std::vector<formats::Measurement<bool>> measurements(series.Size());
+    for (size_t i_measurement = 0; i_measurement < measurements.size(); i_measurement++) {
+        measurements[i_measurement].time = series.time[i_measurement];
+        measurements[i_measurement].value = series.value[i_measurement] != 0;
+    }
+    return measurements;
+}
+// endregion ===========================================================================================================
+
+MetricsColumns ToColumns(const formats::Metrics& metrics) {
+    MetricsColumns columns;
+    columns.pulse_rate = ToColumns(metrics.pulse.values);
+    columns.pulse_trace = ToColumns(metrics.pulse.trace);
+    columns.pulse_strict = metrics.pulse.strict;
+    columns.pulse_snr_sufficient = metrics.pulse.snr_sufficient;
+
+    columns.breathing_rate = ToColumns(metrics.breathing.values);
+    columns.breathing_upper_trace = ToColumns(metrics.breathing.upper_trace);
+    columns.breathing_lower_trace = ToColumns(metrics.breathing.lower_trace);
+    columns.breathing_strict = metrics.breathing.strict;
+    columns.breathing_snr_sufficient = metrics.breathing.snr_sufficient;
+    columns.breathing_amplitude = ToColumns(metrics.breathing.amplitude);
+    columns.apnea = ToIntervals(metrics.breathing.apnea);
+    columns.respiratory_line_length = ToColumns(metrics.breathing.respiratory_line_length);
+    columns.inhale_exhale_ratio = ToColumns(metrics.breathing.inhale_exhale_ratio);
+
+    columns.phasic_blood_pressure = ToColumns(metrics.blood_pressure.phasic);
+    columns.version = metrics.version;
+    return columns;
+}
+
+formats::Metrics ToMetrics(const MetricsColumns& columns) {
+    using Measurement = formats::Measurement<float>;
+    using MeasurementWithConfidence = formats::MeasurementWithConfidence<float>;
+    formats::Metrics metrics;
+    metrics.pulse.values = ToMeasurements<MeasurementWithConfidence>(columns.pulse_rate);
+    metrics.pulse.trace = ToMeasurements<Measurement>(columns.pulse_trace);
+    metrics.pulse.strict = columns.pulse_strict;
+    metrics.pulse.snr_sufficient = columns.pulse_snr_sufficient;
+
+    metrics.breathing.values = ToMeasurements<MeasurementWithConfidence>(columns.breathing_rate);
+    metrics.breathing.upper_trace = ToMeasurements<Measurement>(columns.breathing_upper_trace);
+    metrics.breathing.lower_trace = ToMeasurements<Measurement>(columns.breathing_lower_trace);
+    metrics.breathing.strict = columns.breathing_strict;
+    metrics.breathing.snr_sufficient = columns.breathing_snr_sufficient;
+    metrics.breathing.amplitude = ToMeasurements<Measurement>(columns.breathing_amplitude);
+    metrics.breathing.apnea = ToMeasurements(columns.apnea);
+    metrics.breathing.respiratory_line_length = ToMeasurements<Measurement>(columns.respiratory_line_length);
+    metrics.breathing.inhale_exhale_ratio = ToMeasurements<Measurement>(columns.inhale_exhale_ratio);
+
+    metrics.blood_pressure.phasic = ToMeasurements<MeasurementWithConfidence>(columns.phasic_blood_pressure);
+    metrics.version = columns.version;
+    return metrics;
+}
+
+MetricsColumns ToColumns(const physiology::MetricsBuffer& metrics) {
+    MetricsColumns columns;
+    AppendBufferSeries(metrics, "pulse.rate", true, columns.pulse_rate);
+    AppendBufferSeries(metrics, "pulse.trace", false, columns.pulse_trace);
+
+    AppendBufferSeries(metrics, "breath.rate", true, columns.breathing_rate);
+    AppendBufferSeries(metrics, "breath.upper_trace", false, columns.breathing_upper_trace);
+    AppendBufferSeries(metrics, "breath.lower_trace", false, columns.breathing_lower_trace);
+    AppendBufferSeries(metrics, "breath.amplitude", false, columns.breathing_amplitude);
+    columns.apnea = GetBufferIntervals(metrics, "breath.apnea");
+    AppendBufferSeries(metrics, "breath.respiratory_line_length", false, columns.respiratory_line_length);
+    AppendBufferSeries(metrics, "breath.inhale_exhale_ratio", false, columns.inhale_exhale_ratio);
+
+    AppendBufferSeries(metrics, "pressure.phasic", true, columns.phasic_blood_pressure);
+
+    columns.face_blinking = GetBufferIntervals(metrics, "face.blinking");
+    columns.face_talking = GetBufferIntervals(metrics, "face.talking");
+    return columns;
+}
+
+// region ================================ Columnar computations =======================================================
+std::vector<float> ResampleLinear(const SeriesColumns<float>& series, float rate_hz) {
+    const size_t measurement_count = series.Size();
+    if (measurement_count == 0 || rate_hz <= 0.0f) {
+        return {};
+    }
+    const float start_time = series.time.front();
+    const auto sample_count = static_cast<size_t>(std::floor((series.time.back() - start_time) * rate_hz)) + 1;
+    std::vector<float> samples(sample_count);
+    const float* __restrict times = series.time.data();
+    const float* __restrict values = series.value.data();
+    size_t i_left = 0;
+    for (size_t i_sample = 0; i_sample < sample_count; i_sample++) {
+        const float sample_time = start_time + static_cast<float>(i_sample) / rate_hz;
+        while (i_left + 2 < measurement_count && times[i_left + 1] <= sample_time) {
+            i_left++;
+        }
+        const size_t i_right = std::min(i_left + 1, measurement_count - 1);
+        const float interval = times[i_right] - times[i_left];
+        const float weight = interval > 0.0f ? std::clamp((sample_time - times[i_left]) / interval, 0.0f, 1.0f) : 0.0f;
+        samples[i_sample] = values[i_left] + weight * (values[i_right] - values[i_left]);
+    }
+    return samples;
+}
+
+std::vector<float> WindowedMean(const std::vector<float>& values, size_t window_size) {
+    const size_t value_count = values.size();
+    if (window_size == 0 || value_count < window_size) {
+        return {};
+    }
+    // running sums in double precision, so that long series don't accumulate float round-off
+    std::vector<double> prefix_sums(value_count + 1);
+    prefix_sums[0] = 0.0;
+    for (size_t i_value = 0; i_value < value_count; i_value++) {
+        prefix_sums[i_value + 1] = prefix_sums[i_value] + values[i_value];
+    }
+    const size_t window_count = value_count - window_size + 1;
+    std::vector<float> means(window_count);
+    const double* __restrict window_starts = prefix_sums.data();
+    const double* __restrict window_ends = prefix_sums.data() + window_size;
+    float* __restrict means_data = means.data();
+    const double scale = 1.0 / static_cast<double>(window_size);
+    for (size_t i_window = 0; i_window < window_count; i_window++) {
+        means_data[i_window] = static_cast<float>((window_ends[i_window] - window_starts[i_window]) * scale);
+    }
+    return means;
+}
+
+std::vector<float> WindowedMin(const std::vector<float>& values, size_t window_size) {
+    return WindowedExtremum(values, window_size, [](float a, float b) { return std::min(a, b); });
+}
+
+std::vector<float> WindowedMax(const std::vector<float>& values, size_t window_size) {
+    return WindowedExtremum(values, window_size, [](float a, float b) { return std::max(a, b); });
+}
+
+SeriesColumns<float> FilterByConfidence(const SeriesColumns<float>& series, float min_confidence) {
+    const size_t measurement_count = series.Size();
+    if (series.confidence.size() != measurement_count) {
+        return series;
+    }
+    SeriesColumns<float> filtered;
+    filtered.time.resize(measurement_count);
+    filtered.value.resize(measurement_count);
+    filtered.confidence.resize(measurement_count);
+    // branch-free compaction: every measurement is written, but the output position only advances for kept ones
+    size_t kept_count = 0;
+    for (size_t i_measurement = 0; i_measurement < measurement_count; i_measurement++) {
+        filtered.time[kept_count] = series.time[i_measurement];
+        filtered.value[kept_count] = series.value[i_measurement];
+        filtered.confidence[kept_count] = series.confidence[i_measurement];
+        kept_count += series.confidence[i_measurement] >= min_confidence ? 1 : 0;
+    }
+    filtered.time.resize(kept_count);
+    filtered.value.resize(kept_count);
+    filtered.confidence.resize(kept_count);
+    return filtered;
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,182 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// third-party includes
+#include <physiology/modules/messages/metrics.pb.h>
+#include <smartspectra/formats/metrics.hpp>
+
+namespace presage::smartspectra::examples {
+
+// Structure-of-arrays counterpart of a formats::Metrics series (std::vector<Measurement<TValue>> or
+// std::vector<MeasurementWithConfidence<TValue>>): times, values and confidences each in their own contiguous
+// array, so that per-column computations run over densely packed (and vectorizable) data.
+template<typename TValue>
+struct SeriesColumns {
+    std::vector<float> time;
+    std::vector<TValue> value;
+    // empty for series that carry no confidence
+    std::vector<float> confidence;
+
+    size_t Size() const {
+        return time.size();
+    }
+
+    void Reserve(size_t size, bool with_confidence) {
+        time.reserve(size);
+        value.reserve(size);
+        if (with_confidence) {
+            confidence.reserve(size);
+        }
+    }
+};
+
+template<typename TValue>
+SeriesColumns<TValue> ToColumns(const std::vector<formats::Measurement<TValue>>& series) {
+    SeriesColumns<TValue> columns;
+    columns.Reserve(series.size(), false);
+    for (const auto& measurement: series) {
+        columns.time.push_back(measurement.time);
+        columns.value.push_back(measurement.value);
+    }
+    return columns;
+}
+
+template<typename TValue>
+SeriesColumns<TValue> ToColumns(const std::vector<formats::MeasurementWithConfidence<TValue>>& series) {
+    SeriesColumns<TValue> columns;
+    columns.Reserve(series.size(), true);
+    for (const auto& measurement: series) {
+        columns.time.push_back(measurement.time);
+        columns.value.push_back(measurement.value);
+        columns.confidence.push_back(measurement.confidence);
+    }
+    return columns;
+}
+
+template<typename TMeasurement, typename TValue>
+std::vector<TMeasurement> ToMeasurements(const SeriesColumns<TValue>& columns) {
+    std::vector<TMeasurement> series(columns.Size());
+    for (size_t i_measurement = 0; i_measurement < series.size(); i_measurement++) {
+        series[i_measurement].time = columns.time[i_measurement];
+        series[i_measurement].value = columns.value[i_measurement];
+    }
+    if constexpr (std::is_same_v<TMeasurement, formats::MeasurementWithConfidence<TValue>>) {
+        // series that came without confidences keep the default confidence
+        if (columns.confidence.size() == series.size()) {
+            for (size_t i_measurement = 0; i_measurement < series.size(); i_measurement++) {
+                series[i_measurement].confidence = columns.confidence[i_measurement];
+            }
+        }
+    }
+    return series;
+}
+
+// Run-length form of a boolean per-frame series (apnea, face blinking / talking), which hardly ever changes value:
+// one interval per run of consecutive measurements with the same value, holding the times of its first and last
+// measurement and how many measurements it stands for. A run is broken off where the value changes, where the
+// measurements leave a gap (e.g. frames without a face), and where their times stop being evenly spaced, so that
+// expanding an interval back into evenly spaced measurements reproduces every original time to within
+// kMaxTimeErrorS (plus a float step or two at the magnitude of the time). Unevenly timed frames just make for more
+// (shorter) intervals.
+struct BooleanIntervals {
+    std::vector<float> start_time;
+    std::vector<float> end_time;
+    std::vector<uint32_t> count;
+    // 0 / 1
+    std::vector<uint8_t> value;
+
+    size_t Size() const {
+        return start_time.size();
+    }
+
+    size_t GetMeasurementCount() const;
+    // Adds a measurement timed after all the ones added so far, extending the last interval if it has the same
+    // value, ended at most `max_gap_s` before, was itself built up by Append(), and can take the measurement with all
+    // of its times still evenly spaced (to within kMaxTimeErrorS).
+    void Append(float time, bool measurement_value, float max_gap_s = kDefaultMaxGapS);
+    // Appends the measurements of interval `i_interval`, evenly spaced between its start and end times, to `series`.
+    void Expand(size_t i_interval, SeriesColumns<uint8_t>& series) const;
+
+    // longer than any frame interval, short enough for gaps in the frames to show
+    static constexpr float kDefaultMaxGapS = 0.5f;
+    // well below the millisecond resolution times are given at
+    static constexpr double kMaxTimeErrorS = 1e-4;
+
+private:
+    // Range of spacings (in seconds per measurement) of the last interval for which every time in it is within the
+    // error bound of its evenly spaced position, known while the last interval is the one Append() last built
+    // (interval index `spacing_interval`).
+    size_t spacing_interval = static_cast<size_t>(-1);
+    double min_spacing = 0.0;
+    double max_spacing = 0.0;
+};
+
+// Sorts `series` by time (unless already sorted) and turns it into intervals.
+BooleanIntervals ToIntervals(SeriesColumns<uint8_t> series);
+BooleanIntervals ToIntervals(const std::vector<formats::Measurement<bool>>& series);
+// Expanded (per-measurement) forms of intervals.
+SeriesColumns<uint8_t> ToColumns(const BooleanIntervals& intervals);
+std::vector<formats::Measurement<bool>> ToMeasurements(const BooleanIntervals& intervals);
+
+// Columnar counterpart of formats::Metrics.
+struct MetricsColumns {
+    SeriesColumns<float> pulse_rate;
+    SeriesColumns<float> pulse_trace;
+    float pulse_strict = 0.0f;
+    bool pulse_snr_sufficient = false;
+
+    SeriesColumns<float> breathing_rate;
+    SeriesColumns<float> breathing_upper_trace;
+    SeriesColumns<float> breathing_lower_trace;
+    float breathing_strict = 0.0f;
+    bool breathing_snr_sufficient = false;
+    SeriesColumns<float> breathing_amplitude;
+    BooleanIntervals apnea;
+    SeriesColumns<float> respiratory_line_length;
+    SeriesColumns<float> inhale_exhale_ratio;
+
+    SeriesColumns<float> phasic_blood_pressure;
+
+    // not in formats::Metrics, so lost in ToMetrics()
+    BooleanIntervals face_blinking;
+    BooleanIntervals face_talking;
+
+    std::string version;
+};
+
+MetricsColumns ToColumns(const formats::Metrics& metrics);
+formats::Metrics ToMetrics(const MetricsColumns& columns);
+// Series of a continuous-mode metrics buffer from Core, found by their field paths ("pulse.rate", "breath.apnea",
+// "face.blinking", ...). Series the buffer does not have are left empty; strict values and the version stay unset.
+MetricsColumns ToColumns(const physiology::MetricsBuffer& metrics);
+
+// region ================================ Columnar computations =======================================================
+// These are written as plain loops over contiguous arrays without data-dependent branches in the inner loops, so that
+// the compiler can auto-vectorize them.
+
+// Linearly interpolates the series at a fixed rate, from its first to its last time (inclusive).
+// The series needs to be sorted by time.
+std::vector<float> ResampleLinear(const SeriesColumns<float>& series, float rate_hz);
+
+// Mean / minimum / maximum over every window of `window_size` consecutive values
+// (i.e., values.size() - window_size + 1 results; none if there are fewer values than that).
+std::vector<float> WindowedMean(const std::vector<float>& values, size_t window_size);
+std::vector<float> WindowedMin(const std::vector<float>& values, size_t window_size);
+std::vector<float> WindowedMax(const std::vector<float>& values, size_t window_size);
+
+// Keeps only the measurements whose confidence is at least `min_confidence`
+// (series without confidences are returned as they are).
+SeriesColumns<float> FilterByConfidence(const SeriesColumns<float>& series, float min_confidence);
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,507 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <functional>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// third-party includes
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/absl/strings/str_join.h>
+#include <physiology/interface/nlohmann/json.hpp>
+
+// local includes
+#include "common/metrics_binary_file.hpp"
+#include "common/status_macros.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+constexpr size_t kAlignment = 8;
+constexpr MetricsColumnFlag kColumnOrder[] = {
+    kTimeColumn, kValueColumn, kConfidenceColumn, kEndTimeColumn, kCountColumn
+};
+
+const std::vector<std::string> kMetricsFileFormatNames = {"json", "binary", "compact_binary"};
+
+size_t Padded(size_t size) {
+    return (size + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+void AppendPadded(std::string& out, const void* data, size_t size) {
+    out.append(static_cast<const char*>(data), size);
+    out.append(Padded(size) - size, '\0');
+}
+
+// region ===================================== Delta-varint coding ===================================================
+void AppendDeltaVarints(std::string& out, const std::vector<float>& column) {
+    uint32_t previous_bits = 0;
+    for (float value: column) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const auto delta = static_cast<int32_t>(bits - previous_bits);
+        previous_bits = bits;
+        // zig-zag mapping, so that small negative deltas get small codes, too
+        uint32_t code = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+        while (code >= 0x80) {
+            out.push_back(static_cast<char>((code & 0x7F) | 0x80));
+            code >>= 7;
+        }
+        out.push_back(static_cast<char>(code));
+    }
+}
+
+absl::Status DecodeDeltaVarints(std::string_view data, size_t count, std::vector<float>& column) {
+    column.resize(count);
+    uint32_t previous_bits = 0;
+    size_t offset = 0;
+    for (size_t i_value = 0; i_value < count; i_value++) {
+        uint32_t code = 0;
+        for (int shift = 0;; shift += 7) {
+            if (offset >= data.size() || shift > 28) {
+                return absl::DataLossError("Truncated or corrupt delta-varint column in binary metrics.");
+            }
+            const auto byte = static_cast<uint8_t>(data[offset++]);
+            code |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+        const auto delta = static_cast<uint32_t>(static_cast<int32_t>(code >> 1) ^ -static_cast<int32_t>(code & 1));
+        previous_bits += delta;
+        std::memcpy(&column[i_value], &previous_bits, sizeof(previous_bits));
+    }
+    return absl::OkStatus();
+}
+// endregion ===========================================================================================================
+
+void AppendColumn(std::string& out, const std::vector<float>& column, MetricsColumnEncoding encoding) {
+    if (encoding == MetricsColumnEncoding::DeltaVarint) {
+        std::string encoded;
+        encoded.reserve(column.size() * 2);
+        AppendDeltaVarints(encoded, column);
+        const uint64_t size = encoded.size();
+        out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        AppendPadded(out, encoded.data(), encoded.size());
+    } else {
+        const uint64_t size = column.size() * sizeof(float);
+        out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        AppendPadded(out, column.data(), size);
+    }
+}
+
+void AppendSeries(
+    std::string& out, uint32_t& series_count, MetricsSeriesId series_id, const SeriesColumns<float>& series,
+    MetricsColumnEncoding encoding
+) {
+    if (series.Size() == 0) {
+        return;
+    }
+    MetricsBinarySeriesHeader header{
+        series_id,
+        MetricsValueType::Float32,
+        encoding,
+        kTimeColumn | kValueColumn | (series.confidence.empty() ? 0u : kConfidenceColumn),
+        series.Size()
+    };
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    AppendColumn(out, series.time, encoding);
+    AppendColumn(out, series.value, encoding);
+    if (!series.confidence.empty()) {
+        AppendColumn(out, series.confidence, encoding);
+    }
+    series_count++;
+}
+
+template<typename TValue>
+void AppendRawColumn(std::string& out, const std::vector<TValue>& column) {
+    const uint64_t size = column.size() * sizeof(TValue);
+    out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    AppendPadded(out, column.data(), size);
+}
+
+void AppendSeries(
+    std::string& out, uint32_t& series_count, MetricsSeriesId series_id, const BooleanIntervals& intervals,
+    MetricsColumnEncoding encoding
+) {
+    if (intervals.Size() == 0) {
+        return;
+    }
+    MetricsBinarySeriesHeader header{
+        series_id,
+        MetricsValueType::BooleanIntervals,
+        encoding,
+        kTimeColumn | kValueColumn | kEndTimeColumn | kCountColumn,
+        intervals.Size()
+    };
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    AppendColumn(out, intervals.start_time, encoding);
+    AppendRawColumn(out, intervals.value);
+    AppendColumn(out, intervals.end_time, encoding);
+    AppendRawColumn(out, intervals.count);
+    series_count++;
+}
+
+BooleanIntervals* FindBooleanSeries(MetricsColumns& columns, MetricsSeriesId series_id) {
+    switch (series_id) {
+        case MetricsSeriesId::Apnea: return &columns.apnea;
+        case MetricsSeriesId::FaceBlinking: return &columns.face_blinking;
+        case MetricsSeriesId::FaceTalking: return &columns.face_talking;
+        default: return nullptr;
+    }
+}
+
+SeriesColumns<float>* FindFloatSeries(MetricsColumns& columns, MetricsSeriesId series_id) {
+    switch (series_id) {
+        case MetricsSeriesId::PulseRate: return &columns.pulse_rate;
+        case MetricsSeriesId::PulseTrace: return &columns.pulse_trace;
+        case MetricsSeriesId::BreathingRate: return &columns.breathing_rate;
+        case MetricsSeriesId::BreathingUpperTrace: return &columns.breathing_upper_trace;
+        case MetricsSeriesId::BreathingLowerTrace: return &columns.breathing_lower_trace;
+        case MetricsSeriesId::BreathingAmplitude: return &columns.breathing_amplitude;
+        case MetricsSeriesId::RespiratoryLineLength: return &columns.respiratory_line_length;
+        case MetricsSeriesId::InhaleExhaleRatio: return &columns.inhale_exhale_ratio;
+        case MetricsSeriesId::PhasicBloodPressure: return &columns.phasic_blood_pressure;
+        default: return nullptr;
+    }
+}
+
+absl::Status ReadHeader(std::string_view data, MetricsBinaryFileHeader& header, std::string& version, size_t& offset) {
+    if (data.size() < sizeof(header)) {
+        return absl::DataLossError("Binary metrics are too short to hold a header.");
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMetricsBinaryFileMagic, sizeof(header.magic)) != 0) {
+        return absl::InvalidArgumentError("Not a binary metrics file (bad magic).");
+    }
+    if (header.version < 1 || header.version > kMetricsBinaryFileVersion) {
+        return absl::UnimplementedError(absl::StrCat("Unsupported binary metrics file version ", header.version, "."));
+    }
+    offset = sizeof(header);
+    if (data.size() - offset < Padded(header.version_string_size)) {
+        return absl::DataLossError("Binary metrics are truncated.");
+    }
+    version.assign(data.data() + offset, header.version_string_size);
+    offset += Padded(header.version_string_size);
+    return absl::OkStatus();
+}
+
+using ColumnVisitor = std::function<absl::Status(
+    const MetricsBinarySeriesHeader& series_header, MetricsColumnFlag column, std::string_view column_data
+)>;
+
+// Walks all columns of all series, checking that each lies within `data`.
+absl::Status VisitColumns(std::string_view data, size_t offset, uint32_t series_count, const ColumnVisitor& visit) {
+    for (uint32_t i_series = 0; i_series < series_count; i_series++) {
+        MetricsBinarySeriesHeader series_header{};
+        if (data.size() - offset < sizeof(series_header)) {
+            return absl::DataLossError("Binary metrics are truncated.");
+        }
+        std::memcpy(&series_header, data.data() + offset, sizeof(series_header));
+        offset += sizeof(series_header);
+        for (MetricsColumnFlag column: kColumnOrder) {
+            if ((series_header.column_flags & column) == 0) {
+                continue;
+            }
+            uint64_t column_size = 0;
+            if (data.size() - offset < sizeof(column_size)) {
+                return absl::DataLossError("Binary metrics are truncated.");
+            }
+            std::memcpy(&column_size, data.data() + offset, sizeof(column_size));
+            offset += sizeof(column_size);
+            if (data.size() - offset < Padded(column_size)) {
+                return absl::DataLossError("Binary metrics are truncated.");
+            }
+            MP_RETURN_IF_ERROR(visit(series_header, column, data.substr(offset, column_size)));
+            offset += Padded(column_size);
+        }
+    }
+    return absl::OkStatus();
+}
+
+template<typename TValue>
+absl::Status DecodeRawColumn(std::string_view data, size_t count, std::vector<TValue>& column) {
+    if (data.size() != count * sizeof(TValue)) {
+        return absl::DataLossError("Raw column size does not match the measurement count in binary metrics.");
+    }
+    column.resize(count);
+    std::memcpy(column.data(), data.data(), data.size());
+    return absl::OkStatus();
+}
+
+absl::Status ErrnoStatus(const std::string& what, const std::filesystem::path& path) {
+    return absl::InternalError(absl::StrCat(what, " ", path.string(), ": ", std::strerror(errno)));
+}
+} // anonymous namespace
+
+// region ===================================== Serialization =========================================================
+std::string SerializeMetricsBinary(const MetricsColumns& columns, MetricsColumnEncoding encoding) {
+    std::string out;
+    const size_t trace_size = columns.pulse_trace.Size() + columns.breathing_upper_trace.Size() +
+                              columns.breathing_lower_trace.Size();
+    out.reserve(256 + trace_size * 2 * sizeof(float));
+
+    MetricsBinaryFileHeader header{};
+    std::memcpy(header.magic, kMetricsBinaryFileMagic, sizeof(header.magic));
+    header.version = kMetricsBinaryFileVersion;
+    header.pulse_strict = columns.pulse_strict;
+    header.breathing_strict = columns.breathing_strict;
+    header.flags = (columns.pulse_snr_sufficient ? kPulseSnrSufficient : 0u) |
+                   (columns.breathing_snr_sufficient ? kBreathingSnrSufficient : 0u);
+    header.version_string_size = static_cast<uint32_t>(columns.version.size());
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    AppendPadded(out, columns.version.data(), columns.version.size());
+
+    uint32_t series_count = 0;
+    AppendSeries(out, series_count, MetricsSeriesId::PulseRate, columns.pulse_rate, encoding);
+    AppendSeries(out, series_count, MetricsSeriesId::PulseTrace, columns.pulse_trace, encoding);
+    AppendSeries(out, series_count, MetricsSeriesId::BreathingRate, columns.breathing_rate, encoding);
+    AppendSeries(out, series_count, MetricsSeriesId::BreathingUpperTrace, columns.breathing_upper_trace, encoding);
+    AppendSeries(out, series_count, MetricsSeriesId::BreathingLowerTrace, columns.breathing_lower_trace, encoding);
+    AppendSeries(out, series_count, MetricsSeriesId::BreathingAmplitude, columns.breathing_amplitude, encoding);
+    AppendSeries(out, series_count, MetricsSeriesId::Apnea, columns.apnea, encoding);
+    AppendSeries(out, series_count, MetricsSeriesId::RespiratoryLineLength, columns.respiratory_line_length, encoding);
+    AppendSeries(out, series_count, MetricsSeriesId::InhaleExhaleRatio, columns.inhale_exhale_ratio, encoding);
+    AppendSeries(out, series_count, MetricsSeriesId::PhasicBloodPressure, columns.phasic_blood_pressure, encoding);
+    AppendSeries(out, series_count, MetricsSeriesId::FaceBlinking, columns.face_blinking, encoding);
+    AppendSeries(out, series_count, MetricsSeriesId::FaceTalking, columns.face_talking, encoding);
+    // the series count is only known now
+    std::memcpy(out.data() + offsetof(MetricsBinaryFileHeader, series_count), &series_count, sizeof(series_count));
+    return out;
+}
+
+absl::StatusOr<MetricsColumns> DeserializeMetricsBinary(std::string_view data) {
+    MetricsColumns columns;
+    MetricsBinaryFileHeader header{};
+    size_t offset = 0;
+    MP_RETURN_IF_ERROR(ReadHeader(data, header, columns.version, offset));
+    columns.pulse_strict = header.pulse_strict;
+    columns.breathing_strict = header.breathing_strict;
+    columns.pulse_snr_sufficient = (header.flags & kPulseSnrSufficient) != 0;
+    columns.breathing_snr_sufficient = (header.flags & kBreathingSnrSufficient) != 0;
+
+    // version 1 apnea, per measurement
+    SeriesColumns<uint8_t> measured_apnea;
+    MP_RETURN_IF_ERROR(VisitColumns(
+        data, offset, header.series_count,
+        [&columns, &measured_apnea](const MetricsBinarySeriesHeader& series_header, MetricsColumnFlag column,
+                                    std::string_view column_data) -> absl::Status {
+            const size_t count = series_header.measurement_count;
+            if (series_header.series_id == MetricsSeriesId::Apnea &&
+                series_header.value_type == MetricsValueType::UInt8 &&
+                series_header.encoding == MetricsColumnEncoding::Raw) {
+                if (column == kTimeColumn) {
+                    return DecodeRawColumn(column_data, count, measured_apnea.time);
+                }
+                if (column == kValueColumn) {
+                    return DecodeRawColumn(column_data, count, measured_apnea.value);
+                }
+                return absl::OkStatus();
+            }
+            BooleanIntervals* intervals = FindBooleanSeries(columns, series_header.series_id);
+            if (intervals != nullptr && series_header.value_type == MetricsValueType::BooleanIntervals) {
+                switch (column) {
+                    case kValueColumn:
+                        return DecodeRawColumn(column_data, count, intervals->value);
+                    case kCountColumn:
+                        return DecodeRawColumn(column_data, count, intervals->count);
+                    case kTimeColumn:
+                    case kEndTimeColumn: {
+                        std::vector<float>& target = column == kTimeColumn ? intervals->start_time
+                                                                           : intervals->end_time;
+                        switch (series_header.encoding) {
+                            case MetricsColumnEncoding::Raw:
+                                return DecodeRawColumn(column_data, count, target);
+                            case MetricsColumnEncoding::DeltaVarint:
+                                return DecodeDeltaVarints(column_data, count, target);
+                        }
+                        return absl::UnimplementedError(absl::StrCat(
+                            "Unsupported column encoding ", static_cast<uint32_t>(series_header.encoding),
+                            " in binary metrics."
+                        ));
+                    }
+                    default:
+                        return absl::OkStatus();
+                }
+            }
+            SeriesColumns<float>* series = FindFloatSeries(columns, series_header.series_id);
+            if (series == nullptr || series_header.value_type != MetricsValueType::Float32) {
+                // written by a newer version, skip
+                return absl::OkStatus();
+            }
+            std::vector<float>& target = column == kTimeColumn ? series->time
+                                         : column == kValueColumn ? series->value : series->confidence;
+            switch (series_header.encoding) {
+                case MetricsColumnEncoding::Raw:
+                    return DecodeRawColumn(column_data, count, target);
+                case MetricsColumnEncoding::DeltaVarint:
+                    return DecodeDeltaVarints(column_data, count, target);
+            }
+            return absl::UnimplementedError(absl::StrCat(
+                "Unsupported column encoding ", static_cast<uint32_t>(series_header.encoding), " in binary metrics."
+            ));
+        }
+    ));
+    if (measured_apnea.Size() > 0) {
+        columns.apnea = ToIntervals(std::move(measured_apnea));
+    }
+    for (const BooleanIntervals* intervals: {&columns.apnea, &columns.face_blinking, &columns.face_talking}) {
+        const size_t interval_count = intervals->Size();
+        if (intervals->end_time.size() != interval_count || intervals->count.size() != interval_count ||
+            intervals->value.size() != interval_count) {
+            return absl::DataLossError("Boolean interval series in binary metrics is missing columns.");
+        }
+    }
+    return columns;
+}
+
+absl::Status WriteMetricsBinaryFile(
+    const std::filesystem::path& path,
+    const MetricsColumns& columns,
+    MetricsColumnEncoding encoding
+) {
+    const std::string data = SerializeMetricsBinary(columns, encoding);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (file.fail()) {
+        return absl::InternalError("Could not write binary metrics file " + path.string());
+    }
+    return absl::OkStatus();
+}
+// endregion ===========================================================================================================
+
+// region ===================================== MetricsBinaryFile =====================================================
+absl::StatusOr<std::unique_ptr<MetricsBinaryFile>> MetricsBinaryFile::Open(const std::filesystem::path& path) {
+    std::unique_ptr<MetricsBinaryFile> file(new MetricsBinaryFile());
+    file->file_descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file->file_descriptor < 0) {
+        return ErrnoStatus("Could not open binary metrics file", path);
+    }
+    struct stat file_status{};
+    if (fstat(file->file_descriptor, &file_status) != 0) {
+        return ErrnoStatus("Could not stat binary metrics file", path);
+    }
+    file->mapping_length = static_cast<size_t>(file_status.st_size);
+    if (file->mapping_length == 0) {
+        return absl::DataLossError("Binary metrics file " + path.string() + " is empty.");
+    }
+    void* address = mmap(nullptr, file->mapping_length, PROT_READ, MAP_PRIVATE, file->file_descriptor, 0);
+    if (address == MAP_FAILED) {
+        return ErrnoStatus("Could not memory-map binary metrics file", path);
+    }
+    file->mapping = static_cast<const char*>(address);
+    return file;
+}
+
+MetricsBinaryFile::~MetricsBinaryFile() {
+    if (mapping != nullptr) {
+        munmap(const_cast<char*>(mapping), mapping_length);
+    }
+    if (file_descriptor >= 0) {
+        close(file_descriptor);
+    }
+}
+
+std::string_view MetricsBinaryFile::GetData() const {
+    return {mapping, mapping_length};
+}
+
+absl::StatusOr<MetricsColumns> MetricsBinaryFile::ReadColumns() const {
+    return DeserializeMetricsBinary(GetData());
+}
+
+absl::StatusOr<FloatColumnView> MetricsBinaryFile::GetRawFloatColumn(
+    MetricsSeriesId series_id,
+    MetricsColumnFlag column
+) const {
+    MetricsBinaryFileHeader header{};
+    std::string version;
+    size_t offset = 0;
+    MP_RETURN_IF_ERROR(ReadHeader(GetData(), header, version, offset));
+    FloatColumnView view;
+    bool found = false;
+    MP_RETURN_IF_ERROR(VisitColumns(
+        GetData(), offset, header.series_count,
+        [&](const MetricsBinarySeriesHeader& series_header, MetricsColumnFlag visited_column,
+            std::string_view column_data) -> absl::Status {
+            if (found || series_header.series_id != series_id || visited_column != column) {
+                return absl::OkStatus();
+            }
+            const bool is_float_column = column == kTimeColumn || column == kEndTimeColumn ||
+                                         (column != kCountColumn &&
+                                          series_header.value_type == MetricsValueType::Float32);
+            if (series_header.encoding != MetricsColumnEncoding::Raw || !is_float_column) {
+                return absl::FailedPreconditionError("Requested binary metrics column is not raw float32 data.");
+            }
+            // columns are 8-byte aligned within the (page-aligned) mapping
+            view.data = reinterpret_cast<const float*>(column_data.data());
+            view.size = column_data.size() / sizeof(float);
+            found = true;
+            return absl::OkStatus();
+        }
+    ));
+    if (!found) {
+        return absl::NotFoundError("Binary metrics file has no such column.");
+    }
+    return view;
+}
+// endregion ===========================================================================================================
+
+// region ================================== Metrics file format flag ===================================================
+std::vector<std::string> GetMetricsFileFormatNames() {
+    return kMetricsFileFormatNames;
+}
+
+bool AbslParseFlag(absl::string_view text, MetricsFileFormat* format, std::string* error) {
+    for (size_t i_format = 0; i_format < kMetricsFileFormatNames.size(); i_format++) {
+        if (text == kMetricsFileFormatNames[i_format]) {
+            *format = static_cast<MetricsFileFormat>(i_format);
+            return true;
+        }
+    }
+    *error = absl::StrCat("Unknown metrics file format. Possible values: ", absl::StrJoin(kMetricsFileFormatNames, ", "));
+    return false;
+}
+
+std::string AbslUnparseFlag(MetricsFileFormat format) {
+    auto index = static_cast<size_t>(format);
+    return index < kMetricsFileFormatNames.size() ? kMetricsFileFormatNames[index] : "unknown";
+}
+
+absl::Status SaveMetrics(
+    const formats::Metrics& metrics,
+    const std::filesystem::path& path_stem,
+    MetricsFileFormat format
+) {
+    switch (format) {
+        case MetricsFileFormat::Json: {
+            std::filesystem::path path = path_stem.string() + ".json";
+            std::ofstream file(path);
+            file << nlohmann::json(metrics).dump(2);
+            if (file.fail()) {
+                return absl::InternalError("Could not write metrics to " + path.string());
+            }
+            return absl::OkStatus();
+        }
+        case MetricsFileFormat::Binary:
+        case MetricsFileFormat::CompactBinary:
+            return WriteMetricsBinaryFile(
+                path_stem.string() + kMetricsBinaryFileExtension, ToColumns(metrics),
+                format == MetricsFileFormat::Binary ? MetricsColumnEncoding::Raw : MetricsColumnEncoding::DeltaVarint
+            );
+        default:
+            return absl::InvalidArgumentError("Unknown metrics file format.");
+    }
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
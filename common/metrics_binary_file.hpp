@@ -0,0 +1,166 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// third-party includes
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/status/statusor.h>
+#include <physiology/interface/absl/strings/string_view.h>
+#include <smartspectra/formats/metrics.hpp>
+
+// local includes
+#include "common/metric_columns.hpp"
+
+namespace presage::smartspectra::examples {
+
+// Binary metrics file layout (see docs/metrics_binary_format.md). All fields are little-endian, and every block
+// starts at a multiple of 8 bytes from the beginning of the file.
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Binary metrics files are only supported on little-endian hosts.");
+
+constexpr char kMetricsBinaryFileMagic[8] = {'S', 'S', 'M', 'E', 'T', 'R', 'B', '\0'};
+// version 1 files (apnea as a per-measurement UInt8 series, no face series) are still read
+constexpr uint32_t kMetricsBinaryFileVersion = 2;
+constexpr const char* kMetricsBinaryFileExtension = ".ssmb";
+
+enum class MetricsSeriesId : uint32_t {
+    PulseRate = 0,
+    PulseTrace = 1,
+    BreathingRate = 2,
+    BreathingUpperTrace = 3,
+    BreathingLowerTrace = 4,
+    BreathingAmplitude = 5,
+    Apnea = 6,
+    RespiratoryLineLength = 7,
+    InhaleExhaleRatio = 8,
+    PhasicBloodPressure = 9,
+    FaceBlinking = 10,
+    FaceTalking = 11
+};
+
+enum class MetricsValueType : uint32_t {
+    Float32 = 0,
+    UInt8 = 1,
+    // run-length intervals of a boolean series (see BooleanIntervals): the time column holds the start times, with
+    // end time (float32), count (uint32) and value (uint8) columns, and the measurement count is the interval count
+    BooleanIntervals = 2
+};
+
+enum class MetricsColumnEncoding : uint32_t {
+    // plain little-endian values (float32 columns of raw series can be used straight from a memory mapping)
+    Raw = 0,
+    // each float32 bit pattern minus the previous one (the first minus 0), zig-zag-mapped and written as LEB128
+    // varints: lossless, and small for slowly-changing columns such as (regularly-spaced) times
+    DeltaVarint = 1
+};
+
+enum MetricsColumnFlag : uint32_t {
+    kTimeColumn = 1,
+    kValueColumn = 2,
+    kConfidenceColumn = 4,
+    kEndTimeColumn = 8,
+    kCountColumn = 16
+};
+
+enum MetricsFileFlag : uint32_t {
+    kPulseSnrSufficient = 1,
+    kBreathingSnrSufficient = 2
+};
+
+struct MetricsBinaryFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t series_count;
+    float pulse_strict;
+    float breathing_strict;
+    uint32_t flags;
+    // size of the Physiology version string that follows the header (padded with zeros to a multiple of 8 bytes)
+    uint32_t version_string_size;
+};
+static_assert(sizeof(MetricsBinaryFileHeader) == 32);
+
+struct MetricsBinarySeriesHeader {
+    MetricsSeriesId series_id;
+    MetricsValueType value_type;
+    MetricsColumnEncoding encoding;
+    // MetricsColumnFlag bits of the columns that follow, which come in time, value, confidence, end time, count order,
+    // each as a uint64 byte size followed by the column data (padded with zeros to a multiple of 8 bytes)
+    uint32_t column_flags;
+    uint64_t measurement_count;
+};
+static_assert(sizeof(MetricsBinarySeriesHeader) == 24);
+
+// Serialized form of `columns`. Float columns get `encoding`; the count and (0 / 1) value columns of the boolean
+// interval series are always raw.
+std::string SerializeMetricsBinary(const MetricsColumns& columns, MetricsColumnEncoding encoding);
+// Reads serialized metrics back, skipping series with unknown ids.
+absl::StatusOr<MetricsColumns> DeserializeMetricsBinary(std::string_view data);
+
+absl::Status WriteMetricsBinaryFile(
+    const std::filesystem::path& path,
+    const MetricsColumns& columns,
+    MetricsColumnEncoding encoding
+);
+
+struct FloatColumnView {
+    const float* data = nullptr;
+    size_t size = 0;
+};
+
+// Read-only memory mapping of a binary metrics file.
+class MetricsBinaryFile {
+public:
+    static absl::StatusOr<std::unique_ptr<MetricsBinaryFile>> Open(const std::filesystem::path& path);
+    ~MetricsBinaryFile();
+
+    MetricsBinaryFile(const MetricsBinaryFile&) = delete;
+    MetricsBinaryFile& operator=(const MetricsBinaryFile&) = delete;
+
+    std::string_view GetData() const;
+    absl::StatusOr<MetricsColumns> ReadColumns() const;
+    // Zero-copy access to a raw float32 column (NotFound if the series has no such column, FailedPrecondition if
+    // the column is encoded and thus needs to be read with ReadColumns()).
+    absl::StatusOr<FloatColumnView> GetRawFloatColumn(MetricsSeriesId series_id, MetricsColumnFlag column) const;
+
+private:
+    MetricsBinaryFile() = default;
+
+    int file_descriptor = -1;
+    const char* mapping = nullptr;
+    size_t mapping_length = 0;
+};
+
+// region ================================== Metrics file format flag ===================================================
+enum class MetricsFileFormat {
+    // formats::Metrics as (pretty-printed) JSON
+    Json,
+    // binary metrics file with raw columns
+    Binary,
+    // binary metrics file with delta-varint-encoded columns
+    CompactBinary,
+    Unknown_EnumEnd
+};
+
+std::vector<std::string> GetMetricsFileFormatNames();
+bool AbslParseFlag(absl::string_view text, MetricsFileFormat* format, std::string* error);
+std::string AbslUnparseFlag(MetricsFileFormat format);
+
+// Saves `metrics` as `path_stem` + ".json" or `kMetricsBinaryFileExtension`, depending on the format.
+absl::Status SaveMetrics(
+    const formats::Metrics& metrics,
+    const std::filesystem::path& path_stem,
+    MetricsFileFormat format
+);
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
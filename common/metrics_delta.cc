@@ -0,0 +1,351 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+// third-party includes
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/util/json_util.h>
+#include <physiology/interface/absl/strings/str_cat.h>
+
+// local includes
+#include "common/metrics_delta.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::Reflection;
+
+// Returns the `time` field of the series element type, if `field` is a time series, null otherwise.
+const FieldDescriptor* GetSeriesTimeField(const FieldDescriptor* field) {
+    if (!field->is_repeated() || field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+        return nullptr;
+    }
+    const FieldDescriptor* time_field = field->message_type()->FindFieldByName("time");
+    if (time_field == nullptr || time_field->is_repeated()) {
+        return nullptr;
+    }
+    switch (time_field->cpp_type()) {
+        case FieldDescriptor::CPPTYPE_FLOAT:
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+        case FieldDescriptor::CPPTYPE_INT32:
+        case FieldDescriptor::CPPTYPE_INT64:
+            return time_field;
+        default:
+            return nullptr;
+    }
+}
+
+double GetTime(const Message& measurement, const FieldDescriptor* time_field) {
+    const Reflection* reflection = measurement.GetReflection();
+    switch (time_field->cpp_type()) {
+        case FieldDescriptor::CPPTYPE_FLOAT:
+            return reflection->GetFloat(measurement, time_field);
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+            return reflection->GetDouble(measurement, time_field);
+        case FieldDescriptor::CPPTYPE_INT32:
+            return reflection->GetInt32(measurement, time_field);
+        default:
+            return static_cast<double>(reflection->GetInt64(measurement, time_field));
+    }
+}
+
+void SetTime(Message& measurement, const FieldDescriptor* time_field, double time) {
+    const Reflection* reflection = measurement.GetReflection();
+    switch (time_field->cpp_type()) {
+        case FieldDescriptor::CPPTYPE_FLOAT:
+            reflection->SetFloat(&measurement, time_field, static_cast<float>(time));
+            break;
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+            reflection->SetDouble(&measurement, time_field, time);
+            break;
+        case FieldDescriptor::CPPTYPE_INT32:
+            reflection->SetInt32(&measurement, time_field, static_cast<int32_t>(std::llround(time)));
+            break;
+        default:
+            reflection->SetInt64(&measurement, time_field, std::llround(time));
+            break;
+    }
+}
+
+// Calls `visit(measurement, time_field)` for every measurement of every time series in `message`, at any depth.
+template<typename TMessage, typename TVisit>
+void ForEachSeriesMeasurement(TMessage& message, const TVisit& visit) {
+    const google::protobuf::Descriptor* descriptor = message.GetDescriptor();
+    const Reflection* reflection = message.GetReflection();
+    for (int i_field = 0; i_field < descriptor->field_count(); i_field++) {
+        const FieldDescriptor* field = descriptor->field(i_field);
+        if (field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+            continue;
+        }
+        if (!field->is_repeated()) {
+            if (reflection->HasField(message, field)) {
+                if constexpr (std::is_const_v<TMessage>) {
+                    ForEachSeriesMeasurement(reflection->GetMessage(message, field), visit);
+                } else {
+                    ForEachSeriesMeasurement(*reflection->MutableMessage(&message, field), visit);
+                }
+            }
+            continue;
+        }
+        const FieldDescriptor* time_field = GetSeriesTimeField(field);
+        if (time_field == nullptr) {
+            continue;
+        }
+        for (int i_item = 0; i_item < reflection->FieldSize(message, field); i_item++) {
+            if constexpr (std::is_const_v<TMessage>) {
+                visit(reflection->GetRepeatedMessage(message, field, i_item), time_field);
+            } else {
+                visit(*reflection->MutableRepeatedMessage(&message, field, i_item), time_field);
+            }
+        }
+    }
+}
+
+// Copies a field that does not hold messages (scalars, enums, strings, and repeated fields of those).
+void CopyPlainField(const Message& source, Message* destination, const FieldDescriptor* field) {
+    const Reflection* source_reflection = source.GetReflection();
+    const Reflection* destination_reflection = destination->GetReflection();
+#define COPY_PLAIN_FIELD_CASE(CPP_TYPE, METHOD)                                                                       \
+        case FieldDescriptor::CPPTYPE_##CPP_TYPE:                                                                     \
+            if (field->is_repeated()) {                                                                               \
+                for (int i_item = 0; i_item < source_reflection->FieldSize(source, field); i_item++) {                \
+                    destination_reflection->Add##METHOD(                                                              \
+                        destination, field, source_reflection->GetRepeated##METHOD(source, field, i_item)             \
+                    );                                                                                                \
+                }                                                                                                     \
+            } else if (source_reflection->HasField(source, field)) {                                                  \
+                destination_reflection->Set##METHOD(                                                                  \
+                    destination, field, source_reflection->Get##METHOD(source, field)                                 \
+                );                                                                                                    \
+            }                                                                                                         \
+            break;
+    switch (field->cpp_type()) {
+        COPY_PLAIN_FIELD_CASE(INT32, Int32)
+        COPY_PLAIN_FIELD_CASE(INT64, Int64)
+        COPY_PLAIN_FIELD_CASE(UINT32, UInt32)
+        COPY_PLAIN_FIELD_CASE(UINT64, UInt64)
+        COPY_PLAIN_FIELD_CASE(FLOAT, Float)
+        COPY_PLAIN_FIELD_CASE(DOUBLE, Double)
+        COPY_PLAIN_FIELD_CASE(BOOL, Bool)
+        COPY_PLAIN_FIELD_CASE(ENUM, EnumValue)
+        COPY_PLAIN_FIELD_CASE(STRING, String)
+        default:
+            break;
+    }
+#undef COPY_PLAIN_FIELD_CASE
+}
+
+void MergeSeriesMessage(const Message& source, Message* destination, double from_time, double until_time) {
+    const google::protobuf::Descriptor* descriptor = source.GetDescriptor();
+    const Reflection* reflection = source.GetReflection();
+    const Reflection* destination_reflection = destination->GetReflection();
+    for (int i_field = 0; i_field < descriptor->field_count(); i_field++) {
+        const FieldDescriptor* field = descriptor->field(i_field);
+        if (field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+            if (field->is_repeated()) {
+                destination_reflection->ClearField(destination, field);
+            }
+            CopyPlainField(source, destination, field);
+            continue;
+        }
+        if (!field->is_repeated()) {
+            if (reflection->HasField(source, field)) {
+                MergeSeriesMessage(
+                    reflection->GetMessage(source, field), destination_reflection->MutableMessage(destination, field),
+                    from_time, until_time
+                );
+            }
+            continue;
+        }
+        const auto& series = reflection->GetRepeatedPtrField<Message>(source, field);
+        const FieldDescriptor* time_field = GetSeriesTimeField(field);
+        if (time_field == nullptr) {
+            // repeated, but not a time series: replace as a whole
+            destination_reflection->ClearField(destination, field);
+            for (const Message& item: series) {
+                destination_reflection->AddMessage(destination, field)->CopyFrom(item);
+            }
+            continue;
+        }
+        const auto first_kept = std::partition_point(
+            series.begin(), series.end(),
+            [&](const Message& measurement) { return GetTime(measurement, time_field) < from_time; }
+        );
+        const auto end_kept = std::partition_point(
+            first_kept, series.end(),
+            [&](const Message& measurement) { return GetTime(measurement, time_field) < until_time; }
+        );
+        if (first_kept == end_kept) {
+            continue;
+        }
+        const double first_kept_time = GetTime(*first_kept, time_field);
+        while (destination_reflection->FieldSize(*destination, field) > 0 &&
+               GetTime(destination_reflection->GetRepeatedMessage(
+                   *destination, field, destination_reflection->FieldSize(*destination, field) - 1
+               ), time_field) >= first_kept_time) {
+            destination_reflection->RemoveLast(destination, field);
+        }
+        for (auto measurement = first_kept; measurement != end_kept; ++measurement) {
+            destination_reflection->AddMessage(destination, field)->CopyFrom(*measurement);
+        }
+    }
+}
+
+} // anonymous namespace
+
+void MergeMetricsSeries(
+    const physiology::MetricsBuffer& source,
+    physiology::MetricsBuffer& destination,
+    double from_time_s,
+    double until_time_s
+) {
+    MergeSeriesMessage(source, &destination, from_time_s, until_time_s);
+}
+
+void ShiftMetricsSeries(physiology::MetricsBuffer& metrics, double offset_s) {
+    ForEachSeriesMeasurement(metrics, [&](Message& measurement, const FieldDescriptor* time_field) {
+        SetTime(measurement, time_field, GetTime(measurement, time_field) + offset_s);
+    });
+}
+
+double GetEarliestMetricsTime(const physiology::MetricsBuffer& metrics) {
+    double earliest_time = std::numeric_limits<double>::infinity();
+    ForEachSeriesMeasurement(metrics, [&](const Message& measurement, const FieldDescriptor* time_field) {
+        earliest_time = std::min(earliest_time, GetTime(measurement, time_field));
+    });
+    return earliest_time;
+}
+
+physiology::MetricsBuffer StitchSegmentMetrics(std::vector<SegmentMetrics>& segments) {
+    // how far before its read start the metrics of a part may start and still count as on the recording's timeline
+    constexpr double kTimelineToleranceSeconds = 1.0;
+    physiology::MetricsBuffer stitched;
+    for (SegmentMetrics& segment: segments) {
+        if (GetEarliestMetricsTime(segment.metrics) < segment.read_start_s - kTimelineToleranceSeconds) {
+            ShiftMetricsSeries(segment.metrics, segment.read_start_s);
+        }
+        MergeMetricsSeries(segment.metrics, stitched, segment.keep_from_s, segment.keep_until_s);
+    }
+    return stitched;
+}
+
+// region ===================================== MetricsDeltaTracker ====================================================
+MetricsDeltaTracker::MetricsDeltaTracker(MetricsDeltaSettings settings) : settings(settings) {}
+
+bool MetricsDeltaTracker::Track(const physiology::MetricsBuffer& metrics, physiology::MetricsBuffer& delta) {
+    const bool is_snapshot =
+        output_count == 0 ||
+        (settings.full_snapshot_interval > 0 && output_count % settings.full_snapshot_interval == 0);
+    output_count++;
+    if (is_snapshot) {
+        TrackMessage(metrics, nullptr, "");
+    } else {
+        delta.Clear();
+        TrackMessage(metrics, &delta, "");
+    }
+    return is_snapshot;
+}
+
+void MetricsDeltaTracker::Reset() {
+    output_count = 0;
+    high_water_times.clear();
+}
+
+void MetricsDeltaTracker::TrackMessage(const Message& source, Message* delta, const std::string& path) {
+    const google::protobuf::Descriptor* descriptor = source.GetDescriptor();
+    const Reflection* reflection = source.GetReflection();
+    for (int i_field = 0; i_field < descriptor->field_count(); i_field++) {
+        const FieldDescriptor* field = descriptor->field(i_field);
+        if (field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+            if (delta != nullptr) {
+                CopyPlainField(source, delta, field);
+            }
+            continue;
+        }
+        const std::string field_path = path.empty() ? field->name() : absl::StrCat(path, ".", field->name());
+        if (!field->is_repeated()) {
+            if (reflection->HasField(source, field)) {
+                TrackMessage(
+                    reflection->GetMessage(source, field),
+                    delta != nullptr ? delta->GetReflection()->MutableMessage(delta, field) : nullptr,
+                    field_path
+                );
+            }
+            continue;
+        }
+        const auto& series = reflection->GetRepeatedPtrField<Message>(source, field);
+        const FieldDescriptor* time_field = GetSeriesTimeField(field);
+        if (time_field == nullptr) {
+            // repeated, but not a time series: pass through as is
+            for (int i_item = 0; delta != nullptr && i_item < series.size(); i_item++) {
+                delta->GetReflection()->AddMessage(delta, field)->CopyFrom(series.Get(i_item));
+            }
+            continue;
+        }
+        if (series.empty()) {
+            continue;
+        }
+        const double last_time = GetTime(*(series.end() - 1), time_field);
+        auto high_water_time = high_water_times.find(field_path);
+        auto first_new = series.begin();
+        if (high_water_time != high_water_times.end() && last_time >= high_water_time->second) {
+            // binary search, so that the cost stays proportional to the new measurements rather than to the history
+            first_new = std::partition_point(
+                series.begin(), series.end(),
+                [&](const Message& measurement) { return GetTime(measurement, time_field) <= high_water_time->second; }
+            );
+        }
+        for (auto measurement = first_new; delta != nullptr && measurement != series.end(); ++measurement) {
+            delta->GetReflection()->AddMessage(delta, field)->CopyFrom(*measurement);
+        }
+        high_water_times[field_path] = last_time;
+    }
+}
+// endregion ===========================================================================================================
+
+// region ===================================== MetricsDeltaWriter =====================================================
+MetricsDeltaWriter::MetricsDeltaWriter(std::filesystem::path path, MetricsDeltaSettings settings)
+    : path(std::move(path)), file(this->path, std::ios::trunc), tracker(settings) {}
+
+absl::StatusOr<std::unique_ptr<MetricsDeltaWriter>> MetricsDeltaWriter::Open(
+    const std::filesystem::path& path,
+    MetricsDeltaSettings settings
+) {
+    std::unique_ptr<MetricsDeltaWriter> writer(new MetricsDeltaWriter(path, settings));
+    if (!writer->file.is_open()) {
+        return absl::InternalError("Could not open metrics delta stream " + path.string());
+    }
+    return writer;
+}
+
+absl::Status MetricsDeltaWriter::Write(const physiology::MetricsBuffer& metrics, int64_t timestamp_us) {
+    const bool is_snapshot = tracker.Track(metrics, delta);
+    metrics_json.clear();
+    google::protobuf::util::JsonPrintOptions json_options;
+    json_options.preserve_proto_field_names = true;
+    const auto conversion_status =
+        google::protobuf::util::MessageToJsonString(is_snapshot ? metrics : delta, &metrics_json, json_options);
+    if (!conversion_status.ok()) {
+        return absl::InternalError(
+            absl::StrCat("Could not convert metrics to JSON: ", conversion_status.ToString())
+        );
+    }
+    file << "{\"sequence\":" << sequence++ << ",\"timestamp_us\":" << timestamp_us
+         << ",\"snapshot\":" << (is_snapshot ? "true" : "false") << ",\"metrics\":" << metrics_json << "}\n";
+    file.flush();
+    if (file.fail()) {
+        return absl::InternalError("Could not write to metrics delta stream " + path.string());
+    }
+    return absl::OkStatus();
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,128 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// third-party includes
+#include <google/protobuf/message.h>
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/status/statusor.h>
+#include <physiology/modules/messages/metrics.pb.h>
+
+namespace presage::smartspectra::examples {
+
+struct MetricsDeltaSettings {
+    // Every this many outputs, the whole metrics buffer is emitted instead of a delta, so that consumers that missed
+    // (or started after) earlier outputs, or that need measurements revised after they were first emitted, can resync.
+    // When 1, every output is a full snapshot; when 0, only the first one is.
+    int full_snapshot_interval = 20;
+};
+
+// Turns the growing metrics buffers of continuous mode into a delta stream: tracks, for every time series in the
+// buffer (any repeated message field with a `time` field, at any depth), the time of the last measurement emitted so
+// far, so that later outputs only need to carry what came after it.
+// Series are expected to be in time order, as Core produces them. Measurements that Core revises after they were
+// emitted (e.g. ones that were not yet stable) are only picked up by the next full snapshot.
+class MetricsDeltaTracker {
+public:
+    explicit MetricsDeltaTracker(MetricsDeltaSettings settings = MetricsDeltaSettings());
+
+    // Records `metrics` as emitted and returns true if it is due to be emitted in full, as a snapshot.
+    // Otherwise, fills `delta` with the measurements of `metrics` that are newer than the ones emitted before (a series
+    // that went back in time, e.g. after the Core buffer was reset, is taken in full), plus everything in `metrics`
+    // that is not a time series, and returns false.
+    bool Track(const physiology::MetricsBuffer& metrics, physiology::MetricsBuffer& delta);
+    // Forgets what was emitted. The next output will be a full snapshot.
+    void Reset();
+
+    int64_t GetOutputCount() const { return output_count; }
+
+private:
+    // Copies the new part of `source` into `delta`, or, when `delta` is null, just updates the high-water times.
+    void TrackMessage(
+        const google::protobuf::Message& source,
+        google::protobuf::Message* delta,
+        const std::string& path
+    );
+
+    MetricsDeltaSettings settings;
+    int64_t output_count = 0;
+    // time of the last emitted measurement, by series path (e.g. "pulse.rate")
+    std::unordered_map<std::string, double> high_water_times;
+};
+
+// Merges the time series of `source` (as told apart by MetricsDeltaTracker) into `destination`: the measurements of
+// `source` timed within [from_time_s, until_time_s) replace those of `destination` from the first of them on, so that
+// later (possibly revised) measurements win. Everything else in `source` replaces what is in `destination`.
+// Builds up the whole history out of successive continuous-mode outputs (which only hold what Core still buffers), or
+// stitches together the histories of consecutive parts of a recording, each kept within its own time range.
+void MergeMetricsSeries(
+    const physiology::MetricsBuffer& source,
+    physiology::MetricsBuffer& destination,
+    double from_time_s = -std::numeric_limits<double>::infinity(),
+    double until_time_s = std::numeric_limits<double>::infinity()
+);
+
+// Shifts the times of all the time series of `metrics` (see MetricsDeltaTracker) by `offset_s`.
+void ShiftMetricsSeries(physiology::MetricsBuffer& metrics, double offset_s);
+
+// Returns the time of the earliest measurement in any time series of `metrics`, or +infinity when there is none.
+double GetEarliestMetricsTime(const physiology::MetricsBuffer& metrics);
+
+// Metrics history of one of several consecutive parts of a recording processed on their own (e.g. as separate Core
+// streams), all times in seconds of the recording.
+struct SegmentMetrics {
+    physiology::MetricsBuffer metrics;
+    // where the part was read from
+    double read_start_s = 0.0;
+    // what it is kept for in the stitched history: [keep_from_s, keep_until_s)
+    double keep_from_s = -std::numeric_limits<double>::infinity();
+    double keep_until_s = std::numeric_limits<double>::infinity();
+};
+
+// Stitches the histories of consecutive parts of a recording back together, in order, each kept within its own time
+// range (see MergeMetricsSeries).
+// Core starts the times of every stream near 0, whatever the input timestamps, so the metrics of a part are first
+// shifted by its `read_start_s` (in place), unless they already start within a second of it, on the recording's
+// timeline.
+physiology::MetricsBuffer StitchSegmentMetrics(std::vector<SegmentMetrics>& segments);
+
+// Writes one line per continuous-mode output to an NDJSON file (replacing what was in it, so a file holds one run):
+// {"sequence":<n>,"timestamp_us":<input timestamp>,"snapshot":<true|false>,"metrics":<MetricsBuffer as JSON>},
+// where "metrics" only holds the measurements that are new since the previous line, unless "snapshot" is true.
+// Sequence numbers start at 0 and go up by 1 per line.
+class MetricsDeltaWriter {
+public:
+    static absl::StatusOr<std::unique_ptr<MetricsDeltaWriter>> Open(
+        const std::filesystem::path& path,
+        MetricsDeltaSettings settings = MetricsDeltaSettings()
+    );
+
+    absl::Status Write(const physiology::MetricsBuffer& metrics, int64_t timestamp_us);
+    // Makes the next line a full snapshot (sequence numbers carry on).
+    void Reset() { tracker.Reset(); }
+
+private:
+    MetricsDeltaWriter(std::filesystem::path path, MetricsDeltaSettings settings);
+
+    std::filesystem::path path;
+    std::ofstream file;
+    MetricsDeltaTracker tracker;
+    int64_t sequence = 0;
+    // reused between outputs, to keep its allocations
+    physiology::MetricsBuffer delta;
+    std::string metrics_json;
+};
+
+} // namespace presage::smartspectra::examples
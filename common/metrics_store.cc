@@ -0,0 +1,749 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// third-party includes
+#include <google/protobuf/descriptor.h>
+#include <physiology/interface/absl/strings/numbers.h>
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/absl/strings/str_format.h>
+#include <physiology/interface/absl/strings/str_join.h>
+#include <physiology/interface/absl/strings/str_split.h>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/metrics_store.hpp"
+#include "common/status_macros.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::Reflection;
+
+constexpr double kMiB = 1024.0 * 1024.0;
+
+bool IsNumber(const FieldDescriptor* field) {
+    if (field == nullptr || field->is_repeated()) {
+        return false;
+    }
+    switch (field->cpp_type()) {
+        case FieldDescriptor::CPPTYPE_FLOAT:
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+        case FieldDescriptor::CPPTYPE_INT32:
+        case FieldDescriptor::CPPTYPE_INT64:
+        case FieldDescriptor::CPPTYPE_UINT32:
+        case FieldDescriptor::CPPTYPE_UINT64:
+        case FieldDescriptor::CPPTYPE_BOOL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+float GetNumber(const Message& message, const FieldDescriptor* field) {
+    const Reflection* reflection = message.GetReflection();
+    switch (field->cpp_type()) {
+        case FieldDescriptor::CPPTYPE_FLOAT:
+            return reflection->GetFloat(message, field);
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+            return static_cast<float>(reflection->GetDouble(message, field));
+        case FieldDescriptor::CPPTYPE_INT32:
+            return static_cast<float>(reflection->GetInt32(message, field));
+        case FieldDescriptor::CPPTYPE_INT64:
+            return static_cast<float>(reflection->GetInt64(message, field));
+        case FieldDescriptor::CPPTYPE_UINT32:
+            return static_cast<float>(reflection->GetUInt32(message, field));
+        case FieldDescriptor::CPPTYPE_UINT64:
+            return static_cast<float>(reflection->GetUInt64(message, field));
+        default:
+            return reflection->GetBool(message, field) ? 1.0f : 0.0f;
+    }
+}
+
+// The fields of a time series' measurements, or a null `time` field if `field` is not a time series.
+struct SeriesFields {
+    const FieldDescriptor* time = nullptr;
+    const FieldDescriptor* value = nullptr;
+    // null for series without confidences
+    const FieldDescriptor* confidence = nullptr;
+};
+
+SeriesFields GetSeriesFields(const FieldDescriptor* field) {
+    if (!field->is_repeated() || field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+        return {};
+    }
+    const google::protobuf::Descriptor* measurement = field->message_type();
+    SeriesFields fields{measurement->FindFieldByName("time"), measurement->FindFieldByName("value")};
+    if (fields.value == nullptr) {
+        // detection series, e.g. face blinking / talking
+        fields.value = measurement->FindFieldByName("detected");
+    }
+    if (!IsNumber(fields.time) || fields.time->cpp_type() == FieldDescriptor::CPPTYPE_BOOL ||
+        !IsNumber(fields.value)) {
+        return {};
+    }
+    fields.confidence = measurement->FindFieldByName("confidence");
+    if (!IsNumber(fields.confidence)) {
+        fields.confidence = nullptr;
+    }
+    return fields;
+}
+
+absl::Status ErrnoStatus(const std::string& what) {
+    return absl::InternalError(absl::StrCat(what, ": ", std::strerror(errno)));
+}
+
+absl::Status WriteAll(int descriptor, const void* data, size_t size, int64_t offset) {
+    const auto* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t written = pwrite(descriptor, bytes, size, offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return ErrnoStatus("Could not write to the metrics store spill file");
+        }
+        bytes += written;
+        size -= written;
+        offset += written;
+    }
+    return absl::OkStatus();
+}
+
+absl::Status ReadAll(int descriptor, void* data, size_t size, int64_t offset) {
+    auto* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        const ssize_t read_size = pread(descriptor, bytes, size, offset);
+        if (read_size < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return ErrnoStatus("Could not read from the metrics store spill file");
+        }
+        if (read_size == 0) {
+            return absl::DataLossError("The metrics store spill file is shorter than expected.");
+        }
+        bytes += read_size;
+        size -= read_size;
+        offset += read_size;
+    }
+    return absl::OkStatus();
+}
+
+// Appends the measurements of `chunk_columns` timed within [from_time_s, until_time_s) to `result`.
+void AppendTimeRange(
+    const SeriesColumns<float>& chunk_columns,
+    double from_time_s,
+    double until_time_s,
+    SeriesColumns<float>& result
+) {
+    const auto begin = std::lower_bound(
+        chunk_columns.time.begin(), chunk_columns.time.end(), from_time_s,
+        [](float time, double bound) { return time < bound; }
+    );
+    const auto end = std::lower_bound(
+        begin, chunk_columns.time.end(), until_time_s, [](float time, double bound) { return time < bound; }
+    );
+    const size_t first = begin - chunk_columns.time.begin();
+    const size_t last = end - chunk_columns.time.begin();
+    result.time.insert(result.time.end(), begin, end);
+    result.value.insert(result.value.end(), chunk_columns.value.begin() + first, chunk_columns.value.begin() + last);
+    if (!chunk_columns.confidence.empty()) {
+        result.confidence.insert(
+            result.confidence.end(), chunk_columns.confidence.begin() + first, chunk_columns.confidence.begin() + last
+        );
+    }
+}
+
+void AppendJsonArray(std::string& json, const char* key, const std::vector<float>& values) {
+    absl::StrAppend(&json, ",\"", key, "\":[");
+    for (size_t i_value = 0; i_value < values.size(); i_value++) {
+        if (i_value > 0) {
+            json += ",";
+        }
+        if (std::isfinite(values[i_value])) {
+            absl::StrAppendFormat(&json, "%.7g", values[i_value]);
+        } else {
+            // JSON has no NaN (or infinity), e.g. for a rate Core could not compute
+            json += "null";
+        }
+    }
+    json += "]";
+}
+
+} // anonymous namespace
+
+// region ====================================== MetricsStore ==========================================================
+absl::StatusOr<std::unique_ptr<MetricsStore>> MetricsStore::Create(MetricsStoreSettings settings) {
+    if (settings.chunk_size == 0) {
+        return absl::InvalidArgumentError("The metrics store chunk size has to be positive.");
+    }
+    for (const double interval_s: settings.rollup_intervals_s) {
+        if (!(interval_s > 0.0)) {
+            return absl::InvalidArgumentError(absl::StrCat("Invalid metrics store rollup interval: ", interval_s));
+        }
+    }
+    int spill_descriptor = -1;
+    if (settings.max_resident_bytes > 0) {
+        std::error_code error;
+        const std::filesystem::path spill_directory = settings.spill_directory.empty()
+                                                      ? std::filesystem::temp_directory_path(error)
+                                                      : settings.spill_directory;
+        if (error) {
+            return absl::InternalError("Could not find the temporary directory: " + error.message());
+        }
+        std::string spill_path = (spill_directory / "metrics_store_XXXXXX").string();
+        spill_descriptor = mkstemp(spill_path.data());
+        if (spill_descriptor < 0) {
+            return ErrnoStatus("Could not create a metrics store spill file in " + spill_directory.string());
+        }
+        // the open descriptor keeps the file around for as long as the store needs it
+        unlink(spill_path.c_str());
+    }
+    return std::unique_ptr<MetricsStore>(new MetricsStore(std::move(settings), spill_descriptor));
+}
+
+MetricsStore::MetricsStore(MetricsStoreSettings settings, int spill_descriptor)
+    : settings(std::move(settings)), spill_descriptor(spill_descriptor) {}
+
+MetricsStore::~MetricsStore() {
+    if (spill_descriptor >= 0) {
+        close(spill_descriptor);
+    }
+}
+
+absl::Status MetricsStore::Append(const physiology::MetricsBuffer& metrics) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const absl::Status status = AppendMessage(metrics, "");
+    reset_marked = false;
+    MP_RETURN_IF_ERROR(status);
+    return SpillWhileOverBudget();
+}
+
+absl::Status MetricsStore::Append(const std::string& series_name, const SeriesColumns<float>& measurements) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Series& series = GetOrAddSeries(series_name);
+    const bool with_confidence = measurements.confidence.size() == measurements.Size();
+    if (measurements.Size() > 0) {
+        StartEpochIfReset(series_name, series, measurements.time.back());
+    }
+    for (size_t i_measurement = 0; i_measurement < measurements.Size(); i_measurement++) {
+        const float time = measurements.time[i_measurement] + time_offset;
+        if (series.measurement_count > 0 && time <= series.last_time) {
+            continue;
+        }
+        AppendMeasurement(
+            series, time, measurements.value[i_measurement],
+            with_confidence ? &measurements.confidence[i_measurement] : nullptr
+        );
+    }
+    reset_marked = false;
+    return SpillWhileOverBudget();
+}
+
+void MetricsStore::MarkReset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    reset_marked = true;
+}
+
+absl::Status MetricsStore::AppendMessage(const Message& message, const std::string& path) {
+    const google::protobuf::Descriptor* descriptor = message.GetDescriptor();
+    const Reflection* reflection = message.GetReflection();
+    for (int i_field = 0; i_field < descriptor->field_count(); i_field++) {
+        const FieldDescriptor* field = descriptor->field(i_field);
+        if (field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+            continue;
+        }
+        const std::string field_path = path.empty() ? field->name() : absl::StrCat(path, ".", field->name());
+        if (!field->is_repeated()) {
+            if (reflection->HasField(message, field)) {
+                MP_RETURN_IF_ERROR(AppendMessage(reflection->GetMessage(message, field), field_path));
+            }
+            continue;
+        }
+        const SeriesFields fields = GetSeriesFields(field);
+        if (fields.time == nullptr) {
+            continue;
+        }
+        const auto& measurements = reflection->GetRepeatedPtrField<Message>(message, field);
+        Series& series = GetOrAddSeries(field_path, fields.value->cpp_type() == FieldDescriptor::CPPTYPE_BOOL);
+        if (measurements.empty()) {
+            continue;
+        }
+        // Core buffers are in time order and overlap the previous output; only their tail is new
+        int first_new = 0;
+        if (series.measurement_count > 0) {
+            StartEpochIfReset(field_path, series, GetNumber(measurements.Get(measurements.size() - 1), fields.time));
+            const float last_time = series.last_time;
+            const auto new_begin = std::partition_point(
+                measurements.begin(), measurements.end(),
+                [&](const Message& measurement) {
+                    return GetNumber(measurement, fields.time) + time_offset <= last_time;
+                }
+            );
+            first_new = static_cast<int>(new_begin - measurements.begin());
+        }
+        for (int i_measurement = first_new; i_measurement < measurements.size(); i_measurement++) {
+            const Message& measurement = measurements.Get(i_measurement);
+            const float confidence = fields.confidence != nullptr ? GetNumber(measurement, fields.confidence) : 0.0f;
+            AppendMeasurement(
+                series, GetNumber(measurement, fields.time) + time_offset, GetNumber(measurement, fields.value),
+                fields.confidence != nullptr ? &confidence : nullptr
+            );
+        }
+    }
+    return absl::OkStatus();
+}
+
+MetricsStore::Series& MetricsStore::GetOrAddSeries(const std::string& name, bool is_boolean) {
+    auto [series_iterator, inserted] = series_by_name.try_emplace(name);
+    if (inserted) {
+        series_iterator->second.is_boolean = is_boolean;
+        for (const double interval_s: settings.rollup_intervals_s) {
+            series_iterator->second.rollups.push_back(Rollup{interval_s, {}});
+        }
+    }
+    return series_iterator->second;
+}
+
+void MetricsStore::StartEpochIfReset(const std::string& name, const Series& series, float batch_last_time) {
+    if (series.measurement_count == 0 || batch_last_time + time_offset >= series.last_time) {
+        return;
+    }
+    // Core outputs overlap by up to a buffer, so a batch that ends a little earlier than the last one is a stale tail
+    const double time_step_s = static_cast<double>(series.last_time) - (batch_last_time + time_offset);
+    if (!reset_marked && time_step_s <= settings.reset_time_step_s && batch_last_time > settings.reset_time_step_s) {
+        return;
+    }
+    // Core times restart (from about 0) after a reset, so the new epoch starts right after the stored data ends
+    time_offset = std::nextafter(latest_time, std::numeric_limits<float>::infinity());
+    epoch_count++;
+    LOG(WARNING) << "Metrics series " << name << " went back in time (to " << batch_last_time << " s, from "
+                 << series.last_time << " s stored), e.g. after the Core buffer was reset: storing the metrics that "
+                 << "follow as epoch " << epoch_count << ", shifted by " << time_offset << " s.";
+}
+
+void MetricsStore::AppendMeasurement(Series& series, float time, float value, const float* confidence) {
+    series.measurement_count++;
+    series.last_time = time;
+    latest_time = std::max(latest_time, time);
+    AppendToRollups(series, time, value);
+    if (series.is_boolean) {
+        series.intervals.Append(time, value != 0.0f);
+        return;
+    }
+    if (series.chunks.empty() || series.chunks.back().size == settings.chunk_size) {
+        Chunk& chunk = series.chunks.emplace_back();
+        chunk.min_time = time;
+        chunk.has_confidence = confidence != nullptr;
+        chunk.columns.Reserve(settings.chunk_size, chunk.has_confidence);
+    }
+    Chunk& chunk = series.chunks.back();
+    chunk.max_time = time;
+    chunk.columns.time.push_back(time);
+    chunk.columns.value.push_back(value);
+    if (chunk.has_confidence) {
+        chunk.columns.confidence.push_back(confidence != nullptr ? *confidence : 0.0f);
+    }
+    chunk.size++;
+    resident_bytes += chunk.has_confidence ? 3 * sizeof(float) : 2 * sizeof(float);
+    if (chunk.size == settings.chunk_size) {
+        spillable_chunks.emplace_back(&series, series.chunks.size() - 1);
+    }
+}
+
+void MetricsStore::AppendToRollups(Series& series, float time, float value) {
+    for (Rollup& rollup: series.rollups) {
+        const double start_time = std::floor(time / rollup.interval_s) * rollup.interval_s;
+        if (rollup.buckets.empty() || rollup.buckets.back().start_time < start_time) {
+            rollup.buckets.push_back(MetricsRollupBucket{start_time, 0, 0.0, value, value});
+        }
+        MetricsRollupBucket& bucket = rollup.buckets.back();
+        bucket.count++;
+        bucket.sum += value;
+        bucket.min = std::min(bucket.min, value);
+        bucket.max = std::max(bucket.max, value);
+    }
+}
+
+absl::Status MetricsStore::SpillWhileOverBudget() {
+    if (spill_descriptor < 0) {
+        return absl::OkStatus();
+    }
+    while (resident_bytes > settings.max_resident_bytes && !spillable_chunks.empty()) {
+        auto [series, i_chunk] = spillable_chunks.front();
+        Chunk& chunk = series->chunks[i_chunk];
+        // times, values and confidences, one after the other
+        const size_t column_bytes = chunk.size * sizeof(float);
+        int64_t offset = spill_file_size;
+        MP_RETURN_IF_ERROR(WriteAll(spill_descriptor, chunk.columns.time.data(), column_bytes, offset));
+        offset += static_cast<int64_t>(column_bytes);
+        MP_RETURN_IF_ERROR(WriteAll(spill_descriptor, chunk.columns.value.data(), column_bytes, offset));
+        offset += static_cast<int64_t>(column_bytes);
+        if (chunk.has_confidence) {
+            MP_RETURN_IF_ERROR(WriteAll(spill_descriptor, chunk.columns.confidence.data(), column_bytes, offset));
+            offset += static_cast<int64_t>(column_bytes);
+        }
+        chunk.spill_offset = spill_file_size;
+        spill_file_size = offset;
+        resident_bytes -= GetChunkBytes(chunk);
+        spilled_measurement_count += chunk.size;
+        // swapped out rather than cleared, to give the memory back
+        SeriesColumns<float>().time.swap(chunk.columns.time);
+        SeriesColumns<float>().value.swap(chunk.columns.value);
+        SeriesColumns<float>().confidence.swap(chunk.columns.confidence);
+        spillable_chunks.pop_front();
+    }
+    return absl::OkStatus();
+}
+
+size_t MetricsStore::GetChunkBytes(const Chunk& chunk) {
+    return chunk.size * (chunk.has_confidence ? 3 : 2) * sizeof(float);
+}
+
+absl::StatusOr<SeriesColumns<float>> MetricsStore::LoadChunk(const Chunk& chunk) const {
+    SeriesColumns<float> columns;
+    const size_t column_bytes = chunk.size * sizeof(float);
+    int64_t offset = chunk.spill_offset;
+    columns.time.resize(chunk.size);
+    MP_RETURN_IF_ERROR(ReadAll(spill_descriptor, columns.time.data(), column_bytes, offset));
+    offset += static_cast<int64_t>(column_bytes);
+    columns.value.resize(chunk.size);
+    MP_RETURN_IF_ERROR(ReadAll(spill_descriptor, columns.value.data(), column_bytes, offset));
+    offset += static_cast<int64_t>(column_bytes);
+    if (chunk.has_confidence) {
+        columns.confidence.resize(chunk.size);
+        MP_RETURN_IF_ERROR(ReadAll(spill_descriptor, columns.confidence.data(), column_bytes, offset));
+    }
+    return columns;
+}
+
+absl::StatusOr<const MetricsStore::Series*> MetricsStore::FindSeries(const std::string& name) const {
+    const auto series_iterator = series_by_name.find(name);
+    if (series_iterator == series_by_name.end()) {
+        return absl::NotFoundError("No series named " + name + " in the metrics store.");
+    }
+    return &series_iterator->second;
+}
+
+absl::StatusOr<float> MetricsStore::GetLastTime(const std::string& series_name) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto series_or_status = FindSeries(series_name);
+    if (!series_or_status.ok()) {
+        return series_or_status.status();
+    }
+    const Series& series = *series_or_status.value();
+    if (series.measurement_count == 0) {
+        return absl::NotFoundError("Series " + series_name + " has no measurements yet.");
+    }
+    return series.last_time;
+}
+
+absl::StatusOr<SeriesColumns<float>> MetricsStore::Query(
+    const std::string& series_name,
+    double from_time_s,
+    double until_time_s
+) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto series_or_status = FindSeries(series_name);
+    if (!series_or_status.ok()) {
+        return series_or_status.status();
+    }
+    return QueryLocked(*series_or_status.value(), from_time_s, until_time_s);
+}
+
+absl::StatusOr<SeriesColumns<float>> MetricsStore::QueryLast(const std::string& series_name, double duration_s) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto series_or_status = FindSeries(series_name);
+    if (!series_or_status.ok()) {
+        return series_or_status.status();
+    }
+    const Series& series = *series_or_status.value();
+    if (series.measurement_count == 0) {
+        return SeriesColumns<float>();
+    }
+    return QueryLocked(series, series.last_time - duration_s, std::numeric_limits<double>::infinity());
+}
+
+absl::StatusOr<SeriesColumns<float>> MetricsStore::QueryLocked(
+    const Series& series,
+    double from_time_s,
+    double until_time_s
+) const {
+    SeriesColumns<float> result;
+    if (series.is_boolean) {
+        const auto [first, last] = FindIntervals(series, from_time_s, until_time_s);
+        SeriesColumns<uint8_t> expanded;
+        for (size_t i_interval = first; i_interval < last; i_interval++) {
+            series.intervals.Expand(i_interval, expanded);
+        }
+        for (size_t i_measurement = 0; i_measurement < expanded.Size(); i_measurement++) {
+            const float time = expanded.time[i_measurement];
+            if (time >= from_time_s && time < until_time_s) {
+                result.time.push_back(time);
+                result.value.push_back(expanded.value[i_measurement]);
+            }
+        }
+        return result;
+    }
+    // chunks are in time order and don't overlap: skip those that end before the range, stop at the first one that
+    // starts after it
+    auto chunk = std::partition_point(
+        series.chunks.begin(), series.chunks.end(), [from_time_s](const Chunk& chunk) {
+            return chunk.max_time < from_time_s;
+        }
+    );
+    for (; chunk != series.chunks.end() && chunk->min_time < until_time_s; ++chunk) {
+        if (chunk->spill_offset < 0) {
+            AppendTimeRange(chunk->columns, from_time_s, until_time_s, result);
+            continue;
+        }
+        auto columns_or_status = LoadChunk(*chunk);
+        if (!columns_or_status.ok()) {
+            return columns_or_status.status();
+        }
+        AppendTimeRange(columns_or_status.value(), from_time_s, until_time_s, result);
+    }
+    return result;
+}
+
+std::pair<size_t, size_t> MetricsStore::FindIntervals(const Series& series, double from_time_s, double until_time_s) {
+    const BooleanIntervals& intervals = series.intervals;
+    const auto first = std::lower_bound(
+        intervals.end_time.begin(), intervals.end_time.end(), from_time_s,
+        [](float time, double bound) { return time < bound; }
+    ) - intervals.end_time.begin();
+    const auto last = std::lower_bound(
+        intervals.start_time.begin() + first, intervals.start_time.end(), until_time_s,
+        [](float time, double bound) { return time < bound; }
+    ) - intervals.start_time.begin();
+    return {static_cast<size_t>(first), static_cast<size_t>(last)};
+}
+
+bool MetricsStore::HasIntervals(const std::string& series_name) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto series_iterator = series_by_name.find(series_name);
+    return series_iterator != series_by_name.end() && series_iterator->second.is_boolean;
+}
+
+absl::StatusOr<BooleanIntervals> MetricsStore::QueryIntervals(
+    const std::string& series_name,
+    double from_time_s,
+    double until_time_s
+) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto series_or_status = FindSeries(series_name);
+    if (!series_or_status.ok()) {
+        return series_or_status.status();
+    }
+    const Series& series = *series_or_status.value();
+    if (!series.is_boolean) {
+        return absl::FailedPreconditionError("Series " + series_name + " is not a boolean series.");
+    }
+    const auto [first, last] = FindIntervals(series, from_time_s, until_time_s);
+    BooleanIntervals result;
+    auto copy_range = [first = first, last = last](const auto& from, auto& to) {
+        to.assign(from.begin() + first, from.begin() + last);
+    };
+    copy_range(series.intervals.start_time, result.start_time);
+    copy_range(series.intervals.end_time, result.end_time);
+    copy_range(series.intervals.count, result.count);
+    copy_range(series.intervals.value, result.value);
+    return result;
+}
+
+absl::StatusOr<std::vector<MetricsRollupBucket>> MetricsStore::QueryRollup(
+    const std::string& series_name,
+    double interval_s,
+    double from_time_s,
+    double until_time_s
+) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto series_or_status = FindSeries(series_name);
+    if (!series_or_status.ok()) {
+        return series_or_status.status();
+    }
+    for (const Rollup& rollup: series_or_status.value()->rollups) {
+        if (std::abs(rollup.interval_s - interval_s) > 1e-9) {
+            continue;
+        }
+        const auto begin = std::partition_point(
+            rollup.buckets.begin(), rollup.buckets.end(),
+            [from_time_s](const MetricsRollupBucket& bucket) { return bucket.start_time < from_time_s; }
+        );
+        const auto end = std::partition_point(
+            begin, rollup.buckets.end(),
+            [until_time_s](const MetricsRollupBucket& bucket) { return bucket.start_time < until_time_s; }
+        );
+        return std::vector<MetricsRollupBucket>(begin, end);
+    }
+    return absl::InvalidArgumentError(absl::StrCat(
+        "No ", interval_s, " s rollup in the metrics store (rollup intervals: ",
+        absl::StrJoin(settings.rollup_intervals_s, ", "), " s)."
+    ));
+}
+
+std::vector<std::string> MetricsStore::GetSeriesNames() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> names;
+    for (const auto& [name, series]: series_by_name) {
+        names.push_back(name);
+    }
+    return names;
+}
+
+size_t MetricsStore::GetMeasurementCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t measurement_count = 0;
+    for (const auto& [name, series]: series_by_name) {
+        measurement_count += series.measurement_count;
+    }
+    return measurement_count;
+}
+
+int MetricsStore::GetEpochCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return epoch_count;
+}
+
+std::string MetricsStore::Summarize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t measurement_count = 0;
+    size_t interval_count = 0;
+    size_t rollup_bytes = 0;
+    for (const auto& [name, series]: series_by_name) {
+        measurement_count += series.measurement_count;
+        interval_count += series.intervals.Size();
+        for (const Rollup& rollup: series.rollups) {
+            rollup_bytes += rollup.buckets.size() * sizeof(MetricsRollupBucket);
+        }
+    }
+    return absl::StrFormat(
+        "%d series, %d measurements (%d spilled, %.1f MiB; %d boolean intervals), %.1f MiB resident, "
+        "%.1f MiB of rollups, %d time resets",
+        series_by_name.size(), measurement_count, spilled_measurement_count, spill_file_size / kMiB, interval_count,
+        resident_bytes / kMiB, rollup_bytes / kMiB, epoch_count
+    );
+}
+// endregion ===========================================================================================================
+
+absl::StatusOr<std::string> QueryMetricsStoreJson(const MetricsStore& store, std::string_view query) {
+    if (query.empty()) {
+        std::string json = "{\"series\":[";
+        const std::vector<std::string> names = store.GetSeriesNames();
+        for (size_t i_name = 0; i_name < names.size(); i_name++) {
+            absl::StrAppend(&json, i_name == 0 ? "\"" : ",\"", names[i_name], "\"");
+        }
+        return json + "]}";
+    }
+    std::string series_name;
+    double from_time_s = -std::numeric_limits<double>::infinity();
+    double until_time_s = std::numeric_limits<double>::infinity();
+    double last_s = -1.0;
+    double rollup_interval_s = 0.0;
+    for (const absl::string_view parameter: absl::StrSplit(
+        absl::string_view(query.data(), query.size()), '&', absl::SkipEmpty()
+    )) {
+        const std::pair<absl::string_view, absl::string_view> key_value =
+            absl::StrSplit(parameter, absl::MaxSplits('=', 1));
+        const auto& [key, value] = key_value;
+        if (key == "series") {
+            series_name = std::string(value);
+            continue;
+        }
+        double number = 0.0;
+        if (!absl::SimpleAtod(value, &number)) {
+            return absl::InvalidArgumentError(absl::StrCat("Invalid number for ", key, ": ", value));
+        }
+        if (key == "from") {
+            from_time_s = number;
+        } else if (key == "until") {
+            until_time_s = number;
+        } else if (key == "last") {
+            last_s = number;
+        } else if (key == "rollup") {
+            rollup_interval_s = number;
+        } else {
+            return absl::InvalidArgumentError(absl::StrCat(
+                "Unknown query parameter ", key, " (expected series, from, until, last or rollup)."
+            ));
+        }
+    }
+    if (series_name.empty()) {
+        return absl::InvalidArgumentError("Missing the series query parameter.");
+    }
+    if (last_s >= 0.0) {
+        auto last_time_or_status = store.GetLastTime(series_name);
+        if (!last_time_or_status.ok()) {
+            return last_time_or_status.status();
+        }
+        from_time_s = last_time_or_status.value() - last_s;
+        until_time_s = std::numeric_limits<double>::infinity();
+    }
+
+    std::string json = absl::StrCat("{\"series\":\"", series_name, "\"");
+    if (rollup_interval_s > 0.0) {
+        // a bucket that started before the range still covers part of it
+        auto buckets_or_status = store.QueryRollup(
+            series_name, rollup_interval_s, std::floor(from_time_s / rollup_interval_s) * rollup_interval_s,
+            until_time_s
+        );
+        if (!buckets_or_status.ok()) {
+            return buckets_or_status.status();
+        }
+        std::vector<float> start, count, mean, min, max;
+        for (const MetricsRollupBucket& bucket: buckets_or_status.value()) {
+            start.push_back(static_cast<float>(bucket.start_time));
+            count.push_back(static_cast<float>(bucket.count));
+            mean.push_back(bucket.GetMean());
+            min.push_back(bucket.min);
+            max.push_back(bucket.max);
+        }
+        absl::StrAppendFormat(&json, ",\"interval\":%g", rollup_interval_s);
+        AppendJsonArray(json, "start", start);
+        AppendJsonArray(json, "count", count);
+        AppendJsonArray(json, "mean", mean);
+        AppendJsonArray(json, "min", min);
+        AppendJsonArray(json, "max", max);
+        return json + "}";
+    }
+    if (store.HasIntervals(series_name)) {
+        auto intervals_or_status = store.QueryIntervals(series_name, from_time_s, until_time_s);
+        if (!intervals_or_status.ok()) {
+            return intervals_or_status.status();
+        }
+        const BooleanIntervals& intervals = intervals_or_status.value();
+        AppendJsonArray(json, "start", intervals.start_time);
+        AppendJsonArray(json, "end", intervals.end_time);
+        AppendJsonArray(json, "count", std::vector<float>(intervals.count.begin(), intervals.count.end()));
+        AppendJsonArray(json, "value", std::vector<float>(intervals.value.begin(), intervals.value.end()));
+        return json + "}";
+    }
+    auto measurements_or_status = store.Query(series_name, from_time_s, until_time_s);
+    if (!measurements_or_status.ok()) {
+        return measurements_or_status.status();
+    }
+    const SeriesColumns<float>& measurements = measurements_or_status.value();
+    AppendJsonArray(json, "time", measurements.time);
+    AppendJsonArray(json, "value", measurements.value);
+    if (!measurements.confidence.empty()) {
+        AppendJsonArray(json, "confidence", measurements.confidence);
+    }
+    return json + "}";
+}
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,208 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// third-party includes
+#include <google/protobuf/message.h>
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/status/statusor.h>
+#include <physiology/modules/messages/metrics.pb.h>
+
+// local includes
+#include "common/metric_columns.hpp"
+
+namespace presage::smartspectra::examples {
+
+struct MetricsStoreSettings {
+    // Measurements per chunk. Chunks are the unit of spilling and of the time index.
+    size_t chunk_size = 4096;
+    // Once the resident chunks hold more than this, the oldest full ones are written out to the spill file.
+    // When 0, nothing is spilled.
+    size_t max_resident_bytes = 64 << 20;
+    // Where the spill file goes. When empty, the system's temporary directory.
+    std::filesystem::path spill_directory;
+    // Widths, in seconds, of the downsampled rollups kept for every series.
+    std::vector<double> rollup_intervals_s = {1.0, 10.0, 60.0};
+    // How far, in seconds, a series has to go back in time (or how close to 0 it has to end up) for it to be taken as
+    // a Core buffer reset rather than a stale tail. Set it to the Core buffer duration.
+    double reset_time_step_s = 0.5;
+};
+
+// Summary of the measurements of one series within [start_time, start_time + interval).
+struct MetricsRollupBucket {
+    double start_time = 0.0;
+    uint32_t count = 0;
+    double sum = 0.0;
+    float min = 0.0f;
+    float max = 0.0f;
+
+    float GetMean() const {
+        return count > 0 ? static_cast<float>(sum / count) : 0.0f;
+    }
+};
+
+// In-process, append-only store of the time series of continuous-mode metrics, for sessions that run long enough
+// that going back to the emitted metrics (or keeping them all in memory) is not an option.
+// Each series is kept as a list of columnar chunks (times, values and, if the series has them, confidences), each
+// with the range of times it covers, so that a time range is found by binary search over the chunks, then within the
+// first and last of them. Once the chunks use up more than `max_resident_bytes`, the oldest full ones are moved to a
+// spill file (unlinked as soon as it is created, so it goes away with the process) and read back when queried.
+// Every series also has rollups (count, sum, minimum and maximum per fixed-width time bucket), which stay in memory.
+// Boolean series (e.g. face blinking) are kept as run-length intervals (see BooleanIntervals) instead, which hardly
+// take up any memory, with rollups of their 0 / 1 values.
+// Series are expected to be in time order. Measurements at or before the last stored time of their series (ones
+// already stored, or revised ones) are dropped. A batch whose series ends before the last stored time of that series
+// is taken as a Core buffer reset, and starts a new epoch, if it went back by more than `reset_time_step_s`, if it
+// ends within `reset_time_step_s` of 0, or if MarkReset() was called before it; otherwise it is a stale tail, and
+// dropped like the rest. In a new epoch, incoming times are shifted to carry on from the latest stored time, so that
+// the store keeps a single time axis (all times it reports are on it).
+// All methods are thread-safe.
+class MetricsStore {
+public:
+    static absl::StatusOr<std::unique_ptr<MetricsStore>> Create(MetricsStoreSettings settings = MetricsStoreSettings());
+    ~MetricsStore();
+
+    MetricsStore(const MetricsStore&) = delete;
+    MetricsStore& operator=(const MetricsStore&) = delete;
+
+    // Stores the new measurements of every time series in `metrics` (any repeated message field with a `time` field,
+    // at any depth, whose measurements have a scalar `value` or `detected` field), named by path, e.g.
+    // "pulse.trace". Series with boolean values (e.g. face blinking) are stored as intervals.
+    absl::Status Append(const physiology::MetricsBuffer& metrics);
+    // Stores the measurements of `measurements` that are newer than the last stored one of `series`, starting a new
+    // epoch if they all came before it.
+    absl::Status Append(const std::string& series, const SeriesColumns<float>& measurements);
+    // Call when resetting Core processing (ResetProcessing): a series that goes back in time in the next Append()
+    // starts a new epoch however little it went back.
+    void MarkReset();
+
+    // Time of the last stored measurement of `series`.
+    absl::StatusOr<float> GetLastTime(const std::string& series) const;
+    // Measurements of `series` timed within [from_time_s, until_time_s). Boolean series are expanded to 0 / 1 values.
+    absl::StatusOr<SeriesColumns<float>> Query(
+        const std::string& series,
+        double from_time_s,
+        double until_time_s
+    ) const;
+    // Measurements of `series` from `duration_s` before its last one, up to that one.
+    absl::StatusOr<SeriesColumns<float>> QueryLast(const std::string& series, double duration_s) const;
+    // Rollup buckets of `series` (`interval_s` being one of the settings' rollup intervals) that start within
+    // [from_time_s, until_time_s).
+    absl::StatusOr<std::vector<MetricsRollupBucket>> QueryRollup(
+        const std::string& series,
+        double interval_s,
+        double from_time_s,
+        double until_time_s
+    ) const;
+
+    // Whether `series` is a boolean series, kept as intervals.
+    bool HasIntervals(const std::string& series) const;
+    // Intervals of boolean series `series` that overlap [from_time_s, until_time_s).
+    absl::StatusOr<BooleanIntervals> QueryIntervals(
+        const std::string& series,
+        double from_time_s,
+        double until_time_s
+    ) const;
+
+    std::vector<std::string> GetSeriesNames() const;
+    size_t GetMeasurementCount() const;
+    // Number of time resets (see above) seen so far.
+    int GetEpochCount() const;
+    // e.g. "12 series, 1862340 measurements (1310720 spilled, 15.7 MiB; 214 boolean intervals), 4.1 MiB resident,
+    // 0.6 MiB of rollups, 0 time resets"
+    std::string Summarize() const;
+
+private:
+    struct Chunk {
+        float min_time = 0.0f;
+        float max_time = 0.0f;
+        size_t size = 0;
+        bool has_confidence = false;
+        // empty once spilled
+        SeriesColumns<float> columns;
+        // offset of the chunk in the spill file, or -1 while resident
+        int64_t spill_offset = -1;
+    };
+
+    struct Rollup {
+        double interval_s;
+        std::vector<MetricsRollupBucket> buckets;
+    };
+
+    struct Series {
+        // for boolean series: empty, the measurements are in `intervals`
+        std::vector<Chunk> chunks;
+        bool is_boolean = false;
+        BooleanIntervals intervals;
+        std::vector<Rollup> rollups;
+        size_t measurement_count = 0;
+        float last_time = 0.0f;
+    };
+
+    MetricsStore(MetricsStoreSettings settings, int spill_descriptor);
+
+    // Walks `message` for time series, appending the new measurements of each one.
+    absl::Status AppendMessage(const google::protobuf::Message& message, const std::string& path);
+    Series& GetOrAddSeries(const std::string& name, bool is_boolean = false);
+    // Starts a new epoch if the batch of `series` ending at (incoming) `batch_last_time` went back in time after a
+    // reset (see above).
+    void StartEpochIfReset(const std::string& name, const Series& series, float batch_last_time);
+    void AppendMeasurement(Series& series, float time, float value, const float* confidence);
+    static void AppendToRollups(Series& series, float time, float value);
+    absl::Status SpillWhileOverBudget();
+    absl::StatusOr<const Series*> FindSeries(const std::string& name) const;
+    absl::StatusOr<SeriesColumns<float>> QueryLocked(
+        const Series& series,
+        double from_time_s,
+        double until_time_s
+    ) const;
+    // Range of the intervals of `series` that overlap [from_time_s, until_time_s).
+    static std::pair<size_t, size_t> FindIntervals(const Series& series, double from_time_s, double until_time_s);
+    // The chunk's columns, read back from the spill file if it was spilled.
+    absl::StatusOr<SeriesColumns<float>> LoadChunk(const Chunk& chunk) const;
+    static size_t GetChunkBytes(const Chunk& chunk);
+
+    const MetricsStoreSettings settings;
+    // unlinked spill file, or -1 when nothing is to be spilled
+    const int spill_descriptor;
+    mutable std::mutex mutex;
+    std::map<std::string, Series> series_by_name;
+    // latest stored time of any series
+    float latest_time = 0.0f;
+    // added to incoming times, to put the current epoch after the previous ones
+    float time_offset = 0.0f;
+    int epoch_count = 0;
+    // set by MarkReset() until the end of the next Append()
+    bool reset_marked = false;
+    // full chunks that are still resident, oldest first: the next ones to be spilled
+    std::deque<std::pair<Series*, size_t>> spillable_chunks;
+    size_t resident_bytes = 0;
+    int64_t spill_file_size = 0;
+    size_t spilled_measurement_count = 0;
+};
+
+// Answers a query of `store` given as an HTTP query string, with JSON:
+// - "" lists the series: {"series":["pulse.rate",...]};
+// - "series=<name>[&from=<s>][&until=<s>]" or "series=<name>&last=<s>" returns the measurements as columns:
+//   {"series":"<name>","time":[...],"value":[...][,"confidence":[...]]}, or, for boolean series, the intervals that
+//   overlap the range: {"series":"<name>","start":[...],"end":[...],"count":[...],"value":[...]};
+// - adding "&rollup=<interval s>" returns the rollup buckets instead:
+//   {"series":"<name>","interval":<s>,"start":[...],"count":[...],"mean":[...],"min":[...],"max":[...]}.
+absl::StatusOr<std::string> QueryMetricsStoreJson(const MetricsStore& store, std::string_view query);
+
+} // namespace presage::smartspectra::examples
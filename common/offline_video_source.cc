@@ -0,0 +1,156 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <cmath>
+
+// third-party includes
+#include <physiology/interface/absl/strings/str_format.h>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/offline_video_source.hpp"
+
+namespace presage::smartspectra::examples {
+
+// region ===================================== VideoFileFrameSource ===================================================
+VideoFileFrameSource::VideoFileFrameSource(std::filesystem::path path, VideoFileSegment segment)
+    : path(std::move(path)), segment(segment) {}
+
+absl::Status VideoFileFrameSource::Initialize() {
+    if (!capture.open(path.string())) {
+        return absl::NotFoundError("Could not open video file " + path.string());
+    }
+    const double frame_rate = capture.get(cv::CAP_PROP_FPS);
+    if (frame_rate > 0.0) {
+        frame_interval_us = std::llround(1e6 / frame_rate);
+    }
+    if (segment.start_us > 0) {
+        // seeking may land on an earlier key frame: frames before the segment start are skipped in Next()
+        capture.set(cv::CAP_PROP_POS_MSEC, static_cast<double>(segment.start_us) / 1e3);
+    }
+    return absl::OkStatus();
+}
+
+absl::StatusOr<bool> VideoFileFrameSource::Next(TimestampedFrame& frame) {
+    while (true) {
+        if (!capture.read(frame.image) || frame.image.empty()) {
+            return false;
+        }
+        int64_t timestamp_us = std::llround(capture.get(cv::CAP_PROP_POS_MSEC) * 1e3);
+        if (timestamp_us <= last_timestamp_us) {
+            // no (or no usable) presentation time in the file
+            timestamp_us = last_timestamp_us + frame_interval_us;
+        }
+        last_timestamp_us = timestamp_us;
+        if (segment.end_us >= 0 && timestamp_us >= segment.end_us) {
+            return false;
+        }
+        if (timestamp_us >= segment.start_us) {
+            frame.timestamp_us = timestamp_us;
+            return true;
+        }
+    }
+}
+
+absl::StatusOr<int64_t> GetVideoFileDurationUs(const std::filesystem::path& path) {
+    cv::VideoCapture capture(path.string());
+    if (!capture.isOpened()) {
+        return absl::NotFoundError("Could not open video file " + path.string());
+    }
+    const double frame_count = capture.get(cv::CAP_PROP_FRAME_COUNT);
+    const double frame_rate = capture.get(cv::CAP_PROP_FPS);
+    if (frame_count <= 0.0 || frame_rate <= 0.0) {
+        return absl::FailedPreconditionError("Could not tell the duration of video file " + path.string());
+    }
+    return std::llround(frame_count / frame_rate * 1e6);
+}
+// endregion ===========================================================================================================
+
+std::vector<OverlappingVideoSegment> SplitVideoFile(int64_t duration_us, int count, int64_t overlap_us) {
+    count = std::max(count, 1);
+    std::vector<OverlappingVideoSegment> segments;
+    for (int i_segment = 0; i_segment < count; i_segment++) {
+        const int64_t start_us = duration_us * i_segment / count;
+        // the last segment runs to the end of the file, wherever that turns out to be
+        const int64_t end_us = i_segment == count - 1 ? -1 : duration_us * (i_segment + 1) / count;
+        segments.push_back(OverlappingVideoSegment{
+            VideoFileSegment{std::max<int64_t>(start_us - overlap_us, 0), end_us},
+            start_us,
+            end_us
+        });
+    }
+    return segments;
+}
+
+// region ===================================== OutputBackpressure =====================================================
+OutputBackpressure::OutputBackpressure(OutputBackpressureSettings settings) : settings(settings) {}
+
+void OutputBackpressure::OnOutput(int64_t timestamp_us) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        last_output_timestamp_us = std::max(last_output_timestamp_us, timestamp_us);
+    }
+    output_received.notify_all();
+}
+
+void OutputBackpressure::WaitForFrame(int64_t timestamp_us) {
+    const auto max_lag_us = static_cast<int64_t>(settings.max_lag_seconds * 1e6);
+    std::unique_lock<std::mutex> lock(mutex);
+    auto can_read = [&] {
+        return last_output_timestamp_us < 0 || timestamp_us - last_output_timestamp_us <= max_lag_us;
+    };
+    if (can_read()) {
+        return;
+    }
+    wait_count++;
+    const auto wait_start = std::chrono::steady_clock::now();
+    // the stall timeout restarts with every output that does not catch up yet
+    int64_t seen_output_timestamp_us = last_output_timestamp_us;
+    while (!can_read()) {
+        const bool got_output = output_received.wait_for(
+            lock, std::chrono::milliseconds(settings.stall_timeout_ms),
+            [&] { return last_output_timestamp_us != seen_output_timestamp_us; }
+        );
+        if (!got_output) {
+            stall_count++;
+            LOG_EVERY_N(WARNING, 10) << "No output for " << settings.stall_timeout_ms
+                                     << " ms while the input is ahead, reading on.";
+            break;
+        }
+        seen_output_timestamp_us = last_output_timestamp_us;
+    }
+    total_wait_time += std::chrono::steady_clock::now() - wait_start;
+}
+
+std::string OutputBackpressure::Summarize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return absl::StrFormat(
+        "waited %d times, %.1f s in total, %d stalls", wait_count,
+        std::chrono::duration<double>(total_wait_time).count(), stall_count
+    );
+}
+// endregion ===========================================================================================================
+
+// region ===================================== BackpressuredFrameSource ===============================================
+BackpressuredFrameSource::BackpressuredFrameSource(
+    std::unique_ptr<FrameSource> frame_source,
+    OutputBackpressure& backpressure
+) : frame_source(std::move(frame_source)), backpressure(backpressure) {}
+
+absl::Status BackpressuredFrameSource::Initialize() {
+    return frame_source->Initialize();
+}
+
+absl::StatusOr<bool> BackpressuredFrameSource::Next(TimestampedFrame& frame) {
+    auto has_frame_or_status = frame_source->Next(frame);
+    if (has_frame_or_status.ok() && has_frame_or_status.value()) {
+        backpressure.WaitForFrame(frame.timestamp_us);
+    }
+    return has_frame_or_status;
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// third-party includes
+#include <opencv2/videoio.hpp>
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/status/statusor.h>
+
+// local includes
+#include "common/frame_source.hpp"
+
+namespace presage::smartspectra::examples {
+
+// Time range of a video file, in microseconds of its own timeline.
+struct VideoFileSegment {
+    int64_t start_us = 0;
+    // -1: to the end of the file
+    int64_t end_us = -1;
+};
+
+// Reads the frames of a video file (or of a segment of it) as soon as they are asked for, rather than at the pace they
+// were recorded at, timestamped with their presentation time in the file.
+class VideoFileFrameSource : public FrameSource {
+public:
+    explicit VideoFileFrameSource(std::filesystem::path path, VideoFileSegment segment = VideoFileSegment());
+
+    absl::Status Initialize() override;
+    absl::StatusOr<bool> Next(TimestampedFrame& frame) override;
+
+private:
+    std::filesystem::path path;
+    VideoFileSegment segment;
+    cv::VideoCapture capture;
+    // used when the file does not tell the presentation time of a frame
+    int64_t frame_interval_us = 33333;
+    int64_t last_timestamp_us = -1;
+};
+
+// Returns the duration of a video file, in microseconds.
+absl::StatusOr<int64_t> GetVideoFileDurationUs(const std::filesystem::path& path);
+
+// Part of a recording processed on its own: read from `read.start_us`, ahead of the part proper, so that the graph and
+// Core are warmed up by `keep_from_us`, from which on (and until `keep_until_us`) its metrics are kept.
+struct OverlappingVideoSegment {
+    VideoFileSegment read;
+    int64_t keep_from_us = 0;
+    int64_t keep_until_us = 0;
+};
+
+// Splits a recording of the given duration into `count` consecutive parts of equal length, each (but the first)
+// read from `overlap_us` before its start.
+std::vector<OverlappingVideoSegment> SplitVideoFile(int64_t duration_us, int count, int64_t overlap_us);
+
+struct OutputBackpressureSettings {
+    // how far (in input time) frames may be read ahead of the latest output
+    double max_lag_seconds = 3.0;
+    // Longest wait for an output before reading on regardless (e.g. when outputs only come at the end).
+    int stall_timeout_ms = 5000;
+};
+
+// Holds up frame reading while the pipeline's outputs lag too far behind the frames read, so that, without any
+// wall-clock pacing, input is read exactly as fast as the graph and Core get through it. Frames are never held up
+// before the first output, nor for longer than the stall timeout.
+class OutputBackpressure {
+public:
+    explicit OutputBackpressure(OutputBackpressureSettings settings = OutputBackpressureSettings());
+
+    // Call with the input timestamp of each output (e.g. from the metrics output callback), from any thread.
+    void OnOutput(int64_t timestamp_us);
+    // Blocks until the frame with the given timestamp may be handed on.
+    void WaitForFrame(int64_t timestamp_us);
+
+    // e.g. "waited 120 times, 3.4 s in total, 0 stalls"
+    std::string Summarize() const;
+
+private:
+    const OutputBackpressureSettings settings;
+    mutable std::mutex mutex;
+    std::condition_variable output_received;
+    int64_t last_output_timestamp_us = -1;
+    int64_t wait_count = 0;
+    int64_t stall_count = 0;
+    std::chrono::steady_clock::duration total_wait_time{0};
+};
+
+// Hands out the frames of another frame source, subject to an OutputBackpressure.
+class BackpressuredFrameSource : public FrameSource {
+public:
+    BackpressuredFrameSource(std::unique_ptr<FrameSource> frame_source, OutputBackpressure& backpressure);
+
+    absl::Status Initialize() override;
+    absl::StatusOr<bool> Next(TimestampedFrame& frame) override;
+
+private:
+    std::unique_ptr<FrameSource> frame_source;
+    OutputBackpressure& backpressure;
+};
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,395 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <string_view>
+
+// third-party includes
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/glog/logging.h>
+#include <physiology/interface/nlohmann/json.hpp>
+
+// local includes
+#include "common/pipeline_metrics.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+constexpr const char* kPrometheusPrefix = "smartspectra_";
+// Prometheus histogram bucket bounds are powers of two from 64 us to ~16.8 s, which are also LatencyHistogram bucket
+// bounds, so the cumulative counts are exact
+constexpr int kFirstPrometheusBucketExponent = 6;
+constexpr int kLastPrometheusBucketExponent = 24;
+// how long the reporter thread waits for a connection before checking whether it is time to log or stop
+constexpr int kPollTimeoutMs = 200;
+// recent frame read times kept for telling the frame-to-metrics latency, ~10 s at 30 fps
+constexpr size_t kMaxReadTimeCount = 300;
+
+template<typename TValue, typename TEntry>
+TValue& GetOrCreate(std::map<std::string, TEntry>& entries, const std::string& name, const std::string& help) {
+    auto& entry = entries[name];
+    if (entry.value == nullptr) {
+        entry.help = help;
+        entry.value = std::make_unique<TValue>();
+    }
+    return *entry.value;
+}
+
+void AppendHeader(std::ostringstream& output, const std::string& name, const std::string& help, const char* type) {
+    output << "# HELP " << name << ' ' << help << '\n' << "# TYPE " << name << ' ' << type << '\n';
+}
+
+bool SendAll(int descriptor, const std::string& data) {
+    size_t sent_size = 0;
+    while (sent_size < data.size()) {
+        const ssize_t result = send(descriptor, data.data() + sent_size, data.size() - sent_size, MSG_NOSIGNAL);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        sent_size += static_cast<size_t>(result);
+    }
+    return true;
+}
+} // anonymous namespace
+
+// region ===================================== PipelineMetrics ========================================================
+LatencyHistogram& PipelineMetrics::GetHistogram(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return GetOrCreate<LatencyHistogram>(histograms, name, help);
+}
+
+std::atomic<int64_t>& PipelineMetrics::GetCounter(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return GetOrCreate<std::atomic<int64_t>>(counters, name, help);
+}
+
+std::atomic<int64_t>& PipelineMetrics::GetGauge(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return GetOrCreate<std::atomic<int64_t>>(gauges, name, help);
+}
+
+std::string PipelineMetrics::ToJson(std::map<std::string, int64_t>& previous_counts, double elapsed_seconds) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    nlohmann::json stats = {
+        {"counters", nlohmann::json::object()},
+        {"gauges", nlohmann::json::object()},
+        {"histograms", nlohmann::json::object()}
+    };
+    for (const auto& [name, entry]: counters) {
+        const int64_t value = entry.value->load(std::memory_order_relaxed);
+        int64_t& previous_value = previous_counts[name];
+        stats["counters"][name] = {
+            {"value", value},
+            {"per_second", elapsed_seconds > 0.0 ? static_cast<double>(value - previous_value) / elapsed_seconds : 0.0}
+        };
+        previous_value = value;
+    }
+    for (const auto& [name, entry]: gauges) {
+        stats["gauges"][name] = entry.value->load(std::memory_order_relaxed);
+    }
+    for (const auto& [name, entry]: histograms) {
+        const LatencyHistogram& histogram = *entry.value;
+        stats["histograms"][name] = {
+            {"count", histogram.GetCount()},
+            {"mean_us", histogram.GetMeanUs()},
+            {"p50_us", histogram.GetQuantileUs(0.5)},
+            {"p90_us", histogram.GetQuantileUs(0.9)},
+            {"p99_us", histogram.GetQuantileUs(0.99)},
+            {"max_us", histogram.GetMaxUs()}
+        };
+    }
+    return stats.dump();
+}
+
+std::string PipelineMetrics::ToPrometheusText() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream output;
+    // enough digits for bucket bounds to be exact
+    output << std::setprecision(10);
+    for (const auto& [name, entry]: counters) {
+        const std::string full_name = absl::StrCat(kPrometheusPrefix, name);
+        AppendHeader(output, full_name, entry.help, "counter");
+        output << full_name << ' ' << entry.value->load(std::memory_order_relaxed) << '\n';
+    }
+    for (const auto& [name, entry]: gauges) {
+        const std::string full_name = absl::StrCat(kPrometheusPrefix, name);
+        AppendHeader(output, full_name, entry.help, "gauge");
+        output << full_name << ' ' << entry.value->load(std::memory_order_relaxed) << '\n';
+    }
+    for (const auto& [name, entry]: histograms) {
+        const LatencyHistogram& histogram = *entry.value;
+        const std::string full_name = absl::StrCat(kPrometheusPrefix, name, "_seconds");
+        AppendHeader(output, full_name, entry.help, "histogram");
+        // the count goes first, so that no bucket is seen to exceed it while latencies are being recorded
+        const uint64_t count = histogram.GetCount();
+        for (int exponent = kFirstPrometheusBucketExponent; exponent <= kLastPrometheusBucketExponent; exponent++) {
+            const uint64_t bound_us = uint64_t{1} << exponent;
+            output << full_name << "_bucket{le=\"" << static_cast<double>(bound_us) * 1e-6 << "\"} "
+                   << std::min(count, histogram.GetCountAtOrBelowUs(bound_us)) << '\n';
+        }
+        output << full_name << "_bucket{le=\"+Inf\"} " << count << '\n'
+               << full_name << "_sum " << static_cast<double>(histogram.GetSumUs()) * 1e-6 << '\n'
+               << full_name << "_count " << count << '\n';
+    }
+    return output.str();
+}
+// endregion ===========================================================================================================
+
+// region ===================================== PipelineMetricsReporter ================================================
+absl::StatusOr<std::unique_ptr<PipelineMetricsReporter>> PipelineMetricsReporter::Start(
+    PipelineMetrics& metrics,
+    PipelineMetricsReporterSettings settings
+) {
+    std::unique_ptr<PipelineMetricsReporter> reporter(new PipelineMetricsReporter(metrics, settings));
+    if (settings.http_port != 0) {
+        const int descriptor = socket(AF_INET, SOCK_STREAM, 0);
+        if (descriptor < 0) {
+            return absl::InternalError(absl::StrCat("Could not create the metrics socket: ", std::strerror(errno)));
+        }
+        reporter->listening_descriptor = descriptor;
+        const int reuse_address = 1;
+        setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &reuse_address, sizeof(reuse_address));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(settings.http_port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(descriptor, 8) != 0) {
+            return absl::UnavailableError(absl::StrCat(
+                "Could not serve pipeline metrics on 127.0.0.1:", settings.http_port, ": ", std::strerror(errno)
+            ));
+        }
+        LOG(INFO) << "Serving pipeline metrics at http://127.0.0.1:" << settings.http_port << "/metrics";
+    }
+    if (settings.http_port != 0 || settings.log_interval_seconds > 0) {
+        reporter->reporter = std::thread(&PipelineMetricsReporter::Run, reporter.get());
+    }
+    return reporter;
+}
+
+PipelineMetricsReporter::PipelineMetricsReporter(PipelineMetrics& metrics, PipelineMetricsReporterSettings settings)
+    : metrics(metrics), settings(settings), last_log_time(std::chrono::steady_clock::now()) {}
+
+PipelineMetricsReporter::~PipelineMetricsReporter() {
+    const bool started = reporter.joinable();
+    if (started) {
+        stop_requested = true;
+        reporter.join();
+    }
+    if (listening_descriptor >= 0) {
+        close(listening_descriptor);
+    }
+    if (started && settings.log_interval_seconds > 0) {
+        LogStats();
+    }
+}
+
+void PipelineMetricsReporter::Run() {
+    while (!stop_requested) {
+        if (listening_descriptor >= 0) {
+            pollfd listener{listening_descriptor, POLLIN, 0};
+            if (poll(&listener, 1, kPollTimeoutMs) > 0 && (listener.revents & POLLIN) != 0) {
+                const int connection_descriptor = accept(listening_descriptor, nullptr, nullptr);
+                if (connection_descriptor >= 0) {
+                    Serve(connection_descriptor);
+                    close(connection_descriptor);
+                }
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kPollTimeoutMs));
+        }
+        if (settings.log_interval_seconds > 0 &&
+            std::chrono::steady_clock::now() - last_log_time >= std::chrono::seconds(settings.log_interval_seconds)) {
+            LogStats();
+        }
+    }
+}
+
+void PipelineMetricsReporter::LogStats() {
+    const auto now = std::chrono::steady_clock::now();
+    const double elapsed_seconds = std::chrono::duration<double>(now - last_log_time).count();
+    LOG(INFO) << "Pipeline stats: " << metrics.ToJson(previous_counts, elapsed_seconds);
+    last_log_time = now;
+}
+
+std::pair<const JsonEndpoint*, std::string_view> PipelineMetricsReporter::FindJsonEndpoint(
+    std::string_view request_line
+) const {
+    constexpr std::string_view kGet = "GET ";
+    if (request_line.substr(0, kGet.size()) != kGet) {
+        return {nullptr, {}};
+    }
+    std::string_view target = request_line.substr(kGet.size());
+    target = target.substr(0, target.find(' '));
+    const size_t query_start = target.find('?');
+    const std::string path(target.substr(0, query_start));
+    const auto endpoint = settings.json_endpoints.find(path);
+    if (endpoint == settings.json_endpoints.end()) {
+        return {nullptr, {}};
+    }
+    return {&endpoint->second, query_start == std::string_view::npos ? "" : target.substr(query_start + 1)};
+}
+
+void PipelineMetricsReporter::Serve(int connection_descriptor) const {
+    // a scrape request fits in one read; a slow or silent client must not hold up the reporter for long
+    timeval timeout{1, 0};
+    setsockopt(connection_descriptor, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    char request[1024];
+    const ssize_t request_size = recv(connection_descriptor, request, sizeof(request) - 1, 0);
+    if (request_size <= 0) {
+        return;
+    }
+    request[request_size] = '\0';
+    const std::string_view request_line(request, strcspn(request, "\r\n"));
+    std::string body;
+    std::string status_line;
+    std::string content_type = "text/plain";
+    if (request_line.rfind("GET /metrics ", 0) == 0 || request_line.rfind("GET /metrics?", 0) == 0) {
+        status_line = "HTTP/1.1 200 OK";
+        content_type = "text/plain; version=0.0.4";
+        body = metrics.ToPrometheusText();
+    } else if (const auto endpoint = FindJsonEndpoint(request_line); endpoint.first != nullptr) {
+        const absl::StatusOr<std::string> json_or_status = (*endpoint.first)(endpoint.second);
+        if (json_or_status.ok()) {
+            status_line = "HTTP/1.1 200 OK";
+            content_type = "application/json";
+            body = json_or_status.value();
+        } else {
+            switch (json_or_status.status().code()) {
+                case absl::StatusCode::kInvalidArgument:
+                    status_line = "HTTP/1.1 400 Bad Request";
+                    break;
+                case absl::StatusCode::kNotFound:
+                    status_line = "HTTP/1.1 404 Not Found";
+                    break;
+                default:
+                    status_line = "HTTP/1.1 500 Internal Server Error";
+                    break;
+            }
+            body = absl::StrCat(json_or_status.status().message(), "\n");
+        }
+    } else {
+        status_line = "HTTP/1.1 404 Not Found";
+        body = "Metrics are served at /metrics\n";
+    }
+    SendAll(connection_descriptor, absl::StrCat(
+        status_line, "\r\nContent-Type: ", content_type, "\r\nContent-Length: ", body.size(),
+        "\r\nConnection: close\r\n\r\n", body
+    ));
+}
+// endregion ===========================================================================================================
+
+// region ===================================== InstrumentedVideoSource ================================================
+InstrumentedVideoSource::InstrumentedVideoSource(
+    std::unique_ptr<video_source::VideoSource> video_source,
+    PipelineMetrics& metrics
+) : video_source(std::move(video_source)),
+    capture_histogram(metrics.GetHistogram(
+        "frame_capture", "Time to read a frame from the video source (capture and decoding)."
+    )),
+    processing_histogram(metrics.GetHistogram(
+        "frame_processing", "Time from a frame being read to the next one being asked for (graph input, rendering "
+                            "and the container's interframe delay)."
+    )),
+    frame_to_metrics_histogram(metrics.GetHistogram(
+        "frame_to_metrics", "Time from a frame being read to the metrics covering it being output."
+    )),
+    frames_read_counter(metrics.GetCounter("frames_read_total", "Frames read from the video source.")),
+    frames_dropped_counter(metrics.GetCounter(
+        "frames_dropped_total", "Input frames dropped before they could be read, told by gaps in the timestamps."
+    )),
+    metrics_outputs_counter(metrics.GetCounter("metrics_outputs_total", "Metrics output by the pipeline.")) {}
+
+absl::Status InstrumentedVideoSource::Initialize(const video_source::VideoSourceSettings& /*settings*/) {
+    // the wrapped source is initialized by the container before it gets wrapped
+    return absl::OkStatus();
+}
+
+bool InstrumentedVideoSource::SupportsExactFrameTimestamp() const {
+    return video_source->SupportsExactFrameTimestamp();
+}
+
+int64_t InstrumentedVideoSource::GetFrameTimestamp() const {
+    return video_source->GetFrameTimestamp();
+}
+
+int InstrumentedVideoSource::GetWidth() {
+    return video_source->GetWidth();
+}
+
+int InstrumentedVideoSource::GetHeight() {
+    return video_source->GetHeight();
+}
+
+video_source::VideoSource& InstrumentedVideoSource::operator>>(cv::Mat& frame) {
+    const auto request_time = Clock::now();
+    if (frame_out) {
+        processing_histogram.Record(request_time - last_read_time);
+        frame_out = false;
+    }
+    *video_source >> frame;
+    const auto read_time = Clock::now();
+    if (frame.empty()) {
+        return *this;
+    }
+    capture_histogram.Record(read_time - request_time);
+    frames_read_counter.fetch_add(1, std::memory_order_relaxed);
+    // without exact timestamps, the read time stands in for the capture time
+    const int64_t timestamp_us = video_source->SupportsExactFrameTimestamp()
+                                 ? video_source->GetFrameTimestamp()
+                                 : std::chrono::duration_cast<std::chrono::microseconds>(
+                                       read_time.time_since_epoch()
+                                   ).count();
+    frames_dropped_counter.fetch_add(drop_detector.OnFrame(timestamp_us), std::memory_order_relaxed);
+    last_read_time = read_time;
+    frame_out = true;
+    {
+        std::lock_guard<std::mutex> lock(read_times_mutex);
+        read_times.emplace_back(timestamp_us, read_time);
+        if (read_times.size() > kMaxReadTimeCount) {
+            read_times.pop_front();
+        }
+    }
+    return *this;
+}
+
+void InstrumentedVideoSource::RecordMetricsOutput(int64_t timestamp_us) {
+    const auto now = Clock::now();
+    metrics_outputs_counter.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(read_times_mutex);
+    if (read_times.empty()) {
+        return;
+    }
+    // timestamps the source does not provide itself are not comparable with the ones on the metrics
+    if (timestamp_us < 0 || !video_source->SupportsExactFrameTimestamp()) {
+        frame_to_metrics_histogram.Record(now - read_times.back().second);
+        return;
+    }
+    // the latest frame at or before the timestamp, when metrics timestamps are not exactly those of frames
+    auto frame = std::upper_bound(
+        read_times.begin(), read_times.end(), timestamp_us,
+        [](int64_t timestamp, const auto& read_time) { return timestamp < read_time.first; }
+    );
+    if (frame != read_times.begin()) {
+        frame_to_metrics_histogram.Record(now - std::prev(frame)->second);
+    }
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,179 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+// third-party includes
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/status/statusor.h>
+#include <smartspectra/video_source/video_source.hpp>
+
+// local includes
+#include "common/frame_drop_detector.hpp"
+#include "common/latency_histogram.hpp"
+#include "common/status_macros.hpp"
+
+namespace presage::smartspectra::examples {
+
+// Named per-stage latency histograms, counters and gauges of a pipeline. Once looked up (which registers them on first
+// use), they can be updated from any thread without locking. Names follow Prometheus conventions, without the
+// "smartspectra_" prefix or the unit suffix, e.g. "frame_capture" or "frames_read_total".
+class PipelineMetrics {
+public:
+    LatencyHistogram& GetHistogram(const std::string& name, const std::string& help);
+    std::atomic<int64_t>& GetCounter(const std::string& name, const std::string& help);
+    std::atomic<int64_t>& GetGauge(const std::string& name, const std::string& help);
+
+    // One JSON object with all the values and, for counters, their rates since `previous_counts` were taken (which
+    // is updated), e.g. {"counters":{"frames_read_total":{"value":900,"per_second":30.0}},"gauges":{...},
+    // "histograms":{"frame_capture":{"count":900,"mean_us":...,"p50_us":...,"p90_us":...,"p99_us":...,"max_us":...}}}
+    std::string ToJson(std::map<std::string, int64_t>& previous_counts, double elapsed_seconds) const;
+    // Prometheus text exposition format (version 0.0.4), with latencies in seconds.
+    std::string ToPrometheusText() const;
+
+private:
+    template<typename TValue>
+    struct Entry {
+        std::string help;
+        std::unique_ptr<TValue> value;
+    };
+
+    mutable std::mutex mutex;
+    std::map<std::string, Entry<LatencyHistogram>> histograms;
+    std::map<std::string, Entry<std::atomic<int64_t>>> counters;
+    std::map<std::string, Entry<std::atomic<int64_t>>> gauges;
+};
+
+// Answers a GET request to an extra endpoint of the reporter's HTTP server with a JSON body, given the query string
+// (what follows the '?', if anything). InvalidArgument and NotFound errors are answered with 400 and 404.
+using JsonEndpoint = std::function<absl::StatusOr<std::string>(std::string_view query)>;
+
+struct PipelineMetricsReporterSettings {
+    // a "Pipeline stats: {...}" line (see PipelineMetrics::ToJson) is logged this often (never when 0)
+    int log_interval_seconds = 10;
+    // when non-zero, the metrics are served at http://127.0.0.1:<port>/metrics for Prometheus to scrape
+    uint16_t http_port = 0;
+    // also served when `http_port` is non-zero, by path (e.g. "/series")
+    std::map<std::string, JsonEndpoint> json_endpoints;
+};
+
+// Reports PipelineMetrics on a background thread, periodically in the log and on demand over HTTP.
+class PipelineMetricsReporter {
+public:
+    static absl::StatusOr<std::unique_ptr<PipelineMetricsReporter>> Start(
+        PipelineMetrics& metrics,
+        PipelineMetricsReporterSettings settings
+    );
+    // Logs the final stats line.
+    ~PipelineMetricsReporter();
+
+    PipelineMetricsReporter(const PipelineMetricsReporter&) = delete;
+    PipelineMetricsReporter& operator=(const PipelineMetricsReporter&) = delete;
+
+private:
+    PipelineMetricsReporter(PipelineMetrics& metrics, PipelineMetricsReporterSettings settings);
+    void Run();
+    void LogStats();
+    // The JSON endpoint a request is for, if any, and the query string of the request.
+    std::pair<const JsonEndpoint*, std::string_view> FindJsonEndpoint(std::string_view request_line) const;
+    void Serve(int connection_descriptor) const;
+
+    PipelineMetrics& metrics;
+    const PipelineMetricsReporterSettings settings;
+    int listening_descriptor = -1;
+    std::atomic<bool> stop_requested{false};
+    std::thread reporter;
+    std::map<std::string, int64_t> previous_counts;
+    std::chrono::steady_clock::time_point last_log_time;
+};
+
+// Records per-frame stages around another video source: how long it took to read each frame (capture and decoding,
+// as far as the source does it) and how long the container held on to it before asking for the next one (feeding it
+// to the graph and rendering, including the container's interframe delay), plus frame counts and the dropped input
+// frames. Also keeps the read times of recent frames, so that the latency from a frame being read to the metrics that
+// cover it can be told when they come out.
+class InstrumentedVideoSource : public video_source::VideoSource {
+public:
+    InstrumentedVideoSource(std::unique_ptr<video_source::VideoSource> video_source, PipelineMetrics& metrics);
+
+    absl::Status Initialize(const video_source::VideoSourceSettings& settings) override;
+    bool SupportsExactFrameTimestamp() const override;
+    int64_t GetFrameTimestamp() const override;
+    int GetWidth() override;
+    int GetHeight() override;
+    video_source::VideoSource& operator>>(cv::Mat& frame) override;
+
+    // Records the latency from the frame with the given timestamp (or, when it is not known or the source has no exact
+    // timestamps, the last frame read) being read to now, when the metrics covering it are output. Safe to call from
+    // any thread.
+    void RecordMetricsOutput(int64_t timestamp_us);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::unique_ptr<video_source::VideoSource> video_source;
+    LatencyHistogram& capture_histogram;
+    LatencyHistogram& processing_histogram;
+    LatencyHistogram& frame_to_metrics_histogram;
+    std::atomic<int64_t>& frames_read_counter;
+    std::atomic<int64_t>& frames_dropped_counter;
+    std::atomic<int64_t>& metrics_outputs_counter;
+
+    FrameDropDetector drop_detector;
+    bool frame_out = false;
+    Clock::time_point last_read_time;
+
+    std::mutex read_times_mutex;
+    // (frame timestamp, read time) of recent frames, oldest first
+    std::deque<std::pair<int64_t, Clock::time_point>> read_times;
+};
+
+// Foreground container whose video source (whichever the base container sets up) is instrumented with
+// `pipeline_metrics`, unless that is null.
+template<typename TContainer>
+class InstrumentedContainer : public TContainer {
+public:
+    template<typename... TArgs>
+    explicit InstrumentedContainer(PipelineMetrics* pipeline_metrics, TArgs&& ... args)
+        : TContainer(std::forward<TArgs>(args)...), pipeline_metrics(pipeline_metrics) {}
+
+    // Call from the metrics output callback, with the timestamp passed to it if there is one (-1 otherwise).
+    void RecordMetricsOutput(int64_t timestamp_us = -1) {
+        if (instrumented_video_source != nullptr) {
+            instrumented_video_source->RecordMetricsOutput(timestamp_us);
+        }
+    }
+
+protected:
+    absl::Status InitializeVideoSource() override {
+        MP_RETURN_IF_ERROR(TContainer::InitializeVideoSource());
+        if (pipeline_metrics != nullptr) {
+            auto video_source =
+                std::make_unique<InstrumentedVideoSource>(std::move(this->video_source), *pipeline_metrics);
+            instrumented_video_source = video_source.get();
+            this->video_source = std::move(video_source);
+        }
+        return absl::OkStatus();
+    }
+
+private:
+    PipelineMetrics* pipeline_metrics;
+    InstrumentedVideoSource* instrumented_video_source = nullptr;
+};
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,221 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// third-party includes
+#include <physiology/interface/absl/strings/str_cat.h>
+
+// local includes
+#include "common/raw_frame_file.hpp"
+#include "common/status_macros.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+// the mapping is made larger than the file, so it needs to be re-made only every so often as the file grows
+constexpr size_t kMinimumMappingLength = size_t{64} << 20;
+
+absl::Status ErrnoStatus(const std::string& what, const std::filesystem::path& path) {
+    return absl::InternalError(absl::StrCat(what, " ", path.string(), ": ", std::strerror(errno)));
+}
+} // anonymous namespace
+
+// region ==================================== RawFrameFileWriter =====================================================
+RawFrameFileWriter::~RawFrameFileWriter() {
+    if (file_descriptor >= 0) {
+        close(file_descriptor);
+    }
+}
+
+absl::Status RawFrameFileWriter::Open(const std::filesystem::path& path, int width, int height) {
+    if (file_descriptor >= 0) {
+        return absl::FailedPreconditionError("Raw frame file writer is already open.");
+    }
+    file_descriptor = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (file_descriptor < 0) {
+        return ErrnoStatus("Could not create raw frame file", path);
+    }
+    this->width = width;
+    this->height = height;
+    RawFrameFileHeader header{};
+    std::memcpy(header.magic, kRawFrameFileMagic, sizeof(header.magic));
+    header.version = kRawFrameFileVersion;
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    header.pixel_format = RawPixelFormat::Bgr8;
+    header.header_size = sizeof(RawFrameFileHeader);
+    if (write(file_descriptor, &header, sizeof(header)) != static_cast<ssize_t>(sizeof(header))) {
+        return ErrnoStatus("Could not write header of raw frame file", path);
+    }
+    return absl::OkStatus();
+}
+
+absl::Status RawFrameFileWriter::WriteRecord(
+    RawRecordType type,
+    int64_t timestamp_us,
+    const void* payload,
+    size_t payload_size
+) {
+    if (file_descriptor < 0) {
+        return absl::FailedPreconditionError("Raw frame file writer is not open.");
+    }
+    RawRecordHeader record_header{type, static_cast<uint32_t>(payload_size), timestamp_us};
+    iovec parts[2] = {
+        {&record_header, sizeof(record_header)},
+        {const_cast<void*>(payload), payload_size}
+    };
+    const auto expected_size = static_cast<ssize_t>(sizeof(record_header) + payload_size);
+    if (writev(file_descriptor, parts, payload_size > 0 ? 2 : 1) != expected_size) {
+        return absl::InternalError(absl::StrCat("Could not append record to raw frame file: ", std::strerror(errno)));
+    }
+    return absl::OkStatus();
+}
+
+absl::Status RawFrameFileWriter::Append(const cv::Mat& frame_bgr, int64_t timestamp_us) {
+    if (frame_bgr.cols != width || frame_bgr.rows != height || frame_bgr.type() != CV_8UC3) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Expected a ", width, "x", height, " BGR frame, got ", frame_bgr.cols, "x", frame_bgr.rows,
+            " frame of type ", frame_bgr.type(), "."
+        ));
+    }
+    cv::Mat continuous_frame = frame_bgr.isContinuous() ? frame_bgr : frame_bgr.clone();
+    return WriteRecord(
+        RawRecordType::Frame, timestamp_us, continuous_frame.data,
+        continuous_frame.total() * continuous_frame.elemSize()
+    );
+}
+
+absl::Status RawFrameFileWriter::Close() {
+    MP_RETURN_IF_ERROR(WriteRecord(RawRecordType::EndOfStream, 0, nullptr, 0));
+    close(file_descriptor);
+    file_descriptor = -1;
+    return absl::OkStatus();
+}
+// endregion ===========================================================================================================
+
+// region ==================================== RawFrameFileSource =====================================================
+RawFrameFileSource::RawFrameFileSource(std::filesystem::path path, int poll_delay_ms)
+    : path(std::move(path)), poll_delay_ms(poll_delay_ms) {}
+
+RawFrameFileSource::~RawFrameFileSource() {
+    if (mapping != nullptr) {
+        munmap(const_cast<uint8_t*>(mapping), mapping_length);
+    }
+    if (file_descriptor >= 0) {
+        close(file_descriptor);
+    }
+}
+
+absl::Status RawFrameFileSource::MapFile(size_t file_size) {
+    if (mapping != nullptr) {
+        munmap(const_cast<uint8_t*>(mapping), mapping_length);
+        mapping = nullptr;
+    }
+    const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t length = std::max(file_size * 2, kMinimumMappingLength);
+    length = (length + page_size - 1) / page_size * page_size;
+    // Mapping past the end of the file is fine, as long as only the part that has been written (per fstat) is read.
+    void* address = mmap(nullptr, length, PROT_READ, MAP_SHARED, file_descriptor, 0);
+    if (address == MAP_FAILED) {
+        return ErrnoStatus("Could not memory-map raw frame file", path);
+    }
+    mapping = static_cast<const uint8_t*>(address);
+    mapping_length = length;
+    return absl::OkStatus();
+}
+
+absl::Status RawFrameFileSource::WaitForFileSize(size_t size) {
+    while (known_file_size < size) {
+        struct stat file_status{};
+        if (fstat(file_descriptor, &file_status) != 0) {
+            return ErrnoStatus("Could not stat raw frame file", path);
+        }
+        if (static_cast<size_t>(file_status.st_size) < size) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(poll_delay_ms));
+            continue;
+        }
+        known_file_size = static_cast<size_t>(file_status.st_size);
+        if (known_file_size > mapping_length) {
+            MP_RETURN_IF_ERROR(MapFile(known_file_size));
+        }
+    }
+    return absl::OkStatus();
+}
+
+absl::Status RawFrameFileSource::Initialize() {
+    while ((file_descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC)) < 0) {
+        if (errno != ENOENT) {
+            return ErrnoStatus("Could not open raw frame file", path);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(poll_delay_ms));
+    }
+    MP_RETURN_IF_ERROR(MapFile(0));
+    MP_RETURN_IF_ERROR(WaitForFileSize(sizeof(RawFrameFileHeader)));
+    std::memcpy(&header, mapping, sizeof(header));
+
+    if (std::memcmp(header.magic, kRawFrameFileMagic, sizeof(header.magic)) != 0) {
+        return absl::InvalidArgumentError(path.string() + " is not a raw frame file.");
+    }
+    if (header.version != kRawFrameFileVersion) {
+        return absl::UnimplementedError(absl::StrCat("Unsupported raw frame file version: ", header.version));
+    }
+    if (header.pixel_format != RawPixelFormat::Bgr8) {
+        return absl::UnimplementedError(absl::StrCat(
+            "Unsupported raw frame pixel format: ", static_cast<uint32_t>(header.pixel_format)
+        ));
+    }
+    if (header.header_size < sizeof(RawFrameFileHeader)) {
+        return absl::InvalidArgumentError(absl::StrCat("Invalid raw frame file header size: ", header.header_size));
+    }
+    read_offset = header.header_size;
+    return absl::OkStatus();
+}
+
+absl::StatusOr<bool> RawFrameFileSource::Next(TimestampedFrame& frame) {
+    MP_RETURN_IF_ERROR(WaitForFileSize(read_offset + sizeof(RawRecordHeader)));
+    RawRecordHeader record_header{};
+    std::memcpy(&record_header, mapping + read_offset, sizeof(record_header));
+    switch (record_header.type) {
+        case RawRecordType::EndOfStream:
+            return false;
+        case RawRecordType::Frame:
+            break;
+        default:
+            return absl::DataLossError(absl::StrCat(
+                "Unknown record type ", static_cast<uint32_t>(record_header.type), " at offset ", read_offset,
+                " of raw frame file ", path.string()
+            ));
+    }
+    const size_t expected_payload_size = size_t{header.width} * header.height * 3;
+    if (record_header.payload_size != expected_payload_size) {
+        return absl::DataLossError(absl::StrCat(
+            "Frame record at offset ", read_offset, " of raw frame file ", path.string(), " holds ",
+            record_header.payload_size, " bytes instead of ", expected_payload_size, "."
+        ));
+    }
+    const size_t payload_offset = read_offset + sizeof(RawRecordHeader);
+    MP_RETURN_IF_ERROR(WaitForFileSize(payload_offset + record_header.payload_size));
+
+    // Copy the pixels out, since the graph may hold on to the frame while the mapping is re-made as the file grows.
+    frame.image.create(static_cast<int>(header.height), static_cast<int>(header.width), CV_8UC3);
+    std::memcpy(frame.image.data, mapping + payload_offset, record_header.payload_size);
+    frame.timestamp_us = record_header.timestamp_us;
+    read_offset = payload_offset + record_header.payload_size;
+    return true;
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
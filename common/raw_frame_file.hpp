@@ -0,0 +1,105 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// third-party includes
+#include <opencv2/core/mat.hpp>
+
+// local includes
+#include "common/frame_source.hpp"
+
+namespace presage::smartspectra::examples {
+
+// Append-only raw frame file layout (see docs/raw_frame_format.md). All fields are little-endian.
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Raw frame files are only supported on little-endian hosts.");
+
+constexpr char kRawFrameFileMagic[8] = {'S', 'S', 'R', 'A', 'W', 'F', 'R', '\0'};
+constexpr uint32_t kRawFrameFileVersion = 1;
+
+enum class RawPixelFormat : uint32_t {
+    Bgr8 = 0
+};
+
+struct RawFrameFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    RawPixelFormat pixel_format;
+    // offset of the first record, from the beginning of the file
+    uint32_t header_size;
+    uint32_t reserved;
+};
+static_assert(sizeof(RawFrameFileHeader) == 32);
+
+enum class RawRecordType : uint32_t {
+    Frame = 0,
+    EndOfStream = 1
+};
+
+struct RawRecordHeader {
+    RawRecordType type;
+    uint32_t payload_size;
+    int64_t timestamp_us;
+};
+static_assert(sizeof(RawRecordHeader) == 16);
+
+// Producer side: writes the header on Open(), then one record per Append() (each with a single write call),
+// and the end-of-stream record on Close().
+class RawFrameFileWriter {
+public:
+    RawFrameFileWriter() = default;
+    ~RawFrameFileWriter();
+
+    RawFrameFileWriter(const RawFrameFileWriter&) = delete;
+    RawFrameFileWriter& operator=(const RawFrameFileWriter&) = delete;
+
+    absl::Status Open(const std::filesystem::path& path, int width, int height);
+    absl::Status Append(const cv::Mat& frame_bgr, int64_t timestamp_us);
+    absl::Status Close();
+
+private:
+    absl::Status WriteRecord(RawRecordType type, int64_t timestamp_us, const void* payload, size_t payload_size);
+
+    int file_descriptor = -1;
+    int width = 0;
+    int height = 0;
+};
+
+// Consumer side: memory-maps the raw frame file and follows it as the producer appends to it, checking for more
+// records every `poll_delay_ms` when it has caught up. Frames are copied out of the mapping without any decoding.
+class RawFrameFileSource : public FrameSource {
+public:
+    RawFrameFileSource(std::filesystem::path path, int poll_delay_ms);
+    ~RawFrameFileSource() override;
+
+    RawFrameFileSource(const RawFrameFileSource&) = delete;
+    RawFrameFileSource& operator=(const RawFrameFileSource&) = delete;
+
+    // Waits for the file to appear and for its header to be written.
+    absl::Status Initialize() override;
+    absl::StatusOr<bool> Next(TimestampedFrame& frame) override;
+
+private:
+    // Waits until at least `size` bytes of the file are written and mapped.
+    absl::Status WaitForFileSize(size_t size);
+    absl::Status MapFile(size_t file_size);
+
+    std::filesystem::path path;
+    int poll_delay_ms;
+    int file_descriptor = -1;
+    const uint8_t* mapping = nullptr;
+    size_t mapping_length = 0;
+    size_t known_file_size = 0;
+    size_t read_offset = 0;
+    RawFrameFileHeader header{};
+};
+
+} // namespace presage::smartspectra::examples
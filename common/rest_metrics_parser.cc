@@ -0,0 +1,602 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// third-party includes
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/nlohmann/json.hpp>
+
+// local includes
+#include "common/rest_metrics_parser.hpp"
+#include "common/status_macros.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+// rough size of the shortest per-frame trace entry in the response text, e.g. `"1.2":{"value":0.5},`
+constexpr size_t kMinTraceEntryTextSize = 24;
+constexpr size_t kPerFrameTraceCount = 3;
+
+// nesting depths (count of open objects / arrays) at which the different keys of the response appear
+constexpr int kSectionDepth = 1;
+constexpr int kSeriesDepth = 2;
+constexpr int kTimeDepth = 3;
+constexpr int kFieldDepth = 4;
+// objects in the "intervals" array of a boolean series written in interval form
+constexpr int kIntervalDepth = 5;
+
+enum class Section {
+    Pulse,
+    Breath,
+    Pressure,
+    Face,
+    Version,
+    Error,
+    Other
+};
+
+enum class Series {
+    PulseRate,
+    PulseTrace,
+    PulseStrict,
+    BreathingRate,
+    BreathingUpperTrace,
+    BreathingLowerTrace,
+    BreathingStrict,
+    BreathingAmplitude,
+    Apnea,
+    RespiratoryLineLength,
+    InhaleExhaleRatio,
+    PhasicBloodPressure,
+    FaceBlinking,
+    FaceTalking,
+    Other
+};
+
+enum class Field {
+    Value,
+    Confidence,
+    Start,
+    End,
+    Count,
+    Other
+};
+
+Section SectionFromKey(const std::string& key) {
+    if (key == "pulse") return Section::Pulse;
+    if (key == "breath") return Section::Breath;
+    if (key == "pressure") return Section::Pressure;
+    if (key == "face") return Section::Face;
+    if (key == "version") return Section::Version;
+    if (key == "error") return Section::Error;
+    return Section::Other;
+}
+
+Series SeriesFromKey(Section section, const std::string& key) {
+    switch (section) {
+        case Section::Pulse:
+            if (key == "hr") return Series::PulseRate;
+            if (key == "hr_trace") return Series::PulseTrace;
+            if (key == "hr_strict") return Series::PulseStrict;
+            break;
+        case Section::Breath:
+            if (key == "rr") return Series::BreathingRate;
+            if (key == "rr_trace") return Series::BreathingUpperTrace;
+            if (key == "rr_trace_lower") return Series::BreathingLowerTrace;
+            if (key == "rr_strict") return Series::BreathingStrict;
+            if (key == "amplitude") return Series::BreathingAmplitude;
+            if (key == "apnea") return Series::Apnea;
+            if (key == "rrl") return Series::RespiratoryLineLength;
+            if (key == "ie") return Series::InhaleExhaleRatio;
+            break;
+        case Section::Pressure:
+            if (key == "phasic") return Series::PhasicBloodPressure;
+            break;
+        case Section::Face:
+            if (key == "blinking") return Series::FaceBlinking;
+            if (key == "talking") return Series::FaceTalking;
+            break;
+        default:
+            break;
+    }
+    return Series::Other;
+}
+
+bool IsBooleanSeries(Series series) {
+    return series == Series::Apnea || series == Series::FaceBlinking || series == Series::FaceTalking;
+}
+
+Field FieldFromKey(const std::string& key) {
+    if (key == "value") return Field::Value;
+    if (key == "confidence") return Field::Confidence;
+    if (key == "start") return Field::Start;
+    if (key == "end") return Field::End;
+    if (key == "count") return Field::Count;
+    return Field::Other;
+}
+
+// Walks the response and hands every complete series entry to `TSink::Add(series, time, value, confidence)`, and
+// every interval of a boolean series written in interval form (`"apnea":{"intervals":[{"start":0,"end":9.9,
+// "count":300,"value":false},...]}`, see ToRestApiJsonText) to `TSink::AddInterval(series, start, end, count, value)`.
+template<typename TSink>
+class MetricsSaxHandler : public nlohmann::json_sax<nlohmann::json> {
+public:
+    explicit MetricsSaxHandler(TSink& sink) : sink(sink) {}
+
+    bool null() override {
+        return true;
+    }
+
+    bool boolean(bool value) override {
+        return Number(value ? 1.0f : 0.0f);
+    }
+
+    bool number_integer(number_integer_t value) override {
+        return Number(static_cast<float>(value));
+    }
+
+    bool number_unsigned(number_unsigned_t value) override {
+        return Number(static_cast<float>(value));
+    }
+
+    bool number_float(number_float_t value, const string_t& /*text*/) override {
+        return Number(static_cast<float>(value));
+    }
+
+    bool string(string_t& value) override {
+        if (depth == kSectionDepth) {
+            if (section == Section::Version) {
+                sink.SetVersion(value);
+            } else if (section == Section::Error && !value.empty()) {
+                error = absl::UnavailableError("Physiology REST API returned an error: " + value);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool binary(binary_t& /*value*/) override {
+        return true;
+    }
+
+    bool start_object(std::size_t /*element_count*/) override {
+        depth++;
+        if (depth == kFieldDepth) {
+            entry = Entry{entry.time, 0.0f, 0.0f, false};
+            field = Field::Other;
+        } else if (depth == kIntervalDepth && in_intervals) {
+            interval = Interval{0.0f, 0.0f, 0, false};
+            field = Field::Other;
+        }
+        return true;
+    }
+
+    bool key(string_t& key) override {
+        switch (depth) {
+            case kSectionDepth:
+                section = SectionFromKey(key);
+                break;
+            case kSeriesDepth:
+                series = SeriesFromKey(section, key);
+                in_intervals = false;
+                break;
+            case kTimeDepth: {
+                if (series == Series::Other) {
+                    break;
+                }
+                if (key == "intervals" && IsBooleanSeries(series)) {
+                    in_intervals = true;
+                    break;
+                }
+                char* end = nullptr;
+                entry.time = std::strtof(key.c_str(), &end);
+                if (end == key.c_str() || *end != '\0') {
+                    error = absl::InvalidArgumentError(absl::StrCat("Invalid time key in metrics series: \"", key, "\""));
+                    return false;
+                }
+                break;
+            }
+            case kFieldDepth:
+            case kIntervalDepth:
+                field = FieldFromKey(key);
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        if (depth == kFieldDepth && series != Series::Other && !in_intervals && entry.has_value) {
+            sink.Add(series, entry.time, entry.value, entry.confidence);
+        } else if (depth == kIntervalDepth && in_intervals && interval.count > 0) {
+            sink.AddInterval(series, interval.start, interval.end, interval.count, interval.value);
+        }
+        depth--;
+        return true;
+    }
+
+    bool start_array(std::size_t /*element_count*/) override {
+        depth++;
+        return true;
+    }
+
+    bool end_array() override {
+        depth--;
+        return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string& /*last_token*/,
+                     const nlohmann::detail::exception& exception) override {
+        error = absl::InvalidArgumentError(absl::StrCat(
+            "Could not parse metrics JSON at byte ", position, ": ", exception.what()
+        ));
+        return false;
+    }
+
+    absl::Status GetError() const {
+        return error;
+    }
+
+private:
+    struct Entry {
+        float time;
+        float value;
+        float confidence;
+        bool has_value;
+    };
+
+    struct Interval {
+        float start;
+        float end;
+        uint32_t count;
+        bool value;
+    };
+
+    bool Number(float number) {
+        if (series == Series::Other) {
+            return true;
+        }
+        if (in_intervals) {
+            if (depth == kIntervalDepth) {
+                switch (field) {
+                    case Field::Start: interval.start = number; break;
+                    case Field::End: interval.end = number; break;
+                    case Field::Count: interval.count = static_cast<uint32_t>(std::max(0.0f, number)); break;
+                    case Field::Value: interval.value = number != 0.0f; break;
+                    default: break;
+                }
+            }
+            return true;
+        }
+        if (depth == kFieldDepth && field == Field::Value) {
+            entry.value = number;
+            entry.has_value = true;
+        } else if (field == Field::Confidence && (depth == kFieldDepth || depth == kFieldDepth + 1)) {
+            // the strict rates hold a single-element array of confidences
+            entry.confidence = number;
+        }
+        return true;
+    }
+
+    TSink& sink;
+    absl::Status error;
+    int depth = 0;
+    Section section = Section::Other;
+    Series series = Series::Other;
+    Field field = Field::Other;
+    Entry entry{0.0f, 0.0f, 0.0f, false};
+    bool in_intervals = false;
+    Interval interval{0.0f, 0.0f, 0, false};
+};
+
+template<typename TMeasurement>
+void SortByTime(std::vector<TMeasurement>& series) {
+    auto earlier = [](const TMeasurement& a, const TMeasurement& b) { return a.time < b.time; };
+    if (!std::is_sorted(series.begin(), series.end(), earlier)) {
+        std::sort(series.begin(), series.end(), earlier);
+    }
+}
+
+template<typename TValue>
+void SortByTime(SeriesColumns<TValue>& series) {
+    if (std::is_sorted(series.time.begin(), series.time.end())) {
+        return;
+    }
+    std::vector<size_t> order(series.Size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&series](size_t a, size_t b) { return series.time[a] < series.time[b]; });
+    auto reorder = [&order](auto& column) {
+        if (column.empty()) {
+            return;
+        }
+        std::remove_reference_t<decltype(column)> reordered(column.size());
+        for (size_t i_measurement = 0; i_measurement < order.size(); i_measurement++) {
+            reordered[i_measurement] = column[order[i_measurement]];
+        }
+        column.swap(reordered);
+    };
+    reorder(series.time);
+    reorder(series.value);
+    reorder(series.confidence);
+}
+
+template<typename TMeasurement>
+void Append(std::vector<TMeasurement>& series, float time, float value, float confidence) {
+    TMeasurement& measurement = series.emplace_back();
+    measurement.time = time;
+    measurement.value = value;
+    if constexpr (std::is_same_v<TMeasurement, formats::MeasurementWithConfidence<float>>) {
+        measurement.confidence = confidence;
+    }
+}
+
+template<typename TValue>
+void Append(SeriesColumns<TValue>& series, float time, float value, float confidence, bool with_confidence) {
+    series.time.push_back(time);
+    series.value.push_back(static_cast<TValue>(value));
+    if (with_confidence) {
+        series.confidence.push_back(confidence);
+    }
+}
+
+void AppendInterval(BooleanIntervals& intervals, float start, float end, uint32_t count, bool value) {
+    intervals.start_time.push_back(start);
+    intervals.end_time.push_back(end);
+    intervals.count.push_back(count);
+    intervals.value.push_back(value ? 1 : 0);
+}
+
+// Intervals of a boolean series that may have come both as intervals and as separate measurements.
+void MergeIntoIntervals(BooleanIntervals& intervals, SeriesColumns<uint8_t>& measurements) {
+    const bool intervals_sorted = std::is_sorted(intervals.start_time.begin(), intervals.start_time.end());
+    if (measurements.Size() == 0 && intervals_sorted) {
+        return;
+    }
+    for (size_t i_interval = 0; i_interval < intervals.Size(); i_interval++) {
+        intervals.Expand(i_interval, measurements);
+    }
+    intervals = ToIntervals(std::move(measurements));
+}
+
+size_t EstimateTraceLength(std::string_view json_text, const RestMetricsParserSettings& settings) {
+    return settings.expected_trace_length > 0
+           ? settings.expected_trace_length
+           : json_text.size() / (kMinTraceEntryTextSize * kPerFrameTraceCount);
+}
+
+template<typename TSink>
+absl::Status Parse(std::string_view json_text, TSink& sink) {
+    MetricsSaxHandler<TSink> handler(sink);
+    if (!nlohmann::json::sax_parse(json_text.begin(), json_text.end(), &handler)) {
+        absl::Status error = handler.GetError();
+        return error.ok() ? absl::InvalidArgumentError("Could not parse metrics JSON.") : error;
+    }
+    return absl::OkStatus();
+}
+
+class MetricsSink {
+public:
+    MetricsSink(formats::Metrics& metrics, size_t trace_length) : metrics(metrics) {
+        metrics.pulse.trace.reserve(trace_length);
+        metrics.breathing.upper_trace.reserve(trace_length);
+        metrics.breathing.lower_trace.reserve(trace_length);
+    }
+
+    void SetVersion(const std::string& version) {
+        metrics.version = version;
+    }
+
+    void Add(Series series, float time, float value, float confidence) {
+        switch (series) {
+            case Series::PulseRate:
+                Append(metrics.pulse.values, time, value, confidence);
+                break;
+            case Series::PulseTrace:
+                Append(metrics.pulse.trace, time, value, confidence);
+                break;
+            case Series::PulseStrict:
+                metrics.pulse.strict = value;
+                metrics.pulse.snr_sufficient = true;
+                break;
+            case Series::BreathingRate:
+                Append(metrics.breathing.values, time, value, confidence);
+                break;
+            case Series::BreathingUpperTrace:
+                Append(metrics.breathing.upper_trace, time, value, confidence);
+                break;
+            case Series::BreathingLowerTrace:
+                Append(metrics.breathing.lower_trace, time, value, confidence);
+                break;
+            case Series::BreathingStrict:
+                metrics.breathing.strict = value;
+                metrics.breathing.snr_sufficient = true;
+                break;
+            case Series::BreathingAmplitude:
+                Append(metrics.breathing.amplitude, time, value, confidence);
+                break;
+            case Series::Apnea: {
+                auto& measurement = metrics.breathing.apnea.emplace_back();
+                measurement.time = time;
+                measurement.value = value != 0.0f;
+                break;
+            }
+            case Series::RespiratoryLineLength:
+                Append(metrics.breathing.respiratory_line_length, time, value, confidence);
+                break;
+            case Series::InhaleExhaleRatio:
+                Append(metrics.breathing.inhale_exhale_ratio, time, value, confidence);
+                break;
+            case Series::PhasicBloodPressure:
+                Append(metrics.blood_pressure.phasic, time, value, confidence);
+                break;
+            case Series::FaceBlinking:
+            case Series::FaceTalking:
+                // not in formats::Metrics
+            case Series::Other:
+                break;
+        }
+    }
+
+    void AddInterval(Series series, float start, float end, uint32_t count, bool value) {
+        if (series == Series::Apnea) {
+            AppendInterval(apnea_intervals, start, end, count, value);
+        }
+    }
+
+    void SortSeries() {
+        SortByTime(metrics.pulse.values);
+        SortByTime(metrics.pulse.trace);
+        SortByTime(metrics.breathing.values);
+        SortByTime(metrics.breathing.upper_trace);
+        SortByTime(metrics.breathing.lower_trace);
+        SortByTime(metrics.breathing.amplitude);
+        if (apnea_intervals.Size() > 0) {
+            const std::vector<formats::Measurement<bool>> apnea = ToMeasurements(apnea_intervals);
+            metrics.breathing.apnea.insert(metrics.breathing.apnea.end(), apnea.begin(), apnea.end());
+        }
+        SortByTime(metrics.breathing.apnea);
+        SortByTime(metrics.breathing.respiratory_line_length);
+        SortByTime(metrics.breathing.inhale_exhale_ratio);
+        SortByTime(metrics.blood_pressure.phasic);
+    }
+
+private:
+    formats::Metrics& metrics;
+    BooleanIntervals apnea_intervals;
+};
+
+class ColumnsSink {
+public:
+    ColumnsSink(MetricsColumns& columns, size_t trace_length) : columns(columns) {
+        columns.pulse_trace.Reserve(trace_length, false);
+        columns.breathing_upper_trace.Reserve(trace_length, false);
+        columns.breathing_lower_trace.Reserve(trace_length, false);
+    }
+
+    void SetVersion(const std::string& version) {
+        columns.version = version;
+    }
+
+    void Add(Series series, float time, float value, float confidence) {
+        switch (series) {
+            case Series::PulseRate:
+                Append(columns.pulse_rate, time, value, confidence, true);
+                break;
+            case Series::PulseTrace:
+                Append(columns.pulse_trace, time, value, confidence, false);
+                break;
+            case Series::PulseStrict:
+                columns.pulse_strict = value;
+                columns.pulse_snr_sufficient = true;
+                break;
+            case Series::BreathingRate:
+                Append(columns.breathing_rate, time, value, confidence, true);
+                break;
+            case Series::BreathingUpperTrace:
+                Append(columns.breathing_upper_trace, time, value, confidence, false);
+                break;
+            case Series::BreathingLowerTrace:
+                Append(columns.breathing_lower_trace, time, value, confidence, false);
+                break;
+            case Series::BreathingStrict:
+                columns.breathing_strict = value;
+                columns.breathing_snr_sufficient = true;
+                break;
+            case Series::BreathingAmplitude:
+                Append(columns.breathing_amplitude, time, value, confidence, false);
+                break;
+            case Series::Apnea:
+                Append(measured_apnea, time, value != 0.0f ? 1.0f : 0.0f, confidence, false);
+                break;
+            case Series::RespiratoryLineLength:
+                Append(columns.respiratory_line_length, time, value, confidence, false);
+                break;
+            case Series::InhaleExhaleRatio:
+                Append(columns.inhale_exhale_ratio, time, value, confidence, false);
+                break;
+            case Series::PhasicBloodPressure:
+                Append(columns.phasic_blood_pressure, time, value, confidence, true);
+                break;
+            case Series::FaceBlinking:
+                Append(measured_face_blinking, time, value != 0.0f ? 1.0f : 0.0f, confidence, false);
+                break;
+            case Series::FaceTalking:
+                Append(measured_face_talking, time, value != 0.0f ? 1.0f : 0.0f, confidence, false);
+                break;
+            case Series::Other:
+                break;
+        }
+    }
+
+    void AddInterval(Series series, float start, float end, uint32_t count, bool value) {
+        switch (series) {
+            case Series::Apnea:
+                AppendInterval(columns.apnea, start, end, count, value);
+                break;
+            case Series::FaceBlinking:
+                AppendInterval(columns.face_blinking, start, end, count, value);
+                break;
+            case Series::FaceTalking:
+                AppendInterval(columns.face_talking, start, end, count, value);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void SortSeries() {
+        SortByTime(columns.pulse_rate);
+        SortByTime(columns.pulse_trace);
+        SortByTime(columns.breathing_rate);
+        SortByTime(columns.breathing_upper_trace);
+        SortByTime(columns.breathing_lower_trace);
+        SortByTime(columns.breathing_amplitude);
+        MergeIntoIntervals(columns.apnea, measured_apnea);
+        SortByTime(columns.respiratory_line_length);
+        SortByTime(columns.inhale_exhale_ratio);
+        SortByTime(columns.phasic_blood_pressure);
+        MergeIntoIntervals(columns.face_blinking, measured_face_blinking);
+        MergeIntoIntervals(columns.face_talking, measured_face_talking);
+    }
+
+private:
+    MetricsColumns& columns;
+    // boolean series received per measurement, turned into intervals once all are in
+    SeriesColumns<uint8_t> measured_apnea;
+    SeriesColumns<uint8_t> measured_face_blinking;
+    SeriesColumns<uint8_t> measured_face_talking;
+};
+} // anonymous namespace
+
+absl::StatusOr<formats::Metrics> ParseRestApiMetrics(
+    std::string_view json_text,
+    const RestMetricsParserSettings& settings
+) {
+    formats::Metrics metrics;
+    MetricsSink sink(metrics, EstimateTraceLength(json_text, settings));
+    MP_RETURN_IF_ERROR(Parse(json_text, sink));
+    sink.SortSeries();
+    return metrics;
+}
+
+absl::StatusOr<MetricsColumns> ParseRestApiMetricsColumns(
+    std::string_view json_text,
+    const RestMetricsParserSettings& settings
+) {
+    MetricsColumns columns;
+    ColumnsSink sink(columns, EstimateTraceLength(json_text, settings));
+    MP_RETURN_IF_ERROR(Parse(json_text, sink));
+    sink.SortSeries();
+    return columns;
+}
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,43 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <cstddef>
+#include <string_view>
+
+// third-party includes
+#include <physiology/interface/absl/status/statusor.h>
+#include <smartspectra/formats/metrics.hpp>
+
+// local includes
+#include "common/metric_columns.hpp"
+
+namespace presage::smartspectra::examples {
+
+struct RestMetricsParserSettings {
+    // Number of entries to reserve up front for each per-frame trace (pulse trace and both breathing traces).
+    // When 0, it is estimated from the size of the response text.
+    size_t expected_trace_length = 0;
+};
+
+// Reads the Physiology REST API response text (see docs/output_format.md) straight into a formats::Metrics,
+// without building a JSON DOM: the text is walked by a SAX handler that appends every entry to the matching
+// series and, once done, sorts the series that did not arrive in time order.
+// Produces the same Metrics as formats::MetricsFromRestApiJson(nlohmann::json::parse(json_text)). Apnea may also
+// come in the interval form that ToRestApiJsonText can write, and is then expanded back into measurements.
+absl::StatusOr<formats::Metrics> ParseRestApiMetrics(
+    std::string_view json_text,
+    const RestMetricsParserSettings& settings = RestMetricsParserSettings()
+);
+
+// Same as ParseRestApiMetrics, but fills the columnar MetricsColumns directly (no formats::Metrics in between),
+// including the face series, with the boolean series turned into intervals.
+absl::StatusOr<MetricsColumns> ParseRestApiMetricsColumns(
+    std::string_view json_text,
+    const RestMetricsParserSettings& settings = RestMetricsParserSettings()
+);
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <charconv>
+#include <string>
+
+// third-party includes
+#include <physiology/interface/nlohmann/json.hpp>
+
+// local includes
+#include "common/rest_metrics_writer.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+
+void AppendFloat(std::string& out, float value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+template<typename TValue>
+void AppendEntries(std::string& out, const SeriesColumns<TValue>& series, bool leading_comma) {
+    const bool with_confidence = series.confidence.size() == series.Size();
+    for (size_t i_measurement = 0; i_measurement < series.Size(); i_measurement++) {
+        out += i_measurement > 0 || leading_comma ? ",\"" : "\"";
+        AppendFloat(out, series.time[i_measurement]);
+        out += "\":{\"value\":";
+        if constexpr (std::is_same_v<TValue, uint8_t>) {
+            out += series.value[i_measurement] != 0 ? "true" : "false";
+        } else {
+            AppendFloat(out, series.value[i_measurement]);
+        }
+        if (with_confidence) {
+            out += ",\"confidence\":";
+            AppendFloat(out, series.confidence[i_measurement]);
+        }
+        out += '}';
+    }
+}
+
+void AppendSeries(std::string& out, const char* name, const SeriesColumns<float>& series, bool leading_comma = true) {
+    if (leading_comma) {
+        out += ',';
+    }
+    out += '"';
+    out += name;
+    out += "\":{";
+    AppendEntries(out, series, false);
+    out += '}';
+}
+
+void AppendSeries(std::string& out, const char* name, const BooleanIntervals& intervals, bool as_intervals,
+                  bool leading_comma = true) {
+    if (leading_comma) {
+        out += ',';
+    }
+    out += '"';
+    out += name;
+    out += "\":{";
+    if (as_intervals) {
+        out += "\"intervals\":[";
+        for (size_t i_interval = 0; i_interval < intervals.Size(); i_interval++) {
+            out += i_interval > 0 ? ",{\"start\":" : "{\"start\":";
+            AppendFloat(out, intervals.start_time[i_interval]);
+            out += ",\"end\":";
+            AppendFloat(out, intervals.end_time[i_interval]);
+            out += ",\"count\":";
+            out += std::to_string(intervals.count[i_interval]);
+            out += intervals.value[i_interval] != 0 ? ",\"value\":true}" : ",\"value\":false}";
+        }
+        out += ']';
+    } else {
+        // one interval at a time, so as not to hold the whole expanded series
+        SeriesColumns<uint8_t> measurements;
+        for (size_t i_interval = 0; i_interval < intervals.Size(); i_interval++) {
+            measurements.time.clear();
+            measurements.value.clear();
+            intervals.Expand(i_interval, measurements);
+            AppendEntries(out, measurements, i_interval > 0);
+        }
+    }
+    out += '}';
+}
+
+void AppendStrict(std::string& out, const char* name, bool snr_sufficient, float strict,
+                  const SeriesColumns<float>& rates) {
+    out += ",\"";
+    out += name;
+    out += "\":{";
+    if (snr_sufficient) {
+        out += '"';
+        AppendFloat(out, rates.Size() > 0 ? rates.time.back() : 0.0f);
+        out += "\":{\"value\":";
+        AppendFloat(out, strict);
+        out += '}';
+    }
+    out += '}';
+}
+
+} // anonymous namespace
+
+std::string ToRestApiJsonText(const MetricsColumns& columns, const RestMetricsWriterSettings& settings) {
+    std::string out;
+    const size_t trace_size = columns.pulse_trace.Size() + columns.breathing_upper_trace.Size() +
+                              columns.breathing_lower_trace.Size() + columns.phasic_blood_pressure.Size();
+    out.reserve(256 + trace_size * 32);
+    out += "{\"error\":\"\",\"version\":";
+    out += nlohmann::json(columns.version).dump();
+    out += ",\"pulse\":{";
+    AppendSeries(out, "hr", columns.pulse_rate, false);
+    AppendSeries(out, "hr_trace", columns.pulse_trace);
+    AppendStrict(out, "hr_strict", columns.pulse_snr_sufficient, columns.pulse_strict, columns.pulse_rate);
+    out += "},\"breath\":{";
+    AppendSeries(out, "rr", columns.breathing_rate, false);
+    AppendSeries(out, "rr_trace", columns.breathing_upper_trace);
+    AppendSeries(out, "rr_trace_lower", columns.breathing_lower_trace);
+    AppendStrict(out, "rr_strict", columns.breathing_snr_sufficient, columns.breathing_strict, columns.breathing_rate);
+    AppendSeries(out, "rrl", columns.respiratory_line_length);
+    AppendSeries(out, "apnea", columns.apnea, settings.boolean_intervals);
+    AppendSeries(out, "ie", columns.inhale_exhale_ratio);
+    AppendSeries(out, "amplitude", columns.breathing_amplitude);
+    out += "},\"pressure\":{";
+    AppendSeries(out, "phasic", columns.phasic_blood_pressure, false);
+    out += "},\"face\":{";
+    AppendSeries(out, "blinking", columns.face_blinking, settings.boolean_intervals, false);
+    AppendSeries(out, "talking", columns.face_talking, settings.boolean_intervals);
+    out += "}}";
+    return out;
+}
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,31 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <string>
+
+// local includes
+#include "common/metric_columns.hpp"
+
+namespace presage::smartspectra::examples {
+
+struct RestMetricsWriterSettings {
+    // If true, the boolean series (apnea, face blinking / talking) are written as their intervals,
+    // `"apnea":{"intervals":[{"start":0,"end":9.967,"count":300,"value":false},...]}`, which only
+    // ParseRestApiMetrics[Columns] read; otherwise, per measurement, as the REST API sends them.
+    bool boolean_intervals = false;
+};
+
+// Writes metrics back out in the raw Physiology REST API response schema (see docs/output_format.md), with series
+// keyed by time, in time order. Floats are written in their shortest round-trip form, so ParseRestApiMetricsColumns
+// reads back exactly the same columns. The strict rates are keyed by the time of the last rate measurement (the
+// original key and the strict confidence are not kept in MetricsColumns).
+std::string ToRestApiJsonText(
+    const MetricsColumns& columns,
+    const RestMetricsWriterSettings& settings = RestMetricsWriterSettings()
+);
+
+} // namespace presage::smartspectra::examples
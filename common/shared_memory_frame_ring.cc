@@ -0,0 +1,322 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+// third-party includes
+#include <physiology/interface/absl/strings/str_cat.h>
+
+// local includes
+#include "common/shared_memory_frame_ring.hpp"
+#include "common/status_macros.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+// slot headers are padded so that the pixels of every slot start on a cache line
+constexpr size_t kSlotHeaderSize = 64;
+static_assert(sizeof(SharedFrameSlotHeader) <= kSlotHeaderSize);
+
+size_t RoundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+absl::Status ErrnoStatus(const std::string& what, const std::string& name) {
+    return absl::InternalError(absl::StrCat(what, " ", name, ": ", std::strerror(errno)));
+}
+
+SharedFrameSlotHeader* GetSlot(SharedFrameRingHeader* header, uint64_t frame_index) {
+    auto* base = reinterpret_cast<uint8_t*>(header);
+    return reinterpret_cast<SharedFrameSlotHeader*>(
+        base + header->slots_offset + (frame_index % header->slot_count) * header->slot_stride
+    );
+}
+
+uint8_t* GetSlotPixels(SharedFrameSlotHeader* slot) {
+    return reinterpret_cast<uint8_t*>(slot) + kSlotHeaderSize;
+}
+
+// Waits (up to `timeout_ms`) for `word` to be changed from `expected` by another process sharing the mapping.
+void WaitForChange(std::atomic<uint32_t>& word, uint32_t expected, int timeout_ms) {
+#ifdef __linux__
+    timespec timeout{timeout_ms / 1000, static_cast<long>(timeout_ms % 1000) * 1000000L};
+    // not FUTEX_WAIT_PRIVATE: the waker is in another process
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+#else
+    if (word.load(std::memory_order_acquire) == expected) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+    }
+#endif
+}
+
+void WakeWaiters(std::atomic<uint32_t>& word) {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+} // anonymous namespace
+
+// region ================================ SharedMemoryFrameRingWriter =================================================
+SharedMemoryFrameRingWriter::~SharedMemoryFrameRingWriter() {
+    if (header != nullptr) {
+        Close().IgnoreError();
+    }
+}
+
+absl::Status SharedMemoryFrameRingWriter::Open(const std::string& name, int width, int height, int slot_count) {
+    if (header != nullptr) {
+        return absl::FailedPreconditionError("Shared-memory frame ring writer is already open.");
+    }
+    if (width <= 0 || height <= 0 || slot_count < 2) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Invalid shared-memory frame ring dimensions: ", width, "x", height, ", ", slot_count, " slots."
+        ));
+    }
+    this->name = name;
+    frame_size = static_cast<size_t>(width) * height * 3;
+    const size_t slots_offset = RoundUp(sizeof(SharedFrameRingHeader), kSlotHeaderSize);
+    const size_t slot_stride = RoundUp(kSlotHeaderSize + frame_size, kSlotHeaderSize);
+    segment_size = slots_offset + slot_stride * slot_count;
+
+    // a consumer still holding on to a stale segment by this name keeps its mapping, but will not see the new one
+    shm_unlink(name.c_str());
+    const int file_descriptor = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (file_descriptor < 0) {
+        return ErrnoStatus("Could not create shared-memory segment", name);
+    }
+    // the segment is created at its full size at once, so that consumers only ever see it empty or whole
+    if (ftruncate(file_descriptor, static_cast<off_t>(segment_size)) != 0) {
+        close(file_descriptor);
+        shm_unlink(name.c_str());
+        return ErrnoStatus("Could not size shared-memory segment", name);
+    }
+    void* address = mmap(nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+    close(file_descriptor);
+    if (address == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return ErrnoStatus("Could not map shared-memory segment", name);
+    }
+
+    // the segment comes zero-filled, i.e. in the Initializing state, until the header is complete
+    header = new(address) SharedFrameRingHeader{};
+    std::memcpy(header->magic, kSharedFrameRingMagic, sizeof(header->magic));
+    header->version = kSharedFrameRingVersion;
+    header->width = static_cast<uint32_t>(width);
+    header->height = static_cast<uint32_t>(height);
+    header->pixel_format = RawPixelFormat::Bgr8;
+    header->slot_count = static_cast<uint32_t>(slot_count);
+    header->slot_stride = slot_stride;
+    header->slots_offset = slots_offset;
+    for (int i_slot = 0; i_slot < slot_count; i_slot++) {
+        new(GetSlot(header, i_slot)) SharedFrameSlotHeader{};
+    }
+    header->state.store(SharedFrameRingState::Ready, std::memory_order_release);
+    return absl::OkStatus();
+}
+
+absl::StatusOr<bool> SharedMemoryFrameRingWriter::Publish(const cv::Mat& frame_bgr, int64_t timestamp_us) {
+    if (header == nullptr) {
+        return absl::FailedPreconditionError("Shared-memory frame ring writer is not open.");
+    }
+    if (frame_bgr.cols != static_cast<int>(header->width) || frame_bgr.rows != static_cast<int>(header->height) ||
+        frame_bgr.type() != CV_8UC3) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Expected a ", header->width, "x", header->height, " BGR frame, got ", frame_bgr.cols, "x",
+            frame_bgr.rows, " frame of type ", frame_bgr.type(), "."
+        ));
+    }
+    const uint64_t frame_index = header->write_index.load(std::memory_order_relaxed);
+    if (frame_index - header->read_index.load(std::memory_order_acquire) >= header->slot_count) {
+        header->dropped_frame_count.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    SharedFrameSlotHeader* slot = GetSlot(header, frame_index);
+    slot->sequence.store(2 * frame_index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->timestamp_us = timestamp_us;
+    uint8_t* pixels = GetSlotPixels(slot);
+    if (frame_bgr.isContinuous()) {
+        std::memcpy(pixels, frame_bgr.data, frame_size);
+    } else {
+        const size_t row_size = static_cast<size_t>(frame_bgr.cols) * 3;
+        for (int i_row = 0; i_row < frame_bgr.rows; i_row++) {
+            std::memcpy(pixels + i_row * row_size, frame_bgr.ptr(i_row), row_size);
+        }
+    }
+    slot->sequence.store(2 * frame_index + 2, std::memory_order_release);
+
+    // Sequentially consistent, so that either the consumer sees the frame before going to sleep, or we see it
+    // waiting and wake it.
+    header->write_index.store(frame_index + 1);
+    header->publish_counter.fetch_add(1);
+    if (header->consumer_waiting.load() != 0) {
+        WakeWaiters(header->publish_counter);
+    }
+    return true;
+}
+
+bool SharedMemoryFrameRingWriter::WaitForFreeSlot(int timeout_ms) const {
+    if (header == nullptr) {
+        return false;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (header->write_index.load(std::memory_order_relaxed) - header->read_index.load(std::memory_order_acquire) >=
+           header->slot_count) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    return true;
+}
+
+absl::Status SharedMemoryFrameRingWriter::Close() {
+    if (header == nullptr) {
+        return absl::FailedPreconditionError("Shared-memory frame ring writer is not open.");
+    }
+    header->state.store(SharedFrameRingState::Closed);
+    header->publish_counter.fetch_add(1);
+    WakeWaiters(header->publish_counter);
+    munmap(header, segment_size);
+    header = nullptr;
+    if (shm_unlink(name.c_str()) != 0 && errno != ENOENT) {
+        return ErrnoStatus("Could not remove shared-memory segment", name);
+    }
+    return absl::OkStatus();
+}
+
+uint64_t SharedMemoryFrameRingWriter::GetDroppedFrameCount() const {
+    return header == nullptr ? 0 : header->dropped_frame_count.load(std::memory_order_relaxed);
+}
+// endregion ===========================================================================================================
+
+// region ================================== SharedMemoryFrameSource ==================================================
+SharedMemoryFrameSource::SharedMemoryFrameSource(std::string name, int poll_delay_ms)
+    : name(std::move(name)), poll_delay_ms(poll_delay_ms) {}
+
+SharedMemoryFrameSource::~SharedMemoryFrameSource() {
+    if (header != nullptr) {
+        munmap(header, segment_size);
+    }
+}
+
+absl::Status SharedMemoryFrameSource::Initialize() {
+    int file_descriptor;
+    // read-write: the consumer owns the read index
+    while ((file_descriptor = shm_open(name.c_str(), O_RDWR, 0)) < 0) {
+        if (errno != ENOENT) {
+            return ErrnoStatus("Could not open shared-memory segment", name);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(poll_delay_ms));
+    }
+    struct stat segment_status{};
+    while (true) {
+        if (fstat(file_descriptor, &segment_status) != 0) {
+            close(file_descriptor);
+            return ErrnoStatus("Could not stat shared-memory segment", name);
+        }
+        if (static_cast<size_t>(segment_status.st_size) >= sizeof(SharedFrameRingHeader)) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(poll_delay_ms));
+    }
+    segment_size = static_cast<size_t>(segment_status.st_size);
+    void* address = mmap(nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+    close(file_descriptor);
+    if (address == MAP_FAILED) {
+        return ErrnoStatus("Could not map shared-memory segment", name);
+    }
+    header = static_cast<SharedFrameRingHeader*>(address);
+    while (header->state.load(std::memory_order_acquire) == SharedFrameRingState::Initializing) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(poll_delay_ms));
+    }
+
+    if (std::memcmp(header->magic, kSharedFrameRingMagic, sizeof(header->magic)) != 0) {
+        return absl::InvalidArgumentError(name + " is not a shared-memory frame ring.");
+    }
+    if (header->version != kSharedFrameRingVersion) {
+        return absl::UnimplementedError(absl::StrCat(
+            "Unsupported shared-memory frame ring version: ", header->version
+        ));
+    }
+    if (header->pixel_format != RawPixelFormat::Bgr8) {
+        return absl::UnimplementedError(absl::StrCat(
+            "Unsupported shared-memory frame ring pixel format: ", static_cast<uint32_t>(header->pixel_format)
+        ));
+    }
+    const size_t frame_size = size_t{header->width} * header->height * 3;
+    if (header->slot_count == 0 || header->slot_stride < kSlotHeaderSize + frame_size ||
+        header->slots_offset + header->slot_stride * header->slot_count > segment_size) {
+        return absl::InvalidArgumentError(absl::StrCat("Invalid shared-memory frame ring layout in ", name));
+    }
+    // start with the oldest frame still held in the ring
+    next_frame_index = header->read_index.load(std::memory_order_acquire);
+    return absl::OkStatus();
+}
+
+bool SharedMemoryFrameSource::WaitForFrame(uint64_t frame_index) {
+    while (true) {
+        const uint32_t publish_count = header->publish_counter.load(std::memory_order_acquire);
+        if (header->write_index.load(std::memory_order_acquire) > frame_index) {
+            return true;
+        }
+        if (header->state.load(std::memory_order_acquire) == SharedFrameRingState::Closed) {
+            // frames published right before closing are still there
+            return header->write_index.load(std::memory_order_acquire) > frame_index;
+        }
+        // Sequentially consistent, pairing with Publish(): see there.
+        header->consumer_waiting.store(1);
+        if (header->write_index.load() <= frame_index) {
+            // returns as soon as the producer bumps the counter, or after the poll delay in case it went away
+            WaitForChange(header->publish_counter, publish_count, poll_delay_ms);
+        }
+        header->consumer_waiting.store(0);
+    }
+}
+
+absl::StatusOr<bool> SharedMemoryFrameSource::Next(TimestampedFrame& frame) {
+    if (header == nullptr) {
+        return absl::FailedPreconditionError("Shared-memory frame source is not initialized.");
+    }
+    if (!WaitForFrame(next_frame_index)) {
+        return false;
+    }
+    SharedFrameSlotHeader* slot = GetSlot(header, next_frame_index);
+    if (slot->sequence.load(std::memory_order_acquire) != 2 * next_frame_index + 2) {
+        return absl::DataLossError(absl::StrCat(
+            "Slot of frame ", next_frame_index, " in shared-memory frame ring ", name,
+            " was overwritten, was the producer restarted?"
+        ));
+    }
+    // Copy the pixels out, since the graph (or a video sink) may hold on to the frame after the slot is handed back.
+    frame.image.create(static_cast<int>(header->height), static_cast<int>(header->width), CV_8UC3);
+    std::memcpy(frame.image.data, GetSlotPixels(slot), frame.image.total() * frame.image.elemSize());
+    frame.timestamp_us = slot->timestamp_us;
+    next_frame_index++;
+    // hand the slot back to the producer right away
+    header->read_index.store(next_frame_index, std::memory_order_release);
+    return true;
+}
+
+uint64_t SharedMemoryFrameSource::GetDroppedFrameCount() const {
+    return header == nullptr ? 0 : header->dropped_frame_count.load(std::memory_order_relaxed);
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,129 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// third-party includes
+#include <opencv2/core/mat.hpp>
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/status/statusor.h>
+
+// local includes
+#include "common/frame_source.hpp"
+#include "common/raw_frame_file.hpp"
+
+namespace presage::smartspectra::examples {
+
+// Shared-memory frame ring layout (see docs/shared_memory_frame_format.md): a header, followed by `slot_count` slots
+// of `slot_stride` bytes each, every one holding a slot header and the pixels of one frame.
+constexpr char kSharedFrameRingMagic[8] = {'S', 'S', 'S', 'H', 'M', 'F', 'R', '\0'};
+constexpr uint32_t kSharedFrameRingVersion = 1;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "Shared-memory frame rings need lock-free 32- and 64-bit atomics.");
+
+enum class SharedFrameRingState : uint32_t {
+    Initializing = 0,
+    Ready = 1,
+    // the producer is done, no frames will be written past the ones already published
+    Closed = 2
+};
+
+struct SharedFrameRingHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    RawPixelFormat pixel_format;
+    uint32_t slot_count;
+    uint32_t reserved;
+    uint64_t slot_stride;
+    // offset of the first slot, from the beginning of the segment
+    uint64_t slots_offset;
+
+    alignas(64) std::atomic<SharedFrameRingState> state;
+
+    // producer-owned: number of frames published so far; frame n lives in slot n % slot_count
+    alignas(64) std::atomic<uint64_t> write_index;
+    // bumped with every published frame (and on close), for the consumer to futex-wait on
+    std::atomic<uint32_t> publish_counter;
+    std::atomic<uint32_t> consumer_waiting;
+    // frames the producer skipped because the ring was full
+    std::atomic<uint64_t> dropped_frame_count;
+
+    // consumer-owned: number of frames the consumer is done with; the producer never overwrites the slots of frames
+    // at or past this index
+    alignas(64) std::atomic<uint64_t> read_index;
+};
+static_assert(sizeof(SharedFrameRingHeader) == 256);
+
+struct SharedFrameSlotHeader {
+    // seqlock-style: odd while frame n is being written (2n + 1), 2n + 2 once it is complete
+    std::atomic<uint64_t> sequence;
+    int64_t timestamp_us;
+};
+
+// Producer side: creates the shared-memory segment (replacing any stale one by the same name) and publishes frames
+// into it. Publish() never blocks: when the consumer still holds every slot, the frame is dropped (and counted).
+class SharedMemoryFrameRingWriter {
+public:
+    SharedMemoryFrameRingWriter() = default;
+    ~SharedMemoryFrameRingWriter();
+
+    SharedMemoryFrameRingWriter(const SharedMemoryFrameRingWriter&) = delete;
+    SharedMemoryFrameRingWriter& operator=(const SharedMemoryFrameRingWriter&) = delete;
+
+    // `name` is a POSIX shared-memory object name, e.g. "/smartspectra_frames".
+    absl::Status Open(const std::string& name, int width, int height, int slot_count = 4);
+    // Returns false if the frame was dropped because the ring is full.
+    absl::StatusOr<bool> Publish(const cv::Mat& frame_bgr, int64_t timestamp_us);
+    // Waits up to `timeout_ms` for a slot to free up. Returns false if it did not.
+    bool WaitForFreeSlot(int timeout_ms) const;
+    // Marks the end of the stream, and removes the segment name (the consumer keeps its mapping).
+    absl::Status Close();
+
+    uint64_t GetDroppedFrameCount() const;
+
+private:
+    std::string name;
+    SharedFrameRingHeader* header = nullptr;
+    size_t segment_size = 0;
+    size_t frame_size = 0;
+};
+
+// Consumer side: maps the segment the producer created (waiting for it to show up) and hands out each published frame
+// as a cv::Mat of its own, copied out of the segment (one memcpy, no decoding), so that frames stay valid however long
+// they are held on to. Each slot is handed back to the producer as soon as its frame is copied out.
+class SharedMemoryFrameSource : public FrameSource {
+public:
+    SharedMemoryFrameSource(std::string name, int poll_delay_ms);
+    ~SharedMemoryFrameSource() override;
+
+    SharedMemoryFrameSource(const SharedMemoryFrameSource&) = delete;
+    SharedMemoryFrameSource& operator=(const SharedMemoryFrameSource&) = delete;
+
+    // Waits for the segment to appear and for the producer to finish setting it up.
+    absl::Status Initialize() override;
+    absl::StatusOr<bool> Next(TimestampedFrame& frame) override;
+
+    uint64_t GetDroppedFrameCount() const;
+
+private:
+    // Waits until frame `frame_index` is published. Returns false if the producer closed the ring before that.
+    bool WaitForFrame(uint64_t frame_index);
+
+    std::string name;
+    int poll_delay_ms;
+    SharedFrameRingHeader* header = nullptr;
+    size_t segment_size = 0;
+    uint64_t next_frame_index = 0;
+};
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,580 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <system_error>
+
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+// third-party includes
+#include <physiology/interface/absl/strings/ascii.h>
+#include <physiology/interface/absl/strings/match.h>
+#include <physiology/interface/absl/strings/numbers.h>
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/glog/logging.h>
+#include <physiology/interface/nlohmann/json.hpp>
+
+// local includes
+#include "common/spot_uploader.hpp"
+#include "common/status_macros.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+constexpr const char* kHttpScheme = "http://";
+constexpr const char* kFailedSubdirectory = "failed";
+constexpr const char* kPayloadExtension = ".json";
+// nothing the Physiology REST API answers with comes anywhere close
+constexpr size_t kMaxResponseSize = 64 * 1024 * 1024;
+// how much of a rejected request's response body makes it into the log
+constexpr size_t kMaxLoggedBodySize = 200;
+
+using Clock = std::chrono::steady_clock;
+
+class SocketDescriptor {
+public:
+    explicit SocketDescriptor(int descriptor) : descriptor(descriptor) {}
+    ~SocketDescriptor() {
+        if (descriptor >= 0) {
+            close(descriptor);
+        }
+    }
+
+    SocketDescriptor(const SocketDescriptor&) = delete;
+    SocketDescriptor& operator=(const SocketDescriptor&) = delete;
+
+    int Get() const { return descriptor; }
+
+private:
+    int descriptor;
+};
+
+int GetRemainingMs(Clock::time_point deadline) {
+    return static_cast<int>(std::max<int64_t>(
+        0, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count()
+    ));
+}
+
+absl::StatusOr<int> Connect(const HttpUrl& url, Clock::time_point deadline) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    const int lookup_result = getaddrinfo(url.host.c_str(), std::to_string(url.port).c_str(), &hints, &addresses);
+    if (lookup_result != 0) {
+        return absl::UnavailableError(absl::StrCat("Could not resolve ", url.host, ": ", gai_strerror(lookup_result)));
+    }
+    std::string error = "no address";
+    int connected_descriptor = -1;
+    for (addrinfo* address = addresses; address != nullptr && connected_descriptor < 0; address = address->ai_next) {
+        const int descriptor = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+        if (descriptor < 0) {
+            error = std::strerror(errno);
+            continue;
+        }
+        // a blocking connect() gives up after the send timeout
+        const int remaining_ms = std::max(1, GetRemainingMs(deadline));
+        timeval timeout{remaining_ms / 1000, (remaining_ms % 1000) * 1000};
+        setsockopt(descriptor, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        if (connect(descriptor, address->ai_addr, address->ai_addrlen) == 0) {
+            connected_descriptor = descriptor;
+        } else {
+            error = std::strerror(errno);
+            close(descriptor);
+        }
+    }
+    freeaddrinfo(addresses);
+    if (connected_descriptor < 0) {
+        return absl::UnavailableError(absl::StrCat("Could not connect to ", url.host, ":", url.port, ": ", error));
+    }
+    return connected_descriptor;
+}
+
+absl::Status SendAll(int descriptor, const std::string& data) {
+    size_t sent_size = 0;
+    while (sent_size < data.size()) {
+        const ssize_t result = send(descriptor, data.data() + sent_size, data.size() - sent_size, MSG_NOSIGNAL);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return absl::UnavailableError(absl::StrCat("Could not send the request: ", std::strerror(errno)));
+        }
+        sent_size += static_cast<size_t>(result);
+    }
+    return absl::OkStatus();
+}
+
+// Decodes a "Transfer-Encoding: chunked" body (trailers, if any, are ignored). Returns false if it is incomplete.
+bool DecodeChunkedBody(const std::string& encoded, std::string& decoded) {
+    decoded.clear();
+    size_t position = 0;
+    while (true) {
+        const size_t line_end = encoded.find("\r\n", position);
+        if (line_end == std::string::npos) {
+            return false;
+        }
+        const std::string size_text = encoded.substr(position, encoded.find_first_of(";\r", position) - position);
+        uint64_t chunk_size;
+        if (!absl::SimpleHexAtoi(size_text, &chunk_size)) {
+            return false;
+        }
+        position = line_end + 2;
+        if (chunk_size == 0) {
+            return true;
+        }
+        if (encoded.size() < position + chunk_size) {
+            return false;
+        }
+        decoded.append(encoded, position, chunk_size);
+        position += chunk_size + 2;
+    }
+}
+
+struct ResponseHead {
+    int status_code = 0;
+    // -1: not given
+    int64_t content_length = -1;
+    bool chunked = false;
+    size_t body_offset = 0;
+};
+
+// Parses the status line and headers, once all of them came in.
+absl::StatusOr<ResponseHead> ParseResponseHead(const std::string& response, size_t head_end) {
+    ResponseHead head;
+    head.body_offset = head_end + 4;
+    std::istringstream lines(response.substr(0, head_end));
+    std::string line;
+    std::getline(lines, line);
+    // "HTTP/1.1 200 OK"
+    const size_t code_start = line.find(' ');
+    if (!absl::StartsWith(line, "HTTP/") || code_start == std::string::npos ||
+        !absl::SimpleAtoi(line.substr(code_start + 1, 3), &head.status_code)) {
+        return absl::DataLossError("Malformed HTTP response status line: " + line);
+    }
+    while (std::getline(lines, line)) {
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        const std::string name = absl::AsciiStrToLower(line.substr(0, colon));
+        const std::string value = std::string(absl::StripAsciiWhitespace(line.substr(colon + 1)));
+        if (name == "content-length") {
+            absl::SimpleAtoi(value, &head.content_length);
+        } else if (name == "transfer-encoding") {
+            head.chunked = absl::StrContains(absl::AsciiStrToLower(value), "chunked");
+        }
+    }
+    return head;
+}
+
+// Uploaded payloads sort (by name) in the order they were spooled.
+std::string GetSpooledPayloadName(uint64_t sequence_number) {
+    const auto epoch_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+    std::stringstream name;
+    name << std::setw(16) << std::setfill('0') << epoch_us << "_" << std::setw(6) << std::setfill('0')
+         << sequence_number << kPayloadExtension;
+    return name.str();
+}
+
+// rename() when possible; copy and remove when the payload is on another file system
+absl::Status MoveFile(const std::filesystem::path& from, const std::filesystem::path& to) {
+    std::error_code error;
+    std::filesystem::rename(from, to, error);
+    if (!error) {
+        return absl::OkStatus();
+    }
+    std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing, error);
+    if (error) {
+        return absl::InternalError(absl::StrCat(
+            "Could not move ", from.string(), " to ", to.string(), ": ", error.message()
+        ));
+    }
+    std::filesystem::remove(from, error);
+    return absl::OkStatus();
+}
+} // anonymous namespace
+
+// region ========================================== HTTP ==============================================================
+absl::StatusOr<HttpUrl> ParseHttpUrl(const std::string& url) {
+    if (!absl::StartsWith(url, kHttpScheme)) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Only plain HTTP (http://...) upload URLs are supported, got ", url,
+            ". Put a TLS-terminating proxy in front of HTTPS endpoints."
+        ));
+    }
+    HttpUrl parsed;
+    const std::string rest = url.substr(std::strlen(kHttpScheme));
+    const size_t path_start = rest.find('/');
+    std::string authority = rest.substr(0, path_start);
+    if (path_start != std::string::npos) {
+        parsed.path = rest.substr(path_start);
+    }
+    const size_t colon = authority.rfind(':');
+    if (colon != std::string::npos) {
+        int port;
+        if (!absl::SimpleAtoi(authority.substr(colon + 1), &port) || port <= 0 || port > 65535) {
+            return absl::InvalidArgumentError("Invalid port in URL " + url);
+        }
+        parsed.port = static_cast<uint16_t>(port);
+        authority = authority.substr(0, colon);
+    }
+    if (authority.empty()) {
+        return absl::InvalidArgumentError("No host in URL " + url);
+    }
+    parsed.host = authority;
+    return parsed;
+}
+
+absl::StatusOr<HttpResponse> PostJson(
+    const HttpUrl& url,
+    const std::string& body,
+    const std::vector<std::pair<std::string, std::string>>& headers,
+    int timeout_ms
+) {
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    auto descriptor_or_status = Connect(url, deadline);
+    if (!descriptor_or_status.ok()) {
+        return descriptor_or_status.status();
+    }
+    SocketDescriptor descriptor(descriptor_or_status.value());
+
+    std::string request = absl::StrCat(
+        "POST ", url.path, " HTTP/1.1\r\nHost: ", url.host, ":", url.port,
+        "\r\nContent-Type: application/json\r\nContent-Length: ", body.size(), "\r\nConnection: close\r\n"
+    );
+    for (const auto& [name, value]: headers) {
+        absl::StrAppend(&request, name, ": ", value, "\r\n");
+    }
+    absl::StrAppend(&request, "\r\n");
+    MP_RETURN_IF_ERROR(SendAll(descriptor.Get(), request));
+    MP_RETURN_IF_ERROR(SendAll(descriptor.Get(), body));
+
+    std::string response;
+    ResponseHead head;
+    bool head_parsed = false;
+    char buffer[64 * 1024];
+    while (true) {
+        const int remaining_ms = GetRemainingMs(deadline);
+        pollfd readable{descriptor.Get(), POLLIN, 0};
+        const int poll_result = remaining_ms > 0 ? poll(&readable, 1, remaining_ms) : 0;
+        if (poll_result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (poll_result <= 0) {
+            return absl::DeadlineExceededError(absl::StrCat(
+                "No complete response from ", url.host, ":", url.port, " within ", timeout_ms, " ms."
+            ));
+        }
+        const ssize_t size = recv(descriptor.Get(), buffer, sizeof(buffer), 0);
+        if (size < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return absl::UnavailableError(absl::StrCat("Could not read the response: ", std::strerror(errno)));
+        }
+        if (size == 0) {
+            break;
+        }
+        response.append(buffer, static_cast<size_t>(size));
+        if (response.size() > kMaxResponseSize) {
+            return absl::ResourceExhaustedError("Response is too large.");
+        }
+        if (!head_parsed) {
+            const size_t head_end = response.find("\r\n\r\n");
+            if (head_end == std::string::npos) {
+                continue;
+            }
+            auto head_or_status = ParseResponseHead(response, head_end);
+            if (!head_or_status.ok()) {
+                return head_or_status.status();
+            }
+            head = head_or_status.value();
+            head_parsed = true;
+        }
+        // servers may keep the connection open despite "Connection: close"
+        if (!head.chunked && head.content_length >= 0 &&
+            response.size() >= head.body_offset + static_cast<size_t>(head.content_length)) {
+            break;
+        }
+    }
+    if (!head_parsed) {
+        const size_t head_end = response.find("\r\n\r\n");
+        if (head_end == std::string::npos) {
+            return absl::UnavailableError(absl::StrCat(
+                "Connection to ", url.host, ":", url.port, " closed before a response came back."
+            ));
+        }
+        auto head_or_status = ParseResponseHead(response, head_end);
+        if (!head_or_status.ok()) {
+            return head_or_status.status();
+        }
+        head = head_or_status.value();
+    }
+    HttpResponse parsed;
+    parsed.status_code = head.status_code;
+    if (head.chunked) {
+        if (!DecodeChunkedBody(response.substr(head.body_offset), parsed.body)) {
+            return absl::UnavailableError("Connection closed in the middle of a chunked response.");
+        }
+    } else {
+        parsed.body = response.substr(head.body_offset);
+        if (head.content_length >= 0) {
+            if (parsed.body.size() < static_cast<size_t>(head.content_length)) {
+                return absl::UnavailableError("Connection closed in the middle of the response body.");
+            }
+            parsed.body.resize(static_cast<size_t>(head.content_length));
+        }
+    }
+    return parsed;
+}
+// endregion ===========================================================================================================
+
+// region ====================================== SpotUploader ==========================================================
+absl::StatusOr<std::unique_ptr<SpotUploader>> SpotUploader::Start(
+    SpotUploaderSettings settings,
+    ResponseCallback on_response
+) {
+    auto url_or_status = ParseHttpUrl(settings.upload_url);
+    if (!url_or_status.ok()) {
+        return url_or_status.status();
+    }
+    std::error_code error;
+    std::filesystem::create_directories(settings.spool_directory / kFailedSubdirectory, error);
+    if (error) {
+        return absl::InternalError(absl::StrCat(
+            "Could not create the upload spool directory ", settings.spool_directory.string(), ": ", error.message()
+        ));
+    }
+    std::unique_ptr<SpotUploader> uploader(
+        new SpotUploader(std::move(settings), url_or_status.value(), std::move(on_response))
+    );
+    std::vector<std::filesystem::path> spooled_payloads;
+    for (const auto& entry: std::filesystem::directory_iterator(uploader->settings.spool_directory)) {
+        if (entry.is_regular_file() && entry.path().extension() == kPayloadExtension) {
+            spooled_payloads.push_back(entry.path());
+        }
+    }
+    std::sort(spooled_payloads.begin(), spooled_payloads.end());
+    if (!spooled_payloads.empty()) {
+        LOG(INFO) << "Resuming the upload of " << spooled_payloads.size() << " payload(s) spooled in "
+                  << uploader->settings.spool_directory.string() << ".";
+    }
+    uploader->pending_payloads.assign(spooled_payloads.begin(), spooled_payloads.end());
+    if (uploader->pipeline_pending_gauge != nullptr) {
+        *uploader->pipeline_pending_gauge = static_cast<int64_t>(spooled_payloads.size());
+    }
+    uploader->uploader = std::thread(&SpotUploader::Upload, uploader.get());
+    return uploader;
+}
+
+SpotUploader::SpotUploader(SpotUploaderSettings settings, HttpUrl url, ResponseCallback on_response)
+    : settings(std::move(settings)), url(std::move(url)), on_response(std::move(on_response)) {
+    if (this->settings.pipeline_metrics != nullptr) {
+        PipelineMetrics& metrics = *this->settings.pipeline_metrics;
+        pipeline_upload_histogram = &metrics.GetHistogram(
+            "spot_upload", "Time to upload a spot measurement payload and get the response back, per attempt."
+        );
+        pipeline_uploaded_counter = &metrics.GetCounter("spot_uploads_total", "Spot measurement payloads uploaded.");
+        pipeline_failed_counter = &metrics.GetCounter(
+            "spot_uploads_failed_total", "Spot measurement payloads given up on (and set aside in the spool)."
+        );
+        pipeline_retry_counter = &metrics.GetCounter("spot_upload_retries_total", "Spot upload attempts retried.");
+        pipeline_pending_gauge = &metrics.GetGauge(
+            "spot_uploads_pending", "Spot measurement payloads not uploaded yet."
+        );
+    }
+}
+
+SpotUploader::~SpotUploader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop_requested = true;
+    }
+    wake.notify_all();
+    uploader.join();
+    const size_t pending_count = GetPendingCount();
+    if (pending_count > 0) {
+        LOG(WARNING) << pending_count << " payload(s) not uploaded yet stay spooled in "
+                     << settings.spool_directory.string() << ", to be uploaded on the next run.";
+    }
+}
+
+absl::Status SpotUploader::Enqueue(const std::filesystem::path& payload_path) {
+    std::filesystem::path spooled_path;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        spooled_path = settings.spool_directory / GetSpooledPayloadName(spooled_payload_count++);
+    }
+    MP_RETURN_IF_ERROR(MoveFile(payload_path, spooled_path));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending_payloads.push_back(spooled_path);
+        if (pipeline_pending_gauge != nullptr) {
+            *pipeline_pending_gauge = static_cast<int64_t>(pending_payloads.size());
+        }
+    }
+    wake.notify_one();
+    VLOG(1) << "Spooled " << payload_path.string() << " for upload as " << spooled_path.string();
+    return absl::OkStatus();
+}
+
+bool SpotUploader::WaitUntilIdle(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return idle.wait_for(lock, timeout, [this] { return pending_payloads.empty(); });
+}
+
+size_t SpotUploader::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending_payloads.size();
+}
+
+std::string SpotUploader::Summarize() const {
+    return absl::StrCat(
+        uploaded_count.load(), " uploaded, ", failed_count.load(), " failed, ", GetPendingCount(), " pending, ",
+        retry_count.load(), " retries; upload ", upload_histogram.Summarize()
+    );
+}
+
+void SpotUploader::Upload() {
+    std::minstd_rand random_engine(std::random_device{}());
+    std::uniform_real_distribution<double> jitter(1.0, 1.25);
+    int backoff_ms = settings.initial_backoff_ms;
+    int attempt_count = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stop_requested || !pending_payloads.empty(); });
+        if (stop_requested) {
+            break;
+        }
+        const std::filesystem::path payload_path = pending_payloads.front();
+        lock.unlock();
+
+        attempt_count++;
+        AttemptResult result = Attempt(payload_path);
+        if (result == AttemptResult::Retry && settings.max_attempts > 0 && attempt_count >= settings.max_attempts) {
+            LOG(ERROR) << "Giving up on uploading " << payload_path.filename().string() << " after " << attempt_count
+                       << " attempts.";
+            result = AttemptResult::GiveUp;
+        }
+        if (result == AttemptResult::GiveUp) {
+            SetAside(payload_path);
+        }
+
+        lock.lock();
+        if (result == AttemptResult::Retry) {
+            retry_count++;
+            if (pipeline_retry_counter != nullptr) {
+                (*pipeline_retry_counter)++;
+            }
+            // jitter keeps several clients that lost the service at the same time from coming back all at once
+            const auto wait = std::chrono::milliseconds(static_cast<int64_t>(backoff_ms * jitter(random_engine)));
+            LOG(WARNING) << "Retrying the upload of " << payload_path.filename().string() << " in " << wait.count()
+                         << " ms (attempt " << attempt_count + 1 << ").";
+            wake.wait_for(lock, wait, [this] { return stop_requested; });
+            backoff_ms = std::min(backoff_ms * 2, settings.max_backoff_ms);
+            continue;
+        }
+        pending_payloads.pop_front();
+        attempt_count = 0;
+        backoff_ms = settings.initial_backoff_ms;
+        Finish(result == AttemptResult::Uploaded);
+    }
+}
+
+SpotUploader::AttemptResult SpotUploader::Attempt(const std::filesystem::path& payload_path) {
+    std::ifstream payload_file(payload_path, std::ios::binary);
+    if (!payload_file.is_open()) {
+        LOG(ERROR) << "Could not read spooled payload " << payload_path.string();
+        return AttemptResult::GiveUp;
+    }
+    const std::string payload((std::istreambuf_iterator<char>(payload_file)), std::istreambuf_iterator<char>());
+    payload_file.close();
+    std::vector<std::pair<std::string, std::string>> headers;
+    if (!settings.api_key.empty()) {
+        headers.emplace_back("x-api-key", settings.api_key);
+    }
+
+    const auto start = Clock::now();
+    auto response_or_status = PostJson(url, payload, headers, settings.request_timeout_ms);
+    const auto elapsed = Clock::now() - start;
+    upload_histogram.Record(elapsed);
+    if (pipeline_upload_histogram != nullptr) {
+        pipeline_upload_histogram->Record(elapsed);
+    }
+    const std::string payload_name = payload_path.filename().string();
+    if (!response_or_status.ok()) {
+        LOG(WARNING) << "Could not upload " << payload_name << ": " << response_or_status.status().message();
+        return AttemptResult::Retry;
+    }
+    const HttpResponse& response = response_or_status.value();
+    if (response.status_code == 408 || response.status_code == 429 || response.status_code >= 500) {
+        LOG(WARNING) << "Upload of " << payload_name << " answered with HTTP " << response.status_code << ".";
+        return AttemptResult::Retry;
+    }
+    if (response.status_code < 200 || response.status_code >= 300) {
+        LOG(ERROR) << "Upload of " << payload_name << " rejected with HTTP " << response.status_code << ": "
+                   << response.body.substr(0, kMaxLoggedBodySize);
+        return AttemptResult::GiveUp;
+    }
+    // only validated here (without building a DOM), the callback parses the body as it sees fit
+    if (!nlohmann::json::accept(response.body)) {
+        LOG(ERROR) << "Response to the upload of " << payload_name << " is not JSON: "
+                   << response.body.substr(0, kMaxLoggedBodySize);
+        return AttemptResult::GiveUp;
+    }
+    VLOG(1) << "Uploaded " << payload_name << " in "
+            << std::chrono::duration<double, std::milli>(elapsed).count() << " ms.";
+    if (on_response) {
+        absl::Status status = on_response(payload_path, response.body);
+        if (!status.ok()) {
+            LOG(ERROR) << "Could not handle the response to the upload of " << payload_name << ": "
+                       << status.message();
+        }
+    }
+    std::error_code error;
+    std::filesystem::remove(payload_path, error);
+    return AttemptResult::Uploaded;
+}
+
+void SpotUploader::SetAside(const std::filesystem::path& payload_path) {
+    const std::filesystem::path failed_path =
+        settings.spool_directory / kFailedSubdirectory / payload_path.filename();
+    absl::Status status = MoveFile(payload_path, failed_path);
+    if (status.ok()) {
+        LOG(ERROR) << "Set " << payload_path.filename().string() << " aside as " << failed_path.string() << ".";
+    } else {
+        LOG(ERROR) << status.message();
+    }
+}
+
+void SpotUploader::Finish(bool uploaded) {
+    (uploaded ? uploaded_count : failed_count)++;
+    std::atomic<int64_t>* counter = uploaded ? pipeline_uploaded_counter : pipeline_failed_counter;
+    if (counter != nullptr) {
+        (*counter)++;
+    }
+    if (pipeline_pending_gauge != nullptr) {
+        *pipeline_pending_gauge = static_cast<int64_t>(pending_payloads.size());
+    }
+    if (pending_payloads.empty()) {
+        idle.notify_all();
+    }
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// third-party includes
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/status/statusor.h>
+
+// local includes
+#include "common/latency_histogram.hpp"
+#include "common/pipeline_metrics.hpp"
+
+namespace presage::smartspectra::examples {
+
+// An http:// URL, split into what it takes to connect and send a request.
+struct HttpUrl {
+    std::string host;
+    uint16_t port = 80;
+    // including the query, if any
+    std::string path = "/";
+};
+
+// Parses "http://<host>[:<port>][/<path>]". Only plain HTTP is supported.
+absl::StatusOr<HttpUrl> ParseHttpUrl(const std::string& url);
+
+struct HttpResponse {
+    int status_code = 0;
+    std::string body;
+};
+
+// POSTs `body` as JSON over a connection of its own (HTTP/1.1, "Connection: close"). Errors only stand for the request
+// not getting through or the response not coming back within `timeout_ms` (as a whole); any HTTP status is a response.
+absl::StatusOr<HttpResponse> PostJson(
+    const HttpUrl& url,
+    const std::string& body,
+    const std::vector<std::pair<std::string, std::string>>& headers,
+    int timeout_ms
+);
+
+struct SpotUploaderSettings {
+    std::string upload_url;
+    // sent in the "x-api-key" header, when not empty
+    std::string api_key;
+    // Payloads wait here until they are uploaded, so that none are lost while the service is unreachable or the
+    // application is restarted. Payloads given up on are moved to its "failed" subdirectory.
+    std::filesystem::path spool_directory;
+    int request_timeout_ms = 30000;
+    // Wait before retrying after a failed attempt, doubled after every further failure up to `max_backoff_ms`.
+    int initial_backoff_ms = 500;
+    int max_backoff_ms = 30000;
+    // Attempts per payload before it is given up on. 0: keep trying.
+    int max_attempts = 0;
+    // When set, upload latencies, outcomes and the number of pending payloads are recorded there as well.
+    PipelineMetrics* pipeline_metrics = nullptr;
+};
+
+// Uploads spot measurement payloads (preprocessed data, as JSON files) in the background, in the order they were
+// enqueued, handing each response to a callback. Every payload is spooled to disk first; failed attempts (the service
+// being unreachable, timing out, or answering 408, 429 or 5xx) are retried with exponential backoff, holding up the
+// payloads behind it. Payloads spooled by an earlier run are picked up on start.
+class SpotUploader {
+public:
+    // Called on the upload thread with the spooled payload and the response body (checked to be valid JSON, but left
+    // for the callback to parse), for each payload that was uploaded successfully. An error is logged, but does not
+    // make the upload count as failed.
+    using ResponseCallback = std::function<
+        absl::Status(const std::filesystem::path& payload_path, std::string_view response_body)
+    >;
+
+    static absl::StatusOr<std::unique_ptr<SpotUploader>> Start(
+        SpotUploaderSettings settings,
+        ResponseCallback on_response
+    );
+    // Stops after the attempt in progress, if any. Payloads not uploaded yet stay spooled.
+    ~SpotUploader();
+
+    SpotUploader(const SpotUploader&) = delete;
+    SpotUploader& operator=(const SpotUploader&) = delete;
+
+    // Moves the payload file into the spool and queues it for upload. Returns without waiting for the upload.
+    absl::Status Enqueue(const std::filesystem::path& payload_path);
+    // Waits for all queued payloads to be uploaded or given up on. Returns false if some are still pending after
+    // `timeout`.
+    bool WaitUntilIdle(std::chrono::milliseconds timeout);
+    size_t GetPendingCount() const;
+
+    // e.g. "12 uploaded, 0 failed, 1 pending, 3 retries; upload count=12 mean=...us ..."
+    std::string Summarize() const;
+
+private:
+    enum class AttemptResult {
+        Uploaded,
+        Retry,
+        GiveUp
+    };
+
+    SpotUploader(SpotUploaderSettings settings, HttpUrl url, ResponseCallback on_response);
+
+    void Upload();
+    AttemptResult Attempt(const std::filesystem::path& payload_path);
+    void SetAside(const std::filesystem::path& payload_path);
+    // called with `mutex` held
+    void Finish(bool uploaded);
+
+    const SpotUploaderSettings settings;
+    const HttpUrl url;
+    ResponseCallback on_response;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    // the one at the front is being uploaded
+    std::deque<std::filesystem::path> pending_payloads;
+    bool stop_requested = false;
+    uint64_t spooled_payload_count = 0;
+
+    std::atomic<uint64_t> uploaded_count{0};
+    std::atomic<uint64_t> failed_count{0};
+    std::atomic<uint64_t> retry_count{0};
+    LatencyHistogram upload_histogram;
+    // from settings.pipeline_metrics, if set
+    LatencyHistogram* pipeline_upload_histogram = nullptr;
+    std::atomic<int64_t>* pipeline_uploaded_counter = nullptr;
+    std::atomic<int64_t>* pipeline_failed_counter = nullptr;
+    std::atomic<int64_t>* pipeline_retry_counter = nullptr;
+    std::atomic<int64_t>* pipeline_pending_gauge = nullptr;
+
+    std::thread uploader;
+};
+
+} // namespace presage::smartspectra::examples
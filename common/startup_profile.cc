@@ -0,0 +1,180 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+// third-party includes
+#include <unistd.h>
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/absl/strings/str_format.h>
+#include <physiology/interface/glog/logging.h>
+#include <physiology/interface/nlohmann/json.hpp>
+
+// local includes
+#include "common/startup_profile.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+using Clock = StartupProfile::Clock;
+
+// when this library was loaded, in case the process start time cannot be told
+const Clock::time_point kLoadTime = Clock::now();
+
+// How long ago the process started, from its start time in /proc/self/stat (in clock ticks since boot), or a negative
+// duration when that is not available.
+std::chrono::duration<double> GetProcessAge() {
+    std::ifstream stat_file("/proc/self/stat");
+    std::string stat;
+    std::getline(stat_file, stat);
+    // the command name (2nd field) may hold spaces, the fields after it do not
+    const size_t command_end = stat.rfind(')');
+    if (command_end == std::string::npos) {
+        return std::chrono::duration<double>(-1.0);
+    }
+    std::istringstream fields(stat.substr(command_end + 1));
+    std::string field;
+    // the start time is the 22nd field, the 20th after the command name
+    for (int i_field = 0; i_field < 20 && fields >> field; i_field++) {}
+    const long ticks_per_second = sysconf(_SC_CLK_TCK);
+    timespec since_boot{};
+    if (fields.fail() || ticks_per_second <= 0 || clock_gettime(CLOCK_BOOTTIME, &since_boot) != 0) {
+        return std::chrono::duration<double>(-1.0);
+    }
+    const double start_s = std::stod(field) / static_cast<double>(ticks_per_second);
+    const double now_s = static_cast<double>(since_boot.tv_sec) + static_cast<double>(since_boot.tv_nsec) * 1e-9;
+    return std::chrono::duration<double>(now_s - start_s);
+}
+
+Clock::time_point GetProcessStartTime() {
+    const Clock::time_point now = Clock::now();
+    const std::chrono::duration<double> age = GetProcessAge();
+    if (age.count() < 0.0) {
+        return kLoadTime;
+    }
+    // the start time is in whole clock ticks, so it may be up to a tick later than when this library was loaded
+    return std::min(kLoadTime, now - std::chrono::duration_cast<Clock::duration>(age));
+}
+} // anonymous namespace
+
+// region ===================================== StartupProfile =========================================================
+StartupProfile::StartupProfile() : process_start(GetProcessStartTime()) {}
+
+double StartupProfile::GetElapsedMs() const {
+    return std::chrono::duration<double, std::milli>(Clock::now() - process_start).count();
+}
+
+void StartupProfile::Mark(const std::string& milestone) {
+    const double elapsed_ms = GetElapsedMs();
+    std::lock_guard<std::mutex> lock(mutex);
+    milestones_ms.emplace(milestone, elapsed_ms);
+}
+
+void StartupProfile::Begin(const std::string& phase) {
+    const double elapsed_ms = GetElapsedMs();
+    std::lock_guard<std::mutex> lock(mutex);
+    phases.emplace(phase, Phase{elapsed_ms});
+}
+
+void StartupProfile::End(const std::string& phase) {
+    const double elapsed_ms = GetElapsedMs();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = phases.find(phase);
+    // only the first time a phase runs counts
+    if (found != phases.end() && found->second.duration_ms < 0.0) {
+        found->second.duration_ms = elapsed_ms - found->second.start_ms;
+    }
+}
+
+std::string StartupProfile::ToJson() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    nlohmann::json profile = {{"milestones_ms", nlohmann::json::object()}, {"phases", nlohmann::json::object()}};
+    for (const auto& [milestone, time_ms]: milestones_ms) {
+        profile["milestones_ms"][milestone] = time_ms;
+    }
+    for (const auto& [name, phase]: phases) {
+        profile["phases"][name] = {{"start_ms", phase.start_ms}, {"duration_ms", phase.duration_ms}};
+    }
+    return profile.dump();
+}
+
+std::string StartupProfile::Summarize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::pair<double, std::string>> milestones;
+    for (const auto& [milestone, time_ms]: milestones_ms) {
+        milestones.emplace_back(time_ms, milestone);
+    }
+    std::sort(milestones.begin(), milestones.end());
+    std::string summary;
+    double previous_time_ms = 0.0;
+    for (const auto& [time_ms, milestone]: milestones) {
+        absl::StrAppend(
+            &summary, summary.empty() ? "" : ", ", milestone,
+            absl::StrFormat(summary.empty() ? " %.1f ms" : " +%.1f ms", time_ms - previous_time_ms)
+        );
+        previous_time_ms = time_ms;
+    }
+    for (const auto& [name, phase]: phases) {
+        absl::StrAppend(
+            &summary, summary.empty() ? "" : "; ", name,
+            phase.duration_ms < 0.0 ? absl::StrFormat(" from %.1f ms, not done", phase.start_ms)
+                                    : absl::StrFormat(" %.1f ms from %.1f ms", phase.duration_ms, phase.start_ms)
+        );
+    }
+    return summary;
+}
+// endregion ===========================================================================================================
+
+// region ================================= StartupProfiledVideoSource =================================================
+StartupProfiledVideoSource::StartupProfiledVideoSource(
+    std::unique_ptr<video_source::VideoSource> video_source,
+    StartupProfile& profile
+) : video_source(std::move(video_source)), profile(profile) {}
+
+absl::Status StartupProfiledVideoSource::Initialize(const video_source::VideoSourceSettings& /*settings*/) {
+    // the wrapped source is initialized by the container before it gets wrapped
+    return absl::OkStatus();
+}
+
+bool StartupProfiledVideoSource::SupportsExactFrameTimestamp() const {
+    return video_source->SupportsExactFrameTimestamp();
+}
+
+int64_t StartupProfiledVideoSource::GetFrameTimestamp() const {
+    return video_source->GetFrameTimestamp();
+}
+
+int StartupProfiledVideoSource::GetWidth() {
+    return video_source->GetWidth();
+}
+
+int StartupProfiledVideoSource::GetHeight() {
+    return video_source->GetHeight();
+}
+
+video_source::VideoSource& StartupProfiledVideoSource::operator>>(cv::Mat& frame) {
+    if (read_count == 0) {
+        profile.Mark("first_frame_requested");
+    } else if (read_count == 1) {
+        profile.Mark("first_frame_processed");
+        LOG(INFO) << "Startup profile: " << profile.ToJson();
+        LOG(INFO) << "Startup: " << profile.Summarize();
+    }
+    *video_source >> frame;
+    if (read_count == 0 && !frame.empty()) {
+        profile.Mark("first_frame_read");
+    }
+    if (read_count < 2 && !frame.empty()) {
+        read_count++;
+    }
+    return *this;
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
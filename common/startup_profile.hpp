@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+// third-party includes
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/glog/logging.h>
+#include <smartspectra/video_source/video_source.hpp>
+
+// local includes
+#include "common/status_macros.hpp"
+
+namespace presage::smartspectra::examples {
+
+// Times how an example gets from process start to its first processed frame, as milestones (points in time, e.g.
+// "flags_parsed") and phases (spans that may run alongside others, e.g. "video_source_initialization"), both relative
+// to when the process started. Can be updated from any thread.
+class StartupProfile {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Times are taken relative to when the process started: from its start time in /proc, which is only as precise as
+    // the kernel's clock ticks (usually 10 ms), or, where that is not available, from when the examples' code was
+    // first loaded.
+    StartupProfile();
+
+    void Mark(const std::string& milestone);
+    void Begin(const std::string& phase);
+    void End(const std::string& phase);
+
+    // e.g. {"milestones_ms":{"main":48.1,"flags_parsed":49.0,...},"phases":{"video_source_initialization":
+    // {"start_ms":52.3,"duration_ms":410.8}}}
+    std::string ToJson() const;
+    // Milestones in the order they were reached, each with the time since the previous one, then the phases, e.g.
+    // "main 48.1 ms, flags_parsed +0.9 ms, ...; video_source_initialization 410.8 ms from 52.3 ms"
+    std::string Summarize() const;
+
+private:
+    struct Phase {
+        double start_ms = 0.0;
+        double duration_ms = -1.0;
+    };
+
+    double GetElapsedMs() const;
+
+    const Clock::time_point process_start;
+    mutable std::mutex mutex;
+    // first time each milestone was reached
+    std::map<std::string, double> milestones_ms;
+    std::map<std::string, Phase> phases;
+};
+
+// Passes the frames of another video source through, reaching the "first_frame_requested", "first_frame_read" and
+// "first_frame_processed" (the container asking for the second frame) milestones along the way. The profile is logged
+// once the first frame is processed.
+class StartupProfiledVideoSource : public video_source::VideoSource {
+public:
+    StartupProfiledVideoSource(std::unique_ptr<video_source::VideoSource> video_source, StartupProfile& profile);
+
+    absl::Status Initialize(const video_source::VideoSourceSettings& settings) override;
+    bool SupportsExactFrameTimestamp() const override;
+    int64_t GetFrameTimestamp() const override;
+    int GetWidth() override;
+    int GetHeight() override;
+    video_source::VideoSource& operator>>(cv::Mat& frame) override;
+
+private:
+    std::unique_ptr<video_source::VideoSource> video_source;
+    StartupProfile& profile;
+    int read_count = 0;
+};
+
+// Foreground container that, with a StartupProfile, times the initialization of its video source (whichever the base
+// container sets up) and the first frames read from it. Independently of that, the video source can be initialized
+// early, see StartVideoSourceInitialization().
+template<typename TContainer>
+class StartupContainer : public TContainer {
+public:
+    template<typename... TArgs>
+    explicit StartupContainer(StartupProfile* startup_profile, TArgs&& ... args)
+        : TContainer(std::forward<TArgs>(args)...), startup_profile(startup_profile) {}
+
+    ~StartupContainer() {
+        if (early_initialization.joinable()) {
+            early_initialization.join();
+        }
+    }
+
+    // Starts initializing the video source (e.g. opening the camera and, with auto_lock, settling its exposure, or
+    // peeking at the first frame of a frame source) on a thread of its own, so that it runs alongside the graph setup
+    // in Initialize(). Initialize() then waits for it where it would have initialized the source itself. Call right
+    // before Initialize(); this relies on the base container setting up its video source only from its settings (the
+    // warm spot service re-initializes the sources of initialized containers the same way). Only the first call
+    // starts anything: the source is initialized once per container.
+    void StartVideoSourceInitialization() {
+        if (early_initialization_started) {
+            LOG(WARNING) << "The video source initialization was already started; not starting it again.";
+            return;
+        }
+        early_initialization_started = true;
+        early_initialization = std::thread([this]() { early_initialization_status = InitializeProfiledVideoSource(); });
+    }
+
+protected:
+    absl::Status InitializeVideoSource() override {
+        if (early_initialization.joinable()) {
+            early_initialization.join();
+            return early_initialization_status;
+        }
+        return InitializeProfiledVideoSource();
+    }
+
+private:
+    absl::Status InitializeProfiledVideoSource() {
+        if (startup_profile == nullptr) {
+            return TContainer::InitializeVideoSource();
+        }
+        startup_profile->Begin("video_source_initialization");
+        MP_RETURN_IF_ERROR(TContainer::InitializeVideoSource());
+        startup_profile->End("video_source_initialization");
+        this->video_source =
+            std::make_unique<StartupProfiledVideoSource>(std::move(this->video_source), *startup_profile);
+        return absl::OkStatus();
+    }
+
+    StartupProfile* startup_profile;
+    std::thread early_initialization;
+    bool early_initialization_started = false;
+    absl::Status early_initialization_status;
+};
+
+} // namespace presage::smartspectra::examples
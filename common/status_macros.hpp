@@ -0,0 +1,18 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// third-party includes
+#include <physiology/interface/absl/status/status.h>
+
+// MP_RETURN_IF_ERROR usually comes in with the SDK container headers. This keeps the parts of the common library
+// that don't otherwise need the SDK self-contained.
+#ifndef MP_RETURN_IF_ERROR
+#define MP_RETURN_IF_ERROR(expression)                   \
+    do {                                                 \
+        const absl::Status _status = (expression);       \
+        if (!_status.ok()) return _status;               \
+    } while (0)
+#endif
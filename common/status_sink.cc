@@ -0,0 +1,260 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// third-party includes
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/absl/strings/str_join.h>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/status_macros.hpp"
+#include "common/status_sink.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+// upper bound on how long a status change may sit in the queue if its wake-up notification gets lost
+constexpr auto kWriterIdleWakeUpPeriod = std::chrono::milliseconds(50);
+
+const std::vector<std::string> kStatusSinkTypeNames = {"marker_files", "ndjson", "unix_socket"};
+
+std::string ToNdjsonLine(const StatusEvent& event) {
+    return absl::StrCat("{\"epoch_us\":", event.epoch_us, ",\"status\":", event.status_code, "}\n");
+}
+} // anonymous namespace
+
+// region ====================================== StatusSinkType ========================================================
+std::vector<std::string> GetStatusSinkTypeNames() {
+    return kStatusSinkTypeNames;
+}
+
+bool AbslParseFlag(absl::string_view text, StatusSinkType* type, std::string* error) {
+    for (size_t i_type = 0; i_type < kStatusSinkTypeNames.size(); i_type++) {
+        if (text == kStatusSinkTypeNames[i_type]) {
+            *type = static_cast<StatusSinkType>(i_type);
+            return true;
+        }
+    }
+    *error = absl::StrCat("Unknown status sink type. Possible values: ", absl::StrJoin(kStatusSinkTypeNames, ", "));
+    return false;
+}
+
+std::string AbslUnparseFlag(StatusSinkType type) {
+    auto index = static_cast<size_t>(type);
+    return index < kStatusSinkTypeNames.size() ? kStatusSinkTypeNames[index] : "unknown";
+}
+// endregion ===========================================================================================================
+
+// region ====================================== Backends ==============================================================
+MarkerFileStatusSinkBackend::MarkerFileStatusSinkBackend(std::filesystem::path directory)
+    : directory(std::move(directory)) {}
+
+absl::Status MarkerFileStatusSinkBackend::Write(const std::vector<StatusEvent>& events) {
+    for (const auto& event: events) {
+        std::stringstream file_name;
+        file_name << std::setw(16) << std::setfill('0') << event.epoch_us << "_" << std::setw(2) << std::setfill('0')
+                  << event.status_code;
+        auto status_file_path = directory / file_name.str();
+        std::ofstream status_file(status_file_path);
+        if (status_file.fail() || !status_file.is_open()) {
+            return absl::InternalError("Could not write status file " + status_file_path.string());
+        }
+        status_file.close();
+        LOG(INFO) << "Wrote status file " << status_file_path.string();
+    }
+    return absl::OkStatus();
+}
+
+NdjsonStatusSinkBackend::NdjsonStatusSinkBackend(std::filesystem::path path)
+    : path(std::move(path)), file(this->path, std::ios::app) {}
+
+absl::StatusOr<std::unique_ptr<NdjsonStatusSinkBackend>> NdjsonStatusSinkBackend::Open(
+    const std::filesystem::path& path
+) {
+    std::unique_ptr<NdjsonStatusSinkBackend> backend(new NdjsonStatusSinkBackend(path));
+    if (!backend->file.is_open()) {
+        return absl::InternalError("Could not open status log " + path.string());
+    }
+    return backend;
+}
+
+absl::Status NdjsonStatusSinkBackend::Write(const std::vector<StatusEvent>& events) {
+    for (const auto& event: events) {
+        file << ToNdjsonLine(event);
+    }
+    file.flush();
+    if (file.fail()) {
+        return absl::InternalError("Could not append to status log " + path.string());
+    }
+    return absl::OkStatus();
+}
+
+UnixSocketStatusSinkBackend::UnixSocketStatusSinkBackend(std::string socket_path)
+    : socket_path(std::move(socket_path)) {}
+
+UnixSocketStatusSinkBackend::~UnixSocketStatusSinkBackend() {
+    Disconnect();
+}
+
+absl::Status UnixSocketStatusSinkBackend::Connect() {
+    sockaddr_un address{};
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        return absl::InvalidArgumentError("Status socket path is too long: " + socket_path);
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    socket_descriptor = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (socket_descriptor < 0) {
+        return absl::InternalError(absl::StrCat("Could not create status socket: ", std::strerror(errno)));
+    }
+    if (connect(socket_descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        Disconnect();
+        return absl::UnavailableError(absl::StrCat(
+            "Could not connect to status socket ", socket_path, ": ", std::strerror(errno)
+        ));
+    }
+    return absl::OkStatus();
+}
+
+void UnixSocketStatusSinkBackend::Disconnect() {
+    if (socket_descriptor >= 0) {
+        close(socket_descriptor);
+        socket_descriptor = -1;
+    }
+}
+
+absl::Status UnixSocketStatusSinkBackend::Write(const std::vector<StatusEvent>& events) {
+    std::string lines;
+    for (const auto& event: events) {
+        lines += ToNdjsonLine(event);
+    }
+    if (socket_descriptor < 0) {
+        absl::Status status = Connect();
+        if (!status.ok()) {
+            // a listener that is not (yet) there is not an error for the pipeline, the events are just lost
+            LOG(WARNING) << status.message() << ". Dropping " << events.size() << " status change(s).";
+            return absl::OkStatus();
+        }
+    }
+    size_t sent_size = 0;
+    while (sent_size < lines.size()) {
+        ssize_t result = send(socket_descriptor, lines.data() + sent_size, lines.size() - sent_size, MSG_NOSIGNAL);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG(WARNING) << "Status socket " << socket_path << " disconnected: " << std::strerror(errno);
+            Disconnect();
+            return absl::OkStatus();
+        }
+        sent_size += static_cast<size_t>(result);
+    }
+    return absl::OkStatus();
+}
+// endregion ===========================================================================================================
+
+// region ====================================== AsyncStatusSink =======================================================
+AsyncStatusSink::AsyncStatusSink(std::unique_ptr<StatusSinkBackend> backend, StatusSinkSettings settings)
+    : backend(std::move(backend)), settings(settings), queue(settings.queue_capacity) {
+    writer = std::thread(&AsyncStatusSink::WriteEvents, this);
+}
+
+AsyncStatusSink::~AsyncStatusSink() {
+    stop_requested = true;
+    wake.notify_one();
+    writer.join();
+}
+
+absl::Status AsyncStatusSink::Push(int status_code) {
+    if (backend_failed.load(std::memory_order_acquire)) {
+        return backend_status;
+    }
+    StatusEvent event{
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count()),
+        status_code
+    };
+    if (!queue.TryPush(std::move(event))) {
+        dropped_event_count++;
+    }
+    // Notifying without holding the mutex keeps this call from ever blocking on the writer thread.
+    // A wake-up lost this way only delays the write by up to kWriterIdleWakeUpPeriod.
+    wake.notify_one();
+    return absl::OkStatus();
+}
+
+uint64_t AsyncStatusSink::GetDroppedEventCount() const {
+    return dropped_event_count;
+}
+
+uint64_t AsyncStatusSink::GetCoalescedEventCount() const {
+    return coalesced_event_count;
+}
+
+void AsyncStatusSink::CollectEvents(std::vector<StatusEvent>& events) {
+    while (auto event = queue.TryPop()) {
+        events.push_back(event.value());
+    }
+}
+
+void AsyncStatusSink::WriteEvents() {
+    std::vector<StatusEvent> events;
+    std::vector<StatusEvent> events_to_write;
+    bool stopping = false;
+    while (!stopping) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            wake.wait_for(lock, kWriterIdleWakeUpPeriod);
+        }
+        stopping = stop_requested;
+        events.clear();
+        CollectEvents(events);
+        if (events.empty()) {
+            continue;
+        }
+        if (settings.coalesce_window_ms > 0 && !stopping) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(settings.coalesce_window_ms));
+            CollectEvents(events);
+            coalesced_event_count += events.size() - 1;
+            events.erase(events.begin(), events.end() - 1);
+        }
+
+        events_to_write.clear();
+        for (const auto& event: events) {
+            if (event.status_code == last_written_status_code) {
+                coalesced_event_count++;
+                continue;
+            }
+            events_to_write.push_back(event);
+            last_written_status_code = event.status_code;
+        }
+        if (events_to_write.empty() || backend_failed.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        absl::Status status = backend->Write(events_to_write);
+        if (!status.ok()) {
+            LOG(ERROR) << "Could not write status changes: " << status.message();
+            backend_status = status;
+            backend_failed.store(true, std::memory_order_release);
+        }
+    }
+    if (dropped_event_count > 0) {
+        LOG(WARNING) << "Dropped " << dropped_event_count << " status change(s) because the status queue was full.";
+    }
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,139 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// third-party includes
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/status/statusor.h>
+#include <physiology/interface/absl/strings/string_view.h>
+
+// local includes
+#include "common/lock_free_queue.hpp"
+
+namespace presage::smartspectra::examples {
+
+enum class StatusSinkType {
+    MarkerFiles,
+    Ndjson,
+    UnixSocket,
+    Unknown_EnumEnd
+};
+
+std::vector<std::string> GetStatusSinkTypeNames();
+bool AbslParseFlag(absl::string_view text, StatusSinkType* type, std::string* error);
+std::string AbslUnparseFlag(StatusSinkType type);
+
+struct StatusEvent {
+    // time of the status change, in microseconds since epoch
+    uint64_t epoch_us = 0;
+    int status_code = 0;
+};
+
+// Destination of preprocessing status changes. Only ever used from the status sink's writer thread.
+class StatusSinkBackend {
+public:
+    virtual ~StatusSinkBackend() = default;
+    virtual absl::Status Write(const std::vector<StatusEvent>& events) = 0;
+};
+
+// Writes an empty file named <epoch_microsecond>_<status_code> (zero-padded to 16 and 2 characters, respectively)
+// into `directory` for each status change.
+class MarkerFileStatusSinkBackend : public StatusSinkBackend {
+public:
+    explicit MarkerFileStatusSinkBackend(std::filesystem::path directory);
+    absl::Status Write(const std::vector<StatusEvent>& events) override;
+
+private:
+    std::filesystem::path directory;
+};
+
+// Appends one {"epoch_us":<epoch_microsecond>,"status":<status_code>} line per status change to a single file.
+class NdjsonStatusSinkBackend : public StatusSinkBackend {
+public:
+    static absl::StatusOr<std::unique_ptr<NdjsonStatusSinkBackend>> Open(const std::filesystem::path& path);
+    absl::Status Write(const std::vector<StatusEvent>& events) override;
+
+private:
+    explicit NdjsonStatusSinkBackend(std::filesystem::path path);
+
+    std::filesystem::path path;
+    std::ofstream file;
+};
+
+// Sends the same lines as NdjsonStatusSinkBackend to a Unix domain (stream) socket listening at `socket_path`,
+// (re-)connecting as needed.
+class UnixSocketStatusSinkBackend : public StatusSinkBackend {
+public:
+    explicit UnixSocketStatusSinkBackend(std::string socket_path);
+    ~UnixSocketStatusSinkBackend() override;
+
+    UnixSocketStatusSinkBackend(const UnixSocketStatusSinkBackend&) = delete;
+    UnixSocketStatusSinkBackend& operator=(const UnixSocketStatusSinkBackend&) = delete;
+
+    absl::Status Write(const std::vector<StatusEvent>& events) override;
+
+private:
+    absl::Status Connect();
+    void Disconnect();
+
+    std::string socket_path;
+    int socket_descriptor = -1;
+};
+
+struct StatusSinkSettings {
+    size_t queue_capacity = 256;
+    // Status changes that follow one another within this window are collapsed into the last one
+    // (i.e. the status that things settled on). When 0, only repeats of the same status are dropped.
+    int coalesce_window_ms = 0;
+};
+
+// Takes status changes from the container's callback thread without blocking it: Push() only stamps the time and puts
+// the change on a lock-free queue. A background thread drains the queue, drops redundant changes (repeats of the
+// last written status), and hands what remains to the backend in batches.
+class AsyncStatusSink {
+public:
+    AsyncStatusSink(std::unique_ptr<StatusSinkBackend> backend, StatusSinkSettings settings);
+    ~AsyncStatusSink();
+
+    AsyncStatusSink(const AsyncStatusSink&) = delete;
+    AsyncStatusSink& operator=(const AsyncStatusSink&) = delete;
+
+    // Returns the first error the backend ran into, if any, so that callers can still stop on write failures.
+    absl::Status Push(int status_code);
+
+    uint64_t GetDroppedEventCount() const;
+    uint64_t GetCoalescedEventCount() const;
+
+private:
+    void WriteEvents();
+    void CollectEvents(std::vector<StatusEvent>& events);
+
+    std::unique_ptr<StatusSinkBackend> backend;
+    const StatusSinkSettings settings;
+    LockFreeBoundedQueue<StatusEvent> queue;
+    std::atomic<uint64_t> dropped_event_count{0};
+    std::atomic<uint64_t> coalesced_event_count{0};
+    std::atomic<bool> stop_requested{false};
+    std::atomic<bool> backend_failed{false};
+    absl::Status backend_status;
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    int last_written_status_code = -1;
+    std::thread writer;
+};
+
+} // namespace presage::smartspectra::examples
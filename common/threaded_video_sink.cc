@@ -0,0 +1,319 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <algorithm>
+#include <chrono>
+
+// third-party includes
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/absl/strings/str_format.h>
+#include <physiology/interface/absl/strings/str_join.h>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/threaded_video_sink.hpp"
+
+namespace presage::smartspectra::examples {
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+const std::vector<std::string> kVideoSinkDropPolicyNames = {"drop_oldest", "drop_every_nth", "block"};
+} // anonymous namespace
+
+// region ================================== Drop policy flag ==========================================================
+std::vector<std::string> GetVideoSinkDropPolicyNames() {
+    return kVideoSinkDropPolicyNames;
+}
+
+bool AbslParseFlag(absl::string_view text, VideoSinkDropPolicy* policy, std::string* error) {
+    for (size_t i_policy = 0; i_policy < kVideoSinkDropPolicyNames.size(); i_policy++) {
+        if (text == kVideoSinkDropPolicyNames[i_policy]) {
+            *policy = static_cast<VideoSinkDropPolicy>(i_policy);
+            return true;
+        }
+    }
+    *error = absl::StrCat(
+        "Unknown video sink drop policy. Possible values: ", absl::StrJoin(kVideoSinkDropPolicyNames, ", ")
+    );
+    return false;
+}
+
+std::string AbslUnparseFlag(VideoSinkDropPolicy policy) {
+    auto index = static_cast<size_t>(policy);
+    return index < kVideoSinkDropPolicyNames.size() ? kVideoSinkDropPolicyNames[index] : "unknown";
+}
+// endregion ===========================================================================================================
+
+// region =================================== ThreadedVideoSink ========================================================
+absl::StatusOr<std::unique_ptr<ThreadedVideoSink>> ThreadedVideoSink::Start(ThreadedVideoSinkSettings settings) {
+    if (settings.destination.empty()) {
+        return absl::InvalidArgumentError("The video sink needs a destination.");
+    }
+    if (settings.queue_capacity == 0) {
+        return absl::InvalidArgumentError("The video sink queue capacity has to be positive.");
+    }
+    if (!(settings.frame_rate > 0.0)) {
+        return absl::InvalidArgumentError(absl::StrCat("Invalid video sink frame rate: ", settings.frame_rate));
+    }
+    if (!settings.gstreamer && settings.fourcc.size() != 4) {
+        return absl::InvalidArgumentError("Invalid video sink codec \"" + settings.fourcc + "\" (need a fourcc).");
+    }
+    switch (settings.drop_policy) {
+        case VideoSinkDropPolicy::DropOldest:
+        case VideoSinkDropPolicy::Block:
+            break;
+        case VideoSinkDropPolicy::DropEveryNth:
+            if (settings.drop_every_nth < 1) {
+                return absl::InvalidArgumentError(absl::StrCat(
+                    "Invalid video sink drop interval: ", settings.drop_every_nth, " (has to be at least 1)."
+                ));
+            }
+            break;
+        default:
+            return absl::InvalidArgumentError("Unknown video sink drop policy.");
+    }
+    std::unique_ptr<ThreadedVideoSink> sink(new ThreadedVideoSink(std::move(settings)));
+    sink->encoder = std::thread(&ThreadedVideoSink::Encode, sink.get());
+    return sink;
+}
+
+ThreadedVideoSink::ThreadedVideoSink(ThreadedVideoSinkSettings settings)
+    : settings(std::move(settings)), queue(this->settings.queue_capacity) {
+    if (this->settings.pipeline_metrics != nullptr) {
+        PipelineMetrics& metrics = *this->settings.pipeline_metrics;
+        pipeline_encode_histogram = &metrics.GetHistogram(
+            "video_sink_encode", "Time to encode and write out a frame of the output video, on the encoder thread."
+        );
+        pipeline_encoded_counter = &metrics.GetCounter(
+            "video_sink_frames_encoded_total", "Output video frames written."
+        );
+        pipeline_dropped_counter = &metrics.GetCounter(
+            "video_sink_frames_dropped_total", "Output video frames dropped, mostly for the encoder falling behind."
+        );
+        pipeline_queue_gauge = &metrics.GetGauge(
+            "video_sink_frames_queued", "Output video frames waiting for the encoder."
+        );
+    }
+}
+
+ThreadedVideoSink::~ThreadedVideoSink() {
+    if (!encoder.joinable()) {
+        // closed already, errors returned from Close()
+        return;
+    }
+    const absl::Status close_status = Close();
+    if (!close_status.ok()) {
+        LOG(ERROR) << close_status.message();
+    }
+}
+
+void ThreadedVideoSink::Write(const cv::Mat& frame) {
+    written_count++;
+    // A frame without an allocation of its own (u == nullptr) views a buffer that its owner may reuse (e.g. a ring
+    // slot) before the encoder gets to it, so it is queued as a copy; any other frame is queued by reference.
+    const cv::Mat queued_frame = frame.u == nullptr && !frame.empty() ? frame.clone() : frame;
+    std::unique_lock<std::mutex> lock(mutex);
+    if (stop_requested || !status.ok()) {
+        CountDropped();
+        return;
+    }
+    const size_t capacity = queue.size();
+    switch (settings.drop_policy) {
+        case VideoSinkDropPolicy::Block:
+            space_freed.wait(lock, [this, capacity] {
+                return queue_size < capacity || stop_requested || !status.ok();
+            });
+            if (stop_requested || !status.ok()) {
+                CountDropped();
+                return;
+            }
+            break;
+        case VideoSinkDropPolicy::DropEveryNth:
+            if (queue_size >= std::max<size_t>(capacity / 2, 1)) {
+                backlog_frame_count++;
+                if (backlog_frame_count % settings.drop_every_nth == 0) {
+                    CountDropped();
+                    return;
+                }
+            } else {
+                backlog_frame_count = 0;
+            }
+            break;
+        default:
+            break;
+    }
+    if (queue_size == capacity) {
+        DropOldest();
+    }
+    queue[(queue_head + queue_size) % capacity] = queued_frame;
+    queue_size++;
+    UpdateQueueGauge();
+    lock.unlock();
+    frame_queued.notify_one();
+}
+
+void ThreadedVideoSink::DropOldest() {
+    queue[queue_head].release();
+    queue_head = (queue_head + 1) % queue.size();
+    queue_size--;
+    CountDropped();
+}
+
+void ThreadedVideoSink::CountDropped() {
+    dropped_count++;
+    if (pipeline_dropped_counter != nullptr) {
+        (*pipeline_dropped_counter)++;
+    }
+}
+
+void ThreadedVideoSink::UpdateQueueGauge() {
+    if (pipeline_queue_gauge != nullptr) {
+        *pipeline_queue_gauge = static_cast<int64_t>(queue_size);
+    }
+}
+
+absl::Status ThreadedVideoSink::Close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop_requested = true;
+    }
+    frame_queued.notify_all();
+    space_freed.notify_all();
+    if (encoder.joinable()) {
+        encoder.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    return status;
+}
+
+std::string ThreadedVideoSink::Summarize() const {
+    size_t queued_count;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued_count = queue_size;
+    }
+    const uint64_t written = written_count.load();
+    const uint64_t dropped = dropped_count.load();
+    return absl::StrFormat(
+        "encoded %d of %d frames, dropped %d (%.2f%%, %s), %d queued; encode %s", encoded_count.load(), written,
+        dropped, written > 0 ? 100.0 * static_cast<double>(dropped) / static_cast<double>(written) : 0.0,
+        AbslUnparseFlag(settings.drop_policy), queued_count, encode_histogram.Summarize()
+    );
+}
+
+void ThreadedVideoSink::Encode() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        frame_queued.wait(lock, [this] { return stop_requested || queue_size > 0; });
+        if (queue_size == 0) {
+            // stopped, with every queued frame written
+            break;
+        }
+        cv::Mat frame = std::move(queue[queue_head]);
+        queue_head = (queue_head + 1) % queue.size();
+        queue_size--;
+        UpdateQueueGauge();
+        lock.unlock();
+        space_freed.notify_one();
+
+        absl::Status frame_status = absl::OkStatus();
+        if (!writer.isOpened()) {
+            frame_size = frame.size();
+            const bool opened = settings.gstreamer
+                                ? writer.open(settings.destination, cv::CAP_GSTREAMER, 0, settings.frame_rate,
+                                              frame_size, true)
+                                : writer.open(settings.destination,
+                                              cv::VideoWriter::fourcc(settings.fourcc[0], settings.fourcc[1],
+                                                                      settings.fourcc[2], settings.fourcc[3]),
+                                              settings.frame_rate, frame_size, true);
+            if (!opened) {
+                frame_status = absl::UnavailableError(absl::StrCat(
+                    "Could not open the output video ", settings.destination, settings.gstreamer ? " (GStreamer)" : "",
+                    " for ", frame_size.width, "x", frame_size.height, " frames."
+                ));
+            }
+        }
+        bool encoded = false;
+        if (frame_status.ok() && frame.size() == frame_size) {
+            const auto start = Clock::now();
+            writer.write(frame);
+            const auto elapsed = Clock::now() - start;
+            encode_histogram.Record(elapsed);
+            if (pipeline_encode_histogram != nullptr) {
+                pipeline_encode_histogram->Record(elapsed);
+            }
+            encoded = true;
+        }
+        // released here, off the capture thread
+        frame.release();
+
+        lock.lock();
+        if (encoded) {
+            encoded_count++;
+            if (pipeline_encoded_counter != nullptr) {
+                (*pipeline_encoded_counter)++;
+            }
+        } else {
+            CountDropped();
+        }
+        if (!frame_status.ok()) {
+            status = frame_status;
+            // nothing more can be written: drop what is queued and let blocked writers go
+            while (queue_size > 0) {
+                DropOldest();
+            }
+            UpdateQueueGauge();
+            space_freed.notify_all();
+            break;
+        }
+    }
+    lock.unlock();
+    if (writer.isOpened()) {
+        writer.release();
+    }
+}
+// endregion ===========================================================================================================
+
+// region ================================== RecordedVideoSource =======================================================
+RecordedVideoSource::RecordedVideoSource(
+    std::unique_ptr<video_source::VideoSource> video_source,
+    ThreadedVideoSink& sink
+) : video_source(std::move(video_source)), sink(sink) {}
+
+absl::Status RecordedVideoSource::Initialize(const video_source::VideoSourceSettings& settings) {
+    return video_source->Initialize(settings);
+}
+
+bool RecordedVideoSource::SupportsExactFrameTimestamp() const {
+    return video_source->SupportsExactFrameTimestamp();
+}
+
+int64_t RecordedVideoSource::GetFrameTimestamp() const {
+    return video_source->GetFrameTimestamp();
+}
+
+int RecordedVideoSource::GetWidth() {
+    return video_source->GetWidth();
+}
+
+int RecordedVideoSource::GetHeight() {
+    return video_source->GetHeight();
+}
+
+video_source::VideoSource& RecordedVideoSource::operator>>(cv::Mat& frame) {
+    // a new header (and thus, a new buffer), rather than `frame`, which may still share the previous frame's buffer
+    // with the sink's queue
+    cv::Mat read_frame;
+    *video_source >> read_frame;
+    if (!read_frame.empty()) {
+        sink.Write(read_frame);
+    }
+    frame = read_frame;
+    return *this;
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::examples
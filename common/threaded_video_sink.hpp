@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+#pragma once
+
+// stdlib includes
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// third-party includes
+#include <opencv2/videoio.hpp>
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/status/statusor.h>
+#include <physiology/interface/absl/strings/string_view.h>
+#include <smartspectra/video_source/video_source.hpp>
+
+// local includes
+#include "common/latency_histogram.hpp"
+#include "common/pipeline_metrics.hpp"
+#include "common/status_macros.hpp"
+
+namespace presage::smartspectra::examples {
+
+// What to do with a frame when the encoder has fallen behind.
+enum class VideoSinkDropPolicy {
+    // when the queue is full, the oldest queued frame makes room for the new one
+    DropOldest,
+    // while the queue is at least half full, every `drop_every_nth`-th frame is dropped as it comes in, thinning the
+    // video out evenly rather than losing a stretch of it; if the queue fills up regardless, the oldest frame goes
+    DropEveryNth,
+    // when the queue is full, wait for the encoder to make room (nothing is dropped, processing is held up instead)
+    Block,
+    Unknown_EnumEnd
+};
+
+std::vector<std::string> GetVideoSinkDropPolicyNames();
+bool AbslParseFlag(absl::string_view text, VideoSinkDropPolicy* policy, std::string* error);
+std::string AbslUnparseFlag(VideoSinkDropPolicy policy);
+
+struct ThreadedVideoSinkSettings {
+    // video file to write or, with `gstreamer`, a GStreamer pipeline ending in a sink
+    std::string destination;
+    bool gstreamer = false;
+    // four-character code of the codec (ignored with `gstreamer`); MJPG is available in every OpenCV build
+    std::string fourcc = "MJPG";
+    double frame_rate = 30.0;
+    // frames that can wait for the encoder
+    size_t queue_capacity = 32;
+    VideoSinkDropPolicy drop_policy = VideoSinkDropPolicy::DropOldest;
+    int drop_every_nth = 2;
+    // When set, encoding times, encoded / dropped frame counts and the queue depth are recorded there as well.
+    PipelineMetrics* pipeline_metrics = nullptr;
+};
+
+// Writes video on an encoder thread of its own, so that encoding time stays off the processing path. Frames wait for
+// the encoder in a bounded ring of frame references: cv::Mat shares its pixel data, so queuing a frame copies no
+// pixels, and whatever hands a frame over must not modify it afterwards (see RecordedVideoSource). Frames that only
+// view memory they do not own (e.g. a slot of a shared-memory ring) are copied when queued instead. When the encoder
+// falls behind, frames are dropped (or the caller waits) as per the drop policy. The writer is opened with the size
+// of the first frame; frames of any other size are dropped.
+class ThreadedVideoSink {
+public:
+    static absl::StatusOr<std::unique_ptr<ThreadedVideoSink>> Start(ThreadedVideoSinkSettings settings);
+    // Same as Close() (unless closed already), with errors logged.
+    ~ThreadedVideoSink();
+
+    ThreadedVideoSink(const ThreadedVideoSink&) = delete;
+    ThreadedVideoSink& operator=(const ThreadedVideoSink&) = delete;
+
+    // Queues `frame` (by reference, or as a copy if it does not own its pixels) for encoding. Frames handed over after the sink failed or was closed are dropped.
+    void Write(const cv::Mat& frame);
+    // Encodes the frames still queued, then closes the writer. Returns the first error the encoder ran into, if any.
+    absl::Status Close();
+
+    uint64_t GetEncodedFrameCount() const { return encoded_count.load(std::memory_order_relaxed); }
+    uint64_t GetDroppedFrameCount() const { return dropped_count.load(std::memory_order_relaxed); }
+
+    // e.g. "encoded 1780 of 1800 frames, dropped 20 (1.11%, drop_oldest), 4 queued; encode count=1780 mean=...us ..."
+    std::string Summarize() const;
+
+private:
+    explicit ThreadedVideoSink(ThreadedVideoSinkSettings settings);
+
+    void Encode();
+    // called with `mutex` held
+    void DropOldest();
+    void CountDropped();
+    void UpdateQueueGauge();
+
+    const ThreadedVideoSinkSettings settings;
+
+    mutable std::mutex mutex;
+    std::condition_variable frame_queued;
+    std::condition_variable space_freed;
+    // ring of `queue_capacity` slots, the oldest queued frame at `queue_head`
+    std::vector<cv::Mat> queue;
+    size_t queue_head = 0;
+    size_t queue_size = 0;
+    // frames that came in while the queue was at least half full, for DropEveryNth
+    uint64_t backlog_frame_count = 0;
+    bool stop_requested = false;
+    absl::Status status;
+
+    std::atomic<uint64_t> written_count{0};
+    std::atomic<uint64_t> encoded_count{0};
+    std::atomic<uint64_t> dropped_count{0};
+    LatencyHistogram encode_histogram;
+    // from settings.pipeline_metrics, if set
+    LatencyHistogram* pipeline_encode_histogram = nullptr;
+    std::atomic<int64_t>* pipeline_encoded_counter = nullptr;
+    std::atomic<int64_t>* pipeline_dropped_counter = nullptr;
+    std::atomic<int64_t>* pipeline_queue_gauge = nullptr;
+
+    cv::VideoWriter writer;
+    cv::Size frame_size;
+    std::thread encoder;
+};
+
+// Hands out the frames of another video source, handing each one to a ThreadedVideoSink as well. Each frame is read
+// into a cv::Mat of its own, so the source underneath never writes into a buffer that is still queued for encoding.
+class RecordedVideoSource : public video_source::VideoSource {
+public:
+    RecordedVideoSource(std::unique_ptr<video_source::VideoSource> video_source, ThreadedVideoSink& sink);
+
+    absl::Status Initialize(const video_source::VideoSourceSettings& settings) override;
+    bool SupportsExactFrameTimestamp() const override;
+    int64_t GetFrameTimestamp() const override;
+    int GetWidth() override;
+    int GetHeight() override;
+    video_source::VideoSource& operator>>(cv::Mat& frame) override;
+
+private:
+    std::unique_ptr<video_source::VideoSource> video_source;
+    ThreadedVideoSink& sink;
+};
+
+// Foreground container whose input frames (from whichever video source the base container sets up) are also written
+// out by `video_sink`, unless that is null. Stack it outside InputReductionContainer to record the frames the graph
+// gets, inside it to record the frames as captured.
+template<typename TContainer>
+class RecordedContainer : public TContainer {
+public:
+    template<typename... TArgs>
+    explicit RecordedContainer(ThreadedVideoSink* video_sink, TArgs&& ... args)
+        : TContainer(std::forward<TArgs>(args)...), video_sink(video_sink) {}
+
+protected:
+    absl::Status InitializeVideoSource() override {
+        MP_RETURN_IF_ERROR(TContainer::InitializeVideoSource());
+        if (video_sink != nullptr) {
+            this->video_source = std::make_unique<RecordedVideoSource>(std::move(this->video_source), *video_sink);
+        }
+        return absl::OkStatus();
+    }
+
+private:
+    ThreadedVideoSink* video_sink;
+};
+
+} // namespace presage::smartspectra::examples
@@ -0,0 +1,1010 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Dummy/Example Physiology Core gRPC Server (procedures produce random outputs): a native counterpart of
+// example_physiology_core_grpc_server.py that keeps up with (many) C++ clients, for load-testing the gRPC continuous
+// container locally. Can also generate load itself (--load_clients), against itself or another server.
+
+// stdlib includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// third-party includes
+#include <google/protobuf/empty.pb.h>
+#include <google/protobuf/wrappers.pb.h>
+#include <grpcpp/generic/async_generic_service.h>
+#include <grpcpp/generic/generic_stub.h>
+#include <grpcpp/grpcpp.h>
+#include <physiology/graph/physiology_core_service.grpc.pb.h>
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/glog/logging.h>
+#include <physiology/modules/messages/metrics.pb.h>
+
+// local includes
+#include "common/core_stream_relay.hpp"
+#include "common/latency_histogram.hpp"
+#include "common/status_macros.hpp"
+
+namespace physiology = presage::physiology;
+namespace examples = presage::smartspectra::examples;
+
+ABSL_FLAG(bool, also_log_to_stderr, false, "If true, log to stderr as well.");
+ABSL_FLAG(uint16_t, port, 50052,
+          "Port to serve the Physiology service on (the default matches `--core_port` of grpc_continuous_example).");
+ABSL_FLAG(int, worker_threads, 0,
+          "Maximum number of threads handling RPCs. When 0, the number of hardware threads is used.");
+ABSL_FLAG(int, seed, -1,
+          "Seed to use to randomize the outputs. When non-negative, every GetMetrics call returns the same metrics.");
+ABSL_FLAG(bool, constant_metrics, false, "If true, return constant instead of random metrics.");
+ABSL_FLAG(int, metrics_length_seconds, 4, "Number of seconds of metrics to return from each GetMetrics call.");
+ABSL_FLAG(int, report_interval, 10,
+          "Interval, in seconds, between logging per-RPC latency histograms and throughput. When 0, these are only "
+          "logged on shutdown.");
+// region ===================================== LOAD GENERATION ========================================================
+ABSL_FLAG(int, load_clients, 0,
+          "When positive, run this many load-generating clients, each sending preprocessed data and requesting metrics "
+          "the way the gRPC continuous container does, for `--load_duration` seconds, then log throughput and "
+          "client-side per-RPC latency histograms and exit.");
+ABSL_FLAG(std::string, load_target, "",
+          "Address (host:port) of the server to load. When empty, the load is put on the server started by this "
+          "process.");
+ABSL_FLAG(int, load_duration, 10, "Duration of the load test, in seconds.");
+ABSL_FLAG(double, load_frame_rate, 30.0,
+          "Frame rate each client produces preprocessed data at, in frames per second. When 0, clients send buffers "
+          "as fast as the server takes them.");
+ABSL_FLAG(double, load_buffer_duration, 0.5,
+          "Duration of the preprocessed data buffer sent with each AddPreprocessedData call, in seconds of frames "
+          "(same as `--buffer_duration` of grpc_continuous_example). Each buffer is followed by a GetMetrics call.");
+ABSL_FLAG(int, load_face_landmark_count, 478, "Number of face landmarks in each preprocessed frame.");
+ABSL_FLAG(int, load_roi_count, 8, "Number of regions of interest (besides the face) in each preprocessed frame.");
+ABSL_FLAG(int, load_tracked_point_count, 64, "Number of tracked points in each preprocessed frame.");
+ABSL_FLAG(bool, load_streaming, false,
+          "If true, clients push preprocessed data in batches on a single long-lived StreamPreprocessedData call "
+          "(served by this server only), which streams metrics back, instead of calling AddPreprocessedData and "
+          "GetMetrics once per `--load_buffer_duration`. Compare the frame capture to metrics arrival latency "
+          "logged at the end between both modes. A protocol prototype: the SDK containers (and so the examples) do "
+          "not use this call.");
+ABSL_FLAG(int, stream_batch_frames, 5, "Maximum number of frames per batch in streaming mode.");
+ABSL_FLAG(int, stream_batch_interval_ms, 100,
+          "Maximum time, in milliseconds, from capturing the first frame of a batch to sending the batch, in "
+          "streaming mode.");
+ABSL_FLAG(int, stream_max_in_flight, 4,
+          "Maximum number of batches waiting for their metrics in streaming mode. Once reached, capture waits for "
+          "metrics to come back (backpressure) instead of dropping frames.");
+// endregion ===========================================================================================================
+
+namespace {
+
+std::atomic<bool> stop_requested{false};
+
+void HandleStopSignal(int) {
+    stop_requested = true;
+}
+
+using Clock = std::chrono::steady_clock;
+
+// Bidirectional streaming counterpart of AddPreprocessedData + GetMetrics: the client streams PreprocessedDataBuffer
+// batches, and a MetricsBuffer comes back for each, in order. Not part of the Physiology service definition that
+// ships with the SDK, so it is served (and called) as a generic method, with the messages serialized by hand.
+constexpr const char* kStreamPreprocessedDataMethod = "/presage.physiology.Physiology/StreamPreprocessedData";
+
+// region ===================================== Metrics generation =====================================================
+struct MetricsGeneratorSettings {
+    int seed = -1;
+    bool constant = false;
+    int length_seconds = 4;
+};
+
+template<typename TMeasurement>
+void RandomizeMeasurement(float lower_limit, float upper_limit, TMeasurement& measurement, std::mt19937& generator) {
+    measurement.set_value(std::uniform_real_distribution<float>(lower_limit, upper_limit)(generator));
+    measurement.set_stable(true);
+}
+
+void RandomizeMeasurementWithConfidence(
+    float lower_limit, float upper_limit, physiology::MeasurementWithConfidence& measurement, std::mt19937& generator
+) {
+    RandomizeMeasurement(lower_limit, upper_limit, measurement, generator);
+    measurement.set_confidence(std::uniform_real_distribution<float>(0.0f, 1.0f)(generator));
+}
+
+void GenerateRandomMetrics(physiology::MetricsBuffer& buffer, int length_seconds, std::mt19937& generator) {
+    for (int time_second = 0; time_second < length_seconds; time_second++) {
+        const auto time = static_cast<float>(time_second);
+        auto* pulse_rate = buffer.mutable_pulse()->add_rate();
+        pulse_rate->set_time(time);
+        RandomizeMeasurementWithConfidence(38.0f, 105.0f, *pulse_rate, generator);
+        auto* pulse_trace = buffer.mutable_pulse()->add_trace();
+        pulse_trace->set_time(time);
+        RandomizeMeasurement(0.0f, 1.0f, *pulse_trace, generator);
+        auto* breathing_rate = buffer.mutable_breath()->add_rate();
+        breathing_rate->set_time(time);
+        RandomizeMeasurementWithConfidence(6.0f, 12.0f, *breathing_rate, generator);
+        auto* upper_breathing_trace = buffer.mutable_breath()->add_upper_trace();
+        upper_breathing_trace->set_time(time);
+        RandomizeMeasurement(0.0f, 1.0f, *upper_breathing_trace, generator);
+        auto* lower_breathing_trace = buffer.mutable_breath()->add_lower_trace();
+        lower_breathing_trace->set_time(time);
+        RandomizeMeasurement(0.0f, 1.0f, *lower_breathing_trace, generator);
+        auto* phasic_pressure = buffer.mutable_pressure()->add_phasic();
+        phasic_pressure->set_time(time);
+        RandomizeMeasurementWithConfidence(70.0f, 105.0f, *phasic_pressure, generator);
+    }
+}
+
+void GenerateConstantMetrics(physiology::MetricsBuffer& buffer, int length_seconds) {
+    for (int time_second = 0; time_second < length_seconds; time_second++) {
+        const auto time = static_cast<float>(time_second);
+        auto* pulse_rate = buffer.mutable_pulse()->add_rate();
+        pulse_rate->set_time(time);
+        pulse_rate->set_value(38.0f);
+        pulse_rate->set_confidence(1.0f);
+        auto* pulse_trace = buffer.mutable_pulse()->add_trace();
+        pulse_trace->set_time(time);
+        pulse_trace->set_value(0.5f);
+        auto* breathing_rate = buffer.mutable_breath()->add_rate();
+        breathing_rate->set_time(time);
+        breathing_rate->set_value(12.0f);
+        breathing_rate->set_confidence(1.0f);
+        auto* upper_breathing_trace = buffer.mutable_breath()->add_upper_trace();
+        upper_breathing_trace->set_time(time);
+        upper_breathing_trace->set_value(0.5f);
+        auto* lower_breathing_trace = buffer.mutable_breath()->add_lower_trace();
+        lower_breathing_trace->set_time(time);
+        lower_breathing_trace->set_value(0.5f);
+        auto* phasic_pressure = buffer.mutable_pressure()->add_phasic();
+        phasic_pressure->set_time(time);
+        phasic_pressure->set_value(70.0f);
+        phasic_pressure->set_confidence(1.0f);
+    }
+}
+
+void GenerateMetrics(physiology::MetricsBuffer& buffer, const MetricsGeneratorSettings& settings) {
+    if (settings.constant) {
+        GenerateConstantMetrics(buffer, settings.length_seconds);
+    } else if (settings.seed >= 0) {
+        // re-seeded on every call, same as the Python server
+        std::mt19937 generator(static_cast<std::mt19937::result_type>(settings.seed));
+        GenerateRandomMetrics(buffer, settings.length_seconds, generator);
+    } else {
+        thread_local std::mt19937 generator{std::random_device{}()};
+        GenerateRandomMetrics(buffer, settings.length_seconds, generator);
+    }
+}
+// endregion ===========================================================================================================
+
+// region ===================================== Service ================================================================
+struct RpcHistograms {
+    examples::LatencyHistogram add_preprocessed_data;
+    examples::LatencyHistogram get_metrics;
+    examples::LatencyHistogram set_buffer_duration;
+    examples::LatencyHistogram reset_processing;
+    // per batch: handling time on the server, from sending the batch to receiving its metrics on the client
+    examples::LatencyHistogram stream_preprocessed_data;
+
+    void Log(const std::string& prefix) const {
+        LOG(INFO) << prefix << " AddPreprocessedData: " << add_preprocessed_data.Summarize();
+        LOG(INFO) << prefix << " GetMetrics: " << get_metrics.Summarize();
+        LOG(INFO) << prefix << " SetBufferDuration: " << set_buffer_duration.Summarize();
+        LOG(INFO) << prefix << " ResetProcessing: " << reset_processing.Summarize();
+        LOG(INFO) << prefix << " StreamPreprocessedData (per batch): " << stream_preprocessed_data.Summarize();
+    }
+};
+
+// Records the time until it goes out of scope in the given histogram.
+class ScopedRpcTimer {
+public:
+    explicit ScopedRpcTimer(examples::LatencyHistogram& histogram) : histogram(histogram), start(Clock::now()) {}
+    ~ScopedRpcTimer() { histogram.Record(Clock::now() - start); }
+
+private:
+    examples::LatencyHistogram& histogram;
+    Clock::time_point start;
+};
+
+// Stream a call belongs to, as tagged by CoreStreamRelay (or the load generator); empty for untagged calls.
+std::string GetStreamId(const grpc::ServerContextBase& context) {
+    const auto& metadata = context.client_metadata();
+    const auto stream_id = metadata.find(examples::kStreamIdMetadataKey);
+    return stream_id == metadata.end()
+           ? std::string() : std::string(stream_id->second.data(), stream_id->second.size());
+}
+
+// Handlers of the Physiology RPCs, safe to call from any number of worker threads at once. Keeps separate (imaginary)
+// processing state for every stream.
+class StandInPhysiologyHandlers {
+public:
+    explicit StandInPhysiologyHandlers(MetricsGeneratorSettings settings) : settings(settings) {}
+
+    grpc::Status AddPreprocessedData(
+        const std::string& stream_id,
+        const physiology::PreprocessedDataBuffer& request,
+        google::protobuf::Empty&
+    ) {
+        hr_frame_count.fetch_add(request.hr_data_size(), std::memory_order_relaxed);
+        rr_frame_count.fetch_add(request.rr_data_size(), std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(streams_mutex);
+            StreamState& stream = streams[stream_id];
+            stream.hr_frame_count += request.hr_data_size();
+            stream.rr_frame_count += request.rr_data_size();
+        }
+        VLOG(2) << "Got preprocessed data for stream '" << stream_id << "': " << request.hr_data_size()
+                << " hr frames, " << request.rr_data_size() << " rr frames.";
+        return grpc::Status::OK;
+    }
+
+    grpc::Status GetMetrics(const std::string&, const google::protobuf::Empty&, physiology::MetricsBuffer& response) {
+        GenerateMetrics(response, settings);
+        return grpc::Status::OK;
+    }
+
+    grpc::Status IssueBlueTooth(const std::string&, const physiology::BlueTooth&, google::protobuf::Empty&) {
+        return grpc::Status::OK;
+    }
+
+    grpc::Status SetBufferDuration(
+        const std::string& stream_id,
+        const google::protobuf::DoubleValue& request,
+        google::protobuf::Empty&
+    ) {
+        {
+            std::lock_guard<std::mutex> lock(streams_mutex);
+            streams[stream_id].buffer_duration = request.value();
+        }
+        LOG(INFO) << "Set buffer duration of stream '" << stream_id << "' to " << request.value();
+        return grpc::Status::OK;
+    }
+
+    grpc::Status ResetProcessing(
+        const std::string& stream_id,
+        const google::protobuf::Empty&,
+        google::protobuf::Empty&
+    ) {
+        {
+            std::lock_guard<std::mutex> lock(streams_mutex);
+            streams[stream_id].reset_count++;
+        }
+        LOG(INFO) << "Got command to clean the test buffer of stream '" << stream_id
+                  << "'. Cleaning the imaginary test buffer.";
+        return grpc::Status::OK;
+    }
+
+    void LogStatistics() const {
+        LOG(INFO) << "Server received " << hr_frame_count.load() << " hr frames and " << rr_frame_count.load()
+                  << " rr frames so far.";
+        {
+            std::lock_guard<std::mutex> lock(streams_mutex);
+            for (const auto& [stream_id, stream]: streams) {
+                LOG(INFO) << "Stream '" << stream_id << "': " << stream.hr_frame_count << " hr frames, "
+                          << stream.rr_frame_count << " rr frames, buffer duration " << stream.buffer_duration
+                          << " s, reset " << stream.reset_count << " times.";
+            }
+        }
+        histograms.Log("Server-side");
+    }
+
+    RpcHistograms histograms;
+
+private:
+    struct StreamState {
+        int64_t hr_frame_count = 0;
+        int64_t rr_frame_count = 0;
+        double buffer_duration = 0.0;
+        int reset_count = 0;
+    };
+
+    MetricsGeneratorSettings settings;
+    std::atomic<int64_t> hr_frame_count{0};
+    std::atomic<int64_t> rr_frame_count{0};
+    mutable std::mutex streams_mutex;
+    std::map<std::string, StreamState> streams;
+};
+
+// One call in flight on a server completion queue. The sync gRPC server turns calls away once it runs out of threads,
+// so a fixed number of worker threads is served through the async API instead, where calls wait for a free worker.
+class PendingCall {
+public:
+    virtual ~PendingCall() = default;
+    // Invoked by the worker thread when the completion queue hands out this call's tag.
+    virtual void Proceed(bool ok) = 0;
+};
+
+// What a pending call needs from the server it belongs to.
+struct ServingQueue {
+    physiology::Physiology::AsyncService& service;
+    grpc::ServerCompletionQueue& completion_queue;
+    StandInPhysiologyHandlers& handlers;
+    // once set, no more calls are awaited (the completion queue is about to be shut down)
+    const std::atomic<bool>& shutting_down;
+};
+
+template<typename TRequest, typename TResponse>
+class PendingUnaryCall : public PendingCall {
+public:
+    using RequestMethod = void (physiology::Physiology::AsyncService::*)(
+        grpc::ServerContext*, TRequest*, grpc::ServerAsyncResponseWriter<TResponse>*, grpc::CompletionQueue*,
+        grpc::ServerCompletionQueue*, void*
+    );
+    using HandlerMethod =
+        grpc::Status (StandInPhysiologyHandlers::*)(const std::string& stream_id, const TRequest&, TResponse&);
+
+    // Starts waiting for the next call of the method on the queue.
+    static void Await(
+        const ServingQueue& queue,
+        RequestMethod request_method,
+        HandlerMethod handler_method,
+        examples::LatencyHistogram& histogram
+    ) {
+        if (queue.shutting_down) {
+            return;
+        }
+        auto* call = new PendingUnaryCall(queue, request_method, handler_method, histogram);
+        (queue.service.*request_method)(
+            &call->context, &call->request, &call->responder, &queue.completion_queue, &queue.completion_queue, call
+        );
+    }
+
+    void Proceed(bool ok) override {
+        if (!ok || responded) {
+            // the call is done (or the server is shutting down)
+            delete this;
+            return;
+        }
+        Await(queue, request_method, handler_method, histogram);
+        grpc::Status status;
+        {
+            ScopedRpcTimer timer(histogram);
+            status = (queue.handlers.*handler_method)(GetStreamId(context), request, response);
+        }
+        responded = true;
+        responder.Finish(response, status, this);
+    }
+
+private:
+    PendingUnaryCall(
+        const ServingQueue& queue,
+        RequestMethod request_method,
+        HandlerMethod handler_method,
+        examples::LatencyHistogram& histogram
+    ) : queue(queue), request_method(request_method), handler_method(handler_method), histogram(histogram),
+        responder(&context) {}
+
+    ServingQueue queue;
+    RequestMethod request_method;
+    HandlerMethod handler_method;
+    examples::LatencyHistogram& histogram;
+
+    grpc::ServerContext context;
+    TRequest request;
+    TResponse response;
+    grpc::ServerAsyncResponseWriter<TResponse> responder;
+    bool responded = false;
+};
+
+// Server side of a StreamPreprocessedData call: handles one batch at a time, reading the next one once the metrics for
+// the previous one are written, so that a client that sends faster than this keeps up is held back by flow control.
+class PreprocessedDataStreamReactor : public grpc::ServerGenericBidiReactor {
+public:
+    PreprocessedDataStreamReactor(StandInPhysiologyHandlers& handlers, std::string stream_id)
+        : handlers(handlers), stream_id(std::move(stream_id)) {
+        StartRead(&request_message);
+    }
+
+    void OnReadDone(bool ok) override {
+        if (!ok) {
+            // the client is done sending
+            Finish(grpc::Status::OK);
+            return;
+        }
+        ScopedRpcTimer timer(handlers.histograms.stream_preprocessed_data);
+        physiology::PreprocessedDataBuffer batch;
+        grpc::Status status = grpc::SerializationTraits<physiology::PreprocessedDataBuffer>::Deserialize(
+            &request_message, &batch
+        );
+        google::protobuf::Empty empty;
+        physiology::MetricsBuffer metrics;
+        if (status.ok()) {
+            status = handlers.AddPreprocessedData(stream_id, batch, empty);
+        }
+        if (status.ok()) {
+            status = handlers.GetMetrics(stream_id, empty, metrics);
+        }
+        bool own_buffer = false;
+        if (status.ok()) {
+            response_message.Clear();
+            status = grpc::SerializationTraits<physiology::MetricsBuffer>::Serialize(
+                metrics, &response_message, &own_buffer
+            );
+        }
+        if (!status.ok()) {
+            Finish(status);
+            return;
+        }
+        StartWrite(&response_message);
+    }
+
+    void OnWriteDone(bool ok) override {
+        if (!ok) {
+            Finish(grpc::Status(grpc::StatusCode::UNAVAILABLE, "Could not write metrics."));
+            return;
+        }
+        StartRead(&request_message);
+    }
+
+    void OnDone() override {
+        delete this;
+    }
+
+private:
+    StandInPhysiologyHandlers& handlers;
+    const std::string stream_id;
+    grpc::ByteBuffer request_message;
+    grpc::ByteBuffer response_message;
+};
+
+class StreamingPhysiologyService : public grpc::CallbackGenericService {
+public:
+    explicit StreamingPhysiologyService(StandInPhysiologyHandlers& handlers) : handlers(handlers) {}
+
+    grpc::ServerGenericBidiReactor* CreateReactor(grpc::GenericCallbackServerContext* context) override {
+        if (context->method() == kStreamPreprocessedDataMethod) {
+            return new PreprocessedDataStreamReactor(handlers, GetStreamId(*context));
+        }
+        return grpc::CallbackGenericService::CreateReactor(context);
+    }
+
+private:
+    StandInPhysiologyHandlers& handlers;
+};
+
+// Serves the Physiology service on `worker_thread_count` threads, each with its own completion queue.
+// StreamPreprocessedData calls are served on gRPC's own callback threads.
+class StandInPhysiologyServer {
+public:
+    StandInPhysiologyServer(MetricsGeneratorSettings settings, int worker_thread_count)
+        : handlers(settings), worker_thread_count(worker_thread_count), streaming_service(handlers) {}
+
+    ~StandInPhysiologyServer() {
+        Shutdown();
+    }
+
+    absl::Status Start(uint16_t port) {
+        grpc::ServerBuilder builder;
+        const std::string address = absl::StrCat("[::]:", port);
+        builder.AddListeningPort(address, grpc::InsecureServerCredentials());
+        builder.RegisterService(&service);
+        builder.RegisterCallbackGenericService(&streaming_service);
+        for (int i_worker = 0; i_worker < worker_thread_count; i_worker++) {
+            completion_queues.push_back(builder.AddCompletionQueue());
+        }
+        server = builder.BuildAndStart();
+        if (server == nullptr) {
+            return absl::UnavailableError("Could not start the server on " + address);
+        }
+        for (auto& completion_queue: completion_queues) {
+            AwaitCalls(*completion_queue);
+            workers.emplace_back([&completion_queue]() {
+                void* tag = nullptr;
+                bool ok = false;
+                while (completion_queue->Next(&tag, &ok)) {
+                    static_cast<PendingCall*>(tag)->Proceed(ok);
+                }
+            });
+        }
+        return absl::OkStatus();
+    }
+
+    void Shutdown() {
+        if (server == nullptr) {
+            return;
+        }
+        shutting_down = true;
+        server->Shutdown(std::chrono::system_clock::now() + std::chrono::seconds(1));
+        for (auto& completion_queue: completion_queues) {
+            completion_queue->Shutdown();
+        }
+        for (auto& worker: workers) {
+            worker.join();
+        }
+        workers.clear();
+        server.reset();
+    }
+
+    StandInPhysiologyHandlers handlers;
+
+private:
+    void AwaitCalls(grpc::ServerCompletionQueue& completion_queue) {
+        using AsyncService = physiology::Physiology::AsyncService;
+        const ServingQueue queue{service, completion_queue, handlers, shutting_down};
+        PendingUnaryCall<physiology::PreprocessedDataBuffer, google::protobuf::Empty>::Await(
+            queue, &AsyncService::RequestAddPreprocessedData, &StandInPhysiologyHandlers::AddPreprocessedData,
+            handlers.histograms.add_preprocessed_data
+        );
+        PendingUnaryCall<google::protobuf::Empty, physiology::MetricsBuffer>::Await(
+            queue, &AsyncService::RequestGetMetrics, &StandInPhysiologyHandlers::GetMetrics,
+            handlers.histograms.get_metrics
+        );
+        PendingUnaryCall<physiology::BlueTooth, google::protobuf::Empty>::Await(
+            queue, &AsyncService::RequestIssueBlueTooth, &StandInPhysiologyHandlers::IssueBlueTooth,
+            issue_blue_tooth_histogram
+        );
+        PendingUnaryCall<google::protobuf::DoubleValue, google::protobuf::Empty>::Await(
+            queue, &AsyncService::RequestSetBufferDuration, &StandInPhysiologyHandlers::SetBufferDuration,
+            handlers.histograms.set_buffer_duration
+        );
+        PendingUnaryCall<google::protobuf::Empty, google::protobuf::Empty>::Await(
+            queue, &AsyncService::RequestResetProcessing, &StandInPhysiologyHandlers::ResetProcessing,
+            handlers.histograms.reset_processing
+        );
+    }
+
+    int worker_thread_count;
+    physiology::Physiology::AsyncService service;
+    StreamingPhysiologyService streaming_service;
+    std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> completion_queues;
+    std::unique_ptr<grpc::Server> server;
+    std::vector<std::thread> workers;
+    std::atomic<bool> shutting_down{false};
+    examples::LatencyHistogram issue_blue_tooth_histogram;
+};
+// endregion ===========================================================================================================
+
+// region ===================================== Load generation ========================================================
+struct LoadGeneratorSettings {
+    std::string target;
+    int client_count = 1;
+    int duration_seconds = 10;
+    double frame_rate = 30.0;
+    double buffer_duration = 0.5;
+    int face_landmark_count = 478;
+    int roi_count = 8;
+    int tracked_point_count = 64;
+    bool streaming = false;
+    int stream_batch_frames = 5;
+    int stream_batch_interval_ms = 100;
+    int stream_max_in_flight = 4;
+};
+
+struct LoadStatistics {
+    RpcHistograms rpc_histograms;
+    // from the scheduled capture time of a frame to the arrival of the metrics that followed the buffer / batch with it
+    examples::LatencyHistogram end_to_end;
+    std::atomic<int64_t> buffer_count{0};
+    std::atomic<int64_t> frame_count{0};
+    std::atomic<int64_t> failed_call_count{0};
+    // time the capture loop was held up by streaming backpressure
+    std::atomic<int64_t> capture_stall_us{0};
+};
+
+// Simulated capture: produces preprocessed frames (all alike, save for the time) at the given frame rate, or as fast as
+// they are asked for when the frame rate is 0.
+class FrameCapture {
+public:
+    explicit FrameCapture(const LoadGeneratorSettings& settings) : frame_rate(settings.frame_rate) {
+        std::mt19937 generator(0);
+        std::uniform_int_distribution<int> pixel(0, 719);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (int i_landmark = 0; i_landmark < settings.face_landmark_count; i_landmark++) {
+            auto* landmark = hr_frame.add_face_landmark();
+            landmark->set_x(pixel(generator));
+            landmark->set_y(pixel(generator));
+        }
+        // the face average comes first, then the regions of interest
+        for (int i_roi = 0; i_roi < settings.roi_count + 1; i_roi++) {
+            auto* roi = hr_frame.add_roi_bgr_average();
+            roi->set_x(unit(generator) * 255.0f);
+            roi->set_y(unit(generator) * 255.0f);
+            roi->set_z(unit(generator) * 255.0f);
+        }
+        for (int i_point = 0; i_point < settings.tracked_point_count; i_point++) {
+            auto* point = rr_frame.add_tracked_point();
+            point->set_x(unit(generator) * 1280.0f);
+            point->set_y(unit(generator) * 720.0f);
+            rr_frame.add_tracked_point_label(i_point % 4);
+        }
+        if (frame_rate > 0.0) {
+            frame_interval = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(1.0 / frame_rate)
+            );
+        }
+    }
+
+    // Waits for the next frame to be due, appends it to `buffer`, and returns the time it was due at.
+    Clock::time_point CaptureInto(physiology::PreprocessedDataBuffer& buffer) {
+        Clock::time_point capture_time = Clock::now();
+        if (frame_interval > Clock::duration::zero()) {
+            if (frame_index == 0) {
+                next_capture_time = capture_time;
+            }
+            std::this_thread::sleep_until(next_capture_time);
+            capture_time = next_capture_time;
+            next_capture_time += frame_interval;
+        }
+        const double time_now = static_cast<double>(frame_index) / (frame_rate > 0.0 ? frame_rate : 30.0);
+        frame_index++;
+        auto* hr_data = buffer.add_hr_data();
+        *hr_data = hr_frame;
+        hr_data->set_time_now(time_now);
+        auto* rr_data = buffer.add_rr_data();
+        *rr_data = rr_frame;
+        rr_data->set_time_now(time_now);
+        return capture_time;
+    }
+
+private:
+    physiology::HrPreprocessedFrameData hr_frame;
+    physiology::RrPreprocessedFrameData rr_frame;
+    double frame_rate;
+    Clock::duration frame_interval = Clock::duration::zero();
+    Clock::time_point next_capture_time;
+    int64_t frame_index = 0;
+};
+
+void RecordMetricsArrival(const std::vector<Clock::time_point>& capture_times, LoadStatistics& statistics) {
+    const auto arrival_time = Clock::now();
+    for (const auto& capture_time: capture_times) {
+        statistics.end_to_end.Record(arrival_time - capture_time);
+    }
+    statistics.buffer_count++;
+    statistics.frame_count += static_cast<int64_t>(capture_times.size());
+}
+
+// Unary mode, as the gRPC continuous container does it: AddPreprocessedData once a buffer's worth of frames is
+// captured, then GetMetrics. Capture waits for both calls to return.
+void RunUnaryClient(
+    const LoadGeneratorSettings& settings,
+    const std::string& stream_id,
+    const std::shared_ptr<grpc::Channel>& channel,
+    Clock::time_point end,
+    LoadStatistics& statistics
+) {
+    auto stub = physiology::Physiology::NewStub(channel);
+    FrameCapture capture(settings);
+    const double frame_rate = settings.frame_rate > 0.0 ? settings.frame_rate : 30.0;
+    const int frames_per_buffer = std::max(1, static_cast<int>(settings.buffer_duration * frame_rate));
+    physiology::PreprocessedDataBuffer buffer;
+    std::vector<Clock::time_point> capture_times;
+    while (!stop_requested && Clock::now() < end) {
+        buffer.Clear();
+        capture_times.clear();
+        for (int i_frame = 0; i_frame < frames_per_buffer; i_frame++) {
+            capture_times.push_back(capture.CaptureInto(buffer));
+        }
+        google::protobuf::Empty empty;
+        physiology::MetricsBuffer metrics;
+        grpc::Status status;
+        {
+            grpc::ClientContext context;
+            context.AddMetadata(examples::kStreamIdMetadataKey, stream_id);
+            ScopedRpcTimer timer(statistics.rpc_histograms.add_preprocessed_data);
+            status = stub->AddPreprocessedData(&context, buffer, &empty);
+        }
+        if (status.ok()) {
+            grpc::ClientContext context;
+            context.AddMetadata(examples::kStreamIdMetadataKey, stream_id);
+            ScopedRpcTimer timer(statistics.rpc_histograms.get_metrics);
+            status = stub->GetMetrics(&context, google::protobuf::Empty(), &metrics);
+        }
+        if (!status.ok()) {
+            LOG_EVERY_N(WARNING, 100) << "RPC failed: " << status.error_message();
+            statistics.failed_call_count++;
+            continue;
+        }
+        RecordMetricsArrival(capture_times, statistics);
+    }
+}
+
+// Client side of a StreamPreprocessedData call. Batches are written one at a time in the order they are sent, and
+// the metrics that come back are matched to them in the same order.
+class PreprocessedDataStream : public grpc::ClientBidiReactor<grpc::ByteBuffer, grpc::ByteBuffer> {
+public:
+    PreprocessedDataStream(
+        grpc::GenericStub& stub,
+        const std::string& stream_id,
+        int max_in_flight,
+        LoadStatistics& statistics
+    ) : max_in_flight(static_cast<size_t>(std::max(1, max_in_flight))), statistics(statistics) {
+        context.AddMetadata(examples::kStreamIdMetadataKey, stream_id);
+        stub.PrepareBidiStreamingCall(&context, kStreamPreprocessedDataMethod, grpc::StubOptions(), this);
+        StartRead(&metrics_message);
+        StartCall();
+    }
+
+    // Queues `batch` to be written, first waiting (holding up capture) for as long as `max_in_flight` batches are
+    // waiting for their metrics. Returns false if the call has ended.
+    bool Send(const physiology::PreprocessedDataBuffer& batch, std::vector<Clock::time_point> capture_times) {
+        grpc::ByteBuffer message;
+        bool own_buffer = false;
+        grpc::SerializationTraits<physiology::PreprocessedDataBuffer>::Serialize(batch, &message, &own_buffer);
+        bool start_write = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            const auto wait_start = Clock::now();
+            state_changed.wait(lock, [this]() { return done || batches_in_flight.size() < max_in_flight; });
+            statistics.capture_stall_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                Clock::now() - wait_start
+            ).count();
+            if (done) {
+                return false;
+            }
+            batches_in_flight.push_back(BatchInFlight{Clock::now(), std::move(capture_times)});
+            pending_writes.push_back(std::move(message));
+            start_write = pending_writes.size() == 1;
+        }
+        if (start_write) {
+            StartWrite(&pending_writes.front());
+        }
+        return true;
+    }
+
+    // Ends the stream from the client side and waits for the metrics of all batches sent so far.
+    grpc::Status Finish() {
+        bool writes_done = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closing = true;
+            writes_done = pending_writes.empty();
+        }
+        if (writes_done) {
+            StartWritesDone();
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        state_changed.wait(lock, [this]() { return done; });
+        return final_status;
+    }
+
+    void OnWriteDone(bool ok) override {
+        bool start_write = false;
+        bool writes_done = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending_writes.pop_front();
+            if (!ok) {
+                // the call is broken, OnDone follows
+                return;
+            }
+            start_write = !pending_writes.empty();
+            writes_done = !start_write && closing;
+        }
+        if (start_write) {
+            StartWrite(&pending_writes.front());
+        } else if (writes_done) {
+            StartWritesDone();
+        }
+    }
+
+    void OnReadDone(bool ok) override {
+        if (!ok) {
+            return;
+        }
+        BatchInFlight batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (batches_in_flight.empty()) {
+                LOG(WARNING) << "Got metrics that do not follow any batch.";
+            } else {
+                batch = std::move(batches_in_flight.front());
+                batches_in_flight.pop_front();
+            }
+        }
+        state_changed.notify_all();
+        physiology::MetricsBuffer metrics;
+        if (!grpc::SerializationTraits<physiology::MetricsBuffer>::Deserialize(&metrics_message, &metrics).ok()) {
+            LOG_EVERY_N(WARNING, 100) << "Could not parse streamed metrics.";
+            statistics.failed_call_count++;
+        } else if (!batch.capture_times.empty()) {
+            statistics.rpc_histograms.stream_preprocessed_data.Record(Clock::now() - batch.send_time);
+            RecordMetricsArrival(batch.capture_times, statistics);
+        }
+        StartRead(&metrics_message);
+    }
+
+    void OnDone(const grpc::Status& status) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            final_status = status;
+            done = true;
+        }
+        state_changed.notify_all();
+    }
+
+private:
+    struct BatchInFlight {
+        Clock::time_point send_time;
+        std::vector<Clock::time_point> capture_times;
+    };
+
+    const size_t max_in_flight;
+    LoadStatistics& statistics;
+    grpc::ClientContext context;
+    grpc::ByteBuffer metrics_message;
+
+    std::mutex mutex;
+    std::condition_variable state_changed;
+    // references to deque elements stay valid as others are added or removed at the ends
+    std::deque<grpc::ByteBuffer> pending_writes;
+    std::deque<BatchInFlight> batches_in_flight;
+    bool closing = false;
+    bool done = false;
+    grpc::Status final_status;
+};
+
+// Streaming mode: frames go out in batches of up to `stream_batch_frames` frames or `stream_batch_interval_ms`,
+// whichever comes first, on one long-lived call that streams the metrics back. When `stream_max_in_flight` batches
+// are waiting for their metrics, capture waits (rather than frames getting dropped).
+void RunStreamingClient(
+    const LoadGeneratorSettings& settings,
+    const std::string& stream_id,
+    const std::shared_ptr<grpc::Channel>& channel,
+    Clock::time_point end,
+    LoadStatistics& statistics
+) {
+    grpc::GenericStub stub(channel);
+    PreprocessedDataStream stream(stub, stream_id, settings.stream_max_in_flight, statistics);
+    FrameCapture capture(settings);
+    const auto batch_interval = std::chrono::milliseconds(settings.stream_batch_interval_ms);
+    physiology::PreprocessedDataBuffer batch;
+    std::vector<Clock::time_point> capture_times;
+    bool stream_open = true;
+    while (stream_open && !stop_requested && Clock::now() < end) {
+        capture_times.push_back(capture.CaptureInto(batch));
+        if (static_cast<int>(capture_times.size()) >= settings.stream_batch_frames ||
+            Clock::now() - capture_times.front() >= batch_interval) {
+            stream_open = stream.Send(batch, std::move(capture_times));
+            batch.Clear();
+            capture_times.clear();
+        }
+    }
+    if (stream_open && !capture_times.empty()) {
+        stream.Send(batch, std::move(capture_times));
+    }
+    grpc::Status status = stream.Finish();
+    if (!status.ok()) {
+        LOG(WARNING) << "Stream failed: " << status.error_message();
+        statistics.failed_call_count++;
+    }
+}
+
+absl::Status RunLoadGenerator(const LoadGeneratorSettings& settings) {
+    LOG(INFO) << "Loading " << settings.target << " with " << settings.client_count << " "
+              << (settings.streaming ? "streaming" : "unary") << " clients for " << settings.duration_seconds << " s.";
+
+    LoadStatistics statistics;
+    const auto end = Clock::now() + std::chrono::seconds(settings.duration_seconds);
+    std::vector<std::thread> clients;
+    for (int i_client = 0; i_client < settings.client_count; i_client++) {
+        clients.emplace_back([&, i_client]() {
+            const std::string stream_id = absl::StrCat("load-", i_client);
+            // one channel per client, as with separate container processes
+            grpc::ChannelArguments channel_arguments;
+            channel_arguments.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+            auto channel = grpc::CreateCustomChannel(
+                settings.target, grpc::InsecureChannelCredentials(), channel_arguments
+            );
+            if (settings.streaming) {
+                RunStreamingClient(settings, stream_id, channel, end, statistics);
+            } else {
+                RunUnaryClient(settings, stream_id, channel, end, statistics);
+            }
+        });
+    }
+    const auto start = Clock::now();
+    for (auto& client: clients) {
+        client.join();
+    }
+    const double elapsed_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    LOG(INFO) << "Got metrics for " << statistics.buffer_count.load() << " buffers ("
+              << statistics.buffer_count.load() / elapsed_seconds << " buffers/s, "
+              << statistics.frame_count.load() / elapsed_seconds << " frames/s), "
+              << statistics.failed_call_count.load() << " failed calls.";
+    statistics.rpc_histograms.Log("Client-side");
+    LOG(INFO) << "Frame capture to metrics arrival: " << statistics.end_to_end.Summarize();
+    if (settings.streaming) {
+        LOG(INFO) << "Capture held up by backpressure for " << statistics.capture_stall_us.load() / 1000 << " ms.";
+    }
+    if (statistics.buffer_count.load() == 0 && statistics.failed_call_count.load() > 0) {
+        return absl::UnavailableError("All calls to " + settings.target + " failed.");
+    }
+    return absl::OkStatus();
+}
+// endregion ===========================================================================================================
+
+absl::Status RunStandInServer() {
+    const bool load_own_server = absl::GetFlag(FLAGS_load_clients) > 0 && absl::GetFlag(FLAGS_load_target).empty();
+    std::unique_ptr<StandInPhysiologyServer> server;
+    if (absl::GetFlag(FLAGS_load_clients) <= 0 || load_own_server) {
+        int worker_thread_count = absl::GetFlag(FLAGS_worker_threads);
+        if (worker_thread_count <= 0) {
+            worker_thread_count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        }
+        server = std::make_unique<StandInPhysiologyServer>(
+            MetricsGeneratorSettings{
+                absl::GetFlag(FLAGS_seed),
+                absl::GetFlag(FLAGS_constant_metrics),
+                absl::GetFlag(FLAGS_metrics_length_seconds)
+            },
+            worker_thread_count
+        );
+        MP_RETURN_IF_ERROR(server->Start(absl::GetFlag(FLAGS_port)));
+        LOG(INFO) << "Example Physio Core gRPC Server started, listening on port " << absl::GetFlag(FLAGS_port)
+                  << " with " << worker_thread_count << " worker threads.";
+    }
+
+    absl::Status status = absl::OkStatus();
+    if (absl::GetFlag(FLAGS_load_clients) > 0) {
+        status = RunLoadGenerator(LoadGeneratorSettings{
+            load_own_server ? absl::StrCat("localhost:", absl::GetFlag(FLAGS_port)) : absl::GetFlag(FLAGS_load_target),
+            absl::GetFlag(FLAGS_load_clients),
+            absl::GetFlag(FLAGS_load_duration),
+            absl::GetFlag(FLAGS_load_frame_rate),
+            absl::GetFlag(FLAGS_load_buffer_duration),
+            absl::GetFlag(FLAGS_load_face_landmark_count),
+            absl::GetFlag(FLAGS_load_roi_count),
+            absl::GetFlag(FLAGS_load_tracked_point_count),
+            absl::GetFlag(FLAGS_load_streaming),
+            absl::GetFlag(FLAGS_stream_batch_frames),
+            absl::GetFlag(FLAGS_stream_batch_interval_ms),
+            absl::GetFlag(FLAGS_stream_max_in_flight)
+        });
+    } else {
+        const auto report_interval = std::chrono::seconds(absl::GetFlag(FLAGS_report_interval));
+        auto next_report_time = Clock::now() + report_interval;
+        while (!stop_requested) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (report_interval.count() > 0 && Clock::now() >= next_report_time) {
+                server->handlers.LogStatistics();
+                next_report_time += report_interval;
+            }
+        }
+        LOG(INFO) << "Server stopped.";
+    }
+    if (server != nullptr) {
+        server->Shutdown();
+        server->handlers.LogStatistics();
+    }
+    return status;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    absl::SetProgramUsageMessage(
+        "A basic sample C++ application mimicking Physiology Core Server but producing random output, optionally "
+        "generating load for it (or for another server)."
+    );
+    absl::ParseCommandLine(argc, argv);
+    if (absl::GetFlag(FLAGS_also_log_to_stderr)) {
+        // work-around for built-in logging to stderr (for a more human-readable flag name)
+        FLAGS_alsologtostderr = true;
+    }
+    std::signal(SIGINT, HandleStopSignal);
+    std::signal(SIGTERM, HandleStopSignal);
+
+    absl::Status status = RunStandInServer();
+
+    if (!status.ok()) {
+        LOG(ERROR) << "Run failed. " << status.message();
+        return EXIT_FAILURE;
+    } else {
+        LOG(INFO) << "Success!";
+    }
+    return 0;
+}
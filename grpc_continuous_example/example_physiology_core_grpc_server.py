@@ -211,13 +211,16 @@ def main():
                         help="Port number to expect the Physiology Server to service from.")
     parser.add_argument("--seed", "-s", type=int, default=-1,
                         help="Seed to use to randomize the outputs")
+    parser.add_argument("--max_workers", "-w", type=int, default=4,
+                        help="Number of threads serving calls, i.e. of calls (from any number of clients) served "
+                             "at the same time.")
     args = parser.parse_args()
     logging.basicConfig()
 
     print(f"Random seed set to {args.seed}")
 
     port = args.port
-    server = grpc.server(futures.ThreadPoolExecutor(max_workers=1))
+    server = grpc.server(futures.ThreadPoolExecutor(max_workers=args.max_workers))
     ps_grpc.add_PhysiologyServicer_to_server(
         DummyPhysiologyServer(args.seed != -1, args.seed, use_uniform=False), server
     )
@@ -1,21 +1,45 @@
 // stdlib includes
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 // third-party includes
 #include <physiology/interface/absl/status/status.h>
 #include <physiology/interface/absl/flags/flag.h>
 #include <physiology/interface/absl/flags/parse.h>
 #include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/absl/strings/str_cat.h>
 #include <physiology/interface/glog/logging.h>
+#include <google/protobuf/util/json_util.h>
 #include <smartspectra/container/settings.hpp>
 #include <smartspectra/video_source/camera/camera.hpp>
 #include <smartspectra/container/foreground_container.hpp>
 
+// local includes
+#include "common/adaptive_pacing.hpp"
+#include "common/core_stream_relay.hpp"
+#include "common/frame_source_container.hpp"
+#include "common/input_reduction.hpp"
+#include "common/metrics_binary_file.hpp"
+#include "common/metrics_delta.hpp"
+#include "common/metrics_store.hpp"
+#include "common/offline_video_source.hpp"
+#include "common/pipeline_metrics.hpp"
+#include "common/startup_profile.hpp"
+#include "common/threaded_video_sink.hpp"
+
 
 namespace pcam = presage::camera;
 namespace spectra = presage::smartspectra;
 namespace settings = presage::smartspectra::container::settings;
 namespace vs = presage::smartspectra::video_source;
+namespace examples = presage::smartspectra::examples;
 
 // region ========================================= CAMERA SETTINGS ====================================================
 ABSL_FLAG(int, camera_device_index, 0, "The index of the camera device to use in streaming capture mode.");
@@ -60,6 +84,23 @@ ABSL_FLAG(int, interframe_delay, 20,
           "Delay, in milliseconds, before capturing the next frame: "
           "higher values may free up more processing capacity for the graph, i.e. give it more time to process what it "
           "already has and drop fewer frames, resulting in more robust output metrics.");
+ABSL_FLAG(bool, adaptive_interframe_delay, false,
+          "If true, `--interframe_delay` is only where the delay starts: it is then adjusted on the fly, growing while "
+          "the per-frame processing time is over `--pacing_target_processing_ms` (i.e. the graph is falling behind), "
+          "and shrinking while more than `--pacing_target_drop_rate` of the input frames are dropped. The delay and "
+          "dropped-frame counts are logged every few seconds.");
+ABSL_FLAG(double, pacing_target_processing_ms, 0.0,
+          "Per-frame processing time to stay under with `--adaptive_interframe_delay`. When 0, 80% of the input frame "
+          "interval.");
+ABSL_FLAG(double, pacing_target_drop_rate, 0.01,
+          "Fraction of input frames that may be dropped with `--adaptive_interframe_delay` before the delay is cut. "
+          "Not used for inputs without exact frame timestamps, whose dropped frames cannot be told apart.");
+ABSL_FLAG(int, pipeline_stats_interval, 10,
+          "Interval, in seconds, at which per-stage pipeline latencies (frame capture, processing, frame to metrics), "
+          "frame rates and dropped-frame counts are logged as one JSON line. When 0, they are not logged.");
+ABSL_FLAG(uint16_t, pipeline_stats_port, 0,
+          "When non-zero, the pipeline stats are also served in the Prometheus text format at "
+          "http://127.0.0.1:<port>/metrics.");
 ABSL_FLAG(bool,
           start_with_recording_on,
           false,
@@ -70,9 +111,25 @@ ABSL_FLAG(int, start_time_offset_ms, 0,
           "Not functional for streaming mode, as start is disabled until this offset.");
 ABSL_FLAG(bool, scale_input, true,
           "If true, uses input scaling in the ImageTransformationCalculator within the graph.");
+ABSL_FLAG(int, input_max_width, 0,
+          "If positive, input frames (after cropping to `--input_region_of_interest`) wider than this are downsampled "
+          "to fit, keeping their aspect ratio, before they enter the graph. 0: no limit.");
+ABSL_FLAG(int, input_max_height, 0,
+          "If positive, input frames (after cropping to `--input_region_of_interest`) taller than this are downsampled "
+          "to fit, keeping their aspect ratio, before they enter the graph. 0: no limit.");
+ABSL_FLAG(std::string, input_region_of_interest, "",
+          "If set, as <x>,<y>,<width>,<height> in input frame pixels, input frames are cropped to this region before "
+          "they enter the graph (e.g. to the part of the scene where the subject is).");
 ABSL_FLAG(bool, enable_phasic_bp, false, "If true, enable the phasic blood pressure computation.");
 ABSL_FLAG(bool, print_graph_contents, false, "If true, print the graph contents.");
 ABSL_FLAG(int, verbosity, 1, "Verbosity level -- raise to print more.");
+ABSL_FLAG(bool, startup_profile, false,
+          "If true, log how long it took from process start to the first processed frame, broken down into flag "
+          "parsing, container initialization (graph setup and, unless initialized early, the video source), graph "
+          "start (with model loading), first frame capture and first frame processing (see README).");
+ABSL_FLAG(bool, early_video_source_initialization, false,
+          "If true, initialize the video source (opening the camera and, with `--auto_lock`, settling its exposure, "
+          "or opening the input) on a thread of its own, alongside the graph setup, instead of after it.");
 
 // === continuous settings ===
 ABSL_FLAG(double, buffer_duration, 0.5,
@@ -80,6 +137,51 @@ ABSL_FLAG(double, buffer_duration, 0.5,
           "Shorter values will mean more frequent updates and higher Core processing loads.");
 // === grpc settings ==-
 ABSL_FLAG(uint16_t, core_port, 50052, "The port to use to communicate with the gRPC Physiology Core server.");
+// === offline processing settings ===
+ABSL_FLAG(bool, offline, false,
+          "If true, process `--input_video_path` (in headless mode) as fast as possible instead of at the pace it was "
+          "recorded at: frames are read as soon as the graph asks for them, timestamped with their time in the video, "
+          "and only held up while the metrics from Core lag more than `--offline_max_lag` seconds behind.");
+ABSL_FLAG(double, offline_max_lag, 3.0,
+          "How far, in seconds of video, frames may be read ahead of the latest metrics in `--offline` mode.");
+ABSL_FLAG(int, offline_segments, 1,
+          "Number of consecutive segments to split the video into in `--offline` mode, processed at the same time on "
+          "separate pipelines (talking to Core as separate streams, through local relay ports starting at "
+          "`--relay_base_port`). Their metrics are stitched back together. Core has to keep its processing state per "
+          "stream ID (`x-presage-stream-id` metadata) for this, so more than one segment also requires "
+          "`--core_supports_stream_ids`.");
+ABSL_FLAG(double, segment_overlap, 10.0,
+          "Seconds of video each segment (but the first) starts reading ahead of its own part in `--offline` mode, "
+          "for its metrics to have settled by then. Metrics from the overlap are dropped when stitching.");
+ABSL_FLAG(uint16_t, relay_base_port, 50070,
+          "Segment i of a segmented `--offline` run talks to Core through local port relay_base_port + i.");
+ABSL_FLAG(bool, core_supports_stream_ids, false,
+          "Set to confirm that the Core behind `--core_port` keeps its processing state per stream ID "
+          "(`x-presage-stream-id` call metadata). Stock Core builds do not, and would mix the segments' data up, so "
+          "`--offline_segments` above 1 is refused unless this is set.");
+ABSL_FLAG(std::string, offline_metrics_path, "",
+          "When non-empty, the whole metrics history of an `--offline` run (stitched together from all segments) is "
+          "saved to this JSON file.");
+// === metrics output settings ===
+ABSL_FLAG(std::string, metrics_delta_path, "",
+          "When non-empty, write each metrics buffer received from Core to this NDJSON file (replacing its contents) "
+          "as a delta, i.e. holding only the measurements that are new since the previous buffer, with a full "
+          "snapshot every `--full_snapshot_interval` buffers for consumers to resync from (see README).");
+ABSL_FLAG(int, full_snapshot_interval, 20,
+          "Number of outputs between full snapshots in the `--metrics_delta_path` stream. When 0, only the first "
+          "output is a full snapshot.");
+ABSL_FLAG(std::string, metrics_binary_directory, "",
+          "When non-empty, also save each metrics output to this directory as a compact binary metrics file "
+          "(metrics_<timestamp_us>.ssmb, see docs/metrics_binary_format.md).");
+ABSL_FLAG(bool, metrics_store, false,
+          "If true, keep every metrics series received from Core in an in-process, time-indexed store with 1 s, 10 s "
+          "and 60 s rollups, for range queries over the whole run at http://127.0.0.1:<pipeline_stats_port>/series "
+          "(see README). Not used with `--offline`.");
+ABSL_FLAG(int, metrics_store_memory_mb, 64,
+          "Memory, in MiB, that `--metrics_store` series may take up before the oldest measurements are spilled to "
+          "disk. When 0, nothing is spilled.");
+ABSL_FLAG(std::string, metrics_store_spill_directory, "",
+          "Directory for the `--metrics_store` spill file. When empty, the system's temporary directory.");
 // region =========================== VIDEO OUTPUT SETTINGS ============================================================
 ABSL_FLAG(std::string, output_video_destination, "",
           "Full path of video to save or gstreamer output configuration string (see mode documentation). "
@@ -95,18 +197,339 @@ ABSL_FLAG(bool, passthrough_video, false,
           "If true, output video will just use the input video frames directly (see destination "
           "documentation), without passing through any processing "
           "(which might contain rendered visual content from the graph).");
+ABSL_FLAG(bool, threaded_video_sink, true,
+          "If true, `--passthrough_video` output is encoded on a thread of its own, off the processing path, with "
+          "frames queued for it (and dropped as per `--video_sink_drop_policy` when the encoder falls behind). "
+          "Encoding times and dropped frames are part of the pipeline stats. Not used with `--offline`.");
+ABSL_FLAG(int, video_sink_queue_size, 32, "Number of frames that can wait for the `--threaded_video_sink` encoder.");
+ABSL_FLAG(examples::VideoSinkDropPolicy, video_sink_drop_policy, examples::VideoSinkDropPolicy::DropOldest,
+          "What `--threaded_video_sink` does with frames when the encoder falls behind. Possible values: "
+          + absl::StrJoin(examples::GetVideoSinkDropPolicyNames(), ", "));
+ABSL_FLAG(int, video_sink_drop_every_nth, 2,
+          "With `--video_sink_drop_policy=drop_every_nth`, every n-th frame is dropped while the encoder is behind.");
+ABSL_FLAG(double, video_sink_frame_rate, 30.0, "Frame rate written into the `--threaded_video_sink` output video.");
 // endregion ===========================================================================================================
 
-absl::Status RunGrpcContinuousPreprocessing(
-    settings::Settings<settings::OperationMode::Continuous, settings::IntegrationMode::Grpc>& settings
+examples::AdaptivePacingSettings GetAdaptivePacingSettings() {
+    return examples::AdaptivePacingSettings{
+        absl::GetFlag(FLAGS_adaptive_interframe_delay),
+        absl::GetFlag(FLAGS_interframe_delay),
+        /*min_delay_ms=*/0,
+        /*max_delay_ms=*/100,
+        absl::GetFlag(FLAGS_pacing_target_processing_ms),
+        absl::GetFlag(FLAGS_pacing_target_drop_rate)
+    };
+}
+
+// Whether the input frames are written out by a ThreadedVideoSink here rather than by the SDK's video sink.
+bool UseThreadedVideoSink() {
+    return absl::GetFlag(FLAGS_threaded_video_sink) && absl::GetFlag(FLAGS_passthrough_video) &&
+           !absl::GetFlag(FLAGS_output_video_destination).empty() && !absl::GetFlag(FLAGS_offline);
+}
+
+// Starts the sink for `--threaded_video_sink`, or returns null when it is not used.
+absl::StatusOr<std::unique_ptr<examples::ThreadedVideoSink>> StartThreadedVideoSink(
+    examples::PipelineMetrics* pipeline_metrics
+) {
+    if (!UseThreadedVideoSink()) {
+        return nullptr;
+    }
+    return examples::ThreadedVideoSink::Start(examples::ThreadedVideoSinkSettings{
+        absl::GetFlag(FLAGS_output_video_destination),
+        absl::UnparseFlag(absl::GetFlag(FLAGS_video_sink_mode)) == "gstreamer",
+        /*fourcc=*/"MJPG",
+        absl::GetFlag(FLAGS_video_sink_frame_rate),
+        static_cast<size_t>(std::max(0, absl::GetFlag(FLAGS_video_sink_queue_size))),
+        absl::GetFlag(FLAGS_video_sink_drop_policy),
+        absl::GetFlag(FLAGS_video_sink_drop_every_nth),
+        pipeline_metrics
+    });
+}
+
+examples::InputReductionSettings GetInputReductionSettings(examples::PipelineMetrics* pipeline_metrics) {
+    return examples::InputReductionSettings{
+        absl::GetFlag(FLAGS_input_max_width),
+        absl::GetFlag(FLAGS_input_max_height),
+        // validated in main()
+        examples::ParseRegionOfInterest(absl::GetFlag(FLAGS_input_region_of_interest)).value_or(cv::Rect()),
+        pipeline_metrics
+    };
+}
+
+// Runs on `segment` of the input video, reading frames as fast as the pipeline gets through them, and builds up the
+// whole metrics history in `history`.
+absl::Status RunOfflineSegment(
+    settings::Settings<settings::OperationMode::Continuous, settings::IntegrationMode::Grpc> settings,
+    const examples::VideoFileSegment& segment,
+    uint16_t core_port,
+    examples::PipelineMetrics& pipeline_metrics,
+    presage::physiology::MetricsBuffer& history
 ) {
-    spectra::container::CpuContinuousGrpcForegroundContainer container(settings);
+    settings.integration = settings::GrpcSettings{core_port};
+    examples::OutputBackpressure backpressure(examples::OutputBackpressureSettings{
+        absl::GetFlag(FLAGS_offline_max_lag)
+    });
+    examples::InstrumentedContainer<examples::InputReductionContainer<
+        examples::FrameSourceContainer<spectra::container::CpuContinuousGrpcForegroundContainer>
+    >> container(
+        &pipeline_metrics,
+        GetInputReductionSettings(&pipeline_metrics),
+        settings,
+        std::make_unique<examples::BackpressuredFrameSource>(
+            std::make_unique<examples::VideoFileFrameSource>(settings.video_source.input_video_path, segment),
+            backpressure
+        )
+    );
+    container.OnCoreMetricsOutput = [&container, &backpressure, &history](
+        const presage::physiology::MetricsBuffer& metrics, int64_t timestamp_us
+    ) {
+        container.RecordMetricsOutput(timestamp_us);
+        backpressure.OnOutput(timestamp_us);
+        examples::MergeMetricsSeries(metrics, history);
+        return absl::OkStatus();
+    };
     MP_RETURN_IF_ERROR(container.Initialize());
+    MP_RETURN_IF_ERROR(container.Run());
+    LOG(INFO) << "Segment from " << segment.start_us / 1e6 << " s done, metrics backpressure: "
+              << backpressure.Summarize();
+    if (container.IsInputReductionEnabled()) {
+        LOG(INFO) << "Input reduction: " << container.GetInputReducer().Summarize();
+    }
+    return absl::OkStatus();
+}
 
-    return container.Run();
+absl::Status SaveMetricsHistory(const presage::physiology::MetricsBuffer& history, const std::string& path) {
+    std::string history_json;
+    google::protobuf::util::JsonPrintOptions json_options;
+    json_options.preserve_proto_field_names = true;
+    const auto conversion_status = google::protobuf::util::MessageToJsonString(history, &history_json, json_options);
+    if (!conversion_status.ok()) {
+        return absl::InternalError(absl::StrCat("Could not convert metrics to JSON: ", conversion_status.ToString()));
+    }
+    std::ofstream file(path);
+    file << history_json << std::endl;
+    if (file.fail()) {
+        return absl::InternalError("Could not save the metrics history to " + path);
+    }
+    return absl::OkStatus();
+}
+
+absl::Status RunOfflinePreprocessing(
+    settings::Settings<settings::OperationMode::Continuous, settings::IntegrationMode::Grpc>& settings
+) {
+    examples::PipelineMetrics pipeline_metrics;
+    auto reporter_or_status = examples::PipelineMetricsReporter::Start(
+        pipeline_metrics,
+        examples::PipelineMetricsReporterSettings{
+            absl::GetFlag(FLAGS_pipeline_stats_interval),
+            absl::GetFlag(FLAGS_pipeline_stats_port)
+        }
+    );
+    if (!reporter_or_status.ok()) {
+        return reporter_or_status.status();
+    }
+    const int segment_count = std::max(1, absl::GetFlag(FLAGS_offline_segments));
+    if (segment_count > 1 && !absl::GetFlag(FLAGS_core_supports_stream_ids)) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "--offline_segments=", segment_count, " needs a Core that keeps its processing state per ",
+            examples::kStreamIdMetadataKey, " metadata value; pass --core_supports_stream_ids if it does."
+        ));
+    }
+    int64_t duration_us = 0;
+    if (segment_count > 1) {
+        auto duration_or_status = examples::GetVideoFileDurationUs(settings.video_source.input_video_path);
+        if (!duration_or_status.ok()) {
+            return duration_or_status.status();
+        }
+        duration_us = duration_or_status.value();
+    }
+    const std::vector<examples::OverlappingVideoSegment> segments = examples::SplitVideoFile(
+        duration_us, segment_count, static_cast<int64_t>(absl::GetFlag(FLAGS_segment_overlap) * 1e6)
+    );
+
+    // each segment's metrics are kept from where its own part starts, past the overlap it read to warm up
+    std::vector<examples::SegmentMetrics> segment_metrics(segments.size());
+    for (size_t i_segment = 0; i_segment < segments.size(); i_segment++) {
+        const examples::OverlappingVideoSegment& segment = segments[i_segment];
+        segment_metrics[i_segment].read_start_s = static_cast<double>(segment.read.start_us) / 1e6;
+        if (i_segment > 0) {
+            segment_metrics[i_segment].keep_from_s = static_cast<double>(segment.keep_from_us) / 1e6;
+        }
+        if (segment.keep_until_us >= 0) {
+            segment_metrics[i_segment].keep_until_s = static_cast<double>(segment.keep_until_us) / 1e6;
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    if (segments.size() == 1) {
+        MP_RETURN_IF_ERROR(RunOfflineSegment(
+            settings, segments[0].read, absl::GetFlag(FLAGS_core_port), pipeline_metrics, segment_metrics[0].metrics
+        ));
+    } else {
+        // segments are kept apart by the stream IDs the relay tags their calls with
+        examples::CoreStreamRelay relay(absl::StrCat("localhost:", absl::GetFlag(FLAGS_core_port)));
+        std::vector<absl::Status> statuses(segments.size());
+        std::vector<std::thread> segment_threads;
+        for (size_t i_segment = 0; i_segment < segments.size(); i_segment++) {
+            const auto relay_port = static_cast<uint16_t>(absl::GetFlag(FLAGS_relay_base_port) + i_segment);
+            statuses[i_segment] = relay.AddStream(absl::StrCat("segment-", i_segment), relay_port);
+            if (!statuses[i_segment].ok()) {
+                continue;
+            }
+            segment_threads.emplace_back([&, i_segment, relay_port]() {
+                statuses[i_segment] = RunOfflineSegment(
+                    settings, segments[i_segment].read, relay_port, pipeline_metrics,
+                    segment_metrics[i_segment].metrics
+                );
+            });
+        }
+        for (auto& segment_thread: segment_threads) {
+            segment_thread.join();
+        }
+        relay.Shutdown();
+        relay.LogStatistics();
+        for (size_t i_segment = 0; i_segment < segments.size(); i_segment++) {
+            if (!statuses[i_segment].ok()) {
+                return absl::Status(statuses[i_segment].code(), absl::StrCat(
+                    "Segment ", i_segment, " failed: ", statuses[i_segment].message()
+                ));
+            }
+        }
+    }
+    const double wall_time_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const presage::physiology::MetricsBuffer history = examples::StitchSegmentMetrics(segment_metrics);
+    LOG(INFO) << "Processed " << settings.video_source.input_video_path << " in " << wall_time_s << " s over "
+              << segments.size() << " segment(s): " << history.pulse().rate_size() << " pulse rate and "
+              << history.breath().rate_size() << " breathing rate measurements.";
+    if (!absl::GetFlag(FLAGS_offline_metrics_path).empty()) {
+        MP_RETURN_IF_ERROR(SaveMetricsHistory(history, absl::GetFlag(FLAGS_offline_metrics_path)));
+    }
+    return absl::OkStatus();
+}
+
+// Creates the store for `--metrics_store`, or returns null when it is off.
+absl::StatusOr<std::unique_ptr<examples::MetricsStore>> CreateMetricsStore() {
+    if (!absl::GetFlag(FLAGS_metrics_store)) {
+        return nullptr;
+    }
+    examples::MetricsStoreSettings store_settings;
+    const int memory_mb = std::max(0, absl::GetFlag(FLAGS_metrics_store_memory_mb));
+    store_settings.max_resident_bytes = static_cast<size_t>(memory_mb) << 20;
+    store_settings.spill_directory = absl::GetFlag(FLAGS_metrics_store_spill_directory);
+    store_settings.reset_time_step_s = absl::GetFlag(FLAGS_buffer_duration);
+    return examples::MetricsStore::Create(store_settings);
+}
+
+absl::Status RunGrpcContinuousPreprocessing(
+    settings::Settings<settings::OperationMode::Continuous, settings::IntegrationMode::Grpc>& settings,
+    examples::StartupProfile& startup_profile
+) {
+    if (absl::GetFlag(FLAGS_offline)) {
+        return RunOfflinePreprocessing(settings);
+    }
+    // created first, since the reporter serves queries of it for as long as it runs
+    auto metrics_store_or_status = CreateMetricsStore();
+    if (!metrics_store_or_status.ok()) {
+        return metrics_store_or_status.status();
+    }
+    const std::unique_ptr<examples::MetricsStore> metrics_store = std::move(metrics_store_or_status).value();
+    examples::PipelineMetrics pipeline_metrics;
+    examples::PipelineMetricsReporterSettings reporter_settings{
+        absl::GetFlag(FLAGS_pipeline_stats_interval),
+        absl::GetFlag(FLAGS_pipeline_stats_port)
+    };
+    if (metrics_store != nullptr) {
+        reporter_settings.json_endpoints["/series"] = [&metrics_store](std::string_view query) {
+            return examples::QueryMetricsStoreJson(*metrics_store, query);
+        };
+    }
+    auto reporter_or_status = examples::PipelineMetricsReporter::Start(pipeline_metrics, reporter_settings);
+    if (!reporter_or_status.ok()) {
+        return reporter_or_status.status();
+    }
+    auto video_sink_or_status = StartThreadedVideoSink(&pipeline_metrics);
+    if (!video_sink_or_status.ok()) {
+        return video_sink_or_status.status();
+    }
+    const std::unique_ptr<examples::ThreadedVideoSink> video_sink = std::move(video_sink_or_status).value();
+    examples::StartupContainer<examples::PacedContainer<examples::InstrumentedContainer<examples::RecordedContainer<
+        examples::InputReductionContainer<spectra::container::CpuContinuousGrpcForegroundContainer>
+    >>>> container(
+        absl::GetFlag(FLAGS_startup_profile) ? &startup_profile : nullptr,
+        GetAdaptivePacingSettings(),
+        &pipeline_metrics,
+        video_sink.get(),
+        GetInputReductionSettings(&pipeline_metrics),
+        settings
+    );
+    std::unique_ptr<examples::MetricsDeltaWriter> metrics_delta_writer;
+    if (!absl::GetFlag(FLAGS_metrics_delta_path).empty()) {
+        auto writer_or_status = examples::MetricsDeltaWriter::Open(
+            absl::GetFlag(FLAGS_metrics_delta_path),
+            examples::MetricsDeltaSettings{absl::GetFlag(FLAGS_full_snapshot_interval)}
+        );
+        if (!writer_or_status.ok()) {
+            return writer_or_status.status();
+        }
+        metrics_delta_writer = std::move(writer_or_status).value();
+    }
+    const std::filesystem::path metrics_binary_directory = absl::GetFlag(FLAGS_metrics_binary_directory);
+    if (!metrics_binary_directory.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(metrics_binary_directory, error);
+        if (error) {
+            return absl::InternalError(
+                "Could not create " + metrics_binary_directory.string() + ": " + error.message()
+            );
+        }
+    }
+    container.OnCoreMetricsOutput = [&container, &metrics_delta_writer, &metrics_store, &metrics_binary_directory](
+        const presage::physiology::MetricsBuffer& metrics, int64_t timestamp_us
+    ) {
+        container.RecordMetricsOutput(timestamp_us);
+        if (metrics_store != nullptr) {
+            MP_RETURN_IF_ERROR(metrics_store->Append(metrics));
+        }
+        if (!metrics_binary_directory.empty()) {
+            MP_RETURN_IF_ERROR(examples::WriteMetricsBinaryFile(
+                metrics_binary_directory
+                    / absl::StrCat("metrics_", timestamp_us, examples::kMetricsBinaryFileExtension),
+                examples::ToColumns(metrics),
+                examples::MetricsColumnEncoding::DeltaVarint
+            ));
+        }
+        if (metrics_delta_writer != nullptr) {
+            return metrics_delta_writer->Write(metrics, timestamp_us);
+        }
+        return absl::OkStatus();
+    };
+    if (absl::GetFlag(FLAGS_early_video_source_initialization)) {
+        container.StartVideoSourceInitialization();
+    }
+    MP_RETURN_IF_ERROR(container.Initialize());
+    startup_profile.Mark("container_initialized");
+    MP_RETURN_IF_ERROR(container.Run());
+    if (video_sink != nullptr) {
+        MP_RETURN_IF_ERROR(video_sink->Close());
+        LOG(INFO) << "Video sink: " << video_sink->Summarize();
+    }
+    if (metrics_store != nullptr) {
+        LOG(INFO) << "Metrics store: " << metrics_store->Summarize();
+    }
+    if (absl::GetFlag(FLAGS_adaptive_interframe_delay)) {
+        LOG(INFO) << "Adaptive interframe delay: " << container.GetPacer().Summarize();
+    }
+    if (container.IsInputReductionEnabled()) {
+        LOG(INFO) << "Input reduction: " << container.GetInputReducer().Summarize();
+    }
+    return absl::OkStatus();
 }
 
 int main(int argc, char** argv) {
+    // from the start, since whether it is logged is only known once the flags are parsed
+    examples::StartupProfile startup_profile;
+    startup_profile.Mark("main");
     google::InitGoogleLogging(argv[0]);
 
     absl::SetProgramUsageMessage(
@@ -114,6 +537,7 @@ int main(int argc, char** argv) {
         "Requires the Presage Physiology gRPC Server to be running on the same machine."
     );
     absl::ParseCommandLine(argc, argv);
+    startup_profile.Mark("flags_parsed");
     if (absl::GetFlag(FLAGS_also_log_to_stderr)) {
         // work-around for built-in logging to stderr (for a more human-readable flag name)
         FLAGS_alsologtostderr = true;
@@ -130,13 +554,17 @@ int main(int argc, char** argv) {
             absl::GetFlag(FLAGS_auto_lock),
             absl::GetFlag(FLAGS_input_video_path),
         },
-        settings::VideoSinkSettings{
+        // with `--threaded_video_sink`, the input frames are written out by the sink set up around the container
+        UseThreadedVideoSink() ? settings::VideoSinkSettings{} : settings::VideoSinkSettings{
             absl::GetFlag(FLAGS_output_video_destination),
             absl::GetFlag(FLAGS_video_sink_mode),
             absl::GetFlag(FLAGS_passthrough_video)
         },
         absl::GetFlag(FLAGS_headless),
-        absl::GetFlag(FLAGS_interframe_delay),
+        // with adaptive pacing, the container only waits the minimum and the paced video source does the rest;
+        // offline, frames are not paced at all
+        absl::GetFlag(FLAGS_adaptive_interframe_delay) || absl::GetFlag(FLAGS_offline)
+        ? 1 : absl::GetFlag(FLAGS_interframe_delay),
         absl::GetFlag(FLAGS_start_with_recording_on),
         absl::GetFlag(FLAGS_start_time_offset_ms),
         absl::GetFlag(FLAGS_scale_input),
@@ -156,8 +584,21 @@ int main(int argc, char** argv) {
         LOG(ERROR) << "Cannot use headless mode without loading video. Run with --help=main to see usage.";
         exit(-1);
     }
+    if (absl::GetFlag(FLAGS_offline) && (!settings.headless || settings.video_source.input_video_path.empty())) {
+        LOG(ERROR) << "Offline mode requires headless mode and a video to load. Run with --help=main to see usage.";
+        exit(-1);
+    }
+    if (auto region_or_status = examples::ParseRegionOfInterest(absl::GetFlag(FLAGS_input_region_of_interest));
+        !region_or_status.ok()) {
+        LOG(ERROR) << region_or_status.status().message() << " Run with --help=main to see usage.";
+        exit(-1);
+    }
+    if (absl::GetFlag(FLAGS_offline) && absl::GetFlag(FLAGS_adaptive_interframe_delay)) {
+        LOG(WARNING) << "Frames are not paced in offline mode, ignoring --adaptive_interframe_delay.";
+    }
 
-    absl::Status status = RunGrpcContinuousPreprocessing(settings);
+    startup_profile.Mark("settings_built");
+    absl::Status status = RunGrpcContinuousPreprocessing(settings, startup_profile);
 
     if (!status.ok()) {
         LOG(ERROR) << "Run failed. " << status.message();
@@ -0,0 +1,349 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+
+// third-party includes
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/status/statusor.h>
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/absl/strings/numbers.h>
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/absl/strings/str_split.h>
+#include <physiology/interface/glog/logging.h>
+#include <physiology/modules/filesystem_absl.h>
+#include <smartspectra/container/settings.hpp>
+#include <smartspectra/video_source/camera/camera.hpp>
+#include <smartspectra/container/foreground_container.hpp>
+
+// local includes
+#include "common/adaptive_pacing.hpp"
+#include "common/core_stream_relay.hpp"
+#include "common/metrics_delta.hpp"
+
+namespace pcam = presage::camera;
+namespace spectra = presage::smartspectra;
+namespace settings = presage::smartspectra::container::settings;
+namespace vs = presage::smartspectra::video_source;
+namespace examples = presage::smartspectra::examples;
+
+// region ========================================= STREAM SETTINGS ====================================================
+ABSL_FLAG(std::vector<std::string>, input_video_paths, {},
+          "Comma-separated paths of videos to run a stream on each, e.g. to simulate several cameras.");
+ABSL_FLAG(std::vector<std::string>, camera_device_indices, {},
+          "Comma-separated indices of camera devices to run a stream on each (after the `--input_video_paths` "
+          "streams, if any).");
+ABSL_FLAG(std::vector<std::string>, stream_ids, {},
+          "Comma-separated IDs of the streams, in the order above, under which Core tells them apart. "
+          "Defaults to stream0, stream1, etc.");
+ABSL_FLAG(std::vector<std::string>, stream_buffer_durations, {},
+          "Comma-separated preprocessing buffer durations of the streams, in seconds, in the order above. Streams "
+          "without one use `--buffer_duration`.");
+ABSL_FLAG(std::string, stream_cpu_sets, "",
+          "Semicolon-separated CPU lists to pin the streams to, in the order above, e.g. '0-1;2-3;4,5' "
+          "(streams without one are not pinned). Everything a stream runs, from capture and preprocessing to relaying "
+          "its calls to Core, is started from the stream's thread and so stays within its CPUs: this is what keeps "
+          "a busy stream from starving the others.");
+// endregion ===========================================================================================================
+
+ABSL_FLAG(bool, headless, false, "If true, no GUI will be displayed. Only valid when all streams are videos.");
+ABSL_FLAG(bool, also_log_to_stderr, false, "If true, log to stderr as well.");
+ABSL_FLAG(int, interframe_delay, 20,
+          "Delay, in milliseconds, before capturing the next frame: "
+          "higher values may free up more processing capacity for the graph, i.e. give it more time to process what it "
+          "already has and drop fewer frames, resulting in more robust output metrics.");
+ABSL_FLAG(bool, adaptive_interframe_delay, false,
+          "If true, `--interframe_delay` is only where the delay starts: it is then adjusted on the fly for each "
+          "stream, growing while the per-frame processing time is over `--pacing_target_processing_ms` (i.e. the graph "
+          "is falling behind), and shrinking while more than `--pacing_target_drop_rate` of the input frames are "
+          "dropped.");
+ABSL_FLAG(double, pacing_target_processing_ms, 0.0,
+          "Per-frame processing time to stay under with `--adaptive_interframe_delay`. When 0, 80% of the input frame "
+          "interval.");
+ABSL_FLAG(double, pacing_target_drop_rate, 0.01,
+          "Fraction of input frames that may be dropped with `--adaptive_interframe_delay` before the delay is cut. "
+          "Not used for inputs without exact frame timestamps, whose dropped frames cannot be told apart.");
+ABSL_FLAG(bool, scale_input, true,
+          "If true, uses input scaling in the ImageTransformationCalculator within the graph.");
+ABSL_FLAG(bool, enable_phasic_bp, false, "If true, enable the phasic blood pressure computation.");
+ABSL_FLAG(int, verbosity, 1, "Verbosity level -- raise to print more.");
+
+// === continuous settings ===
+ABSL_FLAG(double, buffer_duration, 0.5,
+          "Duration of preprocessing buffer in seconds. Recommended values currently are between 0.2 and 1.0. "
+          "Shorter values will mean more frequent updates and higher Core processing loads.");
+// === grpc settings ===
+ABSL_FLAG(uint16_t, core_port, 50052,
+          "The port of the (stream-aware) gRPC Physiology Core server that all streams share.");
+ABSL_FLAG(uint16_t, relay_base_port, 50060,
+          "Stream i talks to Core through a local relay port, relay_base_port + i, which forwards its calls over the "
+          "connection shared by all streams.");
+ABSL_FLAG(int, relay_threads_per_stream, 2, "Maximum number of threads polling for each stream's calls in the relay.");
+ABSL_FLAG(bool, core_supports_stream_ids, false,
+          "Set to confirm that the Core behind `--core_port` keeps its processing state per stream ID "
+          "(`x-presage-stream-id` call metadata, which the relay tags each stream's calls with). Stock Core builds "
+          "do not, and would mix the streams' data up, so more than one stream is refused unless this is set.");
+// === metrics output settings ===
+ABSL_FLAG(std::string, metrics_delta_directory, "",
+          "When non-empty, append each stream's metrics to <stream_id>.ndjson in this directory as a delta stream "
+          "(see `--metrics_delta_path` of grpc_continuous_example).");
+ABSL_FLAG(int, full_snapshot_interval, 20,
+          "Number of outputs between full snapshots in the `--metrics_delta_directory` streams. When 0, only the first "
+          "output is a full snapshot.");
+
+struct StreamSettings {
+    std::string stream_id;
+    // the stream reads from this video if non-empty, from the camera otherwise
+    std::string input_video_path;
+    int camera_device_index = 0;
+    double buffer_duration = 0.5;
+    uint16_t relay_port = 0;
+    std::vector<int> cpus;
+};
+
+struct StreamResult {
+    absl::Status status;
+    std::atomic<int64_t> metrics_count{0};
+    double wall_time_s = 0.0;
+};
+
+// Parses a CPU list such as "0-2,5" (like taskset's).
+absl::StatusOr<std::vector<int>> ParseCpuList(absl::string_view text) {
+    std::vector<int> cpus;
+    for (absl::string_view range: absl::StrSplit(text, ',', absl::SkipWhitespace())) {
+        std::vector<absl::string_view> bounds = absl::StrSplit(range, '-');
+        int first = 0;
+        int last = 0;
+        if (bounds.size() > 2 || !absl::SimpleAtoi(bounds.front(), &first) || !absl::SimpleAtoi(bounds.back(), &last) ||
+            first < 0 || last < first || last >= CPU_SETSIZE) {
+            return absl::InvalidArgumentError(absl::StrCat("Invalid CPU list: '", text, "'"));
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+absl::Status PinCurrentThread(const std::vector<int>& cpus) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu: cpus) {
+        CPU_SET(cpu, &cpu_set);
+    }
+    // threads started from this one from now on inherit the affinity
+    const int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (error != 0) {
+        return absl::InvalidArgumentError(absl::StrCat("Could not pin the stream to its CPUs: ", std::strerror(error)));
+    }
+    return absl::OkStatus();
+}
+
+absl::StatusOr<std::vector<StreamSettings>> BuildStreamSettings() {
+    std::vector<StreamSettings> streams;
+    for (const auto& input_video_path: absl::GetFlag(FLAGS_input_video_paths)) {
+        streams.push_back(StreamSettings{"", input_video_path});
+    }
+    for (const auto& camera_device_index: absl::GetFlag(FLAGS_camera_device_indices)) {
+        StreamSettings stream;
+        if (!absl::SimpleAtoi(camera_device_index, &stream.camera_device_index)) {
+            return absl::InvalidArgumentError("Invalid camera device index: " + camera_device_index);
+        }
+        streams.push_back(stream);
+    }
+    const auto stream_ids = absl::GetFlag(FLAGS_stream_ids);
+    const auto buffer_durations = absl::GetFlag(FLAGS_stream_buffer_durations);
+    const std::vector<std::string> cpu_lists = absl::StrSplit(absl::GetFlag(FLAGS_stream_cpu_sets), ';');
+    for (size_t i_stream = 0; i_stream < streams.size(); i_stream++) {
+        StreamSettings& stream = streams[i_stream];
+        stream.stream_id = i_stream < stream_ids.size() ? stream_ids[i_stream] : absl::StrCat("stream", i_stream);
+        stream.buffer_duration = absl::GetFlag(FLAGS_buffer_duration);
+        if (i_stream < buffer_durations.size() &&
+            !absl::SimpleAtod(buffer_durations[i_stream], &stream.buffer_duration)) {
+            return absl::InvalidArgumentError("Invalid buffer duration: " + buffer_durations[i_stream]);
+        }
+        stream.relay_port = static_cast<uint16_t>(absl::GetFlag(FLAGS_relay_base_port) + i_stream);
+        if (i_stream < cpu_lists.size()) {
+            auto cpus_or_status = ParseCpuList(cpu_lists[i_stream]);
+            if (!cpus_or_status.ok()) {
+                return cpus_or_status.status();
+            }
+            stream.cpus = std::move(cpus_or_status).value();
+        }
+    }
+    return streams;
+}
+
+// Runs the capture and preprocessing pipeline of one stream, talking to Core through the stream's relay port.
+absl::Status RunStream(const StreamSettings& stream, examples::CoreStreamRelay& relay, StreamResult& result) {
+    if (!stream.cpus.empty()) {
+        MP_RETURN_IF_ERROR(PinCurrentThread(stream.cpus));
+    }
+    MP_RETURN_IF_ERROR(
+        relay.AddStream(stream.stream_id, stream.relay_port, absl::GetFlag(FLAGS_relay_threads_per_stream))
+    );
+
+    settings::Settings<settings::OperationMode::Continuous, settings::IntegrationMode::Grpc> settings{
+        vs::VideoSourceSettings{
+            stream.camera_device_index,
+            vs::ResolutionSelectionMode::Auto,
+            /*capture_width_px=*/-1,
+            /*capture_height_px=*/-1,
+            pcam::CameraResolutionRange::Unspecified_EnumEnd,
+            pcam::CaptureCodec::MJPG,
+            /*auto_lock=*/true,
+            stream.input_video_path
+        },
+        settings::VideoSinkSettings{},
+        absl::GetFlag(FLAGS_headless),
+        // with adaptive pacing, the container only waits the minimum and the paced video source does the rest
+        absl::GetFlag(FLAGS_adaptive_interframe_delay) ? 1 : absl::GetFlag(FLAGS_interframe_delay),
+        /*start_with_recording_on=*/true,
+        /*start_time_offset_ms=*/0,
+        absl::GetFlag(FLAGS_scale_input),
+        /*binary_graph=*/true,
+        absl::GetFlag(FLAGS_enable_phasic_bp),
+        /*print_graph_contents=*/false,
+        absl::GetFlag(FLAGS_verbosity),
+        settings::ContinuousSettings{
+            stream.buffer_duration
+        },
+        settings::GrpcSettings{
+            stream.relay_port
+        }
+    };
+    examples::PacedContainer<spectra::container::CpuContinuousGrpcForegroundContainer> container(
+        examples::AdaptivePacingSettings{
+            absl::GetFlag(FLAGS_adaptive_interframe_delay),
+            absl::GetFlag(FLAGS_interframe_delay),
+            /*min_delay_ms=*/0,
+            /*max_delay_ms=*/100,
+            absl::GetFlag(FLAGS_pacing_target_processing_ms),
+            absl::GetFlag(FLAGS_pacing_target_drop_rate)
+        },
+        settings
+    );
+    std::unique_ptr<examples::MetricsDeltaWriter> metrics_delta_writer;
+    if (!absl::GetFlag(FLAGS_metrics_delta_directory).empty()) {
+        auto writer_or_status = examples::MetricsDeltaWriter::Open(
+            std::filesystem::path(absl::GetFlag(FLAGS_metrics_delta_directory)) / (stream.stream_id + ".ndjson"),
+            examples::MetricsDeltaSettings{absl::GetFlag(FLAGS_full_snapshot_interval)}
+        );
+        if (!writer_or_status.ok()) {
+            return writer_or_status.status();
+        }
+        metrics_delta_writer = std::move(writer_or_status).value();
+    }
+    container.OnCoreMetricsOutput = [&stream, &result, &metrics_delta_writer](
+        const presage::physiology::MetricsBuffer& metrics, int64_t timestamp_us
+    ) {
+        result.metrics_count++;
+        VLOG(1) << "Got metrics for stream '" << stream.stream_id << "' at " << timestamp_us << " us.";
+        return metrics_delta_writer == nullptr ? absl::OkStatus() : metrics_delta_writer->Write(metrics, timestamp_us);
+    };
+    MP_RETURN_IF_ERROR(container.Initialize());
+    MP_RETURN_IF_ERROR(container.Run());
+    if (absl::GetFlag(FLAGS_adaptive_interframe_delay)) {
+        LOG(INFO) << "Adaptive interframe delay of stream '" << stream.stream_id << "': "
+                  << container.GetPacer().Summarize();
+    }
+    return absl::OkStatus();
+}
+
+absl::Status RunMultiStream() {
+    auto streams_or_status = BuildStreamSettings();
+    if (!streams_or_status.ok()) {
+        return streams_or_status.status();
+    }
+    const std::vector<StreamSettings>& streams = streams_or_status.value();
+    if (streams.empty()) {
+        return absl::InvalidArgumentError("No streams: pass --input_video_paths and/or --camera_device_indices.");
+    }
+    if (streams.size() > 1 && !absl::GetFlag(FLAGS_core_supports_stream_ids)) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Got ", streams.size(), " streams, but Core is not known to keep its processing state per ",
+            examples::kStreamIdMetadataKey, " metadata value; pass --core_supports_stream_ids if it does, or run "
+            "one grpc_continuous_example per stream, each against its own Core."
+        ));
+    }
+    if (!absl::GetFlag(FLAGS_metrics_delta_directory).empty()) {
+        MP_RETURN_IF_ERROR(
+            presage::filesystem::abseil::CreateDirectoryIfMissing(absl::GetFlag(FLAGS_metrics_delta_directory))
+        );
+    }
+
+    examples::CoreStreamRelay relay(absl::StrCat("localhost:", absl::GetFlag(FLAGS_core_port)));
+    std::vector<StreamResult> results(streams.size());
+    std::vector<std::thread> stream_threads;
+    for (size_t i_stream = 0; i_stream < streams.size(); i_stream++) {
+        stream_threads.emplace_back([&, i_stream]() {
+            const auto start = std::chrono::steady_clock::now();
+            results[i_stream].status = RunStream(streams[i_stream], relay, results[i_stream]);
+            results[i_stream].wall_time_s =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        });
+    }
+    for (auto& stream_thread: stream_threads) {
+        stream_thread.join();
+    }
+    relay.Shutdown();
+
+    size_t failed_stream_count = 0;
+    for (size_t i_stream = 0; i_stream < streams.size(); i_stream++) {
+        const StreamResult& result = results[i_stream];
+        if (result.status.ok()) {
+            LOG(INFO) << "Stream '" << streams[i_stream].stream_id << "' got " << result.metrics_count.load()
+                      << " metrics outputs in " << result.wall_time_s << " s.";
+        } else {
+            failed_stream_count++;
+            LOG(ERROR) << "Stream '" << streams[i_stream].stream_id << "' failed: " << result.status.message();
+        }
+    }
+    relay.LogStatistics();
+    if (failed_stream_count > 0) {
+        return absl::InternalError(absl::StrCat(failed_stream_count, " of ", streams.size(), " streams failed."));
+    }
+    return absl::OkStatus();
+}
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+
+    absl::SetProgramUsageMessage(
+        "Run Presage Physiology Preprocessing on several cameras and/or videos at once, all sharing one gRPC "
+        "Physiology Core server (which tells the streams apart by their IDs)."
+    );
+    absl::ParseCommandLine(argc, argv);
+    if (absl::GetFlag(FLAGS_also_log_to_stderr)) {
+        // work-around for built-in logging to stderr (for a more human-readable flag name)
+        FLAGS_alsologtostderr = true;
+    }
+
+    if (absl::GetFlag(FLAGS_headless) && !absl::GetFlag(FLAGS_camera_device_indices).empty()) {
+        LOG(ERROR) << "Cannot use headless mode with camera streams. Run with --help=main to see usage.";
+        exit(-1);
+    }
+
+    absl::Status status = RunMultiStream();
+
+    if (!status.ok()) {
+        LOG(ERROR) << "Run failed. " << status.message();
+        return EXIT_FAILURE;
+    } else {
+        LOG(INFO) << "Success!";
+    }
+    return 0;
+}
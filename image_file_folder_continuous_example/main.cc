@@ -4,15 +4,19 @@
 //
 
 // stdlib includes
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <sstream>
 
 // third-party includes
 #include <physiology/interface/absl/flags/flag.h>
 #include <physiology/interface/absl/flags/parse.h>
 #include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/absl/strings/str_cat.h>
 #include <physiology/interface/glog/logging.h>
 #include <physiology/modules/messages/status.pb.h>
 #include <physiology/modules/filesystem_absl.h>
@@ -20,11 +24,27 @@
 #include <smartspectra/video_source/camera/camera.hpp>
 #include <smartspectra/container/foreground_container.hpp>
 
+// local includes
+#include "common/adaptive_pacing.hpp"
+#include "common/file_stream_frame_source.hpp"
+#include "common/file_stream_watcher.hpp"
+#include "common/frame_source_container.hpp"
+#include "common/input_reduction.hpp"
+#include "common/metrics_binary_file.hpp"
+#include "common/metrics_delta.hpp"
+#include "common/metrics_store.hpp"
+#include "common/pipeline_metrics.hpp"
+#include "common/raw_frame_file.hpp"
+#include "common/shared_memory_frame_ring.hpp"
+#include "common/startup_profile.hpp"
+#include "common/status_sink.hpp"
+#include "common/threaded_video_sink.hpp"
 
 namespace pcam = presage::camera;
 namespace spectra = presage::smartspectra;
 namespace settings = presage::smartspectra::container::settings;
 namespace vs = presage::smartspectra::video_source;
+namespace examples = presage::smartspectra::examples;
 
 // region ========================================= CAMERA SETTINGS ====================================================
 //TODO: implement ABSL_FLAG_GROUP(group_name, param1, param2, param3, ...) macro in Abseil,
@@ -67,13 +87,40 @@ ABSL_FLAG(std::string, end_of_stream, "end_of_stream",
           "This is the file that will be placed as a token signalling \"end of stream\" to preprocessing.");
 ABSL_FLAG(int, file_stream_rescan_delay, 5,
           "Delay, in milliseconds, before re-scanning the input folder for more frames. Decrease to accommodate "
-          "faster streaming. Conversely, if input streaming is slow, decreasing the delay will just hog the application.");
+          "faster streaming. Conversely, if input streaming is slow, decreasing the delay will just hog the application."
+          " Only used when the folder is re-scanned, see `--use_inotify`.");
+ABSL_FLAG(bool, use_inotify, true,
+          "If true, pick up each frame file in file stream mode as soon as the writer closes it (or moves it into the "
+          "folder), based on inotify events, instead of re-scanning the folder every `--file_stream_rescan_delay` ms. "
+          "Falls back to re-scanning when inotify is not available (e.g. not on Linux), and is not used with `--loop`. "
+          "Note that inotify does not see files written to network file systems (e.g. NFS) by other hosts.");
 ABSL_FLAG(bool,
           erase_read_files,
           true,
           "Erase frame image files that were already read in. Incompatible with `--loop`.");
 ABSL_FLAG(bool, loop, false, "Loop around the folder. Presumes static input, i.e. folder will not be rescanned. "
                              "Incompatible with `--erase_read_files`.");
+ABSL_FLAG(std::string, raw_frame_file_path, "",
+          "Path to an append-only raw frame file (see docs/raw_frame_format.md) holding BGR frames with microsecond "
+          "timestamps, ended by an end-of-stream record. Signifies raw frame file mode will be used: the file is "
+          "memory-mapped and followed as the producer appends to it, checking for new frames every "
+          "`--file_stream_rescan_delay` ms when caught up. Takes precedence over `--file_stream_path`.");
+ABSL_FLAG(std::string, shared_memory_frame_ring, "",
+          "Name of a POSIX shared-memory frame ring (see docs/shared_memory_frame_format.md), e.g. "
+          "`/smartspectra_frames`, that another process (e.g. `shared_memory_frame_producer`) publishes BGR frames "
+          "with microsecond timestamps to. Signifies shared-memory mode will be used: each frame is copied out of "
+          "shared memory once (without decoding it) and fed to the graph, until the producer closes the ring. Takes "
+          "precedence over `--raw_frame_file_path` and `--file_stream_path`.");
+ABSL_FLAG(int, shared_memory_poll_delay, 5,
+          "Delay, in milliseconds, between checks for the shared-memory frame ring to show up and, while waiting for "
+          "new frames, for the producer to have closed it.");
+ABSL_FLAG(int, decode_threads, 0,
+          "Number of worker threads that read and decode upcoming frame files in file stream mode ahead of time, "
+          "so that image decoding does not hold up feeding frames to the graph. When 0, each frame is read and "
+          "decoded right before it is needed. Not used with `--loop`.");
+ABSL_FLAG(int, prefetch_depth, 8,
+          "Maximum number of frames being decoded or decoded and waiting to be fed to the graph when "
+          "`--decode_threads` is positive. Queue occupancy is logged periodically.");
 // endregion ===========================================================================================================
 
 ABSL_FLAG(bool,
@@ -85,6 +132,24 @@ ABSL_FLAG(int, interframe_delay, 20,
           "Delay, in milliseconds, before capturing the next frame: "
           "higher values may free up more processing capacity for the graph, i.e. give it more time to process what it "
           "already has and drop fewer frames, resulting in more robust output metrics.");
+ABSL_FLAG(bool, adaptive_interframe_delay, false,
+          "If true, `--interframe_delay` is only where the delay starts: it is then adjusted on the fly, growing while "
+          "the per-frame processing time is over `--pacing_target_processing_ms` (i.e. the graph is falling behind), "
+          "and shrinking while more than `--pacing_target_drop_rate` of the input frames are dropped. The delay and "
+          "dropped-frame counts are logged every few seconds.");
+ABSL_FLAG(double, pacing_target_processing_ms, 0.0,
+          "Per-frame processing time to stay under with `--adaptive_interframe_delay`. When 0, 80% of the input frame "
+          "interval.");
+ABSL_FLAG(double, pacing_target_drop_rate, 0.01,
+          "Fraction of input frames that may be dropped with `--adaptive_interframe_delay` before the delay is cut. "
+          "Not used for inputs without exact frame timestamps, whose dropped frames cannot be told apart.");
+ABSL_FLAG(int, pipeline_stats_interval, 10,
+          "Interval, in seconds, at which per-stage pipeline latencies (frame capture, file decoding, processing, "
+          "frame to metrics), frame rates, dropped-frame counts and prefetch queue occupancy are logged as one JSON "
+          "line. When 0, they are not logged.");
+ABSL_FLAG(uint16_t, pipeline_stats_port, 0,
+          "When non-zero, the pipeline stats are also served in the Prometheus text format at "
+          "http://127.0.0.1:<port>/metrics.");
 ABSL_FLAG(bool,
           start_with_recording_on,
           false,
@@ -95,6 +160,15 @@ ABSL_FLAG(int, start_time_offset_ms, 0,
           "Not functional for streaming mode, as start is disabled until this offset.");
 ABSL_FLAG(bool, scale_input, true,
           "If true, uses input scaling in the ImageTransformationCalculator within the graph.");
+ABSL_FLAG(int, input_max_width, 0,
+          "If positive, input frames (after cropping to `--input_region_of_interest`) wider than this are downsampled "
+          "to fit, keeping their aspect ratio, before they enter the graph. 0: no limit.");
+ABSL_FLAG(int, input_max_height, 0,
+          "If positive, input frames (after cropping to `--input_region_of_interest`) taller than this are downsampled "
+          "to fit, keeping their aspect ratio, before they enter the graph. 0: no limit.");
+ABSL_FLAG(std::string, input_region_of_interest, "",
+          "If set, as <x>,<y>,<width>,<height> in input frame pixels, input frames are cropped to this region before "
+          "they enter the graph (e.g. to the part of the scene where the subject is).");
 ABSL_FLAG(bool, enable_phasic_bp, false, "If true, enable the phasic blood pressure computation.");
 ABSL_FLAG(bool, print_graph_contents, false, "If true, print the graph contents.");
 ABSL_FLAG(std::string,
@@ -103,6 +177,14 @@ ABSL_FLAG(std::string,
           "Directory where to save preprocessed analysis data as JSON. "
           "If it does not exist, the app will attempt to make one.");
 ABSL_FLAG(int, verbosity, 1, "Verbosity level -- raise to print more.");
+ABSL_FLAG(bool, startup_profile, false,
+          "If true, log how long it took from process start to the first processed frame, broken down into flag "
+          "parsing, container initialization (graph setup and, unless initialized early, the video source), graph "
+          "start (with model loading), first frame capture and first frame processing (see README).");
+ABSL_FLAG(bool, early_video_source_initialization, false,
+          "If true, initialize the video source (opening the camera and, with `--auto_lock`, settling its exposure, "
+          "or waiting for the first input frame) on a thread of its own, alongside the graph setup, instead of after "
+          "it.");
 ABSL_FLAG(double, buffer_duration, 0.5,
           "Duration of preprocessing buffer in seconds. Recommended values currently are between 0.2 and 1.0. "
           "Shorter values will mean more frequent updates and higher Core processing loads.");
@@ -121,6 +203,17 @@ ABSL_FLAG(bool, passthrough_video, false,
           "If true, output video will just use the input video frames directly (see destination "
           "documentation), without passing through any processing "
           "(which might contain rendered visual content from the graph).");
+ABSL_FLAG(bool, threaded_video_sink, true,
+          "If true, `--passthrough_video` output is encoded on a thread of its own, off the processing path, with "
+          "frames queued for it (and dropped as per `--video_sink_drop_policy` when the encoder falls behind). "
+          "Encoding times and dropped frames are part of the pipeline stats.");
+ABSL_FLAG(int, video_sink_queue_size, 32, "Number of frames that can wait for the `--threaded_video_sink` encoder.");
+ABSL_FLAG(examples::VideoSinkDropPolicy, video_sink_drop_policy, examples::VideoSinkDropPolicy::DropOldest,
+          "What `--threaded_video_sink` does with frames when the encoder falls behind. Possible values: "
+          + absl::StrJoin(examples::GetVideoSinkDropPolicyNames(), ", "));
+ABSL_FLAG(int, video_sink_drop_every_nth, 2,
+          "With `--video_sink_drop_policy=drop_every_nth`, every n-th frame is dropped while the encoder is behind.");
+ABSL_FLAG(double, video_sink_frame_rate, 30.0, "Frame rate written into the `--threaded_video_sink` output video.");
 // endregion ===========================================================================================================
 // region ========================  CUSTOM SETTINGS (not for container) ================================================
 ABSL_FLAG(std::string, status_file_directory_path, "out",
@@ -130,43 +223,352 @@ ABSL_FLAG(std::string, status_file_directory_path, "out",
           "epoch microsecond is a 16-character zero-padded string holding an unsigned integer value representing the "
           "current time, and the status code is a two-character string holding a zero-padded unsigned integer value. "
           "E.g. 0000000000000000_00 would be produced by a machine with it's internal clock back in "
-          "January 1, 1970 that produces a 0 status code while running this application.");
+          "January 1, 1970 that produces a 0 status code while running this application. "
+          "Status changes are written on a background thread, see `--status_sink` for other output formats.");
+ABSL_FLAG(examples::StatusSinkType, status_sink, examples::StatusSinkType::MarkerFiles,
+          "Where to write preprocessing status changes: `marker_files` writes the empty files described for "
+          "`--status_file_directory_path`, `ndjson` appends one {\"epoch_us\":...,\"status\":...} line per change to "
+          "status.ndjson in that directory, and `unix_socket` sends the same lines to the Unix domain socket at "
+          "`--status_socket_path`. Possible values: " + absl::StrJoin(examples::GetStatusSinkTypeNames(), ", "));
+ABSL_FLAG(std::string, status_socket_path, "",
+          "Path of the Unix domain (stream) socket to send status changes to, for `--status_sink=unix_socket`.");
+ABSL_FLAG(int, status_coalesce_window_ms, 0,
+          "Status changes that follow one another within this many milliseconds (e.g. when the face flickers in and "
+          "out of frame) are collapsed into the last one. When 0, only repeats of the same status are dropped.");
+ABSL_FLAG(std::string, metrics_delta_path, "",
+          "When non-empty, also write each metrics output to this NDJSON file (replacing its contents) as a delta, "
+          "i.e. holding only the measurements that are new since the previous output, with a full snapshot every "
+          "`--full_snapshot_interval` outputs for consumers to resync from (see README). This does not turn off the "
+          "SDK's own JSON files in `--output_directory`, which are still written in full.");
+ABSL_FLAG(int, full_snapshot_interval, 20,
+          "Number of outputs between full snapshots in the `--metrics_delta_path` stream. When 0, only the first "
+          "output is a full snapshot.");
+ABSL_FLAG(std::string, metrics_binary_directory, "",
+          "When non-empty, also save each metrics output to this directory as a compact binary metrics file "
+          "(metrics_<timestamp_us>.ssmb, see docs/metrics_binary_format.md).");
+ABSL_FLAG(bool, metrics_store, false,
+          "If true, keep every metrics series in an in-process, time-indexed store with 1 s, 10 s and 60 s rollups, "
+          "for range queries over the whole run at http://127.0.0.1:<pipeline_stats_port>/series (see README).");
+ABSL_FLAG(int, metrics_store_memory_mb, 64,
+          "Memory, in MiB, that `--metrics_store` series may take up before the oldest measurements are spilled to "
+          "disk. When 0, nothing is spilled.");
+ABSL_FLAG(std::string, metrics_store_spill_directory, "",
+          "Directory for the `--metrics_store` spill file. When empty, the system's temporary directory.");
 // endregion ===========================================================================================================
 
-absl::Status RunFileContinuousPreprocessing(
-    settings::Settings<settings::OperationMode::Continuous, settings::IntegrationMode::JsonFileOnDisk>& settings
+absl::StatusOr<std::unique_ptr<examples::StatusSinkBackend>> BuildStatusSinkBackend(
+    const std::filesystem::path& status_file_directory_path
 ) {
-    spectra::container::CpuContinuousFileForegroundContainer container(settings);
+    switch (absl::GetFlag(FLAGS_status_sink)) {
+        case examples::StatusSinkType::MarkerFiles:
+            return std::make_unique<examples::MarkerFileStatusSinkBackend>(status_file_directory_path);
+        case examples::StatusSinkType::Ndjson: {
+            auto backend_or_status =
+                examples::NdjsonStatusSinkBackend::Open(status_file_directory_path / "status.ndjson");
+            if (!backend_or_status.ok()) {
+                return backend_or_status.status();
+            }
+            return std::unique_ptr<examples::StatusSinkBackend>(std::move(backend_or_status).value());
+        }
+        case examples::StatusSinkType::UnixSocket:
+            if (absl::GetFlag(FLAGS_status_socket_path).empty()) {
+                return absl::InvalidArgumentError("`--status_socket_path` is required for the unix_socket status sink.");
+            }
+            return std::make_unique<examples::UnixSocketStatusSinkBackend>(absl::GetFlag(FLAGS_status_socket_path));
+        default:
+            return absl::InvalidArgumentError("Unsupported status sink type.");
+    }
+}
+
+examples::AdaptivePacingSettings GetAdaptivePacingSettings() {
+    return examples::AdaptivePacingSettings{
+        absl::GetFlag(FLAGS_adaptive_interframe_delay),
+        absl::GetFlag(FLAGS_interframe_delay),
+        /*min_delay_ms=*/0,
+        /*max_delay_ms=*/100,
+        absl::GetFlag(FLAGS_pacing_target_processing_ms),
+        absl::GetFlag(FLAGS_pacing_target_drop_rate)
+    };
+}
+
+// Whether the input frames are written out by a ThreadedVideoSink here rather than by the SDK's video sink.
+bool UseThreadedVideoSink() {
+    return absl::GetFlag(FLAGS_threaded_video_sink) && absl::GetFlag(FLAGS_passthrough_video) &&
+           !absl::GetFlag(FLAGS_output_video_destination).empty();
+}
+
+// Starts the sink for `--threaded_video_sink`, or returns null when it is not used.
+absl::StatusOr<std::unique_ptr<examples::ThreadedVideoSink>> StartThreadedVideoSink(
+    examples::PipelineMetrics* pipeline_metrics
+) {
+    if (!UseThreadedVideoSink()) {
+        return nullptr;
+    }
+    return examples::ThreadedVideoSink::Start(examples::ThreadedVideoSinkSettings{
+        absl::GetFlag(FLAGS_output_video_destination),
+        absl::UnparseFlag(absl::GetFlag(FLAGS_video_sink_mode)) == "gstreamer",
+        /*fourcc=*/"MJPG",
+        absl::GetFlag(FLAGS_video_sink_frame_rate),
+        static_cast<size_t>(std::max(0, absl::GetFlag(FLAGS_video_sink_queue_size))),
+        absl::GetFlag(FLAGS_video_sink_drop_policy),
+        absl::GetFlag(FLAGS_video_sink_drop_every_nth),
+        pipeline_metrics
+    });
+}
+
+examples::InputReductionSettings GetInputReductionSettings(examples::PipelineMetrics* pipeline_metrics) {
+    return examples::InputReductionSettings{
+        absl::GetFlag(FLAGS_input_max_width),
+        absl::GetFlag(FLAGS_input_max_height),
+        // validated in main()
+        examples::ParseRegionOfInterest(absl::GetFlag(FLAGS_input_region_of_interest)).value_or(cv::Rect()),
+        pipeline_metrics
+    };
+}
+
+// Creates the store for `--metrics_store`, or returns null when it is off.
+absl::StatusOr<std::unique_ptr<examples::MetricsStore>> CreateMetricsStore() {
+    if (!absl::GetFlag(FLAGS_metrics_store)) {
+        return nullptr;
+    }
+    examples::MetricsStoreSettings store_settings;
+    const int memory_mb = std::max(0, absl::GetFlag(FLAGS_metrics_store_memory_mb));
+    store_settings.max_resident_bytes = static_cast<size_t>(memory_mb) << 20;
+    store_settings.spill_directory = absl::GetFlag(FLAGS_metrics_store_spill_directory);
+    store_settings.reset_time_step_s = absl::GetFlag(FLAGS_buffer_duration);
+    return examples::MetricsStore::Create(store_settings);
+}
+
+// Creates the sink for status changes, or returns null when `--status_file_directory_path` is not set.
+absl::StatusOr<std::unique_ptr<examples::AsyncStatusSink>> CreateStatusSink() {
     std::filesystem::path status_file_directory_path(absl::GetFlag(FLAGS_status_file_directory_path));
+    if (status_file_directory_path.empty()) {
+        return nullptr;
+    }
     MP_RETURN_IF_ERROR(presage::filesystem::abseil::CreateDirectoryIfMissing(status_file_directory_path));
+    auto backend_or_status = BuildStatusSinkBackend(status_file_directory_path);
+    if (!backend_or_status.ok()) {
+        return backend_or_status.status();
+    }
+    return std::make_unique<examples::AsyncStatusSink>(
+        std::move(backend_or_status).value(),
+        examples::StatusSinkSettings{
+            /*queue_capacity=*/256,
+            absl::GetFlag(FLAGS_status_coalesce_window_ms)
+        }
+    );
+}
 
-    if (!status_file_directory_path.empty()) {
-        container.OnStatusChange = [&status_file_directory_path](presage::physiology::StatusCode status) {
-            uint64_t epoch_ms = std::chrono::duration_cast<std::chrono::microseconds>(
-                std::chrono::high_resolution_clock::now().time_since_epoch()
-            ).count();
-
-            std::stringstream file_name;
-            file_name << std::setw(16) << std::setfill('0') << epoch_ms << "_" << std::setw(2) << std::setfill('0')
-                      << static_cast<int>(status);
-            auto status_file_path = status_file_directory_path / file_name.str();
-            std::ofstream status_file(status_file_path);
-            if (status_file.fail() || !status_file.is_open()) {
-                status_file.close();
-                return absl::InternalError(
-                    "Could not write status file " + status_file_path.string()
-                );
-            }
-            status_file.close();
-            LOG(INFO)  << "Wrote status file " << status_file_path.string();
-            return absl::OkStatus();
+template<typename TContainer>
+absl::Status InitializeAndRun(
+    TContainer& container,
+    examples::AsyncStatusSink* status_sink,
+    examples::MetricsStore* metrics_store,
+    examples::ThreadedVideoSink* video_sink,
+    examples::StartupProfile& startup_profile
+) {
+    if (status_sink != nullptr) {
+        container.OnStatusChange = [status_sink](presage::physiology::StatusCode status) {
+            return status_sink->Push(static_cast<int>(status));
         };
     }
+    std::unique_ptr<examples::MetricsDeltaWriter> metrics_delta_writer;
+    if (!absl::GetFlag(FLAGS_metrics_delta_path).empty()) {
+        auto writer_or_status = examples::MetricsDeltaWriter::Open(
+            absl::GetFlag(FLAGS_metrics_delta_path),
+            examples::MetricsDeltaSettings{absl::GetFlag(FLAGS_full_snapshot_interval)}
+        );
+        if (!writer_or_status.ok()) {
+            return writer_or_status.status();
+        }
+        metrics_delta_writer = std::move(writer_or_status).value();
+    }
+    const std::filesystem::path metrics_binary_directory = absl::GetFlag(FLAGS_metrics_binary_directory);
+    if (!metrics_binary_directory.empty()) {
+        MP_RETURN_IF_ERROR(presage::filesystem::abseil::CreateDirectoryIfMissing(metrics_binary_directory));
+    }
+    container.OnCoreMetricsOutput = [&container, &metrics_delta_writer, metrics_store, &metrics_binary_directory](
+        const presage::physiology::MetricsBuffer& metrics, int64_t timestamp_us
+    ) {
+        container.RecordMetricsOutput(timestamp_us);
+        if (metrics_store != nullptr) {
+            MP_RETURN_IF_ERROR(metrics_store->Append(metrics));
+        }
+        if (!metrics_binary_directory.empty()) {
+            MP_RETURN_IF_ERROR(examples::WriteMetricsBinaryFile(
+                metrics_binary_directory
+                    / absl::StrCat("metrics_", timestamp_us, examples::kMetricsBinaryFileExtension),
+                examples::ToColumns(metrics),
+                examples::MetricsColumnEncoding::DeltaVarint
+            ));
+        }
+        if (metrics_delta_writer != nullptr) {
+            return metrics_delta_writer->Write(metrics, timestamp_us);
+        }
+        return absl::OkStatus();
+    };
+    if (absl::GetFlag(FLAGS_early_video_source_initialization)) {
+        container.StartVideoSourceInitialization();
+    }
     MP_RETURN_IF_ERROR(container.Initialize());
-    return container.Run();
+    startup_profile.Mark("container_initialized");
+    MP_RETURN_IF_ERROR(container.Run());
+    if (video_sink != nullptr) {
+        MP_RETURN_IF_ERROR(video_sink->Close());
+        LOG(INFO) << "Video sink: " << video_sink->Summarize();
+    }
+    if (metrics_store != nullptr) {
+        LOG(INFO) << "Metrics store: " << metrics_store->Summarize();
+    }
+    if (absl::GetFlag(FLAGS_adaptive_interframe_delay)) {
+        LOG(INFO) << "Adaptive interframe delay: " << container.GetPacer().Summarize();
+    }
+    if (container.IsInputReductionEnabled()) {
+        LOG(INFO) << "Input reduction: " << container.GetInputReducer().Summarize();
+    }
+    return absl::OkStatus();
+}
+
+// Returns a started watcher for the file stream folder: inotify-driven if requested and possible, re-scanning otherwise.
+absl::StatusOr<std::unique_ptr<examples::FrameFileWatcher>> StartFrameFileWatcher() {
+    auto pattern_or_status = examples::FileStreamPattern::Parse(absl::GetFlag(FLAGS_file_stream_path));
+    if (!pattern_or_status.ok()) {
+        return pattern_or_status.status();
+    }
+    if (absl::GetFlag(FLAGS_use_inotify) && examples::InotifyFrameFileWatcher::IsSupported()) {
+        auto watcher = std::make_unique<examples::InotifyFrameFileWatcher>(
+            pattern_or_status.value(), absl::GetFlag(FLAGS_end_of_stream)
+        );
+        absl::Status status = watcher->Start();
+        if (status.ok()) {
+            LOG(INFO) << "Using inotify to pick up frames in the file stream folder.";
+            return watcher;
+        }
+        LOG(WARNING) << "Falling back to re-scanning the file stream folder every "
+                     << absl::GetFlag(FLAGS_file_stream_rescan_delay) << " ms: " << status.message();
+    }
+    auto watcher = std::make_unique<examples::PollingFrameFileWatcher>(
+        std::move(pattern_or_status).value(), absl::GetFlag(FLAGS_end_of_stream),
+        absl::GetFlag(FLAGS_file_stream_rescan_delay)
+    );
+    MP_RETURN_IF_ERROR(watcher->Start());
+    return watcher;
+}
+
+// Returns the examples' own frame source for the input the flags call for, or null when the SDK's video source (camera,
+// video, or file stream) is to be used instead.
+absl::StatusOr<std::unique_ptr<examples::FrameSource>> CreateFrameSource(
+    const settings::Settings<settings::OperationMode::Continuous, settings::IntegrationMode::JsonFileOnDisk>& settings,
+    examples::PipelineMetrics* pipeline_metrics
+) {
+    if (!absl::GetFlag(FLAGS_shared_memory_frame_ring).empty()) {
+        return std::make_unique<examples::SharedMemoryFrameSource>(
+            absl::GetFlag(FLAGS_shared_memory_frame_ring), absl::GetFlag(FLAGS_shared_memory_poll_delay)
+        );
+    }
+    if (!absl::GetFlag(FLAGS_raw_frame_file_path).empty()) {
+        return std::make_unique<examples::RawFrameFileSource>(
+            absl::GetFlag(FLAGS_raw_frame_file_path), absl::GetFlag(FLAGS_file_stream_rescan_delay)
+        );
+    }
+    // the examples' own file stream source is needed for inotify-driven pick-up or for decoding on worker threads,
+    // otherwise leave it to the SDK
+    const bool use_own_file_stream_source =
+        !settings.video_source.file_stream_path.empty() && !absl::GetFlag(FLAGS_loop) &&
+        ((absl::GetFlag(FLAGS_use_inotify) && examples::InotifyFrameFileWatcher::IsSupported()) ||
+         absl::GetFlag(FLAGS_decode_threads) > 0);
+    if (!use_own_file_stream_source) {
+        return nullptr;
+    }
+    auto watcher_or_status = StartFrameFileWatcher();
+    if (!watcher_or_status.ok()) {
+        return watcher_or_status.status();
+    }
+    return std::make_unique<examples::FileStreamFrameSource>(
+        std::move(watcher_or_status).value(),
+        examples::FileStreamFrameSourceSettings{
+            absl::GetFlag(FLAGS_erase_read_files),
+            absl::GetFlag(FLAGS_decode_threads),
+            absl::GetFlag(FLAGS_prefetch_depth),
+            pipeline_metrics
+        }
+    );
+}
+
+absl::Status RunFileContinuousPreprocessing(
+    settings::Settings<settings::OperationMode::Continuous, settings::IntegrationMode::JsonFileOnDisk>& settings,
+    examples::StartupProfile& startup_profile
+) {
+    // created first, since the reporter serves queries of it for as long as it runs
+    auto metrics_store_or_status = CreateMetricsStore();
+    if (!metrics_store_or_status.ok()) {
+        return metrics_store_or_status.status();
+    }
+    const std::unique_ptr<examples::MetricsStore> metrics_store = std::move(metrics_store_or_status).value();
+    examples::PipelineMetrics pipeline_metrics;
+    examples::PipelineMetricsReporterSettings reporter_settings{
+        absl::GetFlag(FLAGS_pipeline_stats_interval),
+        absl::GetFlag(FLAGS_pipeline_stats_port)
+    };
+    if (metrics_store != nullptr) {
+        reporter_settings.json_endpoints["/series"] = [&metrics_store](std::string_view query) {
+            return examples::QueryMetricsStoreJson(*metrics_store, query);
+        };
+    }
+    auto reporter_or_status = examples::PipelineMetricsReporter::Start(pipeline_metrics, reporter_settings);
+    if (!reporter_or_status.ok()) {
+        return reporter_or_status.status();
+    }
+    auto video_sink_or_status = StartThreadedVideoSink(&pipeline_metrics);
+    if (!video_sink_or_status.ok()) {
+        return video_sink_or_status.status();
+    }
+    const std::unique_ptr<examples::ThreadedVideoSink> video_sink = std::move(video_sink_or_status).value();
+    // created ahead of the container, so that it outlives it
+    auto status_sink_or_status = CreateStatusSink();
+    if (!status_sink_or_status.ok()) {
+        return status_sink_or_status.status();
+    }
+    const std::unique_ptr<examples::AsyncStatusSink> status_sink = std::move(status_sink_or_status).value();
+    examples::StartupProfile* profile = absl::GetFlag(FLAGS_startup_profile) ? &startup_profile : nullptr;
+    auto frame_source_or_status = CreateFrameSource(settings, &pipeline_metrics);
+    if (!frame_source_or_status.ok()) {
+        return frame_source_or_status.status();
+    }
+    std::unique_ptr<examples::FrameSource> frame_source = std::move(frame_source_or_status).value();
+    if (frame_source != nullptr) {
+        examples::StartupContainer<examples::PacedContainer<examples::InstrumentedContainer<examples::RecordedContainer<
+            examples::InputReductionContainer<
+                examples::FrameSourceContainer<spectra::container::CpuContinuousFileForegroundContainer>
+            >
+        >>>> container(
+            profile,
+            GetAdaptivePacingSettings(),
+            &pipeline_metrics,
+            video_sink.get(),
+            GetInputReductionSettings(&pipeline_metrics),
+            settings,
+            std::move(frame_source)
+        );
+        return InitializeAndRun(container, status_sink.get(), metrics_store.get(), video_sink.get(), startup_profile);
+    }
+    examples::StartupContainer<examples::PacedContainer<examples::InstrumentedContainer<examples::RecordedContainer<
+        examples::InputReductionContainer<spectra::container::CpuContinuousFileForegroundContainer>
+    >>>> container(
+        profile,
+        GetAdaptivePacingSettings(),
+        &pipeline_metrics,
+        video_sink.get(),
+        GetInputReductionSettings(&pipeline_metrics),
+        settings
+    );
+    return InitializeAndRun(container, status_sink.get(), metrics_store.get(), video_sink.get(), startup_profile);
 }
 
 int main(int argc, char** argv) {
+    // from the start, since whether it is logged is only known once the flags are parsed
+    examples::StartupProfile startup_profile;
+    startup_profile.Mark("main");
     google::InitGoogleLogging(argv[0]);
 
     absl::SetProgramUsageMessage(
@@ -174,6 +576,7 @@ int main(int argc, char** argv) {
         "Requires the Presage Physiology gRPC Server to be running on the same machine."
     );
     absl::ParseCommandLine(argc, argv);
+    startup_profile.Mark("flags_parsed");
     if (absl::GetFlag(FLAGS_also_log_to_stderr)) {
         // work-around for built-in logging to stderr (for a more human-readable flag name)
         FLAGS_alsologtostderr = true;
@@ -195,13 +598,15 @@ int main(int argc, char** argv) {
             absl::GetFlag(FLAGS_erase_read_files),
             absl::GetFlag(FLAGS_loop),
         },
-        settings::VideoSinkSettings{
+        // with `--threaded_video_sink`, the input frames are written out by the sink set up around the container
+        UseThreadedVideoSink() ? settings::VideoSinkSettings{} : settings::VideoSinkSettings{
             absl::GetFlag(FLAGS_output_video_destination),
             absl::GetFlag(FLAGS_video_sink_mode),
             absl::GetFlag(FLAGS_passthrough_video)
         },
         absl::GetFlag(FLAGS_headless),
-        absl::GetFlag(FLAGS_interframe_delay),
+        // with adaptive pacing, the container only waits the minimum and the paced video source does the rest
+        absl::GetFlag(FLAGS_adaptive_interframe_delay) ? 1 : absl::GetFlag(FLAGS_interframe_delay),
         absl::GetFlag(FLAGS_start_with_recording_on),
         absl::GetFlag(FLAGS_start_time_offset_ms),
         absl::GetFlag(FLAGS_scale_input),
@@ -217,13 +622,21 @@ int main(int argc, char** argv) {
         }
     };
 
+    if (auto region_or_status = examples::ParseRegionOfInterest(absl::GetFlag(FLAGS_input_region_of_interest));
+        !region_or_status.ok()) {
+        LOG(ERROR) << region_or_status.status().message() << " Run with --help=main to see usage.";
+        exit(-1);
+    }
     if (settings.headless && settings.video_source.input_video_path.empty() &&
-        settings.video_source.file_stream_path.empty()) {
-        LOG(WARNING) << "Using headless mode without loading a video or loading a file stream. "
+        settings.video_source.file_stream_path.empty() && absl::GetFlag(FLAGS_raw_frame_file_path).empty() &&
+        absl::GetFlag(FLAGS_shared_memory_frame_ring).empty()) {
+        LOG(WARNING) << "Using headless mode without loading a video, a file stream, a raw frame file, or a "
+                        "shared-memory frame ring. "
                         "Please use a keyboard interrupt to stop execution when required.";
     }
 
-    absl::Status status = RunFileContinuousPreprocessing(settings);
+    startup_profile.Mark("settings_built");
+    absl::Status status = RunFileContinuousPreprocessing(settings, startup_profile);
 
     if (!status.ok()) {
         LOG(ERROR) << "Run failed. " << status.message();
@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// third-party includes
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/metrics_binary_file.hpp"
+#include "common/rest_metrics_parser.hpp"
+#include "common/rest_metrics_writer.hpp"
+#include "common/status_macros.hpp"
+
+namespace examples = presage::smartspectra::examples;
+
+ABSL_FLAG(bool, also_log_to_stderr, false, "If true, log to stderr as well.");
+ABSL_FLAG(std::string, input_path, "",
+          "Metrics file to convert: either a binary metrics file (.ssmb), which is converted to JSON in the "
+          "Physiology REST API response format (see docs/output_format.md), or a JSON file in that format, "
+          "which is converted to a binary metrics file.");
+ABSL_FLAG(std::string, output_path, "",
+          "Where to write the converted metrics. Defaults to the input path with the extension replaced.");
+ABSL_FLAG(bool, compact, true,
+          "If true, binary output uses delta-varint-encoded columns (smaller); otherwise, raw float columns "
+          "(readable straight from a memory mapping).");
+ABSL_FLAG(bool, boolean_intervals, true,
+          "If true, JSON output has the boolean series (apnea, face blinking / talking) as run-length intervals "
+          "(much smaller, but only read back by this tool); otherwise, one entry per measurement, as the Physiology "
+          "REST API sends them.");
+
+absl::Status ConvertBinaryToJson(const std::filesystem::path& input_path, const std::filesystem::path& output_path) {
+    auto file_or_status = examples::MetricsBinaryFile::Open(input_path);
+    if (!file_or_status.ok()) {
+        return file_or_status.status();
+    }
+    auto columns_or_status = file_or_status.value()->ReadColumns();
+    if (!columns_or_status.ok()) {
+        return columns_or_status.status();
+    }
+    examples::RestMetricsWriterSettings writer_settings;
+    writer_settings.boolean_intervals = absl::GetFlag(FLAGS_boolean_intervals);
+    std::ofstream output_file(output_path);
+    output_file << examples::ToRestApiJsonText(columns_or_status.value(), writer_settings);
+    if (output_file.fail()) {
+        return absl::InternalError("Could not write " + output_path.string());
+    }
+    return absl::OkStatus();
+}
+
+absl::Status ConvertJsonToBinary(const std::filesystem::path& input_path, const std::filesystem::path& output_path) {
+    std::ifstream input_file(input_path);
+    if (!input_file.is_open()) {
+        return absl::NotFoundError("Could not open " + input_path.string());
+    }
+    std::stringstream json_text;
+    json_text << input_file.rdbuf();
+    auto columns_or_status = examples::ParseRestApiMetricsColumns(json_text.str());
+    if (!columns_or_status.ok()) {
+        return columns_or_status.status();
+    }
+    return examples::WriteMetricsBinaryFile(
+        output_path, columns_or_status.value(),
+        absl::GetFlag(FLAGS_compact) ? examples::MetricsColumnEncoding::DeltaVarint
+                                     : examples::MetricsColumnEncoding::Raw
+    );
+}
+
+absl::Status Convert() {
+    const std::filesystem::path input_path = absl::GetFlag(FLAGS_input_path);
+    const bool binary_input = input_path.extension() == examples::kMetricsBinaryFileExtension;
+    std::filesystem::path output_path = absl::GetFlag(FLAGS_output_path);
+    if (output_path.empty()) {
+        output_path = input_path;
+        output_path.replace_extension(binary_input ? ".json" : examples::kMetricsBinaryFileExtension);
+    }
+    if (binary_input) {
+        MP_RETURN_IF_ERROR(ConvertBinaryToJson(input_path, output_path));
+    } else {
+        MP_RETURN_IF_ERROR(ConvertJsonToBinary(input_path, output_path));
+    }
+    LOG(INFO) << "Converted " << input_path.string() << " (" << std::filesystem::file_size(input_path)
+              << " bytes) to " << output_path.string() << " (" << std::filesystem::file_size(output_path)
+              << " bytes).";
+    return absl::OkStatus();
+}
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+
+    absl::SetProgramUsageMessage(
+        "Convert metrics between the binary metrics file format (.ssmb) and the JSON format of the Physiology REST API."
+    );
+    absl::ParseCommandLine(argc, argv);
+    if (absl::GetFlag(FLAGS_also_log_to_stderr)) {
+        FLAGS_alsologtostderr = true;
+    }
+    if (absl::GetFlag(FLAGS_input_path).empty()) {
+        LOG(ERROR) << "An input path is required. Run with --help=main to see usage.";
+        exit(-1);
+    }
+
+    absl::Status status = Convert();
+
+    if (!status.ok()) {
+        LOG(ERROR) << "Run failed. " << status.message();
+        return EXIT_FAILURE;
+    } else {
+        LOG(INFO) << "Success!";
+    }
+    return 0;
+}
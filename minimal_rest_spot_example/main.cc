@@ -1,8 +1,10 @@
 #include <smartspectra/container/foreground_container.hpp>
 #include <physiology/interface/glog/logging.h>
 #include <physiology/interface/nlohmann/json.hpp>
+#include "common/pipeline_metrics.hpp"
 namespace spectra = presage::smartspectra;
 namespace settings = presage::smartspectra::container::settings;
+namespace examples = presage::smartspectra::examples;
 using DeviceType = presage::platform_independence::DeviceType;
 
 int main(int argc, char** argv) {
@@ -13,12 +15,20 @@ int main(int argc, char** argv) {
     settings.integration.physiology_key = "YOUR_API_KEY_HERE";
     settings.spot.spot_duration_s = 30;
 
-    spectra::container::SpotRestForegroundContainer<DeviceType::Cpu> container(settings);
-    container.OnMetricsOutput = [](const nlohmann::json& metrics) {
+    // per-stage latencies & frame rates, logged every 10 s
+    examples::PipelineMetrics pipeline_metrics;
+    auto reporter = examples::PipelineMetricsReporter::Start(pipeline_metrics, {/*log_interval_seconds=*/10});
+
+    examples::InstrumentedContainer<spectra::container::SpotRestForegroundContainer<DeviceType::Cpu>> container(
+        &pipeline_metrics, settings
+    );
+    container.OnMetricsOutput = [&container](const nlohmann::json& metrics) {
+        container.RecordMetricsOutput();
         LOG(INFO) << "Got metrics from Physiology REST API: " << metrics;
         return absl::OkStatus();
     };
-    auto status = container.Initialize();
+    auto status = reporter.status();
+    if (status.ok()) { status = container.Initialize(); }
     if (status.ok()) { status = container.Run(); }
 
     if (!status.ok()) {
@@ -1,22 +1,41 @@
 // stdlib includes
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
 
 // third-party includes
 #include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/status/statusor.h>
 #include <physiology/interface/absl/flags/flag.h>
 #include <physiology/interface/absl/flags/parse.h>
 #include <physiology/interface/absl/flags/usage.h>
 #include <physiology/interface/glog/logging.h>
 #include <physiology/modules/configuration.h>
+#include <physiology/modules/filesystem_absl.h>
 #include <smartspectra/container/settings.hpp>
 #include <smartspectra/video_source/camera/camera.hpp>
 #include <smartspectra/container/foreground_container.hpp>
 #include <smartspectra/formats/metrics.hpp>
 
+// local includes
+#include "common/adaptive_pacing.hpp"
+#include "common/metrics_binary_file.hpp"
+#include "common/pipeline_metrics.hpp"
+#include "common/rest_metrics_parser.hpp"
+#include "common/spot_uploader.hpp"
+#include "common/startup_profile.hpp"
+#include "common/threaded_video_sink.hpp"
+
 namespace pcam = presage::camera;
 namespace spectra = presage::smartspectra;
 namespace settings = presage::smartspectra::container::settings;
 namespace vs = presage::smartspectra::video_source;
+namespace examples = presage::smartspectra::examples;
 // region ==================================== CAMERA PARAMETERS =======================================================
 //TODO: implement ABSL_FLAG_GROUP(group_name, param1, param2, param3, ...) macro in Abseil,
 // which prints visually-separated, named groups of parameters/flags in help message, and use it here
@@ -56,6 +75,24 @@ ABSL_FLAG(int, interframe_delay, 20,
           "Delay, in milliseconds, before capturing the next frame: "
           "higher values may free more Cpu resources for the graph, giving it more time to process what it already has "
           "and drop fewer frames, resulting in more robust output metrics.");
+ABSL_FLAG(bool, adaptive_interframe_delay, false,
+          "If true, `--interframe_delay` is only where the delay starts: it is then adjusted on the fly, growing while "
+          "the per-frame processing time is over `--pacing_target_processing_ms` (i.e. the graph is falling behind), "
+          "and shrinking while more than `--pacing_target_drop_rate` of the input frames are dropped. The delay and "
+          "dropped-frame counts are logged every few seconds.");
+ABSL_FLAG(double, pacing_target_processing_ms, 0.0,
+          "Per-frame processing time to stay under with `--adaptive_interframe_delay`. When 0, 80% of the input frame "
+          "interval.");
+ABSL_FLAG(double, pacing_target_drop_rate, 0.01,
+          "Fraction of input frames that may be dropped with `--adaptive_interframe_delay` before the delay is cut. "
+          "Not used for inputs without exact frame timestamps, whose dropped frames cannot be told apart.");
+ABSL_FLAG(int, pipeline_stats_interval, 10,
+          "Interval, in seconds, at which per-stage pipeline latencies (frame capture, processing, last frame to "
+          "metrics, i.e. including the REST API round trip), frame rates and dropped-frame counts are logged as one "
+          "JSON line. When 0, they are not logged.");
+ABSL_FLAG(uint16_t, pipeline_stats_port, 0,
+          "When non-zero, the pipeline stats are also served in the Prometheus text format at "
+          "http://127.0.0.1:<port>/metrics.");
 ABSL_FLAG(bool, start_with_recording_on, false, "Attempt to switch data recording on at the start (even in streaming mode).");
 ABSL_FLAG(int, start_time_offset_ms, 0,
           "Offset, in milliseconds, before capturing the first frame: "
@@ -70,12 +107,51 @@ ABSL_FLAG(std::string,
           "out",
           "Directory where to save preprocessed analysis data as JSON. "
           "If it does not exist, the app will attempt to make one.");
+ABSL_FLAG(bool, save_metrics, false,
+          "If true, save the metrics retrieved from the Physiology REST API to the output directory, "
+          "in the format given by metrics_file_format.");
+ABSL_FLAG(examples::MetricsFileFormat, metrics_file_format, examples::MetricsFileFormat::Json,
+          "Format to save metrics in: `json` (metrics.json), or `binary` / `compact_binary` "
+          "(metrics.ssmb, see docs/metrics_binary_format.md). Possible values: "
+          + absl::StrJoin(examples::GetMetricsFileFormatNames(), ", "));
 ABSL_FLAG(int, verbosity, 1, "Verbosity level -- raise to print more.");
+ABSL_FLAG(bool, startup_profile, false,
+          "If true, log how long it took from process start to the first processed frame, broken down into flag "
+          "parsing, container initialization (graph setup and, unless initialized early, the video source), graph "
+          "start (with model loading), first frame capture and first frame processing (see README).");
+ABSL_FLAG(bool, early_video_source_initialization, false,
+          "If true, initialize the video source (opening the camera and, with `--auto_lock`, settling its exposure, "
+          "or opening the input) on a thread of its own, alongside the graph setup, instead of after it.");
 ABSL_FLAG(std::string, physiology_key, "",
           "API key to use for the Physiology online service. "
           "If not provided, final features and/or metrics are not retrieved.");
 // region ======================== SPOT-MODE SETTINGS ==================================================================
 ABSL_FLAG(double, spot_duration, 30.0, "Spot duration in floating-point seconds.");
+ABSL_FLAG(int, spot_count, 1,
+          "Number of spot measurements to take back to back. Without `--async_upload`, each one waits for the "
+          "Physiology REST API to answer before the next one starts capturing. Above 1, the container's Run() is "
+          "called once per spot, which is assumed (not verified against every SDK release) to start a new spot.");
+// endregion ===========================================================================================================
+// region ======================== ASYNC UPLOAD SETTINGS ===============================================================
+ABSL_FLAG(bool, async_upload, false,
+          "If true, the preprocessed data of each spot is handed to a background uploader (retrying with backoff, and "
+          "spooled to disk until it gets through), and the next spot starts capturing right away. Metrics are "
+          "logged (and saved, with `--save_metrics`) as the responses come in. The uploaded body is the file the "
+          "SDK's save-to-disk mode writes, assumed to be what the REST API expects; this has only been checked "
+          "against mock_physiology_rest_server, not the Physiology REST API itself.");
+ABSL_FLAG(std::string, upload_url, "",
+          "Endpoint to upload the preprocessed data to with `--async_upload`. Only plain http:// is supported (no "
+          "TLS), e.g. http://127.0.0.1:8088/ for mock_physiology_rest_server, or a local TLS-terminating proxy to "
+          "the Physiology REST API. The physiology key is sent in the \"x-api-key\" header.");
+ABSL_FLAG(std::string, upload_spool_directory, "",
+          "Directory where preprocessed data waits to be uploaded with `--async_upload` (payloads given up on are "
+          "moved to its `failed` subdirectory). Defaults to `upload_spool` in the output directory.");
+ABSL_FLAG(int, upload_timeout_ms, 30000, "Time, in milliseconds, each upload attempt may take.");
+ABSL_FLAG(int, upload_max_attempts, 0,
+          "Number of attempts per payload before it is given up on. When 0, keep trying (until the app stops; "
+          "payloads still spooled then are picked up on the next run).");
+ABSL_FLAG(double, upload_drain_timeout, 60.0,
+          "Time, in seconds, to wait after the last spot for pending uploads to go out.");
 // endregion ===========================================================================================================
 // region =========================== VIDEO OUTPUT SETTINGS ============================================================
 ABSL_FLAG(std::string, output_video_destination, "",
@@ -92,34 +168,223 @@ ABSL_FLAG(bool, passthrough_video, false,
           "If true, output video will just use the input video frames directly (see destination "
           "documentation), without passing through any processing "
           "(which might contain rendered visual content from the graph).");
+ABSL_FLAG(bool, threaded_video_sink, true,
+          "If true, `--passthrough_video` output is encoded on a thread of its own, off the processing path, with "
+          "frames queued for it (and dropped as per `--video_sink_drop_policy` when the encoder falls behind). "
+          "Encoding times and dropped frames are part of the pipeline stats. All spots go into the same video.");
+ABSL_FLAG(int, video_sink_queue_size, 32, "Number of frames that can wait for the `--threaded_video_sink` encoder.");
+ABSL_FLAG(examples::VideoSinkDropPolicy, video_sink_drop_policy, examples::VideoSinkDropPolicy::DropOldest,
+          "What `--threaded_video_sink` does with frames when the encoder falls behind. Possible values: "
+          + absl::StrJoin(examples::GetVideoSinkDropPolicyNames(), ", "));
+ABSL_FLAG(int, video_sink_drop_every_nth, 2,
+          "With `--video_sink_drop_policy=drop_every_nth`, every n-th frame is dropped while the encoder is behind.");
+ABSL_FLAG(double, video_sink_frame_rate, 30.0, "Frame rate written into the `--threaded_video_sink` output video.");
 // endregion ===========================================================================================================
 // region ========================  CUSTOM SETTINGS (not for container) ================================================
 ABSL_FLAG(bool, use_gpu, false, "If true, use the GPU for some operations.");
 // endregion ===========================================================================================================
 
 
+examples::AdaptivePacingSettings GetAdaptivePacingSettings() {
+    return examples::AdaptivePacingSettings{
+        absl::GetFlag(FLAGS_adaptive_interframe_delay),
+        absl::GetFlag(FLAGS_interframe_delay),
+        /*min_delay_ms=*/0,
+        /*max_delay_ms=*/100,
+        absl::GetFlag(FLAGS_pacing_target_processing_ms),
+        absl::GetFlag(FLAGS_pacing_target_drop_rate)
+    };
+}
+
+// Whether the input frames are written out by a ThreadedVideoSink here rather than by the SDK's video sink.
+bool UseThreadedVideoSink() {
+    return absl::GetFlag(FLAGS_threaded_video_sink) && absl::GetFlag(FLAGS_passthrough_video) &&
+           !absl::GetFlag(FLAGS_output_video_destination).empty();
+}
+
+// Starts the sink for `--threaded_video_sink`, or returns null when it is not used.
+absl::StatusOr<std::unique_ptr<examples::ThreadedVideoSink>> StartThreadedVideoSink(
+    examples::PipelineMetrics* pipeline_metrics
+) {
+    if (!UseThreadedVideoSink()) {
+        return nullptr;
+    }
+    return examples::ThreadedVideoSink::Start(examples::ThreadedVideoSinkSettings{
+        absl::GetFlag(FLAGS_output_video_destination),
+        absl::UnparseFlag(absl::GetFlag(FLAGS_video_sink_mode)) == "gstreamer",
+        /*fourcc=*/"MJPG",
+        absl::GetFlag(FLAGS_video_sink_frame_rate),
+        static_cast<size_t>(std::max(0, absl::GetFlag(FLAGS_video_sink_queue_size))),
+        absl::GetFlag(FLAGS_video_sink_drop_policy),
+        absl::GetFlag(FLAGS_video_sink_drop_every_nth),
+        pipeline_metrics
+    });
+}
+
+std::filesystem::path GetOutputDirectory() {
+    return absl::GetFlag(FLAGS_output_directory);
+}
+
+// With --async_upload, the container saves the preprocessed data of each spot here instead of uploading it itself.
+// The uploader sends these files as they are, on the assumption that they are the body the REST API takes (only
+// checked against mock_physiology_rest_server).
+std::filesystem::path GetSpotPayloadDirectory() {
+    return GetOutputDirectory() / "spot_payloads";
+}
+
+absl::Status HandleMetrics(
+    const absl::StatusOr<spectra::formats::Metrics>& metrics_or_status,
+    const std::string& metrics_file_stem
+) {
+    if (!metrics_or_status.ok()) {
+        return metrics_or_status.status();
+    }
+    const spectra::formats::Metrics& metrics = metrics_or_status.value();
+    LOG(INFO) << "Got metrics from Physiology REST API: pulse " << metrics.pulse.strict << " bpm ("
+              << metrics.pulse.trace.size() << " trace points), breathing " << metrics.breathing.strict << " Bpm ("
+              << metrics.breathing.upper_trace.size() << " trace points).";
+    // converting the whole struct back to (pretty) JSON is costly for long spots, so only do it when asked to (--v=1)
+    VLOG(1) << "Metrics: " << nlohmann::json(metrics).dump(2);
+    if (absl::GetFlag(FLAGS_save_metrics)) {
+        MP_RETURN_IF_ERROR(presage::filesystem::abseil::CreateDirectoryIfMissing(GetOutputDirectory().string()));
+        return examples::SaveMetrics(
+            metrics, GetOutputDirectory() / metrics_file_stem, absl::GetFlag(FLAGS_metrics_file_format)
+        );
+    }
+    return absl::OkStatus();
+}
+
+// Hands whatever preprocessed data the container saved for the last spot over to the uploader.
+absl::Status EnqueueSpotPayloads(examples::SpotUploader& uploader) {
+    std::vector<std::filesystem::path> payload_paths;
+    for (const auto& entry: std::filesystem::directory_iterator(GetSpotPayloadDirectory())) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json") {
+            payload_paths.push_back(entry.path());
+        }
+    }
+    if (payload_paths.empty()) {
+        LOG(WARNING) << "No preprocessed data was saved for the spot, there is nothing to upload.";
+    }
+    std::sort(payload_paths.begin(), payload_paths.end());
+    for (const auto& payload_path: payload_paths) {
+        MP_RETURN_IF_ERROR(uploader.Enqueue(payload_path));
+    }
+    return absl::OkStatus();
+}
+
+absl::StatusOr<std::unique_ptr<examples::SpotUploader>> StartSpotUploader(examples::PipelineMetrics& pipeline_metrics) {
+    std::error_code error;
+    std::filesystem::create_directories(GetSpotPayloadDirectory(), error);
+    if (error) {
+        return absl::InternalError("Could not create " + GetSpotPayloadDirectory().string() + ": " + error.message());
+    }
+    const std::string spool_directory = absl::GetFlag(FLAGS_upload_spool_directory);
+    examples::SpotUploaderSettings uploader_settings;
+    uploader_settings.upload_url = absl::GetFlag(FLAGS_upload_url);
+    uploader_settings.api_key = absl::GetFlag(FLAGS_physiology_key);
+    uploader_settings.spool_directory =
+        spool_directory.empty() ? GetOutputDirectory() / "upload_spool" : std::filesystem::path(spool_directory);
+    uploader_settings.request_timeout_ms = absl::GetFlag(FLAGS_upload_timeout_ms);
+    uploader_settings.max_attempts = absl::GetFlag(FLAGS_upload_max_attempts);
+    uploader_settings.pipeline_metrics = &pipeline_metrics;
+    return examples::SpotUploader::Start(
+        uploader_settings,
+        [](const std::filesystem::path& payload_path, std::string_view response_body) {
+            // the response text is at hand here, so it is read straight into the metrics, without a JSON DOM;
+            // the file is named after the payload, which is named after the time it was spooled
+            return HandleMetrics(
+                examples::ParseRestApiMetrics(response_body), "metrics_" + payload_path.stem().string()
+            );
+        }
+    );
+}
+
 template<presage::platform_independence::DeviceType TDeviceType>
 absl::Status RunRestSpotPreprocessing(
-    settings::Settings<settings::OperationMode::Spot, settings::IntegrationMode::JsonRestApi>& settings
+    settings::Settings<settings::OperationMode::Spot, settings::IntegrationMode::JsonRestApi>& settings,
+    examples::StartupProfile& startup_profile
 ) {
-    spectra::container::SpotRestForegroundContainer<TDeviceType> container(settings);
-    container.OnMetricsOutput = [](const nlohmann::json& api_json_metrics) {
-        auto metrics_or_status = spectra::formats::MetricsFromRestApiJson(api_json_metrics);
-        if (!metrics_or_status.ok()) {
-            return metrics_or_status.status();
+    examples::PipelineMetrics pipeline_metrics;
+    auto reporter_or_status = examples::PipelineMetricsReporter::Start(
+        pipeline_metrics,
+        examples::PipelineMetricsReporterSettings{
+            absl::GetFlag(FLAGS_pipeline_stats_interval),
+            absl::GetFlag(FLAGS_pipeline_stats_port)
         }
-        spectra::formats::Metrics metrics = metrics_or_status.value();
-        nlohmann::json metrics_nice_json{metrics};
-        LOG(INFO) << "Got metrics from Physiology REST API: " << metrics_nice_json.dump(2);
-        return absl::OkStatus();
+    );
+    if (!reporter_or_status.ok()) {
+        return reporter_or_status.status();
+    }
+    std::unique_ptr<examples::SpotUploader> uploader;
+    if (absl::GetFlag(FLAGS_async_upload)) {
+        auto uploader_or_status = StartSpotUploader(pipeline_metrics);
+        if (!uploader_or_status.ok()) {
+            return uploader_or_status.status();
+        }
+        uploader = std::move(uploader_or_status.value());
+    }
+    auto video_sink_or_status = StartThreadedVideoSink(&pipeline_metrics);
+    if (!video_sink_or_status.ok()) {
+        return video_sink_or_status.status();
+    }
+    const std::unique_ptr<examples::ThreadedVideoSink> video_sink = std::move(video_sink_or_status).value();
+    const int spot_count = absl::GetFlag(FLAGS_spot_count);
+    int i_spot = 0;
+    examples::StartupContainer<examples::PacedContainer<examples::InstrumentedContainer<
+        examples::RecordedContainer<spectra::container::SpotRestForegroundContainer<TDeviceType>>
+    >>> container(
+        absl::GetFlag(FLAGS_startup_profile) ? &startup_profile : nullptr,
+        GetAdaptivePacingSettings(),
+        &pipeline_metrics,
+        video_sink.get(),
+        settings
+    );
+    container.OnMetricsOutput = [&container, &i_spot, spot_count](const nlohmann::json& api_json_metrics) {
+        container.RecordMetricsOutput();
+        return HandleMetrics(
+            spectra::formats::MetricsFromRestApiJson(api_json_metrics),
+            spot_count > 1 ? absl::StrCat("metrics_", i_spot + 1) : "metrics"
+        );
     };
+    if (absl::GetFlag(FLAGS_early_video_source_initialization)) {
+        container.StartVideoSourceInitialization();
+    }
     MP_RETURN_IF_ERROR(container.Initialize());
-    MP_RETURN_IF_ERROR(container.Run());
+    startup_profile.Mark("container_initialized");
+    for (; i_spot < spot_count; i_spot++) {
+        const auto spot_start = std::chrono::steady_clock::now();
+        MP_RETURN_IF_ERROR(container.Run());
+        if (uploader != nullptr) {
+            MP_RETURN_IF_ERROR(EnqueueSpotPayloads(*uploader));
+        }
+        LOG(INFO) << "Spot " << i_spot + 1 << "/" << spot_count << " done in "
+                  << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - spot_start).count()
+                  << " ms" << (uploader != nullptr ? " (upload queued)." : " (including the upload).");
+    }
+    if (video_sink != nullptr) {
+        MP_RETURN_IF_ERROR(video_sink->Close());
+        LOG(INFO) << "Video sink: " << video_sink->Summarize();
+    }
+    if (absl::GetFlag(FLAGS_adaptive_interframe_delay)) {
+        LOG(INFO) << "Adaptive interframe delay: " << container.GetPacer().Summarize();
+    }
+    if (uploader != nullptr) {
+        const auto drain_timeout = std::chrono::milliseconds(
+            static_cast<int64_t>(absl::GetFlag(FLAGS_upload_drain_timeout) * 1000.0)
+        );
+        if (!uploader->WaitUntilIdle(drain_timeout)) {
+            LOG(WARNING) << "Uploads still pending after " << absl::GetFlag(FLAGS_upload_drain_timeout) << " s.";
+        }
+        LOG(INFO) << "Spot uploads: " << uploader->Summarize();
+    }
 
     return absl::OkStatus();
 }
 
 int main(int argc, char** argv) {
+    // from the start, since whether it is logged is only known once the flags are parsed
+    examples::StartupProfile startup_profile;
+    startup_profile.Mark("main");
     google::InitGoogleLogging(argv[0]);
 
     absl::SetProgramUsageMessage(
@@ -128,6 +393,7 @@ int main(int argc, char** argv) {
         "the input video if a valid Physiology Web API key is provided via the --api_key argument."
     );
     absl::ParseCommandLine(argc, argv);
+    startup_profile.Mark("flags_parsed");
 
     if (absl::GetFlag(FLAGS_also_log_to_stderr)) {
         FLAGS_alsologtostderr = true;
@@ -144,13 +410,15 @@ int main(int argc, char** argv) {
             absl::GetFlag(FLAGS_auto_lock),
             absl::GetFlag(FLAGS_input_video_path),
         },
-        settings::VideoSinkSettings{
+        // with `--threaded_video_sink`, the input frames are written out by the sink set up around the container
+        UseThreadedVideoSink() ? settings::VideoSinkSettings{} : settings::VideoSinkSettings{
             absl::GetFlag(FLAGS_output_video_destination),
             absl::GetFlag(FLAGS_video_sink_mode),
             absl::GetFlag(FLAGS_passthrough_video)
         },
         absl::GetFlag(FLAGS_headless),
-        absl::GetFlag(FLAGS_interframe_delay),
+        // with adaptive pacing, the container only waits the minimum and the paced video source does the rest
+        absl::GetFlag(FLAGS_adaptive_interframe_delay) ? 1 : absl::GetFlag(FLAGS_interframe_delay),
         absl::GetFlag(FLAGS_start_with_recording_on),
         absl::GetFlag(FLAGS_start_time_offset_ms),
         absl::GetFlag(FLAGS_scale_input),
@@ -162,7 +430,14 @@ int main(int argc, char** argv) {
         settings::SpotSettings {
             absl::GetFlag(FLAGS_spot_duration)
         },
-        settings::JsonRestApiSettings{
+        // with --async_upload, the container only saves the preprocessed data, and the uploader takes it from there
+        absl::GetFlag(FLAGS_async_upload)
+        ? settings::JsonRestApiSettings{
+            /*physiology_key=*/"",
+            GetSpotPayloadDirectory().string(),
+            /*save_to_disk=*/true,
+        }
+        : settings::JsonRestApiSettings{
             absl::GetFlag(FLAGS_physiology_key),
             absl::GetFlag(FLAGS_output_directory),
             /*save_to_disk=*/false,
@@ -176,16 +451,27 @@ int main(int argc, char** argv) {
         LOG(ERROR) << "Cannot use headless mode without loading video. Run with --help=main to see usage.";
         exit(-1);
     }
+    if (absl::GetFlag(FLAGS_spot_count) < 1) {
+        LOG(ERROR) << "--spot_count must be at least 1. Run with --help=main to see usage.";
+        exit(-1);
+    }
+    if (absl::GetFlag(FLAGS_async_upload) && absl::GetFlag(FLAGS_upload_url).empty()) {
+        LOG(ERROR) << "Cannot use --async_upload without an --upload_url. Run with --help=main to see usage.";
+        exit(-1);
+    }
+    startup_profile.Mark("settings_built");
 
 #ifdef WITH_OPENGL
     if (absl::GetFlag(FLAGS_use_gpu)) {
-        status = RunRestSpotPreprocessing<presage::platform_independence::DeviceType::OpenGl>(settings);
+        status = RunRestSpotPreprocessing<presage::platform_independence::DeviceType::OpenGl>(
+            settings, startup_profile
+        );
     } else {
-        status = RunRestSpotPreprocessing<presage::platform_independence::DeviceType::Cpu>(settings);
+        status = RunRestSpotPreprocessing<presage::platform_independence::DeviceType::Cpu>(settings, startup_profile);
     }
 #else
     // no choice left here but to use Cpu-only version
-    status = RunRestSpotPreprocessing<presage::platform_independence::DeviceType::Cpu>(settings);
+    status = RunRestSpotPreprocessing<presage::platform_independence::DeviceType::Cpu>(settings, startup_profile);
 #endif
 
     if (!status.ok()) {
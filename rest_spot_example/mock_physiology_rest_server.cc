@@ -0,0 +1,288 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Mock Physiology REST API endpoint: answers every POSTed spot measurement payload with synthetic metrics in the REST
+// API response schema, after an injectable delay and with injectable failures, for exercising the asynchronous upload
+// mode of rest_spot_example (--async_upload) locally.
+
+// stdlib includes
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+// third-party includes
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/strings/ascii.h>
+#include <physiology/interface/absl/strings/numbers.h>
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/latency_histogram.hpp"
+#include "common/metric_columns.hpp"
+#include "common/rest_metrics_writer.hpp"
+
+namespace examples = presage::smartspectra::examples;
+
+ABSL_FLAG(bool, also_log_to_stderr, false, "If true, log to stderr as well.");
+ABSL_FLAG(uint16_t, port, 8088, "Port to accept uploads on, at http://127.0.0.1:<port>/ (any path).");
+ABSL_FLAG(int, response_delay_ms, 0, "Delay, in milliseconds, before answering each upload.");
+ABSL_FLAG(double, failure_rate, 0.0, "Fraction (0-1) of uploads answered with HTTP 503 instead of metrics.");
+ABSL_FLAG(int, fail_first_uploads, 0,
+          "Number of uploads, from the start, to answer with HTTP 503 (e.g. to see payloads pile up in the spool and "
+          "go out once the service \"comes back\").");
+ABSL_FLAG(double, spot_duration, 30.0, "Duration, in seconds, covered by the synthetic metrics in each response.");
+ABSL_FLAG(int, seed, -1, "Seed for the injected failures. When negative, a random seed is used.");
+
+namespace {
+
+std::atomic<bool> stop_requested{false};
+
+void HandleStopSignal(int) {
+    stop_requested = true;
+}
+
+constexpr size_t kMaxRequestSize = 256 * 1024 * 1024;
+constexpr float kTraceFrameRate = 30.0f;
+
+// Steady 60 bpm pulse and 15 Bpm breathing, with the traces to go with them.
+std::string BuildMetricsResponse(double spot_duration) {
+    examples::MetricsColumns columns;
+    columns.version = "mock";
+    const auto duration = static_cast<float>(spot_duration);
+    for (int second = 1; static_cast<float>(second) <= duration; second++) {
+        const auto time = static_cast<float>(second);
+        columns.pulse_rate.time.push_back(time);
+        columns.pulse_rate.value.push_back(60.0f);
+        columns.pulse_rate.confidence.push_back(0.9f);
+        columns.breathing_rate.time.push_back(time);
+        columns.breathing_rate.value.push_back(15.0f);
+        columns.breathing_rate.confidence.push_back(0.9f);
+    }
+    for (int i_frame = 0; static_cast<float>(i_frame) < duration * kTraceFrameRate; i_frame++) {
+        const float time = static_cast<float>(i_frame) / kTraceFrameRate;
+        columns.pulse_trace.time.push_back(time);
+        columns.pulse_trace.value.push_back(std::sin(2.0f * static_cast<float>(M_PI) * time));
+        columns.breathing_upper_trace.time.push_back(time);
+        columns.breathing_upper_trace.value.push_back(std::sin(2.0f * static_cast<float>(M_PI) * time / 4.0f));
+        columns.apnea.Append(time, false);
+        columns.face_blinking.Append(time, false);
+        columns.face_talking.Append(time, false);
+    }
+    columns.pulse_strict = 60.0f;
+    columns.pulse_snr_sufficient = true;
+    columns.breathing_strict = 15.0f;
+    columns.breathing_snr_sufficient = true;
+    return examples::ToRestApiJsonText(columns);
+}
+
+struct ServerStatistics {
+    std::atomic<int64_t> upload_count{0};
+    std::atomic<int64_t> failed_upload_count{0};
+    std::atomic<int64_t> received_byte_count{0};
+    // from the first byte of a request to the last byte of the response
+    examples::LatencyHistogram request_histogram;
+
+    void Log() const {
+        LOG(INFO) << "Served " << upload_count << " uploads (" << failed_upload_count << " failed on purpose, "
+                  << received_byte_count / 1024 << " KiB received); " << request_histogram.Summarize();
+    }
+};
+
+class MockRestServer {
+public:
+    MockRestServer() : metrics_response(BuildMetricsResponse(absl::GetFlag(FLAGS_spot_duration))),
+                       random_engine(absl::GetFlag(FLAGS_seed) >= 0
+                                     ? static_cast<unsigned>(absl::GetFlag(FLAGS_seed))
+                                     : std::random_device{}()) {}
+
+    void Serve(int connection_descriptor) {
+        const auto start = std::chrono::steady_clock::now();
+        // a client that stops sending must not hold up shutdown forever
+        timeval timeout{30, 0};
+        setsockopt(connection_descriptor, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        size_t body_size = 0;
+        const bool read = ReadRequest(connection_descriptor, body_size);
+        if (read) {
+            statistics.received_byte_count += static_cast<int64_t>(body_size);
+            const int64_t upload_index = statistics.upload_count++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(absl::GetFlag(FLAGS_response_delay_ms)));
+            if (ShouldFail(upload_index)) {
+                statistics.failed_upload_count++;
+                SendResponse(connection_descriptor, "503 Service Unavailable", "{\"error\":\"injected failure\"}");
+                VLOG(1) << "Failed upload " << upload_index << " (" << body_size << " bytes) on purpose.";
+            } else {
+                SendResponse(connection_descriptor, "200 OK", metrics_response);
+                VLOG(1) << "Answered upload " << upload_index << " (" << body_size << " bytes).";
+            }
+            statistics.request_histogram.Record(std::chrono::steady_clock::now() - start);
+        } else {
+            SendResponse(connection_descriptor, "400 Bad Request", "{\"error\":\"malformed request\"}");
+        }
+        close(connection_descriptor);
+    }
+
+    const ServerStatistics& GetStatistics() const { return statistics; }
+
+private:
+    // Reads the headers and the whole body (the latter is not looked at beyond its size).
+    static bool ReadRequest(int connection_descriptor, size_t& body_size) {
+        std::string request;
+        char buffer[64 * 1024];
+        size_t head_end = std::string::npos;
+        size_t content_length = 0;
+        while (true) {
+            if (head_end != std::string::npos && request.size() >= head_end + 4 + content_length) {
+                body_size = content_length;
+                return true;
+            }
+            const ssize_t size = recv(connection_descriptor, buffer, sizeof(buffer), 0);
+            if (size < 0 && errno == EINTR) {
+                continue;
+            }
+            if (size <= 0 || request.size() > kMaxRequestSize) {
+                return false;
+            }
+            request.append(buffer, static_cast<size_t>(size));
+            if (head_end == std::string::npos) {
+                head_end = request.find("\r\n\r\n");
+                if (head_end == std::string::npos) {
+                    continue;
+                }
+                if (request.rfind("POST ", 0) != 0) {
+                    return false;
+                }
+                const std::string head = absl::AsciiStrToLower(request.substr(0, head_end));
+                const size_t length_start = head.find("\r\ncontent-length:");
+                if (length_start != std::string::npos) {
+                    const size_t value_start = length_start + std::strlen("\r\ncontent-length:");
+                    const std::string value = head.substr(value_start, head.find("\r\n", value_start) - value_start);
+                    if (!absl::SimpleAtoi(absl::StripAsciiWhitespace(value), &content_length)) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    static void SendResponse(int connection_descriptor, const std::string& status, const std::string& body) {
+        const std::string response = absl::StrCat(
+            "HTTP/1.1 ", status, "\r\nContent-Type: application/json\r\nContent-Length: ", body.size(),
+            "\r\nConnection: close\r\n\r\n", body
+        );
+        size_t sent_size = 0;
+        while (sent_size < response.size()) {
+            const ssize_t result = send(
+                connection_descriptor, response.data() + sent_size, response.size() - sent_size, MSG_NOSIGNAL
+            );
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                LOG(WARNING) << "Could not send the response: " << std::strerror(errno);
+                return;
+            }
+            sent_size += static_cast<size_t>(result);
+        }
+    }
+
+    bool ShouldFail(int64_t upload_index) {
+        if (upload_index < absl::GetFlag(FLAGS_fail_first_uploads)) {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(random_mutex);
+        return std::uniform_real_distribution<double>(0.0, 1.0)(random_engine) < absl::GetFlag(FLAGS_failure_rate);
+    }
+
+    const std::string metrics_response;
+    std::mutex random_mutex;
+    std::mt19937 random_engine;
+    ServerStatistics statistics;
+};
+
+} // anonymous namespace
+
+absl::Status RunMockRestServer() {
+    const int listen_descriptor = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_descriptor < 0) {
+        return absl::InternalError(absl::StrCat("Could not create socket: ", std::strerror(errno)));
+    }
+    const int reuse_address = 1;
+    setsockopt(listen_descriptor, SOL_SOCKET, SO_REUSEADDR, &reuse_address, sizeof(reuse_address));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(absl::GetFlag(FLAGS_port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listen_descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listen_descriptor, SOMAXCONN) != 0) {
+        close(listen_descriptor);
+        return absl::UnavailableError(absl::StrCat(
+            "Could not listen on 127.0.0.1:", absl::GetFlag(FLAGS_port), ": ", std::strerror(errno)
+        ));
+    }
+    LOG(INFO) << "Accepting uploads at http://127.0.0.1:" << absl::GetFlag(FLAGS_port) << "/";
+
+    MockRestServer server;
+    std::vector<std::thread> handlers;
+    while (!stop_requested) {
+        pollfd poll_descriptor{listen_descriptor, POLLIN, 0};
+        if (poll(&poll_descriptor, 1, /*timeout=*/200) <= 0) {
+            continue;
+        }
+        const int connection_descriptor = accept4(listen_descriptor, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection_descriptor < 0) {
+            continue;
+        }
+        // with a response delay, uploads overlap like they would against the real service
+        handlers.emplace_back(&MockRestServer::Serve, &server, connection_descriptor);
+    }
+    LOG(INFO) << "Stopping: waiting for uploads in progress to be answered.";
+    for (auto& handler: handlers) {
+        handler.join();
+    }
+    close(listen_descriptor);
+    server.GetStatistics().Log();
+    return absl::OkStatus();
+}
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    absl::SetProgramUsageMessage(
+        "A mock Physiology REST API endpoint answering uploaded spot measurement payloads with synthetic metrics, "
+        "with injectable latency and failures. Stop with a keyboard interrupt."
+    );
+    absl::ParseCommandLine(argc, argv);
+    if (absl::GetFlag(FLAGS_also_log_to_stderr)) {
+        FLAGS_alsologtostderr = true;
+    }
+    std::signal(SIGINT, HandleStopSignal);
+    std::signal(SIGTERM, HandleStopSignal);
+
+    absl::Status status = RunMockRestServer();
+
+    if (!status.ok()) {
+        LOG(ERROR) << "Run failed. " << status.message();
+        return EXIT_FAILURE;
+    } else {
+        LOG(INFO) << "Success!";
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Publishes frames from a camera (or a video file) to a shared-memory frame ring, standing in for a host process that
+// owns the camera, for the Image File Folder example to read with `--shared_memory_frame_ring`.
+
+// stdlib includes
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <string>
+#include <thread>
+
+// third-party includes
+#include <opencv2/videoio.hpp>
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/shared_memory_frame_ring.hpp"
+#include "common/status_macros.hpp"
+
+namespace examples = presage::smartspectra::examples;
+
+ABSL_FLAG(bool, also_log_to_stderr, false, "If true, log to stderr as well.");
+ABSL_FLAG(std::string, shared_memory_frame_ring, "/smartspectra_frames",
+          "Name of the POSIX shared-memory frame ring to create and publish frames to.");
+ABSL_FLAG(int, camera_device_index, 0, "The index of the camera device to capture from.");
+ABSL_FLAG(int, capture_width_px, 0, "Capture width to request from the camera, in pixels. 0: camera default.");
+ABSL_FLAG(int, capture_height_px, 0, "Capture height to request from the camera, in pixels. 0: camera default.");
+ABSL_FLAG(std::string, input_video_path, "",
+          "If set, publish the frames of this video file (timestamped with their time in the video, and paced at its "
+          "frame rate unless `--pace_video` is off) instead of capturing from the camera.");
+ABSL_FLAG(bool, pace_video, true, "If true, publish video file frames at the video's frame rate.");
+ABSL_FLAG(int, slot_count, 4, "Number of frames the ring holds.");
+ABSL_FLAG(bool, wait_for_consumer, false,
+          "If true, wait for the consumer to free up a slot when the ring is full instead of dropping the frame. "
+          "Mainly useful with `--input_video_path`, to have every frame processed.");
+ABSL_FLAG(int, max_frames, 0, "Stop after publishing this many frames. 0: no limit.");
+
+namespace {
+
+std::atomic<bool> stop_requested{false};
+
+void HandleStopSignal(int) {
+    stop_requested = true;
+}
+
+int64_t NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+} // anonymous namespace
+
+absl::Status Produce() {
+    const bool from_video = !absl::GetFlag(FLAGS_input_video_path).empty();
+    cv::VideoCapture capture;
+    if (from_video) {
+        capture.open(absl::GetFlag(FLAGS_input_video_path));
+    } else {
+        capture.open(absl::GetFlag(FLAGS_camera_device_index));
+        if (absl::GetFlag(FLAGS_capture_width_px) > 0 && absl::GetFlag(FLAGS_capture_height_px) > 0) {
+            capture.set(cv::CAP_PROP_FRAME_WIDTH, absl::GetFlag(FLAGS_capture_width_px));
+            capture.set(cv::CAP_PROP_FRAME_HEIGHT, absl::GetFlag(FLAGS_capture_height_px));
+        }
+    }
+    if (!capture.isOpened()) {
+        return absl::NotFoundError(from_video ? "Could not open " + absl::GetFlag(FLAGS_input_video_path)
+                                              : "Could not open the camera.");
+    }
+    cv::Mat frame;
+    if (!capture.read(frame) || frame.empty()) {
+        return absl::OutOfRangeError("Got no frames from the input.");
+    }
+
+    examples::SharedMemoryFrameRingWriter writer;
+    MP_RETURN_IF_ERROR(writer.Open(
+        absl::GetFlag(FLAGS_shared_memory_frame_ring), frame.cols, frame.rows, absl::GetFlag(FLAGS_slot_count)
+    ));
+    LOG(INFO) << "Publishing " << frame.cols << "x" << frame.rows << " frames to "
+              << absl::GetFlag(FLAGS_shared_memory_frame_ring) << ".";
+
+    const double video_frame_rate = from_video ? capture.get(cv::CAP_PROP_FPS) : 0.0;
+    // used when the video file does not tell the presentation time of a frame
+    const auto video_frame_interval_us = static_cast<int64_t>(video_frame_rate > 0.0 ? 1e6 / video_frame_rate : 33333);
+    const auto start = std::chrono::steady_clock::now();
+    int64_t last_video_timestamp_us = -1;
+    int64_t published_frame_count = 0;
+    auto next_log_time = start + std::chrono::seconds(5);
+    const int max_frames = absl::GetFlag(FLAGS_max_frames);
+    do {
+        int64_t timestamp_us;
+        if (from_video) {
+            timestamp_us = static_cast<int64_t>(capture.get(cv::CAP_PROP_POS_MSEC) * 1e3);
+            if (timestamp_us <= last_video_timestamp_us) {
+                timestamp_us = last_video_timestamp_us + video_frame_interval_us;
+            }
+            last_video_timestamp_us = timestamp_us;
+            if (absl::GetFlag(FLAGS_pace_video)) {
+                std::this_thread::sleep_until(start + std::chrono::microseconds(timestamp_us));
+            }
+        } else {
+            timestamp_us = NowUs();
+        }
+        if (absl::GetFlag(FLAGS_wait_for_consumer)) {
+            while (!stop_requested && !writer.WaitForFreeSlot(100)) {}
+        }
+        auto published_or_status = writer.Publish(frame, timestamp_us);
+        if (!published_or_status.ok()) {
+            return published_or_status.status();
+        }
+        if (published_or_status.value()) {
+            published_frame_count++;
+        }
+        if (std::chrono::steady_clock::now() >= next_log_time) {
+            LOG(INFO) << "Published " << published_frame_count << " frames, dropped "
+                      << writer.GetDroppedFrameCount() << " while the ring was full.";
+            next_log_time += std::chrono::seconds(5);
+        }
+    } while (!stop_requested && (max_frames <= 0 || published_frame_count < max_frames) &&
+             capture.read(frame) && !frame.empty());
+
+    LOG(INFO) << "Done: published " << published_frame_count << " frames, dropped "
+              << writer.GetDroppedFrameCount() << ".";
+    return writer.Close();
+}
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+
+    absl::SetProgramUsageMessage(
+        "Publish camera (or video file) frames to a shared-memory frame ring for the Image File Folder example."
+    );
+    absl::ParseCommandLine(argc, argv);
+    if (absl::GetFlag(FLAGS_also_log_to_stderr)) {
+        FLAGS_alsologtostderr = true;
+    }
+    std::signal(SIGINT, HandleStopSignal);
+    std::signal(SIGTERM, HandleStopSignal);
+
+    absl::Status status = Produce();
+
+    if (!status.ok()) {
+        LOG(ERROR) << "Run failed. " << status.message();
+        return EXIT_FAILURE;
+    } else {
+        LOG(INFO) << "Success!";
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Checks that boolean series survive the round trip through run-length intervals (see common/metric_columns.hpp).
+
+// stdlib includes
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+// third-party includes
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/metric_columns.hpp"
+
+namespace examples = presage::smartspectra::examples;
+
+namespace {
+
+// Largest error Expand() may make on `time`: the interval error bound, which allows for one float step, plus rounding
+// the result to float.
+double GetTimeTolerance(float time) {
+    const double float_step = std::nextafter(std::abs(time), INFINITY) - std::abs(time);
+    return examples::BooleanIntervals::kMaxTimeErrorS + 2.0 * float_step;
+}
+
+// Expands the intervals of `series` back and checks that every measurement comes back with its value and time.
+examples::BooleanIntervals CheckRoundTrip(const examples::SeriesColumns<uint8_t>& series) {
+    const examples::BooleanIntervals intervals = examples::ToIntervals(series);
+    CHECK_EQ(intervals.GetMeasurementCount(), series.Size());
+    const examples::SeriesColumns<uint8_t> expanded = examples::ToColumns(intervals);
+    CHECK_EQ(expanded.Size(), series.Size());
+    for (size_t i_measurement = 0; i_measurement < series.Size(); i_measurement++) {
+        CHECK_EQ(expanded.value[i_measurement], series.value[i_measurement]) << "at " << i_measurement;
+        CHECK_LE(std::abs(static_cast<double>(expanded.time[i_measurement]) - series.time[i_measurement]),
+                 GetTimeTolerance(series.time[i_measurement]))
+            << "at " << i_measurement << ": " << expanded.time[i_measurement] << " instead of "
+            << series.time[i_measurement];
+    }
+    return intervals;
+}
+
+// An hour at 30 fps, timed as Core does (in float seconds), blinking for 0.2 s every 4 s.
+void TestEvenlyTimedFrames() {
+    examples::SeriesColumns<uint8_t> series;
+    for (int i_frame = 0; i_frame < 30 * 60 * 60; i_frame++) {
+        series.time.push_back(static_cast<float>(i_frame) / 30.0f);
+        series.value.push_back(i_frame % 120 < 6 ? 1 : 0);
+    }
+    const examples::BooleanIntervals intervals = CheckRoundTrip(series);
+    // evenly timed runs stay one interval each
+    CHECK_EQ(intervals.Size(), static_cast<size_t>(2 * 60 * 60 / 4));
+}
+
+// Frames timed by a camera, a few milliseconds off their nominal times, with a gap without a face.
+void TestUnevenlyTimedFrames() {
+    std::mt19937 generator(17);
+    std::uniform_real_distribution<double> jitter(-0.004, 0.004);
+    examples::SeriesColumns<uint8_t> series;
+    for (int i_frame = 0; i_frame < 30 * 60; i_frame++) {
+        if (i_frame >= 600 && i_frame < 660) {
+            continue;
+        }
+        series.time.push_back(static_cast<float>(i_frame / 30.0 + jitter(generator)));
+        series.value.push_back(i_frame >= 900 ? 1 : 0);
+    }
+    CheckRoundTrip(series);
+}
+
+// Evenly timed frames, each measured twice, e.g. from overlapping outputs.
+void TestRepeatedTimes() {
+    examples::SeriesColumns<uint8_t> series;
+    for (int i_frame = 0; i_frame < 300; i_frame++) {
+        series.time.push_back(static_cast<float>(i_frame / 30));
+        series.value.push_back(0);
+    }
+    CheckRoundTrip(series);
+}
+
+// Intervals built up by Append() are not extended across intervals added to them directly (e.g. when parsed).
+void TestAppendAfterParsedIntervals() {
+    examples::BooleanIntervals intervals;
+    intervals.Append(0.0f, false);
+    intervals.start_time.push_back(1.0f);
+    intervals.end_time.push_back(2.0f);
+    intervals.count.push_back(3);
+    intervals.value.push_back(0);
+    intervals.Append(2.5f, false);
+    CHECK_EQ(intervals.Size(), 3u);
+    CHECK_EQ(intervals.GetMeasurementCount(), 5u);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_alsologtostderr = true;
+
+    TestEvenlyTimedFrames();
+    TestUnevenlyTimedFrames();
+    TestRepeatedTimes();
+    TestAppendAfterParsedIntervals();
+
+    LOG(INFO) << "All metric columns tests passed.";
+    return 0;
+}
@@ -0,0 +1,186 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Checks that metrics survive the round trip through the binary metrics file format (see
+// common/metrics_binary_file.hpp) in both column encodings, and that truncated data is rejected.
+
+// stdlib includes
+#include <cstdint>
+#include <string>
+
+// third-party includes
+#include <physiology/interface/glog/logging.h>
+#include <physiology/modules/messages/metrics.pb.h>
+
+// local includes
+#include "common/metric_columns.hpp"
+#include "common/metrics_binary_file.hpp"
+
+namespace examples = presage::smartspectra::examples;
+namespace physiology = presage::physiology;
+
+namespace {
+
+// `count` measurements at 30 fps from `first_time_s`, with values (and confidences) derived from `seed`.
+void FillSeries(
+    examples::SeriesColumns<float>& series,
+    int count,
+    float first_time_s,
+    float seed,
+    bool with_confidence
+) {
+    for (int i_measurement = 0; i_measurement < count; i_measurement++) {
+        series.time.push_back(first_time_s + static_cast<float>(i_measurement) / 30.0f);
+        series.value.push_back(seed + 0.37f * static_cast<float>(i_measurement % 11) - 1.5f);
+        if (with_confidence) {
+            series.confidence.push_back(static_cast<float>(i_measurement % 5) / 4.0f);
+        }
+    }
+}
+
+examples::BooleanIntervals MakeIntervals(int count, int period) {
+    examples::BooleanIntervals intervals;
+    for (int i_frame = 0; i_frame < count; i_frame++) {
+        intervals.Append(static_cast<float>(i_frame) / 30.0f, i_frame % period < 3);
+    }
+    return intervals;
+}
+
+examples::MetricsColumns MakeColumns() {
+    examples::MetricsColumns columns;
+    FillSeries(columns.pulse_rate, 40, 1.0f, 70.0f, true);
+    FillSeries(columns.pulse_trace, 300, 0.0f, 0.0f, false);
+    columns.pulse_strict = 0.8f;
+    columns.pulse_snr_sufficient = true;
+    FillSeries(columns.breathing_rate, 40, 1.0f, 15.0f, true);
+    FillSeries(columns.breathing_upper_trace, 300, 0.0f, 0.2f, false);
+    FillSeries(columns.breathing_lower_trace, 300, 0.0f, -0.2f, false);
+    columns.breathing_strict = 0.5f;
+    FillSeries(columns.breathing_amplitude, 20, 2.0f, 1.0f, false);
+    columns.apnea = MakeIntervals(300, 100);
+    FillSeries(columns.respiratory_line_length, 20, 2.0f, 3.0f, false);
+    FillSeries(columns.inhale_exhale_ratio, 20, 2.0f, 1.2f, false);
+    FillSeries(columns.phasic_blood_pressure, 300, 0.0f, 0.0f, true);
+    columns.face_blinking = MakeIntervals(300, 45);
+    columns.face_talking = MakeIntervals(300, 200);
+    columns.version = "2.0.0";
+    return columns;
+}
+
+void CheckSameSeries(
+    const examples::SeriesColumns<float>& actual,
+    const examples::SeriesColumns<float>& expected,
+    const char* name
+) {
+    CHECK(actual.time == expected.time) << name << " times differ";
+    CHECK(actual.value == expected.value) << name << " values differ";
+    CHECK(actual.confidence == expected.confidence) << name << " confidences differ";
+}
+
+void CheckSameIntervals(
+    const examples::BooleanIntervals& actual,
+    const examples::BooleanIntervals& expected,
+    const char* name
+) {
+    CHECK(actual.start_time == expected.start_time) << name << " start times differ";
+    CHECK(actual.end_time == expected.end_time) << name << " end times differ";
+    CHECK(actual.count == expected.count) << name << " counts differ";
+    CHECK(actual.value == expected.value) << name << " values differ";
+}
+
+void CheckSameColumns(const examples::MetricsColumns& actual, const examples::MetricsColumns& expected) {
+    CheckSameSeries(actual.pulse_rate, expected.pulse_rate, "pulse rate");
+    CheckSameSeries(actual.pulse_trace, expected.pulse_trace, "pulse trace");
+    CHECK_EQ(actual.pulse_strict, expected.pulse_strict);
+    CHECK_EQ(actual.pulse_snr_sufficient, expected.pulse_snr_sufficient);
+    CheckSameSeries(actual.breathing_rate, expected.breathing_rate, "breathing rate");
+    CheckSameSeries(actual.breathing_upper_trace, expected.breathing_upper_trace, "breathing upper trace");
+    CheckSameSeries(actual.breathing_lower_trace, expected.breathing_lower_trace, "breathing lower trace");
+    CHECK_EQ(actual.breathing_strict, expected.breathing_strict);
+    CHECK_EQ(actual.breathing_snr_sufficient, expected.breathing_snr_sufficient);
+    CheckSameSeries(actual.breathing_amplitude, expected.breathing_amplitude, "breathing amplitude");
+    CheckSameIntervals(actual.apnea, expected.apnea, "apnea");
+    CheckSameSeries(actual.respiratory_line_length, expected.respiratory_line_length, "respiratory line length");
+    CheckSameSeries(actual.inhale_exhale_ratio, expected.inhale_exhale_ratio, "inhale / exhale ratio");
+    CheckSameSeries(actual.phasic_blood_pressure, expected.phasic_blood_pressure, "phasic blood pressure");
+    CheckSameIntervals(actual.face_blinking, expected.face_blinking, "face blinking");
+    CheckSameIntervals(actual.face_talking, expected.face_talking, "face talking");
+    CHECK_EQ(actual.version, expected.version);
+}
+
+void TestRoundTrip(examples::MetricsColumnEncoding encoding) {
+    const examples::MetricsColumns columns = MakeColumns();
+    const std::string data = examples::SerializeMetricsBinary(columns, encoding);
+    const absl::StatusOr<examples::MetricsColumns> read = examples::DeserializeMetricsBinary(data);
+    CHECK(read.ok()) << read.status();
+    CheckSameColumns(*read, columns);
+}
+
+void TestEmptyRoundTrip(examples::MetricsColumnEncoding encoding) {
+    const examples::MetricsColumns columns;
+    const absl::StatusOr<examples::MetricsColumns> read =
+        examples::DeserializeMetricsBinary(examples::SerializeMetricsBinary(columns, encoding));
+    CHECK(read.ok()) << read.status();
+    CheckSameColumns(*read, columns);
+}
+
+// Every proper prefix of a serialized file is rejected with an error rather than read as if it were complete.
+void TestTruncatedData(examples::MetricsColumnEncoding encoding) {
+    const std::string data = examples::SerializeMetricsBinary(MakeColumns(), encoding);
+    for (size_t size = 0; size < data.size(); size++) {
+        const absl::StatusOr<examples::MetricsColumns> read =
+            examples::DeserializeMetricsBinary(std::string_view(data.data(), size));
+        CHECK(!read.ok()) << "a truncation to " << size << " of " << data.size() << " bytes was read";
+    }
+}
+
+// The continuous examples write Core's metrics buffers through ToColumns().
+void TestMetricsBufferToColumns() {
+    physiology::MetricsBuffer metrics;
+    for (int i_frame = 0; i_frame < 90; i_frame++) {
+        const float time_s = 10.0f + static_cast<float>(i_frame) / 30.0f;
+        auto* trace = metrics.mutable_pulse()->add_trace();
+        trace->set_time(time_s);
+        trace->set_value(static_cast<float>(i_frame % 7));
+    }
+    auto* rate = metrics.mutable_pulse()->add_rate();
+    rate->set_time(12.0f);
+    rate->set_value(72.0f);
+    rate->set_confidence(0.9f);
+    metrics.mutable_breath()->add_upper_trace()->set_time(11.0f);
+
+    const examples::MetricsColumns columns = examples::ToColumns(metrics);
+    CHECK_EQ(columns.pulse_trace.Size(), 90u);
+    CHECK(columns.pulse_trace.confidence.empty());
+    CHECK_EQ(columns.pulse_trace.time[30], 11.0f);
+    CHECK_EQ(columns.pulse_trace.value[30], 2.0f);
+    CHECK_EQ(columns.pulse_rate.Size(), 1u);
+    CHECK_EQ(columns.pulse_rate.value[0], 72.0f);
+    CHECK_EQ(columns.pulse_rate.confidence.size(), 1u);
+    CHECK_EQ(columns.pulse_rate.confidence[0], 0.9f);
+    CHECK_EQ(columns.breathing_upper_trace.Size(), 1u);
+    CHECK_EQ(columns.breathing_rate.Size(), 0u);
+
+    const absl::StatusOr<examples::MetricsColumns> read = examples::DeserializeMetricsBinary(
+        examples::SerializeMetricsBinary(columns, examples::MetricsColumnEncoding::DeltaVarint));
+    CHECK(read.ok()) << read.status();
+    CheckSameColumns(*read, columns);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_alsologtostderr = true;
+
+    for (const auto encoding: {examples::MetricsColumnEncoding::Raw, examples::MetricsColumnEncoding::DeltaVarint}) {
+        TestRoundTrip(encoding);
+        TestEmptyRoundTrip(encoding);
+        TestTruncatedData(encoding);
+    }
+    TestMetricsBufferToColumns();
+
+    LOG(INFO) << "All binary metrics file tests passed.";
+    return 0;
+}
@@ -0,0 +1,219 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Checks the delta stream and metrics history helpers of common/metrics_delta.hpp on synthetic MetricsBuffers.
+
+// stdlib includes
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+// third-party includes
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/glog/logging.h>
+#include <physiology/modules/messages/metrics.pb.h>
+
+// local includes
+#include "common/metrics_delta.hpp"
+
+namespace examples = presage::smartspectra::examples;
+namespace physiology = presage::physiology;
+
+namespace {
+
+// Appends a pulse rate and a pulse trace measurement per second over [first_time_s, last_time_s], with `value`.
+void AppendPulse(physiology::MetricsBuffer& metrics, int first_time_s, int last_time_s, float value) {
+    for (int time_s = first_time_s; time_s <= last_time_s; time_s++) {
+        auto* rate = metrics.mutable_pulse()->add_rate();
+        rate->set_time(static_cast<float>(time_s));
+        rate->set_value(value);
+        auto* trace = metrics.mutable_pulse()->add_trace();
+        trace->set_time(static_cast<float>(time_s));
+        trace->set_value(value);
+    }
+}
+
+// A 60 s video split into 3 segments with 10 s of overlap (see SplitVideoFile), each processed as its own Core
+// stream, which (like the Core stand-in servers) times its metrics from 0 on, in seconds of the data it got.
+void TestStitchSegmentMetricsShiftsStreamTimes() {
+    std::vector<examples::SegmentMetrics> segments(3);
+    segments[0].read_start_s = 0.0;
+    segments[0].keep_until_s = 20.0;
+    segments[1].read_start_s = 10.0;
+    segments[1].keep_from_s = 20.0;
+    segments[1].keep_until_s = 40.0;
+    segments[2].read_start_s = 30.0;
+    segments[2].keep_from_s = 40.0;
+    AppendPulse(segments[0].metrics, 0, 19, 0.0f);
+    AppendPulse(segments[1].metrics, 0, 29, 1.0f);
+    AppendPulse(segments[2].metrics, 0, 29, 2.0f);
+
+    const physiology::MetricsBuffer stitched = examples::StitchSegmentMetrics(segments);
+
+    // the stitched series covers the whole video, once, each second from the segment it belongs to
+    CHECK_EQ(stitched.pulse().rate_size(), 60);
+    CHECK_EQ(stitched.pulse().trace_size(), 60);
+    for (int time_s = 0; time_s < 60; time_s++) {
+        const auto& rate = stitched.pulse().rate(time_s);
+        CHECK_EQ(rate.time(), static_cast<float>(time_s));
+        CHECK_EQ(rate.value(), static_cast<float>(time_s / 20)) << "at " << time_s << " s";
+        CHECK_EQ(stitched.pulse().trace(time_s).time(), static_cast<float>(time_s));
+    }
+}
+
+// Metrics that already come on the video's timeline are stitched as they are.
+void TestStitchSegmentMetricsKeepsFileTimes() {
+    std::vector<examples::SegmentMetrics> segments(2);
+    segments[0].keep_until_s = 30.0;
+    segments[1].read_start_s = 20.0;
+    segments[1].keep_from_s = 30.0;
+    AppendPulse(segments[0].metrics, 0, 29, 0.0f);
+    AppendPulse(segments[1].metrics, 20, 59, 1.0f);
+
+    const physiology::MetricsBuffer stitched = examples::StitchSegmentMetrics(segments);
+
+    CHECK_EQ(stitched.pulse().rate_size(), 60);
+    for (int time_s = 0; time_s < 60; time_s++) {
+        CHECK_EQ(stitched.pulse().rate(time_s).time(), static_cast<float>(time_s));
+        CHECK_EQ(stitched.pulse().rate(time_s).value(), time_s < 30 ? 0.0f : 1.0f);
+    }
+}
+
+void TestShiftMetricsSeries() {
+    physiology::MetricsBuffer metrics;
+    AppendPulse(metrics, 0, 2, 0.0f);
+    metrics.mutable_breath()->add_upper_trace()->set_time(1.0f);
+
+    examples::ShiftMetricsSeries(metrics, 10.0);
+
+    CHECK_EQ(examples::GetEarliestMetricsTime(metrics), 10.0);
+    CHECK_EQ(metrics.pulse().rate(2).time(), 12.0f);
+    CHECK_EQ(metrics.pulse().trace(2).time(), 12.0f);
+    CHECK_EQ(metrics.breath().upper_trace(0).time(), 11.0f);
+    CHECK_GT(examples::GetEarliestMetricsTime(physiology::MetricsBuffer()), 1e300);
+}
+
+// Outputs of a growing continuous-mode buffer, one new second each, with a full snapshot every 3 outputs.
+void TestTrackSnapshotInterval() {
+    examples::MetricsDeltaTracker tracker(examples::MetricsDeltaSettings{3});
+    physiology::MetricsBuffer metrics;
+    physiology::MetricsBuffer delta;
+    for (int i_output = 0; i_output < 7; i_output++) {
+        AppendPulse(metrics, i_output, i_output, static_cast<float>(i_output));
+        const bool is_snapshot = tracker.Track(metrics, delta);
+        CHECK_EQ(is_snapshot, i_output % 3 == 0) << "at output " << i_output;
+        CHECK_EQ(tracker.GetOutputCount(), i_output + 1);
+        if (!is_snapshot) {
+            // only the second that is new since the previous output, snapshot or not
+            CHECK_EQ(delta.pulse().rate_size(), 1) << "at output " << i_output;
+            CHECK_EQ(delta.pulse().rate(0).time(), static_cast<float>(i_output));
+            CHECK_EQ(delta.pulse().trace_size(), 1);
+            CHECK(!delta.has_breath());
+        }
+    }
+
+    // after Reset(), the next output is a snapshot again
+    tracker.Reset();
+    AppendPulse(metrics, 7, 7, 7.0f);
+    CHECK(tracker.Track(metrics, delta));
+}
+
+// A series that goes back in time (e.g. after the Core buffer was reset) is taken in full.
+void TestTrackSeriesGoingBackInTime() {
+    examples::MetricsDeltaTracker tracker(examples::MetricsDeltaSettings{0});
+    physiology::MetricsBuffer metrics;
+    physiology::MetricsBuffer delta;
+    AppendPulse(metrics, 0, 9, 0.0f);
+    CHECK(tracker.Track(metrics, delta));
+
+    physiology::MetricsBuffer reset_metrics;
+    AppendPulse(reset_metrics, 0, 2, 1.0f);
+    CHECK(!tracker.Track(reset_metrics, delta));
+    CHECK_EQ(delta.pulse().rate_size(), 3);
+    CHECK_EQ(delta.pulse().rate(0).time(), 0.0f);
+
+    // and tracked from there on
+    AppendPulse(reset_metrics, 3, 4, 1.0f);
+    CHECK(!tracker.Track(reset_metrics, delta));
+    CHECK_EQ(delta.pulse().rate_size(), 2);
+    CHECK_EQ(delta.pulse().rate(0).time(), 3.0f);
+}
+
+// Later measurements replace earlier ones from the first of them on, within the kept time range.
+void TestMergeMetricsSeries() {
+    physiology::MetricsBuffer history;
+    AppendPulse(history, 0, 9, 0.0f);
+    physiology::MetricsBuffer output;
+    AppendPulse(output, 5, 14, 1.0f);
+    output.mutable_breath()->add_upper_trace()->set_time(14.0f);
+
+    examples::MergeMetricsSeries(output, history);
+
+    CHECK_EQ(history.pulse().rate_size(), 15);
+    for (int time_s = 0; time_s < 15; time_s++) {
+        CHECK_EQ(history.pulse().rate(time_s).time(), static_cast<float>(time_s));
+        CHECK_EQ(history.pulse().rate(time_s).value(), time_s < 5 ? 0.0f : 1.0f) << "at " << time_s << " s";
+    }
+    CHECK_EQ(history.breath().upper_trace_size(), 1);
+
+    // measurements outside of [from, until) are left out, and do not displace the ones already there
+    physiology::MetricsBuffer revised;
+    AppendPulse(revised, 10, 19, 2.0f);
+    examples::MergeMetricsSeries(revised, history, 12.0, 17.0);
+    CHECK_EQ(history.pulse().rate_size(), 17);
+    CHECK_EQ(history.pulse().rate(11).value(), 1.0f);
+    CHECK_EQ(history.pulse().rate(12).value(), 2.0f);
+    CHECK_EQ(history.pulse().rate(16).time(), 16.0f);
+
+    // a source without a series leaves it alone
+    examples::MergeMetricsSeries(physiology::MetricsBuffer(), history);
+    CHECK_EQ(history.pulse().rate_size(), 17);
+}
+
+// Every run starts its own file, numbered from 0 on, and Reset() does not restart the numbering.
+void TestWriterReplacesFile() {
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / absl::StrCat("metrics_delta_test_", getpid(), ".ndjson");
+    physiology::MetricsBuffer metrics;
+    AppendPulse(metrics, 0, 1, 0.0f);
+    for (int i_run = 0; i_run < 2; i_run++) {
+        auto writer_or_status = examples::MetricsDeltaWriter::Open(path, examples::MetricsDeltaSettings{0});
+        CHECK(writer_or_status.ok()) << writer_or_status.status();
+        examples::MetricsDeltaWriter& writer = **writer_or_status;
+        CHECK(writer.Write(metrics, 0).ok());
+        writer.Reset();
+        CHECK(writer.Write(metrics, 1).ok());
+    }
+
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);) {
+        lines.push_back(line);
+    }
+    std::filesystem::remove(path);
+    CHECK_EQ(lines.size(), 2u);
+    CHECK_EQ(lines[0].rfind("{\"sequence\":0,", 0), 0u) << lines[0];
+    CHECK_EQ(lines[1].rfind("{\"sequence\":1,\"timestamp_us\":1,\"snapshot\":true,", 0), 0u) << lines[1];
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_alsologtostderr = true;
+
+    TestTrackSnapshotInterval();
+    TestTrackSeriesGoingBackInTime();
+    TestMergeMetricsSeries();
+    TestWriterReplacesFile();
+    TestShiftMetricsSeries();
+    TestStitchSegmentMetricsShiftsStreamTimes();
+    TestStitchSegmentMetricsKeepsFileTimes();
+
+    LOG(INFO) << "All metrics delta tests passed.";
+    return 0;
+}
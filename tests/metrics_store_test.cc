@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// Checks when common/metrics_store.hpp takes a step back in time as a Core buffer reset, and its JSON output.
+
+// stdlib includes
+#include <cmath>
+#include <memory>
+#include <string>
+
+// third-party includes
+#include <physiology/interface/glog/logging.h>
+
+// local includes
+#include "common/metric_columns.hpp"
+#include "common/metrics_store.hpp"
+
+namespace examples = presage::smartspectra::examples;
+
+namespace {
+
+constexpr double kBufferDurationS = 0.5;
+
+std::unique_ptr<examples::MetricsStore> CreateStore() {
+    examples::MetricsStoreSettings settings;
+    settings.max_resident_bytes = 0;
+    settings.reset_time_step_s = kBufferDurationS;
+    auto store_or_status = examples::MetricsStore::Create(settings);
+    CHECK(store_or_status.ok()) << store_or_status.status();
+    return std::move(store_or_status).value();
+}
+
+// Measurements at 10 Hz over [first_time_s, last_time_s].
+examples::SeriesColumns<float> MakeBatch(float first_time_s, float last_time_s) {
+    examples::SeriesColumns<float> batch;
+    for (int i_measurement = 0; first_time_s + i_measurement * 0.1f <= last_time_s + 1e-4f; i_measurement++) {
+        batch.time.push_back(first_time_s + i_measurement * 0.1f);
+        batch.value.push_back(1.0f);
+    }
+    return batch;
+}
+
+float GetLastTime(const examples::MetricsStore& store) {
+    const absl::StatusOr<float> last_time = store.GetLastTime("pulse.rate");
+    CHECK(last_time.ok()) << last_time.status();
+    return *last_time;
+}
+
+// A batch that ends a little (less than a buffer) before the stored data is a stale tail, and dropped.
+void TestStaleTailIsDropped() {
+    auto store = CreateStore();
+    CHECK(store->Append("pulse.rate", MakeBatch(0.0f, 10.0f)).ok());
+    CHECK(store->Append("pulse.rate", MakeBatch(9.0f, 9.7f)).ok());
+    CHECK_EQ(store->GetEpochCount(), 0);
+    CHECK_EQ(store->GetMeasurementCount(), 101u);
+    CHECK_NEAR(GetLastTime(*store), 10.0f, 1e-4f);
+}
+
+// Going back by more than a buffer, or to near 0, is a reset: the batch is stored after the earlier data.
+void TestLargeStepBackStartsEpoch() {
+    auto store = CreateStore();
+    CHECK(store->Append("pulse.rate", MakeBatch(0.0f, 10.0f)).ok());
+    CHECK(store->Append("pulse.rate", MakeBatch(3.0f, 5.0f)).ok());
+    CHECK_EQ(store->GetEpochCount(), 1);
+    CHECK_NEAR(GetLastTime(*store), 15.0f, 1e-4f);
+}
+
+void TestStepBackToNearZeroStartsEpoch() {
+    auto store = CreateStore();
+    CHECK(store->Append("pulse.rate", MakeBatch(0.0f, 0.6f)).ok());
+    CHECK(store->Append("pulse.rate", MakeBatch(0.0f, 0.3f)).ok());
+    CHECK_EQ(store->GetEpochCount(), 1);
+    CHECK_NEAR(GetLastTime(*store), 0.9f, 1e-4f);
+}
+
+// After MarkReset(), even a small step back starts an epoch, but only in the next Append().
+void TestMarkedReset() {
+    auto store = CreateStore();
+    CHECK(store->Append("pulse.rate", MakeBatch(0.0f, 10.0f)).ok());
+    store->MarkReset();
+    CHECK(store->Append("pulse.rate", MakeBatch(9.8f, 9.9f)).ok());
+    CHECK_EQ(store->GetEpochCount(), 1);
+    CHECK(store->Append("pulse.rate", MakeBatch(9.5f, 9.6f)).ok());
+    CHECK_EQ(store->GetEpochCount(), 1);
+}
+
+void TestNotANumberIsNull() {
+    auto store = CreateStore();
+    examples::SeriesColumns<float> batch = MakeBatch(0.0f, 0.1f);
+    batch.value[1] = NAN;
+    CHECK(store->Append("pulse.rate", batch).ok());
+    const absl::StatusOr<std::string> json = examples::QueryMetricsStoreJson(*store, "series=pulse.rate");
+    CHECK(json.ok()) << json.status();
+    CHECK(json->find("\"value\":[1,null]") != std::string::npos) << *json;
+    CHECK(json->find("nan") == std::string::npos) << *json;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_alsologtostderr = true;
+
+    TestStaleTailIsDropped();
+    TestLargeStepBackStartsEpoch();
+    TestStepBackToNearZeroStartsEpoch();
+    TestMarkedReset();
+    TestNotANumberIsNull();
+
+    LOG(INFO) << "All metrics store tests passed.";
+    return 0;
+}
@@ -0,0 +1,501 @@
+//
+// Copyright (c) 2026 Presage Technologies
+//
+
+// stdlib includes
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// third-party includes
+#include <physiology/interface/absl/status/status.h>
+#include <physiology/interface/absl/status/statusor.h>
+#include <physiology/interface/absl/flags/flag.h>
+#include <physiology/interface/absl/flags/parse.h>
+#include <physiology/interface/absl/flags/usage.h>
+#include <physiology/interface/absl/strings/str_cat.h>
+#include <physiology/interface/absl/strings/str_join.h>
+#include <physiology/interface/glog/logging.h>
+#include <physiology/interface/nlohmann/json.hpp>
+#include <smartspectra/container/settings.hpp>
+#include <smartspectra/video_source/camera/camera.hpp>
+#include <smartspectra/container/foreground_container.hpp>
+#include <smartspectra/formats/metrics.hpp>
+
+namespace pcam = presage::camera;
+namespace spectra = presage::smartspectra;
+namespace settings = presage::smartspectra::container::settings;
+namespace vs = presage::smartspectra::video_source;
+using DeviceType = presage::platform_independence::DeviceType;
+
+// region ==================================== CAMERA PARAMETERS =======================================================
+ABSL_FLAG(int, camera_device_index, 0,
+          "The index of the camera device to use for measurement requests that do not name an input video.");
+ABSL_FLAG(
+    vs::ResolutionSelectionMode, resolution_selection_mode, vs::ResolutionSelectionMode::Auto,
+    "A flag to specify the resolution selection mode when both a range and exact resolution are specified."
+    "Possible values: "
+    + absl::StrJoin(vs::GetResolutionSelectionModeNames(), ", ")
+);
+ABSL_FLAG(int, capture_width_px, -1,
+          "The capture width in pixels. Set to 1280 if resolution_selection_mode is set to 'auto' and no resolution range is specified.");
+ABSL_FLAG(int, capture_height_px, -1,
+          "The capture height in pixels. Set to 720 if resolution_selection_mode is set to 'auto' and no resolution range is specified.");
+ABSL_FLAG(
+    pcam::CameraResolutionRange,
+    resolution_range,
+    pcam::CameraResolutionRange::Unspecified_EnumEnd,
+    absl::StrCat(
+        "The resolution range to attempt to use. Possible values: ",
+        pcam::kCommonCameraResolutionRangeNameList
+    )
+);
+ABSL_FLAG(pcam::CaptureCodec, codec, pcam::CaptureCodec::MJPG,
+          absl::StrCat("Video codec to use in streaming capture mode. Possible values: ",
+                       pcam::kCaptureCodecNameList));
+ABSL_FLAG(bool, auto_lock, true,
+          "If true, will try to use auto-exposure before recording and lock exposure when recording starts. If false, doesn't do this automatically.");
+ABSL_FLAG(std::string, warm_up_video_path, "",
+          "Full path of a video to initialize the pooled containers with. When not provided, the containers are "
+          "initialized on the camera.");
+// endregion ===========================================================================================================
+
+ABSL_FLAG(bool, also_log_to_stderr, false, "If true, log to stderr as well.");
+ABSL_FLAG(int, interframe_delay, 20,
+          "Delay, in milliseconds, before capturing the next frame: "
+          "higher values may free more Cpu resources for the graph, giving it more time to process what it already has "
+          "and drop fewer frames, resulting in more robust output metrics.");
+ABSL_FLAG(bool, scale_input, true,
+          "If true, uses input scaling in the ImageTransformationCalculator within the graph.");
+ABSL_FLAG(bool, enable_phasic_bp, false, "If true, enable the phasic blood pressure computation.");
+ABSL_FLAG(std::string,
+          output_directory,
+          "out",
+          "Directory where to save preprocessed analysis data as JSON. "
+          "If it does not exist, the app will attempt to make one.");
+ABSL_FLAG(int, verbosity, 1, "Verbosity level -- raise to print more.");
+ABSL_FLAG(std::string, physiology_key, "",
+          "API key to use for the Physiology online service. "
+          "If not provided, final features and/or metrics are not retrieved.");
+// region ======================== SPOT-MODE SETTINGS ==================================================================
+ABSL_FLAG(double, spot_duration, 30.0, "Spot duration in floating-point seconds.");
+// endregion ===========================================================================================================
+// region ======================== SERVICE SETTINGS ====================================================================
+ABSL_FLAG(std::string, socket_path, "/tmp/smartspectra_spot.sock",
+          "Path of the Unix domain socket to accept measurement requests on. Each connection carries one request: "
+          "a single line holding a JSON object, optionally with an \"input_video_path\" (when missing, the camera is "
+          "used). The reply is a single line holding a JSON object with \"ok\", \"error\", \"metrics\", and "
+          "timings (in milliseconds).");
+ABSL_FLAG(int, pool_size, 1,
+          "Number of pre-initialized spot containers to keep, i.e. the number of measurements that can run at the "
+          "same time. Further requests wait for a container to free up. Values above 1 require "
+          "--warm_up_video_path, since the containers cannot all be initialized on the camera.");
+ABSL_FLAG(bool, compare_cold_start, false,
+          "If true, serve every request on a freshly built and initialized container instead of a warm one (and "
+          "report its initialization time), to compare cold-start to warm-start latency. The container previously "
+          "in the pool slot is destroyed before the new one is built.");
+// endregion ===========================================================================================================
+
+namespace {
+
+std::atomic<bool> stop_requested{false};
+
+void HandleStopSignal(int) {
+    stop_requested = true;
+}
+
+using SpotSettings = settings::Settings<settings::OperationMode::Spot, settings::IntegrationMode::JsonRestApi>;
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Copy of the settings a container works with, inherited ahead of the container base so that it is constructed before
+// (and destroyed after) the base, which only keeps a reference to it.
+struct OwnedSpotSettings {
+    SpotSettings owned_settings;
+};
+
+// Spot container that keeps its graph (and models) loaded between measurements,
+// re-opening only the video source for each one. Each container owns its settings, since Reset() changes them.
+template<DeviceType TDeviceType>
+class WarmSpotContainer : private OwnedSpotSettings,
+                          public spectra::container::SpotRestForegroundContainer<TDeviceType> {
+public:
+    using Base = spectra::container::SpotRestForegroundContainer<TDeviceType>;
+
+    explicit WarmSpotContainer(SpotSettings settings)
+        : OwnedSpotSettings{std::move(settings)}, Base(owned_settings) {
+        this->OnMetricsOutput = [this](const nlohmann::json& api_json_metrics) {
+            auto metrics_or_status = spectra::formats::MetricsFromRestApiJson(api_json_metrics);
+            if (!metrics_or_status.ok()) {
+                return metrics_or_status.status();
+            }
+            last_metrics = nlohmann::json(metrics_or_status.value());
+            return absl::OkStatus();
+        };
+    }
+
+    // Points the (already initialized) container at the input of the next measurement, to Run() it again.
+    // Re-running relies on SpotRestForegroundContainer (as of SmartSpectra 0.4.2) leaving its graph in a state that
+    // InitializeVideoSource() and Run() can be called again in after a run; this has not been verified against every
+    // SDK release, so a container whose reset or run fails is discarded rather than reused (see WarmSpotService).
+    absl::Status Reset(const std::string& input_video_path) {
+        last_metrics = nlohmann::json();
+        this->settings.video_source.input_video_path = input_video_path;
+        return this->InitializeVideoSource();
+    }
+
+    nlohmann::json last_metrics;
+};
+
+struct PoolStatistics {
+    std::mutex mutex;
+    double cold_start_ms_sum = 0.0;
+    int cold_start_count = 0;
+    double warm_start_ms_sum = 0.0;
+    int warm_start_count = 0;
+
+    void Add(bool warm, double start_ms) {
+        std::lock_guard<std::mutex> lock(mutex);
+        (warm ? warm_start_ms_sum : cold_start_ms_sum) += start_ms;
+        (warm ? warm_start_count : cold_start_count)++;
+    }
+
+    void Log() {
+        std::lock_guard<std::mutex> lock(mutex);
+        LOG(INFO) << "Mean container start-up latency: cold "
+                  << (cold_start_count > 0 ? cold_start_ms_sum / cold_start_count : 0.0) << " ms ("
+                  << cold_start_count << " starts), warm "
+                  << (warm_start_count > 0 ? warm_start_ms_sum / warm_start_count : 0.0) << " ms ("
+                  << warm_start_count << " starts).";
+    }
+};
+
+class WarmSpotService {
+public:
+    explicit WarmSpotService(SpotSettings settings) : settings(std::move(settings)) {}
+
+    absl::Status Initialize(int pool_size) {
+        for (int i_container = 0; i_container < pool_size; i_container++) {
+            auto start = std::chrono::steady_clock::now();
+            auto container = std::make_unique<WarmSpotContainer<DeviceType::Cpu>>(settings);
+            MP_RETURN_IF_ERROR(container->Initialize());
+            double cold_start_ms = MillisecondsSince(start);
+            statistics.Add(/*warm=*/false, cold_start_ms);
+            LOG(INFO) << "Initialized spot container " << i_container + 1 << "/" << pool_size << " in "
+                      << cold_start_ms << " ms.";
+            idle_containers.push_back(std::move(container));
+        }
+        return absl::OkStatus();
+    }
+
+    // Queues an accepted connection for the next free worker.
+    void Enqueue(int connection_descriptor) {
+        std::lock_guard<std::mutex> lock(connection_mutex);
+        pending_connections.push_back({connection_descriptor, std::chrono::steady_clock::now()});
+        connection_queued.notify_one();
+    }
+
+    void StartWorkers(int worker_count) {
+        for (int i_worker = 0; i_worker < worker_count; i_worker++) {
+            workers.emplace_back(&WarmSpotService::ServeConnections, this);
+        }
+    }
+
+    // Serves the connections still queued, then stops the workers.
+    void StopWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(connection_mutex);
+            stopping = true;
+            connection_queued.notify_all();
+        }
+        for (auto& worker: workers) {
+            worker.join();
+        }
+        workers.clear();
+    }
+
+    void LogStatistics() {
+        statistics.Log();
+    }
+
+private:
+    struct PendingConnection {
+        int descriptor;
+        std::chrono::steady_clock::time_point accepted_at;
+    };
+
+    void ServeConnections() {
+        while (true) {
+            PendingConnection connection;
+            {
+                std::unique_lock<std::mutex> lock(connection_mutex);
+                connection_queued.wait(lock, [this] { return stopping || !pending_connections.empty(); });
+                if (pending_connections.empty()) {
+                    return;
+                }
+                connection = pending_connections.front();
+                pending_connections.pop_front();
+            }
+            Serve(connection.descriptor, connection.accepted_at);
+        }
+    }
+
+    void Serve(int connection_descriptor, std::chrono::steady_clock::time_point received_at) {
+        nlohmann::json reply;
+        auto request_or_status = ReadRequest(connection_descriptor);
+        if (!request_or_status.ok()) {
+            reply = {{"ok", false}, {"error", std::string(request_or_status.status().message())}};
+        } else {
+            reply = Measure(request_or_status.value(), received_at);
+        }
+        std::string reply_line = reply.dump() + "\n";
+        if (send(connection_descriptor, reply_line.data(), reply_line.size(), MSG_NOSIGNAL) < 0) {
+            LOG(WARNING) << "Could not send reply: " << std::strerror(errno);
+        }
+        close(connection_descriptor);
+    }
+
+    static absl::StatusOr<nlohmann::json> ReadRequest(int connection_descriptor) {
+        constexpr size_t kMaxRequestSize = 64 * 1024;
+        std::string request;
+        char buffer[4096];
+        while (request.find('\n') == std::string::npos) {
+            ssize_t size = recv(connection_descriptor, buffer, sizeof(buffer), 0);
+            if (size < 0 && errno == EINTR) {
+                continue;
+            }
+            if (size <= 0) {
+                break;
+            }
+            request.append(buffer, static_cast<size_t>(size));
+            if (request.size() > kMaxRequestSize) {
+                return absl::InvalidArgumentError("Request is too long.");
+            }
+        }
+        auto request_json = nlohmann::json::parse(request.substr(0, request.find('\n')), nullptr, false);
+        if (request_json.is_discarded() || !request_json.is_object()) {
+            return absl::InvalidArgumentError("Request is not a JSON object.");
+        }
+        return request_json;
+    }
+
+    // Returns the next free pool slot, which is null if its container was discarded.
+    std::unique_ptr<WarmSpotContainer<DeviceType::Cpu>> AcquireContainer() {
+        std::unique_lock<std::mutex> lock(pool_mutex);
+        container_released.wait(lock, [this] { return !idle_containers.empty(); });
+        auto container = std::move(idle_containers.front());
+        idle_containers.pop_front();
+        return container;
+    }
+
+    // Hands a slot back to the pool, with its container, or null if the container is not fit for reuse.
+    void ReleaseContainer(std::unique_ptr<WarmSpotContainer<DeviceType::Cpu>> container) {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        idle_containers.push_back(std::move(container));
+        container_released.notify_one();
+    }
+
+    nlohmann::json Measure(const nlohmann::json& request, std::chrono::steady_clock::time_point received_at) {
+        const std::string input_video_path = request.value("input_video_path", "");
+        auto container = AcquireContainer();
+        double queue_wait_ms = MillisecondsSince(received_at);
+
+        auto start = std::chrono::steady_clock::now();
+        absl::Status status;
+        const bool warm = container != nullptr && !absl::GetFlag(FLAGS_compare_cold_start);
+        if (warm) {
+            status = container->Reset(input_video_path);
+        } else {
+            // the warm container (if any) goes first, so that two graphs are never loaded for one pool slot
+            container.reset();
+            SpotSettings cold_settings = settings;
+            cold_settings.video_source.input_video_path = input_video_path;
+            container = std::make_unique<WarmSpotContainer<DeviceType::Cpu>>(std::move(cold_settings));
+            status = container->Initialize();
+        }
+        double start_ms = MillisecondsSince(start);
+        if (!status.ok()) {
+            LOG(WARNING) << "Could not " << (warm ? "reset" : "initialize") << " a spot container, discarding it: "
+                         << status.message();
+            ReleaseContainer(nullptr);
+            return {{"ok", false}, {"error", std::string(status.message())}, {"start_ms", start_ms}};
+        }
+        statistics.Add(warm, start_ms);
+        auto run_start = std::chrono::steady_clock::now();
+        status = container->Run();
+        double run_ms = MillisecondsSince(run_start);
+        LOG(INFO) << "Served measurement on " << (input_video_path.empty() ? "camera" : input_video_path)
+                  << ": " << (warm ? "warm" : "cold") << " start " << start_ms << " ms, run " << run_ms << " ms.";
+        nlohmann::json reply = {
+            {"ok", status.ok()},
+            {"error", std::string(status.message())},
+            {"metrics", container->last_metrics},
+            {"warm_start", warm},
+            {"queue_wait_ms", queue_wait_ms},
+            {"start_ms", start_ms},
+            {"run_ms", run_ms}
+        };
+        if (!status.ok()) {
+            LOG(WARNING) << "Spot container run failed, discarding the container: " << status.message();
+            container.reset();
+        }
+        ReleaseContainer(std::move(container));
+        return reply;
+    }
+
+    SpotSettings settings;
+    std::mutex pool_mutex;
+    std::condition_variable container_released;
+    // null for slots whose container was discarded: the next request on the slot builds a new one (a cold start)
+    std::deque<std::unique_ptr<WarmSpotContainer<DeviceType::Cpu>>> idle_containers;
+    PoolStatistics statistics;
+    std::mutex connection_mutex;
+    std::condition_variable connection_queued;
+    std::deque<PendingConnection> pending_connections;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+};
+
+absl::StatusOr<int> ListenOnSocket(const std::string& socket_path) {
+    sockaddr_un address{};
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        return absl::InvalidArgumentError("Socket path is too long: " + socket_path);
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    int listen_descriptor = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_descriptor < 0) {
+        return absl::InternalError(absl::StrCat("Could not create socket: ", std::strerror(errno)));
+    }
+    unlink(socket_path.c_str());
+    if (bind(listen_descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listen_descriptor, SOMAXCONN) != 0) {
+        close(listen_descriptor);
+        return absl::InternalError(absl::StrCat("Could not listen on ", socket_path, ": ", std::strerror(errno)));
+    }
+    return listen_descriptor;
+}
+
+} // anonymous namespace
+
+absl::Status RunWarmSpotService(SpotSettings& settings) {
+    const int pool_size = absl::GetFlag(FLAGS_pool_size);
+    if (pool_size < 1) {
+        return absl::InvalidArgumentError("--pool_size has to be at least 1.");
+    }
+    if (pool_size > 1 && settings.video_source.input_video_path.empty()) {
+        return absl::InvalidArgumentError(
+            "--pool_size > 1 requires --warm_up_video_path: pooled containers cannot all be initialized on the camera."
+        );
+    }
+    WarmSpotService service(settings);
+    MP_RETURN_IF_ERROR(service.Initialize(pool_size));
+
+    const std::string socket_path = absl::GetFlag(FLAGS_socket_path);
+    auto listen_descriptor_or_status = ListenOnSocket(socket_path);
+    if (!listen_descriptor_or_status.ok()) {
+        return listen_descriptor_or_status.status();
+    }
+    const int listen_descriptor = listen_descriptor_or_status.value();
+    LOG(INFO) << "Accepting measurement requests on " << socket_path;
+
+    // one worker per pooled container: more could only wait for a container to free up
+    service.StartWorkers(pool_size);
+    while (!stop_requested) {
+        pollfd poll_descriptor{listen_descriptor, POLLIN, 0};
+        if (poll(&poll_descriptor, 1, /*timeout=*/200) <= 0) {
+            continue;
+        }
+        int connection_descriptor = accept4(listen_descriptor, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection_descriptor < 0) {
+            continue;
+        }
+        // requests beyond the pool size wait in the queue for a worker (and its container) to free up
+        service.Enqueue(connection_descriptor);
+    }
+    LOG(INFO) << "Stopping: waiting for queued measurements and those in progress to finish.";
+    service.StopWorkers();
+    close(listen_descriptor);
+    unlink(socket_path.c_str());
+    service.LogStatistics();
+    return absl::OkStatus();
+}
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+
+    absl::SetProgramUsageMessage(
+        "Run a local Presage Physiology spot measurement service that keeps a pool of initialized spot containers\n"
+        "and serves measurement requests (on a video file or the camera) over a Unix domain socket, reusing a warm\n"
+        "container for each one. Stop with a keyboard interrupt."
+    );
+    absl::ParseCommandLine(argc, argv);
+
+    if (absl::GetFlag(FLAGS_also_log_to_stderr)) {
+        FLAGS_alsologtostderr = true;
+    }
+    std::signal(SIGINT, HandleStopSignal);
+    std::signal(SIGTERM, HandleStopSignal);
+
+    SpotSettings settings{
+        vs::VideoSourceSettings{
+            absl::GetFlag(FLAGS_camera_device_index),
+            absl::GetFlag(FLAGS_resolution_selection_mode),
+            absl::GetFlag(FLAGS_capture_width_px),
+            absl::GetFlag(FLAGS_capture_height_px),
+            absl::GetFlag(FLAGS_resolution_range),
+            absl::GetFlag(FLAGS_codec),
+            absl::GetFlag(FLAGS_auto_lock),
+            absl::GetFlag(FLAGS_warm_up_video_path),
+        },
+        settings::VideoSinkSettings{
+            "",
+            settings::VideoSinkMode::Unknown_EnumEnd,
+            false
+        },
+        /*headless=*/true,
+        absl::GetFlag(FLAGS_interframe_delay),
+        /*start_with_recording_on=*/true,
+        /*start_time_offset_ms=*/0,
+        absl::GetFlag(FLAGS_scale_input),
+        /*binary_graph=*/true,
+        absl::GetFlag(FLAGS_enable_phasic_bp),
+        /*print_graph_contents=*/false,
+
+        absl::GetFlag(FLAGS_verbosity),
+        settings::SpotSettings {
+            absl::GetFlag(FLAGS_spot_duration)
+        },
+        settings::JsonRestApiSettings{
+            absl::GetFlag(FLAGS_physiology_key),
+            absl::GetFlag(FLAGS_output_directory),
+            /*save_to_disk=*/false,
+        }
+    };
+
+    absl::Status status = RunWarmSpotService(settings);
+
+    if (!status.ok()) {
+        LOG(ERROR) << "Run failed. " << status.message();
+        return EXIT_FAILURE;
+    } else {
+        LOG(INFO) << "Success!";
+    }
+    return 0;
+}